@@ -112,7 +112,33 @@ auto Binder::BindCreate(duckdb_libpgquery::PGCreateStmt *pg_stmt) -> std::unique
     throw bustub::Exception("should have at least 1 column");
   }
 
-  return std::make_unique<CreateStatement>(std::move(table), std::move(columns));
+  auto layout = TableLayout::ROW;
+  for (auto c = pg_stmt->options == nullptr ? nullptr : pg_stmt->options->head; c != nullptr; c = lnext(c)) {
+    auto option = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(c->data.ptr_value);
+    if (std::string(option->defname) != "storage" || option->arg == nullptr) {
+      throw NotImplementedException(fmt::format("unsupported table option: {}", option->defname));
+    }
+    // `storage = pax` is parsed as a type name, `storage = 'pax'` as a string.
+    std::string storage;
+    if (option->arg->type == duckdb_libpgquery::T_PGTypeName) {
+      auto type_name = reinterpret_cast<duckdb_libpgquery::PGTypeName *>(option->arg);
+      storage = reinterpret_cast<duckdb_libpgquery::PGValue *>(type_name->names->tail->data.ptr_value)->val.str;
+    } else if (option->arg->type == duckdb_libpgquery::T_PGString) {
+      storage = reinterpret_cast<duckdb_libpgquery::PGValue *>(option->arg)->val.str;
+    }
+    storage = StringUtil::Lower(storage);
+    if (storage == "row") {
+      layout = TableLayout::ROW;
+    } else if (storage == "pax") {
+      layout = TableLayout::PAX;
+    } else if (storage == "compressed") {
+      layout = TableLayout::COMPRESSED;
+    } else {
+      throw NotImplementedException(fmt::format("unsupported storage: {}", storage));
+    }
+  }
+
+  return std::make_unique<CreateStatement>(std::move(table), std::move(columns), layout);
 }
 
 auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<IndexStatement> {
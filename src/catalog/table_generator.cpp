@@ -65,6 +65,14 @@ auto TableGenerator::MakeValues(ColumnInsertMeta *col_meta, uint32_t count) -> s
 void TableGenerator::FillTable(TableInfo *info, TableInsertMeta *table_meta) {
   uint32_t num_inserted = 0;
   uint32_t batch_size = 128;
+  // Rows are generated 128 at a time but loaded through the bulk insert path in larger batches.
+  const size_t load_batch_size = 8192;
+  std::vector<Tuple> tuples;
+  auto load = [&]() {
+    auto rids = info->table_->BulkInsert(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuples);
+    BUSTUB_ENSURE(rids.size() == tuples.size(), "Sequential insertion cannot fail");
+    tuples.clear();
+  };
   while (num_inserted < table_meta->num_rows_) {
     std::vector<std::vector<Value>> values;
     uint32_t num_values = std::min(batch_size, table_meta->num_rows_ - num_inserted);
@@ -77,12 +85,14 @@ void TableGenerator::FillTable(TableInfo *info, TableInsertMeta *table_meta) {
       for (const auto &col : values) {
         entry.emplace_back(col[i]);
       }
-      auto rid =
-          info->table_->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, Tuple(entry, &info->schema_));
-      BUSTUB_ENSURE(rid != std::nullopt, "Sequential insertion cannot fail");
+      tuples.emplace_back(entry, &info->schema_);
       num_inserted++;
     }
+    if (tuples.size() >= load_batch_size) {
+      load();
+    }
   }
+  load();
 }
 
 void TableGenerator::GenerateTestTables() {
@@ -1,9 +1,13 @@
 // DDL (Data Definition Language) statement handling in BusTub, including create table, create index, and set/show
 // variable.
 
+#include <algorithm>
+#include <cctype>
 #include <optional>
 #include <shared_mutex>
+#include <stdexcept>
 #include <string>
+#include <thread>  // NOLINT
 #include <tuple>
 
 #include "binder/binder.h"
@@ -42,7 +46,7 @@ namespace bustub {
 
 void BustubInstance::HandleCreateStatement(Transaction *txn, const CreateStatement &stmt, ResultWriter &writer) {
   std::unique_lock<std::shared_mutex> l(catalog_lock_);
-  auto info = catalog_->CreateTable(txn, stmt.table_, Schema(stmt.columns_));
+  auto info = catalog_->CreateTable(txn, stmt.table_, Schema(stmt.columns_), true, stmt.layout_);
   l.unlock();
 
   if (info == nullptr) {
@@ -133,6 +137,33 @@ void BustubInstance::HandleVariableShowStatement(Transaction *txn, const Variabl
 
 void BustubInstance::HandleVariableSetStatement(Transaction *txn, const VariableSetStatement &stmt,
                                                 ResultWriter &writer) {
+  auto variable = StringUtil::Lower(stmt.variable_);
+  if (variable == "parallelism" || variable == "work_mem") {
+    // std::stoul would take "-1" as the largest number, and ignore anything after the digits.
+    size_t number = 0;
+    if (stmt.value_.empty() || !std::all_of(stmt.value_.begin(), stmt.value_.end(), ::isdigit)) {
+      throw Exception(fmt::format("invalid {}: {}", variable, stmt.value_));
+    }
+    try {
+      number = std::stoul(stmt.value_);
+    } catch (const std::out_of_range &e) {
+      throw Exception(fmt::format("invalid {}: {}", variable, stmt.value_));
+    }
+    if (number == 0) {
+      throw Exception(fmt::format("{} must be at least 1", variable));
+    }
+    if (variable == "parallelism") {
+      auto max_workers = std::max(std::thread::hardware_concurrency(), 1U) * MAX_WORKERS_PER_CORE;
+      if (number > max_workers) {
+        throw Exception(fmt::format("parallelism must be at most {}", max_workers));
+      }
+      SetParallelism(number);
+    } else {
+      work_mem_ = number;
+      session_variables_[variable] = std::to_string(number);
+    }
+    return;
+  }
   session_variables_[stmt.variable_] = stmt.value_;
 }
 
@@ -1,6 +1,8 @@
+#include <algorithm>
 #include <optional>
 #include <shared_mutex>
 #include <string>
+#include <thread>  // NOLINT
 #include <tuple>
 
 #include "binder/binder.h"
@@ -26,6 +28,7 @@
 #include "execution/executors/mock_scan_executor.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/task_scheduler.h"
 #include "fmt/core.h"
 #include "fmt/format.h"
 #include "optimizer/optimizer.h"
@@ -39,7 +42,20 @@
 namespace bustub {
 
 auto BustubInstance::MakeExecutorContext(Transaction *txn, bool is_modify) -> std::unique_ptr<ExecutorContext> {
-  return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_, is_modify);
+  auto exec_ctx =
+      std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_, is_modify);
+  exec_ctx->SetTaskScheduler(task_scheduler_.get());
+  exec_ctx->SetWorkMem(work_mem_);
+  return exec_ctx;
+}
+
+void BustubInstance::SetParallelism(size_t num_workers) {
+  BUSTUB_ASSERT(num_workers > 0, "queries run on at least one thread");
+  task_scheduler_.reset();
+  if (num_workers > 1) {
+    task_scheduler_ = std::make_unique<TaskScheduler>(num_workers);
+  }
+  session_variables_["parallelism"] = std::to_string(num_workers);
 }
 
 BustubInstance::BustubInstance(const std::string &db_file_name) {
@@ -80,6 +96,10 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
 
   // Execution engine.
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
+
+  // Run queries on all cores by default.
+  SetParallelism(std::max(std::thread::hardware_concurrency(), 1U));
+  session_variables_["work_mem"] = std::to_string(work_mem_);
 }
 
 BustubInstance::BustubInstance() {
@@ -120,6 +140,10 @@ BustubInstance::BustubInstance() {
 
   // Execution engine.
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
+
+  // Run queries on all cores by default.
+  SetParallelism(std::max(std::thread::hardware_concurrency(), 1U));
+  session_variables_["work_mem"] = std::to_string(work_mem_);
 }
 
 void BustubInstance::CmdDisplayTables(ResultWriter &writer) {
@@ -354,6 +378,7 @@ BustubInstance::~BustubInstance() {
   if (enable_logging) {
     log_manager_->StopFlushThread();
   }
+  task_scheduler_.reset();
   delete execution_engine_;
   delete catalog_;
   delete checkpoint_manager_;
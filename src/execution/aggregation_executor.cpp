@@ -1,29 +1,151 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// aggregation_executor.cpp
-//
-// Identification: src/execution/aggregation_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-#include <memory>
-#include <vector>
-
-#include "execution/executors/aggregation_executor.h"
-
-namespace bustub {
-
-AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
-                                         std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
-
-void AggregationExecutor::Init() {}
-
-auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
-
-auto AggregationExecutor::GetChildExecutor() const -> const AbstractExecutor * { return child_executor_.get(); }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_executor.cpp
+//
+// Identification: src/execution/aggregation_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include <memory>
+#include <vector>
+
+#include "execution/executors/aggregation_executor.h"
+#include "execution/parallel_pipeline.h"
+#include "execution/task_scheduler.h"
+
+namespace bustub {
+
+AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
+                                         std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+
+void AggregationExecutor::Init() {
+  tables_.clear();
+  partition_ = 0;
+  group_ = 0;
+  partition_ready_ = false;
+  num_output_ = 0;
+  if (auto pipeline = ParallelPipeline::Make(exec_ctx_, plan_->GetChildPlan()); pipeline != nullptr) {
+    for (size_t i = 0; i < pipeline->NumWorkers(); i++) {
+      tables_.push_back(MakeTable(exec_ctx_->GetWorkMem() / pipeline->NumWorkers()));
+    }
+    pipeline->Run([&](size_t worker, const TupleBatch &batch) { AggregateBatch(batch, tables_[worker].get()); });
+    MergeTables();
+  } else {
+    tables_.push_back(MakeTable(exec_ctx_->GetWorkMem()));
+    AggregateChild();
+  }
+}
+
+auto AggregationExecutor::MakeTable(size_t memory_limit) const -> std::unique_ptr<AggregationHashTable> {
+  std::vector<TypeId> group_by_types;
+  std::vector<TypeId> input_types;
+  for (const auto &expr : plan_->GetGroupBys()) {
+    group_by_types.push_back(expr->GetReturnType());
+  }
+  for (const auto &expr : plan_->GetAggregates()) {
+    input_types.push_back(expr->GetReturnType());
+  }
+  return std::make_unique<AggregationHashTable>(std::move(group_by_types), plan_->GetAggregateTypes(), input_types,
+                                                exec_ctx_->GetBufferPoolManager(), memory_limit);
+}
+
+void AggregationExecutor::AggregateChild() {
+  child_executor_->Init();
+  TupleBatch batch;
+  if (child_executor_->SupportsBatch()) {
+    while (child_executor_->NextBatch(&batch)) {
+      AggregateBatch(batch, tables_[0].get());
+    }
+    return;
+  }
+  const auto &schema = child_executor_->GetOutputSchema();
+  Tuple tuple;
+  RID rid;
+  bool more = true;
+  while (more) {
+    batch.Reset(schema);
+    while (!batch.IsFull() && (more = child_executor_->Next(&tuple, &rid))) {
+      batch.AppendTuple(TupleRef(tuple), schema);
+    }
+    AggregateBatch(batch, tables_[0].get());
+  }
+}
+
+void AggregationExecutor::AggregateBatch(const TupleBatch &batch, AggregationHashTable *table) const {
+  const auto &group_bys = plan_->GetGroupBys();
+  const auto &aggregates = plan_->GetAggregates();
+  std::vector<ColumnVector> group_by_columns(group_bys.size());
+  std::vector<ColumnVector> aggregate_columns(aggregates.size());
+  for (uint32_t i = 0; i < group_bys.size(); i++) {
+    group_bys[i]->EvaluateBatch(batch, &group_by_columns[i]);
+  }
+  for (uint32_t i = 0; i < aggregates.size(); i++) {
+    aggregates[i]->EvaluateBatch(batch, &aggregate_columns[i]);
+  }
+  table->Aggregate(group_by_columns, aggregate_columns, batch.NumSelected());
+}
+
+void AggregationExecutor::MergeTables() {
+  std::vector<TaskScheduler::Task> tasks;
+  for (uint32_t partition = 0; partition < AggregationHashTable::NUM_PARTITIONS; partition++) {
+    tasks.emplace_back([this, partition](size_t /*worker*/) {
+      for (size_t i = 1; i < tables_.size(); i++) {
+        tables_[0]->MergePartition(tables_[i].get(), partition);
+      }
+    });
+  }
+  exec_ctx_->GetTaskScheduler()->RunAll(tasks);
+  tables_.resize(1);
+}
+
+auto AggregationExecutor::NextGroup(std::vector<Value> *values) -> bool {
+  auto &table = *tables_[0];
+  while (partition_ < AggregationHashTable::NUM_PARTITIONS) {
+    if (!partition_ready_) {
+      table.Unspill(partition_);
+      partition_ready_ = true;
+    }
+    if (group_ < table.NumGroups(partition_)) {
+      *values = table.GetGroup(partition_, group_++);
+      num_output_++;
+      return true;
+    }
+    table.ClearPartition(partition_);
+    partition_++;
+    group_ = 0;
+    partition_ready_ = false;
+  }
+  // Without GROUP BY, an empty input still yields one row of initial values, e.g. a count of 0.
+  if (plan_->GetGroupBys().empty() && num_output_ == 0) {
+    *values = table.InitialAggregates();
+    num_output_++;
+    return true;
+  }
+  return false;
+}
+
+auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  std::vector<Value> values;
+  if (!NextGroup(&values)) {
+    return false;
+  }
+  *tuple = Tuple{values, &GetOutputSchema()};
+  return true;
+}
+
+auto AggregationExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset(GetOutputSchema());
+  std::vector<Value> values;
+  while (!batch->IsFull() && NextGroup(&values)) {
+    batch->AppendRow(std::move(values));
+  }
+  return batch->NumSelected() > 0;
+}
+
+auto AggregationExecutor::GetChildExecutor() const -> const AbstractExecutor * { return child_executor_.get(); }
+
+}  // namespace bustub
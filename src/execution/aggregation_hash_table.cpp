@@ -0,0 +1,806 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_hash_table.cpp
+//
+// Identification: src/execution/aggregation_hash_table.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/aggregation_hash_table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "common/exception.h"
+#include "common/util/hash_util.h"
+#include "fmt/format.h"
+#include "type/limits.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** How a state of a sum, min or max folds in an input. */
+enum class FoldOp : uint8_t { SUM, MIN, MAX };
+
+/** @return the value of C++ type `T` stored in the low bytes of `word` */
+template <class T>
+auto Load(uint64_t word) -> T {
+  T value;
+  memcpy(&value, &word, sizeof(T));
+  return value;
+}
+
+/** @return `value` stored in the low bytes of a word */
+template <class T>
+auto Store(T value) -> uint64_t {
+  uint64_t word = 0;
+  memcpy(&word, &value, sizeof(T));
+  return word;
+}
+
+/** Fold `input` into the state `*state` of C++ type `T`, int64_t or double, which is NULL if `*nulls & bit`. */
+template <FoldOp Op, class T>
+void Fold(uint64_t *state, uint64_t *nulls, uint64_t bit, T input) {
+  if ((*nulls & bit) != 0) {
+    *state = Store(input);
+    *nulls &= ~bit;
+    return;
+  }
+  auto value = Load<T>(*state);
+  if constexpr (Op == FoldOp::SUM) {
+    if constexpr (std::is_integral_v<T>) {
+      if (__builtin_add_overflow(value, input, &value)) {
+        throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
+      }
+    } else {
+      value += input;
+    }
+  } else if constexpr (Op == FoldOp::MIN) {
+    value = std::min(value, input);
+  } else {
+    value = std::max(value, input);
+  }
+  *state = Store(value);
+}
+
+/** Call `f(row, value)` for the non-NULL values of the first `num_rows` rows of `column`, of C++ type `T`. */
+template <class T, class F>
+void ForEachValue(const ColumnVector &column, size_t num_rows, F f) {
+  const auto *data = column.GetData<T>();
+  if (!column.HasNulls()) {
+    for (size_t row = 0; row < num_rows; row++) {
+      f(row, data[row]);
+    }
+    return;
+  }
+  for (size_t row = 0; row < num_rows; row++) {
+    if (!column.IsNull(row)) {
+      f(row, data[row]);
+    }
+  }
+}
+
+/** Call `f(row, value)` for the non-NULL values of the first `num_rows` rows of integer `column`, as int64_t. */
+template <class F>
+void ForEachInteger(const ColumnVector &column, size_t num_rows, F f) {
+  switch (column.GetType()) {
+    case TypeId::TINYINT:
+      ForEachValue<int8_t>(column, num_rows, f);
+      break;
+    case TypeId::SMALLINT:
+      ForEachValue<int16_t>(column, num_rows, f);
+      break;
+    case TypeId::INTEGER:
+      ForEachValue<int32_t>(column, num_rows, f);
+      break;
+    case TypeId::BIGINT:
+      ForEachValue<int64_t>(column, num_rows, f);
+      break;
+    default:
+      UNREACHABLE("not an integer column");
+  }
+}
+
+/** Fold the values of `column` into the state `slot` of the groups `rows`, one per row. */
+template <FoldOp Op, class T>
+void FoldColumn(const ColumnVector &column, size_t num_rows, uint64_t *const *rows, size_t slot, size_t nulls,
+                uint64_t bit) {
+  auto fold = [&](size_t row, T value) { Fold<Op, T>(&rows[row][slot], &rows[row][nulls], bit, value); };
+  if constexpr (std::is_integral_v<T>) {
+    ForEachInteger(column, num_rows, fold);
+  } else {
+    ForEachValue<double>(column, num_rows, fold);
+  }
+}
+
+auto IsInteger(TypeId type) -> bool {
+  return type == TypeId::TINYINT || type == TypeId::SMALLINT || type == TypeId::INTEGER || type == TypeId::BIGINT;
+}
+
+/** @return the words of the first `num_rows` values of fixed-size `column`, of C++ type `T`, NULL ones included */
+template <class T>
+void LoadWords(const ColumnVector &column, size_t num_rows, uint64_t *words) {
+  const auto *data = column.GetData<T>();
+  for (size_t row = 0; row < num_rows; row++) {
+    if constexpr (std::is_same_v<T, double>) {
+      // -0.0 and 0.0 are the same group.
+      words[row] = data[row] == 0 ? 0 : Store(data[row]);
+    } else {
+      words[row] = static_cast<std::make_unsigned_t<T>>(data[row]);
+    }
+  }
+}
+
+/** @return `value` as a Value of integer type `type`, if it fits */
+auto MakeInteger(TypeId type, int64_t value) -> Value {
+  switch (type) {
+    case TypeId::TINYINT:
+      if (value >= BUSTUB_INT8_MIN && value <= BUSTUB_INT8_MAX) {
+        return {type, static_cast<int8_t>(value)};
+      }
+      break;
+    case TypeId::SMALLINT:
+      if (value >= BUSTUB_INT16_MIN && value <= BUSTUB_INT16_MAX) {
+        return {type, static_cast<int16_t>(value)};
+      }
+      break;
+    case TypeId::INTEGER:
+      if (value >= BUSTUB_INT32_MIN && value <= BUSTUB_INT32_MAX) {
+        return {type, static_cast<int32_t>(value)};
+      }
+      break;
+    default:
+      return {type, value};
+  }
+  throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
+}
+
+/** @return `column`, or its values cast to `type` in `buffer` if it has another type */
+auto CastColumn(const ColumnVector &column, TypeId type, size_t num_rows, ColumnVector *buffer)
+    -> const ColumnVector & {
+  if (column.GetType() == type) {
+    return column;
+  }
+  buffer->Reset(type);
+  for (size_t row = 0; row < num_rows; row++) {
+    buffer->Append(column.GetValue(row));
+  }
+  return *buffer;
+}
+
+}  // namespace
+
+AggregationHashTable::AggregationHashTable(std::vector<TypeId> group_by_types,
+                                           const std::vector<AggregationType> &agg_types,
+                                           const std::vector<TypeId> &input_types, BufferPoolManager *bpm,
+                                           size_t memory_limit)
+    : group_by_types_(std::move(group_by_types)),
+      agg_types_(agg_types),
+      input_types_(input_types),
+      spill_schema_(MakeSpillSchema(group_by_types_, agg_types, input_types)),
+      bpm_(bpm),
+      memory_limit_(memory_limit) {
+  BUSTUB_ENSURE(group_by_types_.size() + agg_types.size() < 64, "too many group-bys and aggregates");
+  for (uint32_t i = 0; i < agg_types.size(); i++) {
+    kinds_.push_back(StateKindOf(agg_types[i], input_types[i]));
+    boxed_index_.push_back(num_boxed_);
+    num_boxed_ += kinds_.back() == StateKind::BOXED ? 1 : 0;
+  }
+}
+
+auto AggregationHashTable::StateKindOf(AggregationType agg_type, TypeId input_type) -> StateKind {
+  auto integer = IsInteger(input_type);
+  auto decimal = input_type == TypeId::DECIMAL;
+  switch (agg_type) {
+    case AggregationType::CountStarAggregate:
+      return StateKind::COUNT_STAR;
+    case AggregationType::CountAggregate:
+      return StateKind::COUNT;
+    case AggregationType::SumAggregate:
+      return integer ? StateKind::SUM_INTEGER : decimal ? StateKind::SUM_DECIMAL : StateKind::BOXED;
+    case AggregationType::MinAggregate:
+      return integer ? StateKind::MIN_INTEGER : decimal ? StateKind::MIN_DECIMAL : StateKind::BOXED;
+    case AggregationType::MaxAggregate:
+      return integer ? StateKind::MAX_INTEGER : decimal ? StateKind::MAX_DECIMAL : StateKind::BOXED;
+  }
+  UNREACHABLE("unknown aggregation type");
+}
+
+auto AggregationHashTable::MakeSpillSchema(const std::vector<TypeId> &group_by_types,
+                                           const std::vector<AggregationType> &agg_types,
+                                           const std::vector<TypeId> &input_types) -> Schema {
+  std::vector<Column> columns;
+  auto add_column = [&](TypeId type) {
+    auto name = fmt::format("#{}", columns.size());
+    if (type == TypeId::VARCHAR) {
+      columns.emplace_back(name, type, BUSTUB_PAGE_SIZE);
+    } else {
+      columns.emplace_back(name, type);
+    }
+  };
+  for (auto type : group_by_types) {
+    add_column(type);
+  }
+  for (uint32_t i = 0; i < agg_types.size(); i++) {
+    switch (StateKindOf(agg_types[i], input_types[i])) {
+      case StateKind::SUM_DECIMAL:
+      case StateKind::MIN_DECIMAL:
+      case StateKind::MAX_DECIMAL:
+        add_column(TypeId::DECIMAL);
+        break;
+      case StateKind::BOXED:
+        add_column(input_types[i]);
+        break;
+      default:
+        // Counts and the states of integers are spilled as they are kept, as 64-bit integers.
+        add_column(TypeId::BIGINT);
+        break;
+    }
+  }
+  return Schema(columns);
+}
+
+void AggregationHashTable::Aggregate(const std::vector<ColumnVector> &group_bys,
+                                     const std::vector<ColumnVector> &inputs, size_t num_rows) {
+  std::vector<const ColumnVector *> keys;
+  keys.reserve(group_bys.size());
+  for (const auto &column : group_bys) {
+    keys.push_back(&column);
+  }
+  EncodeKeys(keys, num_rows);
+  FindGroups(num_rows);
+  for (uint32_t i = 0; i < inputs.size(); i++) {
+    UpdateStates(i, inputs[i], num_rows, false);
+  }
+  if (bpm_ != nullptr && MemoryUsage() > memory_limit_) {
+    Spill();
+  }
+}
+
+void AggregationHashTable::EncodeKeys(const std::vector<const ColumnVector *> &group_bys, size_t num_rows) {
+  keys_.words_.resize(NumKeys());
+  keys_.nulls_.assign(num_rows, 0);
+  keys_.strings_.clear();
+  keys_.hashes_.assign(num_rows, 0);
+  keys_.casts_.resize(NumKeys());
+  for (uint32_t i = 0; i < NumKeys(); i++) {
+    auto type = group_by_types_[i];
+    const auto &column = CastColumn(*group_bys[i], type, num_rows, &keys_.casts_[i]);
+    auto &words = keys_.words_[i];
+    words.resize(num_rows);
+    auto null_bit = uint64_t{1} << i;
+    if (type == TypeId::VARCHAR) {
+      for (size_t row = 0; row < num_rows; row++) {
+        const auto &value = column.GetBoxedValue(row);
+        if (value.IsNull()) {
+          words[row] = 0;
+          keys_.nulls_[row] |= null_bit;
+        } else {
+          words[row] = keys_.strings_.size();
+          keys_.strings_.emplace_back(value.GetData(), value.GetLength());
+        }
+        auto hash = value.IsNull() ? 0 : HashUtil::HashBytes(value.GetData(), value.GetLength());
+        keys_.hashes_[row] = HashUtil::MixHash(keys_.hashes_[row] ^ hash);
+      }
+      continue;
+    }
+    switch (type) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        LoadWords<int8_t>(column, num_rows, words.data());
+        break;
+      case TypeId::SMALLINT:
+        LoadWords<int16_t>(column, num_rows, words.data());
+        break;
+      case TypeId::INTEGER:
+        LoadWords<int32_t>(column, num_rows, words.data());
+        break;
+      case TypeId::BIGINT:
+        LoadWords<int64_t>(column, num_rows, words.data());
+        break;
+      case TypeId::DECIMAL:
+        LoadWords<double>(column, num_rows, words.data());
+        break;
+      case TypeId::TIMESTAMP:
+        LoadWords<uint64_t>(column, num_rows, words.data());
+        break;
+      default:
+        UNREACHABLE("not a fixed-size type");
+    }
+    if (column.HasNulls()) {
+      for (size_t row = 0; row < num_rows; row++) {
+        if (column.IsNull(row)) {
+          words[row] = 0;
+          keys_.nulls_[row] |= null_bit;
+        }
+      }
+    }
+    for (size_t row = 0; row < num_rows; row++) {
+      keys_.hashes_[row] = HashUtil::MixHash(keys_.hashes_[row] ^ words[row]);
+    }
+  }
+}
+
+template <class Equals, class Insert>
+auto AggregationHashTable::FindOrInsert(Partition *partition, uint64_t hash, Equals equals, Insert insert)
+    -> uint32_t {
+  if ((partition->hashes_.size() + 1) * 2 > partition->slots_.size()) {
+    Grow(partition);
+  }
+  auto mask = partition->slots_.size() - 1;
+  auto tag = static_cast<uint32_t>(hash >> 32);
+  for (auto idx = hash & mask;; idx = (idx + 1) & mask) {
+    auto &slot = partition->slots_[idx];
+    if (slot.group_ == 0) {
+      auto group = static_cast<uint32_t>(partition->hashes_.size());
+      partition->hashes_.push_back(hash);
+      insert();
+      slot = {group + 1, tag};
+      return group;
+    }
+    if (slot.tag_ == tag && equals(slot.group_ - 1)) {
+      return slot.group_ - 1;
+    }
+  }
+}
+
+void AggregationHashTable::Grow(Partition *partition) {
+  auto size = std::max<size_t>(partition->slots_.size() * 2, 64);
+  partition->slots_.assign(size, Slot{0, 0});
+  auto mask = size - 1;
+  for (uint32_t group = 0; group < partition->hashes_.size(); group++) {
+    auto hash = partition->hashes_[group];
+    auto idx = hash & mask;
+    while (partition->slots_[idx].group_ != 0) {
+      idx = (idx + 1) & mask;
+    }
+    partition->slots_[idx] = {group + 1, static_cast<uint32_t>(hash >> 32)};
+  }
+}
+
+auto AggregationHashTable::KeyEquals(const Partition &partition, uint32_t group, size_t row) const -> bool {
+  const auto *group_row = &partition.rows_[group * RowWidth()];
+  auto key_nulls = (uint64_t{1} << NumKeys()) - 1;
+  if ((group_row[RowWidth() - 1] & key_nulls) != keys_.nulls_[row]) {
+    return false;
+  }
+  for (uint32_t i = 0; i < NumKeys(); i++) {
+    auto word = keys_.words_[i][row];
+    if (group_by_types_[i] != TypeId::VARCHAR) {
+      if (group_row[i] != word) {
+        return false;
+      }
+    } else if ((keys_.nulls_[row] >> i & 1) == 0 && GetString(partition.heap_, group_row[i]) != keys_.strings_[word]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void AggregationHashTable::FindGroups(size_t num_rows) {
+  groups_.resize(num_rows);
+  for (size_t row = 0; row < num_rows; row++) {
+    auto hash = keys_.hashes_[row];
+    auto *partition = &partitions_[PartitionOf(hash)];
+    groups_[row] = FindOrInsert(
+        partition, hash, [&](uint32_t group) { return KeyEquals(*partition, group, row); },
+        [&] { InsertGroup(partition, row); });
+  }
+  // The groups only move while groups are inserted, so they are pointed at once all are.
+  group_rows_.resize(num_rows);
+  group_boxed_.resize(num_rows);
+  for (size_t row = 0; row < num_rows; row++) {
+    auto &partition = partitions_[PartitionOf(keys_.hashes_[row])];
+    group_rows_[row] = &partition.rows_[groups_[row] * RowWidth()];
+    group_boxed_[row] = partition.boxed_.data() + groups_[row] * NumBoxed();
+  }
+}
+
+void AggregationHashTable::InsertGroup(Partition *partition, size_t row) {
+  auto offset = partition->rows_.size();
+  partition->rows_.resize(offset + RowWidth());
+  auto *group_row = &partition->rows_[offset];
+  for (uint32_t i = 0; i < NumKeys(); i++) {
+    group_row[i] = keys_.words_[i][row];
+    if (group_by_types_[i] == TypeId::VARCHAR && (keys_.nulls_[row] >> i & 1) == 0) {
+      auto value = keys_.strings_[group_row[i]];
+      auto length = static_cast<uint32_t>(value.size());
+      group_row[i] = partition->heap_.size();
+      partition->heap_.insert(partition->heap_.end(), reinterpret_cast<const char *>(&length),
+                              reinterpret_cast<const char *>(&length) + sizeof(length));
+      partition->heap_.insert(partition->heap_.end(), value.begin(), value.end());
+    }
+  }
+  group_row[RowWidth() - 1] = keys_.nulls_[row];
+  InitAggregates(partition, group_row);
+}
+
+void AggregationHashTable::InitAggregates(Partition *partition, uint64_t *row) {
+  for (uint32_t i = 0; i < kinds_.size(); i++) {
+    // Counts start at zero; the others are NULL until they see a value.
+    if (kinds_[i] != StateKind::COUNT_STAR && kinds_[i] != StateKind::COUNT) {
+      row[RowWidth() - 1] |= uint64_t{1} << (NumKeys() + i);
+    }
+  }
+  // A boxed state has the type of its input, e.g. a VARCHAR, even while it is NULL.
+  for (uint32_t i = 0; i < kinds_.size(); i++) {
+    if (kinds_[i] == StateKind::BOXED) {
+      partition->boxed_.push_back(ValueFactory::GetNullValueByType(input_types_[i]));
+    }
+  }
+}
+
+void AggregationHashTable::UpdateStates(uint32_t agg_idx, const ColumnVector &column, size_t num_rows, bool partial) {
+  auto slot = NumKeys() + agg_idx;
+  auto nulls = RowWidth() - 1;
+  auto bit = uint64_t{1} << slot;
+  auto *const *rows = group_rows_.data();
+  auto kind = kinds_[agg_idx];
+  ColumnVector buffer;
+  switch (kind) {
+    case StateKind::COUNT_STAR:
+    case StateKind::COUNT:
+      if (partial) {
+        ForEachValue<int64_t>(CastColumn(column, TypeId::BIGINT, num_rows, &buffer), num_rows,
+                              [&](size_t row, int64_t count) { rows[row][slot] += count; });
+      } else if (kind == StateKind::COUNT_STAR) {
+        for (size_t row = 0; row < num_rows; row++) {
+          rows[row][slot]++;
+        }
+      } else {
+        for (size_t row = 0; row < num_rows; row++) {
+          rows[row][slot] += column.IsNull(row) ? 0 : 1;
+        }
+      }
+      break;
+    case StateKind::SUM_INTEGER:
+    case StateKind::MIN_INTEGER:
+    case StateKind::MAX_INTEGER: {
+      const auto &values =
+          IsInteger(column.GetType()) ? column : CastColumn(column, input_types_[agg_idx], num_rows, &buffer);
+      if (kind == StateKind::SUM_INTEGER) {
+        FoldColumn<FoldOp::SUM, int64_t>(values, num_rows, rows, slot, nulls, bit);
+      } else if (kind == StateKind::MIN_INTEGER) {
+        FoldColumn<FoldOp::MIN, int64_t>(values, num_rows, rows, slot, nulls, bit);
+      } else {
+        FoldColumn<FoldOp::MAX, int64_t>(values, num_rows, rows, slot, nulls, bit);
+      }
+      break;
+    }
+    case StateKind::SUM_DECIMAL:
+    case StateKind::MIN_DECIMAL:
+    case StateKind::MAX_DECIMAL: {
+      const auto &values = CastColumn(column, TypeId::DECIMAL, num_rows, &buffer);
+      if (kind == StateKind::SUM_DECIMAL) {
+        FoldColumn<FoldOp::SUM, double>(values, num_rows, rows, slot, nulls, bit);
+      } else if (kind == StateKind::MIN_DECIMAL) {
+        FoldColumn<FoldOp::MIN, double>(values, num_rows, rows, slot, nulls, bit);
+      } else {
+        FoldColumn<FoldOp::MAX, double>(values, num_rows, rows, slot, nulls, bit);
+      }
+      break;
+    }
+    case StateKind::BOXED:
+      for (size_t row = 0; row < num_rows; row++) {
+        CombineBoxed(agg_types_[agg_idx], &group_boxed_[row][boxed_index_[agg_idx]], column.GetValue(row));
+      }
+      break;
+  }
+}
+
+void AggregationHashTable::CombineBoxed(AggregationType agg_type, Value *value, const Value &input) {
+  if (input.IsNull()) {
+    return;
+  }
+  switch (agg_type) {
+    case AggregationType::SumAggregate:
+      *value = value->IsNull() ? input : value->Add(input);
+      break;
+    case AggregationType::MinAggregate:
+      if (value->IsNull() || input.CompareLessThan(*value) == CmpBool::CmpTrue) {
+        *value = input;
+      }
+      break;
+    case AggregationType::MaxAggregate:
+      if (value->IsNull() || input.CompareGreaterThan(*value) == CmpBool::CmpTrue) {
+        *value = input;
+      }
+      break;
+    default:
+      UNREACHABLE("counts are never boxed");
+  }
+}
+
+void AggregationHashTable::MergeState(uint32_t agg_idx, uint64_t *dst, Value *dst_boxed, const uint64_t *src,
+                                      const Value *src_boxed) {
+  auto slot = NumKeys() + agg_idx;
+  auto nulls = RowWidth() - 1;
+  auto bit = uint64_t{1} << slot;
+  auto kind = kinds_[agg_idx];
+  if (kind == StateKind::COUNT_STAR || kind == StateKind::COUNT) {
+    dst[slot] += src[slot];
+    return;
+  }
+  if ((src[nulls] & bit) != 0) {
+    return;
+  }
+  switch (kind) {
+    case StateKind::SUM_INTEGER:
+      Fold<FoldOp::SUM>(&dst[slot], &dst[nulls], bit, Load<int64_t>(src[slot]));
+      break;
+    case StateKind::MIN_INTEGER:
+      Fold<FoldOp::MIN>(&dst[slot], &dst[nulls], bit, Load<int64_t>(src[slot]));
+      break;
+    case StateKind::MAX_INTEGER:
+      Fold<FoldOp::MAX>(&dst[slot], &dst[nulls], bit, Load<int64_t>(src[slot]));
+      break;
+    case StateKind::SUM_DECIMAL:
+      Fold<FoldOp::SUM>(&dst[slot], &dst[nulls], bit, Load<double>(src[slot]));
+      break;
+    case StateKind::MIN_DECIMAL:
+      Fold<FoldOp::MIN>(&dst[slot], &dst[nulls], bit, Load<double>(src[slot]));
+      break;
+    case StateKind::MAX_DECIMAL:
+      Fold<FoldOp::MAX>(&dst[slot], &dst[nulls], bit, Load<double>(src[slot]));
+      break;
+    default:
+      CombineBoxed(agg_types_[agg_idx], &dst_boxed[boxed_index_[agg_idx]], src_boxed[boxed_index_[agg_idx]]);
+      break;
+  }
+}
+
+void AggregationHashTable::MergePartition(AggregationHashTable *other, uint32_t partition) {
+  auto &dst = partitions_[partition];
+  auto &src = other->partitions_[partition];
+  for (auto &file : src.spilled_) {
+    dst.spilled_.push_back(std::move(file));
+  }
+  if (dst.hashes_.empty()) {
+    // Nothing to merge with: take the groups over as they are.
+    std::swap(dst.rows_, src.rows_);
+    std::swap(dst.hashes_, src.hashes_);
+    std::swap(dst.slots_, src.slots_);
+    std::swap(dst.heap_, src.heap_);
+    std::swap(dst.boxed_, src.boxed_);
+    other->ClearPartition(partition);
+    return;
+  }
+  auto width = RowWidth();
+  for (uint32_t group = 0; group < src.hashes_.size(); group++) {
+    const auto *src_row = &src.rows_[group * width];
+    auto equals = [&](uint32_t dst_group) {
+      const auto *dst_row = &dst.rows_[dst_group * width];
+      auto key_nulls = (uint64_t{1} << NumKeys()) - 1;
+      if ((dst_row[width - 1] & key_nulls) != (src_row[width - 1] & key_nulls)) {
+        return false;
+      }
+      for (uint32_t i = 0; i < NumKeys(); i++) {
+        if (group_by_types_[i] != TypeId::VARCHAR) {
+          if (dst_row[i] != src_row[i]) {
+            return false;
+          }
+        } else if ((src_row[width - 1] >> i & 1) == 0 &&
+                   GetString(dst.heap_, dst_row[i]) != GetString(src.heap_, src_row[i])) {
+          return false;
+        }
+      }
+      return true;
+    };
+    auto insert = [&] {
+      auto offset = dst.rows_.size();
+      dst.rows_.insert(dst.rows_.end(), src_row, src_row + width);
+      for (uint32_t i = 0; i < NumKeys(); i++) {
+        if (group_by_types_[i] == TypeId::VARCHAR && (src_row[width - 1] >> i & 1) == 0) {
+          auto value = GetString(src.heap_, src_row[i]);
+          auto length = static_cast<uint32_t>(value.size());
+          dst.rows_[offset + i] = dst.heap_.size();
+          dst.heap_.insert(dst.heap_.end(), reinterpret_cast<const char *>(&length),
+                           reinterpret_cast<const char *>(&length) + sizeof(length));
+          dst.heap_.insert(dst.heap_.end(), value.begin(), value.end());
+        }
+      }
+      // The new group gets the aggregates of `group` as they are, as if merged into initial ones.
+      dst.boxed_.insert(dst.boxed_.end(), src.boxed_.begin() + group * NumBoxed(),
+                        src.boxed_.begin() + (group + 1) * NumBoxed());
+    };
+    auto groups_before = dst.hashes_.size();
+    auto dst_group = FindOrInsert(&dst, src.hashes_[group], equals, insert);
+    if (dst.hashes_.size() == groups_before) {
+      for (uint32_t i = 0; i < kinds_.size(); i++) {
+        MergeState(i, &dst.rows_[dst_group * width], dst.boxed_.data() + dst_group * NumBoxed(), src_row,
+                   src.boxed_.data() + group * NumBoxed());
+      }
+    }
+  }
+  other->ClearPartition(partition);
+}
+
+void AggregationHashTable::Unspill(uint32_t partition) {
+  auto files = std::move(partitions_[partition].spilled_);
+  partitions_[partition].spilled_.clear();
+  TupleBatch batch;
+  std::vector<const ColumnVector *> keys;
+  for (uint32_t i = 0; i < NumKeys(); i++) {
+    keys.push_back(&batch.GetColumn(i));
+  }
+  Tuple tuple;
+  for (auto &file : files) {
+    TmpTupleFile::Reader reader(file.get());
+    bool more = true;
+    while (more) {
+      batch.Reset(spill_schema_);
+      while (!batch.IsFull() && (more = reader.Next(&tuple))) {
+        batch.AppendTuple(TupleRef(tuple), spill_schema_);
+      }
+      auto num_rows = batch.NumRows();
+      if (num_rows == 0) {
+        break;
+      }
+      for (uint32_t i = 0; i < NumKeys(); i++) {
+        keys[i] = &batch.GetColumn(i);
+      }
+      EncodeKeys(keys, num_rows);
+      FindGroups(num_rows);
+      for (uint32_t i = 0; i < kinds_.size(); i++) {
+        UpdateStates(i, batch.GetColumn(NumKeys() + i), num_rows, true);
+      }
+    }
+    file.reset();
+  }
+}
+
+void AggregationHashTable::Spill() {
+  has_spilled_ = true;
+  for (auto &partition : partitions_) {
+    if (partition.hashes_.empty()) {
+      continue;
+    }
+    auto file = std::make_unique<TmpTupleFile>(bpm_);
+    for (size_t group = 0; group < partition.hashes_.size(); group++) {
+      file->Append(Tuple(GetPartialGroup(partition, group), &spill_schema_));
+    }
+    auto spilled = std::move(partition.spilled_);
+    spilled.push_back(std::move(file));
+    partition = Partition{};
+    partition.spilled_ = std::move(spilled);
+  }
+}
+
+auto AggregationHashTable::MemoryUsage() const -> size_t {
+  size_t size = 0;
+  for (const auto &partition : partitions_) {
+    size += (partition.rows_.capacity() + partition.hashes_.capacity()) * sizeof(uint64_t) +
+            partition.slots_.capacity() * sizeof(Slot) + partition.heap_.capacity() +
+            partition.boxed_.capacity() * sizeof(Value);
+  }
+  return size;
+}
+
+void AggregationHashTable::ClearPartition(uint32_t partition) { partitions_[partition] = Partition{}; }
+
+auto AggregationHashTable::GetString(const std::vector<char> &heap, uint64_t offset) -> std::string_view {
+  uint32_t length;
+  memcpy(&length, &heap[offset], sizeof(length));
+  return {&heap[offset + sizeof(length)], length};
+}
+
+auto AggregationHashTable::GetKey(const Partition &partition, const uint64_t *row, size_t key_idx) const -> Value {
+  auto type = group_by_types_[key_idx];
+  if ((row[RowWidth() - 1] >> key_idx & 1) != 0) {
+    return ValueFactory::GetNullValueByType(type);
+  }
+  auto word = row[key_idx];
+  switch (type) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      return {type, Load<int8_t>(word)};
+    case TypeId::SMALLINT:
+      return {type, Load<int16_t>(word)};
+    case TypeId::INTEGER:
+      return {type, Load<int32_t>(word)};
+    case TypeId::BIGINT:
+      return {type, Load<int64_t>(word)};
+    case TypeId::DECIMAL:
+      return {type, Load<double>(word)};
+    case TypeId::TIMESTAMP:
+      return {type, Load<uint64_t>(word)};
+    case TypeId::VARCHAR: {
+      auto value = GetString(partition.heap_, word);
+      return ValueFactory::GetVarcharValue(value.data(), value.size(), true);
+    }
+    default:
+      UNREACHABLE("unknown group-by type");
+  }
+}
+
+auto AggregationHashTable::GetGroup(uint32_t partition, size_t group) const -> std::vector<Value> {
+  const auto &part = partitions_[partition];
+  const auto *row = &part.rows_[group * RowWidth()];
+  const auto *boxed = part.boxed_.data() + group * NumBoxed();
+  std::vector<Value> values;
+  values.reserve(NumKeys() + kinds_.size());
+  for (uint32_t i = 0; i < NumKeys(); i++) {
+    values.push_back(GetKey(part, row, i));
+  }
+  size_t boxed_idx = 0;
+  for (uint32_t i = 0; i < kinds_.size(); i++) {
+    auto word = row[NumKeys() + i];
+    auto is_null = (row[RowWidth() - 1] >> (NumKeys() + i) & 1) != 0;
+    switch (kinds_[i]) {
+      case StateKind::COUNT_STAR:
+        values.push_back(MakeInteger(TypeId::INTEGER, Load<int64_t>(word)));
+        break;
+      case StateKind::COUNT:
+        // A count is NULL until it sees a value, like the other aggregates.
+        values.push_back(word == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                                   : MakeInteger(TypeId::INTEGER, Load<int64_t>(word)));
+        break;
+      case StateKind::SUM_INTEGER:
+      case StateKind::MIN_INTEGER:
+      case StateKind::MAX_INTEGER:
+        values.push_back(is_null ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                                 : MakeInteger(input_types_[i], Load<int64_t>(word)));
+        break;
+      case StateKind::SUM_DECIMAL:
+      case StateKind::MIN_DECIMAL:
+      case StateKind::MAX_DECIMAL:
+        values.push_back(is_null ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                                 : ValueFactory::GetDecimalValue(Load<double>(word)));
+        break;
+      case StateKind::BOXED:
+        values.push_back(boxed[boxed_idx++]);
+        break;
+    }
+  }
+  return values;
+}
+
+auto AggregationHashTable::GetPartialGroup(const Partition &partition, size_t group) const -> std::vector<Value> {
+  const auto *row = &partition.rows_[group * RowWidth()];
+  const auto *boxed = partition.boxed_.data() + group * NumBoxed();
+  std::vector<Value> values;
+  values.reserve(NumKeys() + kinds_.size());
+  for (uint32_t i = 0; i < NumKeys(); i++) {
+    values.push_back(GetKey(partition, row, i));
+  }
+  size_t boxed_idx = 0;
+  for (uint32_t i = 0; i < kinds_.size(); i++) {
+    auto word = row[NumKeys() + i];
+    auto is_null = (row[RowWidth() - 1] >> (NumKeys() + i) & 1) != 0;
+    auto type = spill_schema_.GetColumn(NumKeys() + i).GetType();
+    if (kinds_[i] == StateKind::BOXED) {
+      const auto &value = boxed[boxed_idx++];
+      values.push_back(value.IsNull()                 ? ValueFactory::GetNullValueByType(type)
+                       : value.GetTypeId() == type ? value
+                                                      : value.CastAs(type));
+    } else if (is_null) {
+      values.push_back(ValueFactory::GetNullValueByType(type));
+    } else if (type == TypeId::DECIMAL) {
+      values.push_back(ValueFactory::GetDecimalValue(Load<double>(word)));
+    } else {
+      values.push_back(ValueFactory::GetBigIntValue(Load<int64_t>(word)));
+    }
+  }
+  return values;
+}
+
+auto AggregationHashTable::InitialAggregates() const -> std::vector<Value> {
+  std::vector<Value> values;
+  for (uint32_t i = 0; i < kinds_.size(); i++) {
+    if (kinds_[i] == StateKind::COUNT_STAR) {
+      values.push_back(ValueFactory::GetIntegerValue(0));
+    } else {
+      auto type = kinds_[i] == StateKind::BOXED ? input_types_[i] : TypeId::INTEGER;
+      values.push_back(ValueFactory::GetNullValueByType(type));
+    }
+  }
+  return values;
+}
+
+}  // namespace bustub
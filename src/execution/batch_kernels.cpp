@@ -0,0 +1,212 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// batch_kernels.cpp
+//
+// Identification: src/execution/batch_kernels.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/batch_kernels.h"
+
+#include <functional>
+#include <type_traits>
+
+#include "common/macros.h"
+#include "execution/expressions/arithmetic_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "type/limits.h"
+
+namespace bustub {
+
+namespace {
+
+/** Call `func` with a value of the C++ type of numeric `type`. @return false if `type` has no kernels */
+template <typename Func>
+auto DispatchNumeric(TypeId type, Func &&func) -> bool {
+  switch (type) {
+    case TypeId::INTEGER:
+      func(int32_t{});
+      return true;
+    case TypeId::BIGINT:
+      func(int64_t{});
+      return true;
+    case TypeId::DECIMAL:
+      func(double{});
+      return true;
+    default:
+      return false;
+  }
+}
+
+template <typename L, typename R, typename Op>
+void CompareLoop(const L *lhs, const R *rhs, int8_t *out, size_t size, Op op) {
+  for (size_t i = 0; i < size; i++) {
+    out[i] = static_cast<int8_t>(op(lhs[i], rhs[i]));
+  }
+}
+
+template <typename L, typename R>
+void CompareTyped(ComparisonType comp_type, const L *lhs, const R *rhs, int8_t *out, size_t size) {
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      CompareLoop(lhs, rhs, out, size, std::equal_to<>());
+      break;
+    case ComparisonType::NotEqual:
+      CompareLoop(lhs, rhs, out, size, std::not_equal_to<>());
+      break;
+    case ComparisonType::LessThan:
+      CompareLoop(lhs, rhs, out, size, std::less<>());
+      break;
+    case ComparisonType::LessThanOrEqual:
+      CompareLoop(lhs, rhs, out, size, std::less_equal<>());
+      break;
+    case ComparisonType::GreaterThan:
+      CompareLoop(lhs, rhs, out, size, std::greater<>());
+      break;
+    case ComparisonType::GreaterThanOrEqual:
+      CompareLoop(lhs, rhs, out, size, std::greater_equal<>());
+      break;
+    default:
+      UNREACHABLE("Unsupported comparison type.");
+  }
+}
+
+/** The type to compute T in: integers wrap around on overflow, as unsigned arithmetic does, instead of being UB. */
+template <typename T, typename = void>
+struct WrappingType {
+  using type = T;
+};
+
+template <typename T>
+struct WrappingType<T, std::enable_if_t<std::is_integral_v<T>>> {
+  using type = std::make_unsigned_t<T>;
+};
+
+/** @return the value that stands for NULL in a column of C++ type T */
+template <typename T>
+constexpr auto NullSentinel() -> T {
+  if constexpr (std::is_same_v<T, int32_t>) {
+    return BUSTUB_INT32_NULL;
+  } else if constexpr (std::is_same_v<T, int64_t>) {
+    return BUSTUB_INT64_NULL;
+  } else {
+    return BUSTUB_DECIMAL_NULL;
+  }
+}
+
+template <typename T>
+void ComputeTyped(ArithmeticType compute_type, const T *lhs, const T *rhs, T *out, size_t size) {
+  using U = typename WrappingType<T>::type;
+  switch (compute_type) {
+    case ArithmeticType::Plus:
+      for (size_t i = 0; i < size; i++) {
+        out[i] = static_cast<T>(static_cast<U>(lhs[i]) + static_cast<U>(rhs[i]));
+      }
+      break;
+    case ArithmeticType::Minus:
+      for (size_t i = 0; i < size; i++) {
+        out[i] = static_cast<T>(static_cast<U>(lhs[i]) - static_cast<U>(rhs[i]));
+      }
+      break;
+    default:
+      UNREACHABLE("Unsupported arithmetic type.");
+  }
+}
+
+}  // namespace
+
+auto BatchKernels::Compare(ComparisonType comp_type, const ColumnVector &lhs, const ColumnVector &rhs,
+                           ColumnVector *result) -> bool {
+  if (!lhs.IsFixedSize() || !rhs.IsFixedSize()) {
+    return false;
+  }
+  auto size = lhs.Size();
+  bool supported = false;
+  DispatchNumeric(lhs.GetType(), [&](auto l) {
+    DispatchNumeric(rhs.GetType(), [&](auto r) {
+      using L = decltype(l);
+      using R = decltype(r);
+      result->Reset(TypeId::BOOLEAN);
+      result->Resize(size);
+      CompareTyped(comp_type, lhs.GetData<L>(), rhs.GetData<R>(), result->GetMutableData<int8_t>(), size);
+      result->SetNullsFrom(lhs, rhs);
+      supported = true;
+    });
+  });
+  return supported;
+}
+
+auto BatchKernels::Compute(ArithmeticType compute_type, const ColumnVector &lhs, const ColumnVector &rhs,
+                           ColumnVector *result) -> bool {
+  if (!lhs.IsFixedSize() || lhs.GetType() != rhs.GetType()) {
+    return false;
+  }
+  auto size = lhs.Size();
+  return DispatchNumeric(lhs.GetType(), [&](auto t) {
+    using T = decltype(t);
+    result->Reset(lhs.GetType());
+    result->Resize(size);
+    ComputeTyped(compute_type, lhs.GetData<T>(), rhs.GetData<T>(), result->GetMutableData<T>(), size);
+    result->SetNullsFrom(lhs, rhs);
+    // A result that lands on the NULL sentinel of its type, after an overflow, is NULL, as it is for a Value.
+    const auto *out = result->GetData<T>();
+    for (size_t i = 0; i < size; i++) {
+      if (out[i] == NullSentinel<T>()) {
+        result->SetNull(i);
+      }
+    }
+  });
+}
+
+auto BatchKernels::Combine(LogicType logic_type, const ColumnVector &lhs, const ColumnVector &rhs,
+                           ColumnVector *result) -> bool {
+  if (lhs.GetType() != TypeId::BOOLEAN || rhs.GetType() != TypeId::BOOLEAN || !lhs.IsFixedSize() ||
+      !rhs.IsFixedSize()) {
+    return false;
+  }
+  auto size = lhs.Size();
+  const auto *l = lhs.GetData<int8_t>();
+  const auto *r = rhs.GetData<int8_t>();
+  result->Reset(TypeId::BOOLEAN);
+  result->Resize(size);
+  auto *out = result->GetMutableData<int8_t>();
+  bool is_and = logic_type == LogicType::And;
+  BUSTUB_ASSERT(is_and || logic_type == LogicType::Or, "Unsupported logic type.");
+  if (!lhs.HasNulls() && !rhs.HasNulls()) {
+    if (is_and) {
+      for (size_t i = 0; i < size; i++) {
+        out[i] = static_cast<int8_t>((l[i] != 0) & (r[i] != 0));
+      }
+    } else {
+      for (size_t i = 0; i < size; i++) {
+        out[i] = static_cast<int8_t>((l[i] != 0) | (r[i] != 0));
+      }
+    }
+    return true;
+  }
+  // A NULL side makes the result NULL, unless the other side alone decides it: FALSE for AND, TRUE for OR.
+  for (size_t i = 0; i < size; i++) {
+    bool l_null = lhs.IsNull(i);
+    bool r_null = rhs.IsNull(i);
+    bool l_value = !l_null && l[i] != 0;
+    bool r_value = !r_null && r[i] != 0;
+    if (is_and) {
+      bool is_false = (!l_null && !l_value) || (!r_null && !r_value);
+      out[i] = static_cast<int8_t>(l_value && r_value);
+      if (!is_false && (l_null || r_null)) {
+        result->SetNull(i);
+      }
+    } else {
+      out[i] = static_cast<int8_t>(l_value || r_value);
+      if (!out[i] && (l_null || r_null)) {
+        result->SetNull(i);
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace bustub
@@ -31,4 +31,25 @@ auto FilterExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   }
 }
 
+auto FilterExecutor::NextRef(TupleRef *tuple, RID *rid) -> bool {
+  const auto &filter_expr = plan_->GetPredicate();
+  while (child_executor_->NextRef(tuple, rid)) {
+    auto value = filter_expr->Evaluate(*tuple, child_executor_->GetOutputSchema());
+    if (!value.IsNull() && value.GetAs<bool>()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+auto FilterExecutor::NextBatch(TupleBatch *batch) -> bool {
+  while (child_executor_->NextBatch(batch)) {
+    batch->Select(*plan_->GetPredicate());
+    if (batch->NumSelected() > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace bustub
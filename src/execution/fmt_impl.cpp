@@ -9,6 +9,7 @@
 #include "execution/plans/aggregation_plan.h"
 #include "execution/plans/hash_join_plan.h"
 #include "execution/plans/limit_plan.h"
+#include "execution/plans/merge_join_plan.h"
 #include "execution/plans/projection_plan.h"
 #include "execution/plans/sort_plan.h"
 #include "execution/plans/topn_plan.h"
@@ -37,10 +38,19 @@ auto AggregationPlanNode::PlanNodeToString() const -> std::string {
 }
 
 auto HashJoinPlanNode::PlanNodeToString() const -> std::string {
+  if (runtime_filter_id_.has_value()) {
+    return fmt::format("HashJoin {{ type={}, left_key={}, right_key={}, runtime_filter=#{} }}", join_type_,
+                       left_key_expressions_, right_key_expressions_, *runtime_filter_id_);
+  }
   return fmt::format("HashJoin {{ type={}, left_key={}, right_key={} }}", join_type_, left_key_expressions_,
                      right_key_expressions_);
 }
 
+auto MergeJoinPlanNode::PlanNodeToString() const -> std::string {
+  return fmt::format("MergeJoin {{ type={}, left_key={}, right_key={} }}", join_type_, left_key_expressions_,
+                     right_key_expressions_);
+}
+
 auto ProjectionPlanNode::PlanNodeToString() const -> std::string {
   return fmt::format("Projection {{ exprs={} }}", expressions_);
 }
@@ -56,6 +66,9 @@ auto SortPlanNode::PlanNodeToString() const -> std::string {
 auto LimitPlanNode::PlanNodeToString() const -> std::string { return fmt::format("Limit {{ limit={} }}", limit_); }
 
 auto TopNPlanNode::PlanNodeToString() const -> std::string {
+  if (topn_filter_id_.has_value()) {
+    return fmt::format("TopN {{ n={}, order_bys={}, topn_filter=#{} }}", n_, order_bys_, *topn_filter_id_);
+  }
   return fmt::format("TopN {{ n={}, order_bys={}}}", n_, order_bys_);
 }
 
@@ -12,20 +12,280 @@
 
 #include "execution/executors/hash_join_executor.h"
 
+#include <algorithm>
+
+#include "execution/parallel_pipeline.h"
+#include "type/value_factory.h"
+
 namespace bustub {
 
 HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
                                    std::unique_ptr<AbstractExecutor> &&left_child,
                                    std::unique_ptr<AbstractExecutor> &&right_child)
-    : AbstractExecutor(exec_ctx) {
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_executor_(std::move(left_child)),
+      right_executor_(std::move(right_child)),
+      build_schema_(
+          JoinHashTable::MakeBuildSchema(plan->RightJoinKeyExpressions(), right_executor_->GetOutputSchema())) {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2023 Spring: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
 }
 
-void HashJoinExecutor::Init() { throw NotImplementedException("HashJoinExecutor is not implemented"); }
+void HashJoinExecutor::Init() {
+  left_batch_.Reset(left_executor_->GetOutputSchema());
+  probe_pos_ = 0;
+  match_ = nullptr;
+  output_.Reset(GetOutputSchema());
+  output_pos_ = 0;
+  spilled_left_.clear();
+  spilled_left_.resize(JoinHashTable::NUM_PARTITIONS);
+  spilled_joins_.clear();
+  left_reader_.reset();
+  left_file_.reset();
+
+  // In a parallel pipeline, the first copy of the join builds the table and the others use it.
+  shared_ = dynamic_cast<SharedJoinTable *>(exec_ctx_->GetSharedState(plan_));
+  if (shared_ != nullptr && shared_->table_ != nullptr) {
+    ht_ = shared_->table_;
+  } else {
+    ht_ = BuildTable();
+    if (shared_ != nullptr) {
+      shared_->table_ = ht_;
+    }
+    // The scans of the left side pick up the filter when they are initialized, so the table is built first.
+    if (plan_->runtime_filter_id_.has_value()) {
+      exec_ctx_->SetRuntimeFilter(*plan_->runtime_filter_id_, ht_->MakeBloomFilter());
+    }
+  }
+  left_executor_->Init();
+}
+
+auto HashJoinExecutor::BuildTable() -> std::shared_ptr<const JoinHashTable> {
+  auto *bpm = exec_ctx_->GetBufferPoolManager();
+  auto num_keys = plan_->RightJoinKeyExpressions().size();
+  auto table = std::make_shared<JoinHashTable>(build_schema_, num_keys, bpm, exec_ctx_->GetWorkMem());
+  if (auto pipeline = ParallelPipeline::Make(exec_ctx_, plan_->GetRightPlan()); pipeline != nullptr) {
+    // Each worker gets a share of the memory budget, and the tables of the workers are merged at the end.
+    std::vector<std::unique_ptr<JoinHashTable>> tables;
+    for (size_t i = 0; i < pipeline->NumWorkers(); i++) {
+      tables.push_back(std::make_unique<JoinHashTable>(build_schema_, num_keys, bpm,
+                                                       exec_ctx_->GetWorkMem() / pipeline->NumWorkers()));
+    }
+    pipeline->Run([&](size_t worker, const TupleBatch &batch) { BuildBatch(batch, tables[worker].get()); });
+    for (auto &worker_table : tables) {
+      table->Merge(worker_table.get());
+    }
+    table->Finalize();
+    return table;
+  }
+
+  right_executor_->Init();
+  if (right_executor_->SupportsBatch()) {
+    TupleBatch batch;
+    while (right_executor_->NextBatch(&batch)) {
+      BuildBatch(batch, table.get());
+    }
+    table->Finalize();
+    return table;
+  }
+  const auto &right_schema = right_executor_->GetOutputSchema();
+  Tuple tuple;
+  RID rid;
+  std::vector<Value> keys;
+  std::vector<Value> values;
+  while (right_executor_->Next(&tuple, &rid)) {
+    keys.clear();
+    for (const auto &expr : plan_->RightJoinKeyExpressions()) {
+      keys.push_back(expr->Evaluate(tuple, right_schema));
+    }
+    values.clear();
+    for (uint32_t i = 0; i < right_schema.GetColumnCount(); i++) {
+      values.push_back(tuple.GetValue(&right_schema, i));
+    }
+    Build(keys, values, table.get());
+  }
+  table->Finalize();
+  return table;
+}
+
+void HashJoinExecutor::BuildBatch(const TupleBatch &batch, JoinHashTable *table) const {
+  const auto &key_exprs = plan_->RightJoinKeyExpressions();
+  std::vector<ColumnVector> key_columns(key_exprs.size());
+  for (uint32_t i = 0; i < key_exprs.size(); i++) {
+    key_exprs[i]->EvaluateBatch(batch, &key_columns[i]);
+  }
+  std::vector<Value> keys;
+  for (size_t i = 0; i < batch.NumSelected(); i++) {
+    keys.clear();
+    for (const auto &column : key_columns) {
+      keys.push_back(column.GetValue(i));
+    }
+    Build(keys, batch.GetRowValues(batch.GetSelection()[i]), table);
+  }
+}
+
+void HashJoinExecutor::Build(const std::vector<Value> &keys, const std::vector<Value> &values, JoinHashTable *table) {
+  for (const auto &value : keys) {
+    if (value.IsNull()) {
+      return;
+    }
+  }
+  table->Insert(table->MakeRow(JoinHashTable::HashKeys(keys), keys, values));
+}
+
+auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (output_pos_ == output_.NumSelected()) {
+    output_pos_ = 0;
+    if (!NextBatch(&output_)) {
+      return false;
+    }
+  }
+  *tuple = output_.GetTuple(output_.GetSelection()[output_pos_++], GetOutputSchema());
+  return true;
+}
+
+auto HashJoinExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset(GetOutputSchema());
+  while (!batch->IsFull()) {
+    if (match_ != nullptr) {
+      AppendJoinedRow(left_row_, match_, batch);
+      match_ = ht_->FindNext(probe_hash_, probe_keys_, match_);
+      continue;
+    }
+    if (probe_pos_ == left_batch_.NumSelected()) {
+      if (!NextLeftBatch()) {
+        break;
+      }
+      continue;
+    }
+    Probe(batch);
+  }
+  return batch->NumSelected() > 0;
+}
 
-auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto HashJoinExecutor::NextLeftBatch() -> bool {
+  probe_pos_ = 0;
+  while (!ReadLeftBatch()) {
+    // In a parallel pipeline, the left child ends with each morsel, and the spilled partitions wait for the last.
+    if (left_reader_ == nullptr && shared_ != nullptr && !shared_->probe_done_) {
+      return false;
+    }
+    if (!StartSpilledJoin()) {
+      return false;
+    }
+  }
+  const auto &key_exprs = plan_->LeftJoinKeyExpressions();
+  left_key_columns_.resize(key_exprs.size());
+  for (uint32_t i = 0; i < key_exprs.size(); i++) {
+    key_exprs[i]->EvaluateBatch(left_batch_, &left_key_columns_[i]);
+  }
+  return true;
+}
+
+auto HashJoinExecutor::ReadLeftBatch() -> bool {
+  const auto &left_schema = left_executor_->GetOutputSchema();
+  if (left_reader_ == nullptr && left_executor_->SupportsBatch()) {
+    return left_executor_->NextBatch(&left_batch_);
+  }
+  left_batch_.Reset(left_schema);
+  Tuple tuple;
+  RID rid;
+  while (!left_batch_.IsFull() &&
+         (left_reader_ != nullptr ? left_reader_->Next(&tuple) : left_executor_->Next(&tuple, &rid))) {
+    left_batch_.AppendTuple(tuple, left_schema);
+  }
+  return left_batch_.NumRows() > 0;
+}
+
+auto HashJoinExecutor::StartSpilledJoin() -> bool {
+  // Queue the partitions the current table spilled, which the left side probed, the first one to be joined next.
+  for (auto partition = JoinHashTable::NUM_PARTITIONS; partition-- > 0;) {
+    if (spilled_left_[partition] != nullptr) {
+      spilled_joins_.push_back({ht_, partition, std::move(spilled_left_[partition])});
+    }
+  }
+  left_reader_.reset();
+  left_file_.reset();
+  if (spilled_joins_.empty()) {
+    return false;
+  }
+  auto join = std::move(spilled_joins_.back());
+  spilled_joins_.pop_back();
+
+  // The copies of the executor in a parallel pipeline each load their own table, so they split the budget.
+  auto memory_limit = exec_ctx_->GetWorkMem();
+  if (shared_ != nullptr) {
+    memory_limit = std::max<size_t>(memory_limit / exec_ctx_->GetTaskScheduler()->NumWorkers(), 1);
+  }
+  auto table = std::make_shared<JoinHashTable>(build_schema_, plan_->RightJoinKeyExpressions().size(),
+                                               exec_ctx_->GetBufferPoolManager(), memory_limit,
+                                               join.table_->Level() + 1);
+  Tuple tuple;
+  for (const auto &file : join.table_->GetSpilledRows(join.partition_)) {
+    TmpTupleFile::Reader reader(file.get());
+    while (reader.Next(&tuple)) {
+      table->Insert(tuple);
+    }
+  }
+  table->Finalize();
+  ht_ = std::move(table);
+  left_file_ = std::move(join.left_);
+  left_reader_ = std::make_unique<TmpTupleFile::Reader>(left_file_.get());
+  return true;
+}
+
+void HashJoinExecutor::Probe(TupleBatch *batch) {
+  left_row_ = left_batch_.GetSelection()[probe_pos_];
+  probe_keys_.clear();
+  bool has_null = false;
+  for (const auto &column : left_key_columns_) {
+    probe_keys_.push_back(column.GetValue(probe_pos_));
+    has_null = has_null || probe_keys_.back().IsNull();
+  }
+  probe_pos_++;
+  if (!has_null) {
+    probe_hash_ = JoinHashTable::HashKeys(probe_keys_);
+    auto partition = ht_->PartitionOf(probe_hash_);
+    if (ht_->IsSpilled(partition)) {
+      auto &file = spilled_left_[partition];
+      if (file == nullptr) {
+        file = std::make_unique<TmpTupleFile>(exec_ctx_->GetBufferPoolManager());
+      }
+      file->Append(left_batch_.GetTuple(left_row_, left_executor_->GetOutputSchema()));
+      return;
+    }
+    match_ = ht_->FindNext(probe_hash_, probe_keys_, nullptr);
+  }
+  if (match_ == nullptr && plan_->GetJoinType() == JoinType::LEFT) {
+    AppendJoinedRow(left_row_, nullptr, batch);
+  }
+}
+
+void HashJoinExecutor::AppendJoinedRow(uint32_t left_row, const JoinHashTable::Row *row, TupleBatch *batch) const {
+  auto num_left_columns = left_batch_.NumColumns();
+  for (uint32_t i = 0; i < num_left_columns; i++) {
+    batch->GetColumn(i).Append(left_batch_.GetColumn(i).GetValue(left_row));
+  }
+  // The right values follow the hash and the join keys in the rows of the table.
+  auto first = 1 + plan_->RightJoinKeyExpressions().size();
+  for (uint32_t i = 0; num_left_columns + i < batch->NumColumns(); i++) {
+    auto &column = batch->GetColumn(num_left_columns + i);
+    if (row == nullptr) {
+      column.Append(ValueFactory::GetNullValueByType(column.GetType()));
+      continue;
+    }
+    auto tuple = JoinHashTable::GetTuple(row);
+    const auto &build_column = build_schema_.GetColumn(first + i);
+    if (column.IsFixedSize() && build_column.GetType() == column.GetType()) {
+      column.AppendRaw(tuple.GetData() + build_column.GetOffset());
+    } else {
+      column.Append(tuple.GetValue(&build_schema_, first + i));
+    }
+  }
+  batch->FinishRows();
+}
 
 }  // namespace bustub
@@ -1,27 +1,78 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// insert_executor.cpp
-//
-// Identification: src/execution/insert_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-
-#include <memory>
-
-#include "execution/executors/insert_executor.h"
-
-namespace bustub {
-
-InsertExecutor::InsertExecutor(ExecutorContext *exec_ctx, const InsertPlanNode *plan,
-                               std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
-
-void InsertExecutor::Init() { throw NotImplementedException("InsertExecutor is not implemented"); }
-
-auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool { return false; }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// insert_executor.cpp
+//
+// Identification: src/execution/insert_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executors/insert_executor.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+InsertExecutor::InsertExecutor(ExecutorContext *exec_ctx, const InsertPlanNode *plan,
+                               std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+
+void InsertExecutor::Init() {
+  child_executor_->Init();
+  done_ = false;
+}
+
+auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
+  if (done_) {
+    return false;
+  }
+  done_ = true;
+
+  auto catalog = exec_ctx_->GetCatalog();
+  auto table_info = catalog->GetTable(plan_->GetTableOid());
+  auto indexes = catalog->GetTableIndexes(table_info->name_);
+
+  int32_t num_inserted = 0;
+  std::vector<Tuple> batch;
+  bool child_done = false;
+  while (!child_done) {
+    batch.clear();
+    Tuple child_tuple;
+    RID child_rid;
+    while (batch.size() < BULK_INSERT_BATCH_SIZE) {
+      if (!child_executor_->Next(&child_tuple, &child_rid)) {
+        child_done = true;
+        break;
+      }
+      batch.push_back(std::move(child_tuple));
+    }
+    if (batch.empty()) {
+      break;
+    }
+
+    auto rids = table_info->table_->BulkInsert(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, batch);
+    for (auto index_info : indexes) {
+      std::vector<std::pair<Tuple, RID>> entries;
+      entries.reserve(batch.size());
+      for (size_t i = 0; i < batch.size(); i++) {
+        entries.emplace_back(
+            batch[i].KeyFromTuple(table_info->schema_, index_info->key_schema_, index_info->index_->GetKeyAttrs()),
+            rids[i]);
+      }
+      index_info->index_->InsertEntries(&entries, exec_ctx_->GetTransaction());
+    }
+    num_inserted += batch.size();
+  }
+
+  std::vector<Value> values{ValueFactory::GetIntegerValue(num_inserted)};
+  *tuple = Tuple(values, &GetOutputSchema());
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,250 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_hash_table.cpp
+//
+// Identification: src/execution/join_hash_table.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/join_hash_table.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/util/hash_util.h"
+#include "fmt/format.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+JoinHashTable::JoinHashTable(const Schema &build_schema, size_t num_keys, BufferPoolManager *bpm,
+                             size_t memory_limit, uint32_t level)
+    : build_schema_(build_schema), num_keys_(num_keys), bpm_(bpm), memory_limit_(memory_limit), level_(level) {
+  BUSTUB_ASSERT(level <= MAX_LEVEL, "the hash has no bits left to partition by");
+}
+
+auto JoinHashTable::MakeBuildSchema(const std::vector<AbstractExpressionRef> &key_exprs, const Schema &schema)
+    -> Schema {
+  std::vector<Column> columns;
+  columns.emplace_back("#hash", TypeId::BIGINT);
+  for (const auto &expr : key_exprs) {
+    auto name = fmt::format("#key{}", columns.size() - 1);
+    if (expr->GetReturnType() == TypeId::VARCHAR) {
+      columns.emplace_back(name, TypeId::VARCHAR, BUSTUB_PAGE_SIZE);
+    } else {
+      columns.emplace_back(name, expr->GetReturnType());
+    }
+  }
+  for (const auto &column : schema.GetColumns()) {
+    columns.push_back(column);
+  }
+  return Schema(columns);
+}
+
+auto JoinHashTable::HashKeys(const std::vector<Value> &keys) -> uint64_t {
+  uint64_t hash = 0;
+  for (const auto &key : keys) {
+    hash = HashUtil::MixHash(hash ^ HashUtil::HashValue(&key));
+  }
+  return hash;
+}
+
+auto JoinHashTable::MakeRow(uint64_t hash, const std::vector<Value> &keys, const std::vector<Value> &values) const
+    -> Tuple {
+  std::vector<Value> row;
+  row.reserve(1 + keys.size() + values.size());
+  row.push_back(ValueFactory::GetBigIntValue(static_cast<int64_t>(hash)));
+  row.insert(row.end(), keys.begin(), keys.end());
+  row.insert(row.end(), values.begin(), values.end());
+  return {std::move(row), &build_schema_};
+}
+
+void JoinHashTable::Insert(const TupleRef &row) {
+  auto &partition = partitions_[PartitionOf(GetHash(row))];
+  if (partition.spilled_) {
+    partition.files_.back()->Append(row);
+    return;
+  }
+  Append(&partition, row);
+  SpillIfNeeded();
+}
+
+void JoinHashTable::Append(Partition *partition, const TupleRef &row) {
+  auto size = RowSize(row.GetLength());
+  auto &chunks = partition->chunks_;
+  if (chunks.empty() || chunks.back().capacity() - chunks.back().size() < size) {
+    // Chunks double up to MAX_CHUNK_SIZE, so small tables stay small.
+    auto capacity = chunks.empty() ? MIN_CHUNK_SIZE : std::min(MAX_CHUNK_SIZE, chunks.back().capacity() * 2);
+    std::vector<char> chunk;
+    chunk.reserve(std::max(capacity, size));
+    memory_usage_ += chunk.capacity();
+    chunks.push_back(std::move(chunk));
+  }
+  auto &chunk = chunks.back();
+  auto offset = chunk.size();
+  chunk.resize(offset + size);
+  auto *header = reinterpret_cast<Row *>(chunk.data() + offset);
+  header->next_ = nullptr;
+  header->size_ = row.GetLength();
+  header->padding_ = 0;
+  memcpy(header + 1, row.GetData(), row.GetLength());
+  partition->num_rows_++;
+}
+
+template <class F>
+void JoinHashTable::ForEachRow(Partition *partition, F f) {
+  for (auto &chunk : partition->chunks_) {
+    for (size_t offset = 0; offset < chunk.size();) {
+      auto *row = reinterpret_cast<Row *>(chunk.data() + offset);
+      offset += RowSize(row->size_);
+      f(row);
+    }
+  }
+}
+
+auto JoinHashTable::ChunkBytes(const Partition &partition) -> size_t {
+  size_t bytes = 0;
+  for (const auto &chunk : partition.chunks_) {
+    bytes += chunk.capacity();
+  }
+  return bytes;
+}
+
+void JoinHashTable::SpillIfNeeded() {
+  while (CanSpill() && memory_usage_ > memory_limit_) {
+    Partition *largest = nullptr;
+    size_t largest_bytes = 0;
+    for (auto &partition : partitions_) {
+      auto bytes = ChunkBytes(partition);
+      if (!partition.spilled_ && bytes > largest_bytes) {
+        largest = &partition;
+        largest_bytes = bytes;
+      }
+    }
+    if (largest == nullptr) {
+      return;
+    }
+    Spill(largest);
+  }
+}
+
+void JoinHashTable::Spill(Partition *partition) {
+  BUSTUB_ASSERT(CanSpill(), "the table must not spill");
+  if (partition->files_.empty()) {
+    partition->files_.push_back(std::make_unique<TmpTupleFile>(bpm_));
+  }
+  auto *file = partition->files_.back().get();
+  ForEachRow(partition, [&](const Row *row) { file->Append(GetTuple(row)); });
+  memory_usage_ -= ChunkBytes(*partition);
+  partition->chunks_ = {};
+  partition->num_rows_ = 0;
+  partition->spilled_ = true;
+}
+
+void JoinHashTable::Merge(JoinHashTable *other) {
+  BUSTUB_ASSERT(other->level_ == level_ && other->num_keys_ == num_keys_, "the tables must be alike");
+  for (uint32_t i = 0; i < NUM_PARTITIONS; i++) {
+    auto &dst = partitions_[i];
+    auto &src = other->partitions_[i];
+    auto src_bytes = ChunkBytes(src);
+    if (src.spilled_ && !dst.spilled_) {
+      Spill(&dst);
+    }
+    if (dst.spilled_) {
+      auto *file = dst.files_.back().get();
+      ForEachRow(&src, [&](const Row *row) { file->Append(GetTuple(row)); });
+      for (auto &src_file : src.files_) {
+        dst.files_.push_back(std::move(src_file));
+      }
+    } else {
+      memory_usage_ += src_bytes;
+      for (auto &chunk : src.chunks_) {
+        dst.chunks_.push_back(std::move(chunk));
+      }
+      dst.num_rows_ += src.num_rows_;
+    }
+    other->memory_usage_ -= src_bytes;
+    src = Partition();
+  }
+  SpillIfNeeded();
+}
+
+auto JoinHashTable::MakeBloomFilter() const -> std::shared_ptr<const BloomFilter> {
+  size_t num_rows = 0;
+  for (const auto &partition : partitions_) {
+    if (partition.spilled_) {
+      return nullptr;
+    }
+    num_rows += partition.num_rows_;
+  }
+  auto filter = std::make_shared<BloomFilter>(num_rows);
+  for (const auto &partition : partitions_) {
+    for (auto entry : partition.directory_) {
+      for (const auto *row = reinterpret_cast<const Row *>(entry & POINTER_MASK); row != nullptr; row = row->next_) {
+        filter->Insert(GetHash(GetTuple(row)));
+      }
+    }
+  }
+  return filter;
+}
+
+void JoinHashTable::Finalize() {
+  std::vector<Row *> rows;
+  for (auto &partition : partitions_) {
+    if (partition.spilled_ || partition.num_rows_ == 0) {
+      partition.directory_.clear();
+      continue;
+    }
+    size_t capacity = 1;
+    while (capacity < partition.num_rows_ * 2) {
+      capacity <<= 1;
+    }
+    partition.directory_.assign(capacity, 0);
+    rows.clear();
+    ForEachRow(&partition, [&](Row *row) { rows.push_back(row); });
+    // Each row goes in front of its bucket, so the rows are inserted last to first to keep them in order.
+    for (auto row = rows.rbegin(); row != rows.rend(); ++row) {
+      auto hash = GetHash(GetTuple(*row));
+      auto &entry = partition.directory_[hash & (capacity - 1)];
+      auto pointer = reinterpret_cast<uintptr_t>(*row);
+      BUSTUB_ASSERT((pointer & ~POINTER_MASK) == 0, "a pointer to a row must fit into 48 bits");
+      (*row)->next_ = reinterpret_cast<const Row *>(entry & POINTER_MASK);
+      entry = pointer | (entry & ~POINTER_MASK) | TagOf(hash);
+    }
+  }
+}
+
+auto JoinHashTable::FindNext(uint64_t hash, const std::vector<Value> &keys, const Row *row) const -> const Row * {
+  const Row *candidate;
+  if (row == nullptr) {
+    const auto &directory = partitions_[PartitionOf(hash)].directory_;
+    if (directory.empty()) {
+      return nullptr;
+    }
+    auto entry = directory[hash & (directory.size() - 1)];
+    if ((entry & TagOf(hash)) == 0) {
+      return nullptr;
+    }
+    candidate = reinterpret_cast<const Row *>(entry & POINTER_MASK);
+  } else {
+    candidate = row->next_;
+  }
+  for (; candidate != nullptr; candidate = candidate->next_) {
+    auto tuple = GetTuple(candidate);
+    if (GetHash(tuple) != hash) {
+      continue;
+    }
+    bool equal = true;
+    for (uint32_t i = 0; i < num_keys_ && equal; i++) {
+      equal = tuple.GetValue(&build_schema_, 1 + i).CompareEquals(keys[i]) == CmpBool::CmpTrue;
+    }
+    if (equal) {
+      return candidate;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace bustub
@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor.cpp
+//
+// Identification: src/execution/merge_join_executor.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/merge_join_executor.h"
+
+#include "execution/normalized_key.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+MergeJoinExecutor::MergeJoinExecutor(ExecutorContext *exec_ctx, const MergeJoinPlanNode *plan,
+                                     std::unique_ptr<AbstractExecutor> &&left_executor,
+                                     std::unique_ptr<AbstractExecutor> &&right_executor)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_executor_(std::move(left_executor)),
+      right_executor_(std::move(right_executor)) {
+  if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
+    throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
+  }
+}
+
+void MergeJoinExecutor::Init() {
+  left_executor_->Init();
+  right_executor_->Init();
+  run_.clear();
+  run_key_.clear();
+  run_pos_ = 0;
+  NextRight();
+}
+
+auto MergeJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  while (true) {
+    if (run_pos_ < run_.size()) {
+      *tuple = MakeJoinedTuple(&run_[run_pos_++]);
+      return true;
+    }
+    RID left_rid;
+    if (!left_executor_->Next(&left_tuple_, &left_rid)) {
+      return false;
+    }
+    if (EncodeKey(plan_->LeftJoinKeyExpressions(), left_tuple_, left_executor_->GetOutputSchema(), &left_key_)) {
+      // The left tuples with the same key as the one before are joined with the same run.
+      if (left_key_ != run_key_) {
+        FindRun();
+      }
+      run_pos_ = 0;
+    } else {
+      run_pos_ = run_.size();
+    }
+    if (run_pos_ == run_.size() && plan_->GetJoinType() == JoinType::LEFT) {
+      *tuple = MakeJoinedTuple(nullptr);
+      return true;
+    }
+  }
+}
+
+auto MergeJoinExecutor::EncodeKey(const std::vector<AbstractExpressionRef> &exprs, const Tuple &tuple,
+                                  const Schema &schema, std::vector<char> *key) -> bool {
+  key->clear();
+  for (const auto &expr : exprs) {
+    auto value = expr->Evaluate(tuple, schema);
+    if (value.IsNull()) {
+      return false;
+    }
+    KeyNormalizer::AppendValue(value, false, key);
+  }
+  return true;
+}
+
+void MergeJoinExecutor::NextRight() {
+  RID rid;
+  right_done_ = !right_executor_->Next(&right_tuple_, &rid);
+  if (!right_done_ &&
+      !EncodeKey(plan_->RightJoinKeyExpressions(), right_tuple_, right_executor_->GetOutputSchema(), &right_key_)) {
+    right_key_.clear();
+  }
+}
+
+void MergeJoinExecutor::FindRun() {
+  run_.clear();
+  run_key_ = left_key_;
+  // The right tuples before the left key, or with a NULL key, match none of the left tuples from here on.
+  while (!right_done_ && (right_key_.empty() || KeyNormalizer::Compare(right_key_.data(), right_key_.size(),
+                                                                       left_key_.data(), left_key_.size()) < 0)) {
+    NextRight();
+  }
+  while (!right_done_ && right_key_ == left_key_) {
+    run_.push_back(right_tuple_);
+    NextRight();
+  }
+}
+
+auto MergeJoinExecutor::MakeJoinedTuple(const Tuple *right) const -> Tuple {
+  const auto &left_schema = left_executor_->GetOutputSchema();
+  const auto &right_schema = right_executor_->GetOutputSchema();
+  std::vector<Value> values;
+  values.reserve(GetOutputSchema().GetColumnCount());
+  for (uint32_t i = 0; i < left_schema.GetColumnCount(); i++) {
+    values.push_back(left_tuple_.GetValue(&left_schema, i));
+  }
+  for (uint32_t i = 0; i < right_schema.GetColumnCount(); i++) {
+    values.push_back(right == nullptr ? ValueFactory::GetNullValueByType(right_schema.GetColumn(i).GetType())
+                                      : right->GetValue(&right_schema, i));
+  }
+  return Tuple{values, &GetOutputSchema()};
+}
+
+}  // namespace bustub
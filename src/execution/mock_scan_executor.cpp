@@ -200,32 +200,32 @@ auto GetShuffled(const MockScanPlanNode *plan) -> bool {
   return false;
 }
 
-auto GetFunctionOf(const MockScanPlanNode *plan) -> std::function<Tuple(size_t)> {
+auto GetFunctionOf(const MockScanPlanNode *plan) -> std::function<std::vector<Value>(size_t)> {
   const auto &table = plan->GetTable();
 
   if (table == "__mock_table_1") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.reserve(2);
       values.push_back(ValueFactory::GetIntegerValue(cursor));
       values.push_back(ValueFactory::GetIntegerValue(cursor * 100));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_table_2") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.reserve(2);
       values.push_back(ValueFactory::GetVarcharValue(fmt::format("{}-\U0001F4A9", cursor)));  // the poop emoji
       values.push_back(
           ValueFactory::GetVarcharValue(StringUtil::Repeat("\U0001F607", cursor % 8)));  // the innocent emoji
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_table_3") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.reserve(2);
       if (cursor % 2 == 0) {
@@ -234,48 +234,48 @@ auto GetFunctionOf(const MockScanPlanNode *plan) -> std::function<Tuple(size_t)>
         values.push_back(ValueFactory::GetNullValueByType(TypeId::INTEGER));
       }
       values.push_back(ValueFactory::GetVarcharValue(fmt::format("{}-\U0001F4A9", cursor)));  // the poop emoji
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_table_tas_2022") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.push_back(ValueFactory::GetVarcharValue(ta_list_2022[cursor]));
       values.push_back(ValueFactory::GetVarcharValue(ta_oh_2022[cursor]));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_table_tas_2023") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.push_back(ValueFactory::GetVarcharValue(ta_list_2023[cursor]));
       values.push_back(ValueFactory::GetVarcharValue(ta_oh_2023[cursor]));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_table_schedule_2022") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.push_back(ValueFactory::GetVarcharValue(course_on_date[cursor]));
       values.push_back(ValueFactory::GetIntegerValue(cursor == 1 || cursor == 3 ? 1 : 0));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_table_schedule_2023") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.push_back(ValueFactory::GetVarcharValue(course_on_date[cursor]));
       values.push_back(ValueFactory::GetIntegerValue(cursor == 0 || cursor == 2 ? 1 : 0));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_agg_input_small") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.push_back(ValueFactory::GetIntegerValue((cursor + 2) % 10));
       values.push_back(ValueFactory::GetIntegerValue(cursor));
@@ -284,12 +284,12 @@ auto GetFunctionOf(const MockScanPlanNode *plan) -> std::function<Tuple(size_t)>
       values.push_back(ValueFactory::GetIntegerValue(233));
       values.push_back(
           ValueFactory::GetVarcharValue(StringUtil::Repeat("\U0001F4A9", (cursor % 8) + 1)));  // the poop emoji
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_agg_input_big") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.push_back(ValueFactory::GetIntegerValue((cursor + 2) % 10));
       values.push_back(ValueFactory::GetIntegerValue(cursor));
@@ -298,20 +298,20 @@ auto GetFunctionOf(const MockScanPlanNode *plan) -> std::function<Tuple(size_t)>
       values.push_back(ValueFactory::GetIntegerValue(233));
       values.push_back(
           ValueFactory::GetVarcharValue(StringUtil::Repeat("\U0001F4A9", (cursor % 16) + 1)));  // the poop emoji
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_table_123") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.push_back(ValueFactory::GetIntegerValue(cursor + 1));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_graph") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       int src = cursor % GRAPH_NODE_CNT;
       int dst = cursor / GRAPH_NODE_CNT;
@@ -324,65 +324,65 @@ auto GetFunctionOf(const MockScanPlanNode *plan) -> std::function<Tuple(size_t)>
       } else {
         values.push_back(ValueFactory::GetIntegerValue(1));
       }
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_t1") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.push_back(ValueFactory::GetIntegerValue(cursor / 10000));
       values.push_back(ValueFactory::GetIntegerValue(cursor % 10000));
       values.push_back(ValueFactory::GetIntegerValue(cursor));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_t4_1m") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       cursor = cursor % 500000;
       values.push_back(ValueFactory::GetIntegerValue(cursor));
       values.push_back(ValueFactory::GetIntegerValue(cursor * 10));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_t5_1m") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       cursor = (cursor + 30000) % 500000;
       values.push_back(ValueFactory::GetIntegerValue(cursor));
       values.push_back(ValueFactory::GetIntegerValue(cursor * 10));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_t6_1m") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       cursor = (cursor + 60000) % 500000;
       values.push_back(ValueFactory::GetIntegerValue(cursor));
       values.push_back(ValueFactory::GetIntegerValue(cursor * 10));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_t7") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.push_back(ValueFactory::GetIntegerValue(cursor % 20));
       values.push_back(ValueFactory::GetIntegerValue(cursor));
       values.push_back(ValueFactory::GetIntegerValue(cursor));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
   if (table == "__mock_t8") {
-    return [plan](size_t cursor) {
+    return [](size_t cursor) {
       std::vector<Value> values{};
       values.push_back(ValueFactory::GetIntegerValue(cursor));
-      return Tuple{values, &plan->OutputSchema()};
+      return values;
     };
   }
 
@@ -393,42 +393,85 @@ auto GetFunctionOf(const MockScanPlanNode *plan) -> std::function<Tuple(size_t)>
     for (const auto &column : plan->OutputSchema().GetColumns()) {
       values.push_back(ValueFactory::GetZeroValueByType(column.GetType()));
     }
-    return Tuple{values, &plan->OutputSchema()};
+    return values;
   };
 }
 
 MockScanExecutor::MockScanExecutor(ExecutorContext *exec_ctx, const MockScanPlanNode *plan)
-    : AbstractExecutor{exec_ctx}, plan_{plan}, func_(GetFunctionOf(plan)), size_(GetSizeOf(plan)) {
+    : AbstractExecutor{exec_ctx}, plan_{plan}, func_(GetFunctionOf(plan)), size_(GetSizeOf(plan)) {}
+
+/** @return the row order of a scan of `plan`, shuffled if its table is, or else empty */
+static auto MakeShuffledIdx(const MockScanPlanNode *plan, size_t size) -> std::vector<size_t> {
+  std::vector<size_t> shuffled_idx;
   if (GetShuffled(plan)) {
-    for (size_t i = 0; i < size_; i++) {
-      shuffled_idx_.push_back(i);
+    for (size_t i = 0; i < size; i++) {
+      shuffled_idx.push_back(i);
     }
     std::random_device rd;
     std::mt19937 g(rd());
-    std::shuffle(shuffled_idx_.begin(), shuffled_idx_.end(), g);
+    std::shuffle(shuffled_idx.begin(), shuffled_idx.end(), g);
   }
+  return shuffled_idx;
 }
 
 void MockScanExecutor::Init() {
   // Reset the cursor
   cursor_ = 0;
+  morsels_ = dynamic_cast<MockMorselSource *>(exec_ctx_->GetSharedState(plan_));
+  if (morsels_ != nullptr) {
+    // The tasks of the pipeline assign the morsels to read, from an order shared by all copies of the scan.
+    worker_ = morsels_->AddCopy();
+    shuffled_idx_ = &morsels_->ShuffledIdx();
+    end_ = 0;
+    return;
+  }
+  if (own_shuffled_idx_.empty()) {
+    own_shuffled_idx_ = MakeShuffledIdx(plan_, size_);
+  }
+  shuffled_idx_ = &own_shuffled_idx_;
+  end_ = size_;
 }
 
 auto MockScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  if (cursor_ == size_) {
+  if (cursor_ == end_ && !NextMorsel()) {
     // Scan complete
     return EXECUTOR_EXHAUSTED;
   }
-  if (shuffled_idx_.empty()) {
-    *tuple = func_(cursor_);
-  } else {
-    *tuple = func_(shuffled_idx_[cursor_]);
-  }
+  *tuple = Tuple{func_(RowAt(cursor_)), &GetOutputSchema()};
   ++cursor_;
   *rid = MakeDummyRID();
   return EXECUTOR_ACTIVE;
 }
 
+auto MockScanExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset(GetOutputSchema());
+  while (!batch->IsFull() && (cursor_ < end_ || NextMorsel())) {
+    for (; cursor_ < end_ && !batch->IsFull(); ++cursor_) {
+      batch->AppendRow(func_(RowAt(cursor_)));
+    }
+  }
+  return batch->NumSelected() > 0;
+}
+
+auto MockScanExecutor::NextMorsel() -> bool {
+  auto morsel = morsels_ == nullptr ? std::nullopt : morsels_->TakeMorsel(worker_);
+  if (!morsel.has_value()) {
+    return false;
+  }
+  cursor_ = *morsel * morsels_->RowsPerMorsel();
+  end_ = std::min(cursor_ + morsels_->RowsPerMorsel(), size_);
+  return true;
+}
+
+auto MockScanExecutor::MakeMorselSource(ExecutorContext *exec_ctx, const MockScanPlanNode *plan, size_t num_workers)
+    -> std::unique_ptr<MockMorselSource> {
+  auto size = GetSizeOf(plan);
+  if (size <= ROWS_PER_MORSEL) {
+    return nullptr;
+  }
+  return std::make_unique<MockMorselSource>(size, ROWS_PER_MORSEL, MakeShuffledIdx(plan, size), num_workers);
+}
+
 auto MockScanExecutor::MakeDummyRID() -> RID { return RID{0}; }
 
 }  // namespace bustub
@@ -0,0 +1,163 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// normalized_key.cpp
+//
+// Identification: src/execution/normalized_key.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/normalized_key.h"
+
+#include "common/exception.h"
+#include "execution/expressions/column_value_expression.h"
+#include "type/limits.h"
+
+namespace bustub {
+
+/** Append the bytes of `value` to `key`, most significant first. */
+template <class T>
+static void AppendBigEndian(T value, std::vector<char> *key) {
+  for (auto shift = static_cast<int>(sizeof(T) * 8) - 8; shift >= 0; shift -= 8) {
+    key->push_back(static_cast<char>(value >> shift));
+  }
+}
+
+/** @return the value of type T serialized at `data` */
+template <class T>
+static auto Read(const char *data) -> T {
+  T value;
+  memcpy(&value, data, sizeof(T));
+  return value;
+}
+
+/** @return true if the value of fixed-size type `type` serialized at `data` is NULL */
+static auto IsNullRaw(TypeId type, const char *data) -> bool {
+  switch (type) {
+    case TypeId::BOOLEAN:
+      return Read<int8_t>(data) == BUSTUB_BOOLEAN_NULL;
+    case TypeId::TINYINT:
+      return Read<int8_t>(data) == BUSTUB_INT8_NULL;
+    case TypeId::SMALLINT:
+      return Read<int16_t>(data) == BUSTUB_INT16_NULL;
+    case TypeId::INTEGER:
+      return Read<int32_t>(data) == BUSTUB_INT32_NULL;
+    case TypeId::BIGINT:
+      return Read<int64_t>(data) == BUSTUB_INT64_NULL;
+    case TypeId::DECIMAL:
+      return Read<double>(data) == BUSTUB_DECIMAL_NULL;
+    case TypeId::TIMESTAMP:
+      return Read<uint64_t>(data) == BUSTUB_TIMESTAMP_NULL;
+    default:
+      throw NotImplementedException("cannot sort by this type");
+  }
+}
+
+/** Append the normalized form of the non-NULL value of fixed-size type `type` serialized at `data` to `key`. */
+static void AppendFixed(TypeId type, const char *data, std::vector<char> *key) {
+  switch (type) {
+    case TypeId::BOOLEAN:
+      key->push_back(static_cast<char>(Read<int8_t>(data)));
+      break;
+    case TypeId::TINYINT:
+      AppendBigEndian(static_cast<uint8_t>(static_cast<uint8_t>(Read<int8_t>(data)) ^ uint8_t{0x80}), key);
+      break;
+    case TypeId::SMALLINT:
+      AppendBigEndian(static_cast<uint16_t>(static_cast<uint16_t>(Read<int16_t>(data)) ^ uint16_t{0x8000}), key);
+      break;
+    case TypeId::INTEGER:
+      AppendBigEndian(static_cast<uint32_t>(Read<int32_t>(data)) ^ (uint32_t{1} << 31), key);
+      break;
+    case TypeId::BIGINT:
+      AppendBigEndian(static_cast<uint64_t>(Read<int64_t>(data)) ^ (uint64_t{1} << 63), key);
+      break;
+    case TypeId::DECIMAL: {
+      // -0.0 equals 0.0. A negative double orders as its bits inverted, a positive one with its sign bit set.
+      auto decimal = Read<double>(data) == 0 ? 0.0 : Read<double>(data);
+      uint64_t bits;
+      memcpy(&bits, &decimal, sizeof(bits));
+      AppendBigEndian((bits >> 63) != 0 ? ~bits : bits ^ (uint64_t{1} << 63), key);
+      break;
+    }
+    case TypeId::TIMESTAMP:
+      AppendBigEndian(Read<uint64_t>(data), key);
+      break;
+    default:
+      throw NotImplementedException("cannot sort by this type");
+  }
+}
+
+/** Invert the bytes of `key` from `begin` on, for a DESC key. */
+static void Invert(size_t begin, std::vector<char> *key) {
+  for (auto i = begin; i < key->size(); i++) {
+    (*key)[i] = static_cast<char>(~(*key)[i]);
+  }
+}
+
+KeyNormalizer::KeyNormalizer(std::vector<std::pair<OrderByType, AbstractExpressionRef>> order_bys)
+    : order_bys_(std::move(order_bys)) {
+  for (const auto &[order_by_type, expr] : order_bys_) {
+    const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(expr.get());
+    column_ids_.push_back(column_expr != nullptr && column_expr->GetTupleIdx() == 0
+                              ? static_cast<int64_t>(column_expr->GetColIdx())
+                              : -1);
+  }
+}
+
+void KeyNormalizer::Encode(const TupleRef &tuple, const Schema &schema, std::vector<char> *key) const {
+  for (size_t i = 0; i < order_bys_.size(); i++) {
+    const auto &[order_by_type, expr] = order_bys_[i];
+    auto descending = order_by_type == OrderByType::DESC;
+    if (column_ids_[i] >= 0) {
+      const auto &column = schema.GetColumn(column_ids_[i]);
+      if (column.IsInlined()) {
+        AppendRaw(column.GetType(), tuple.GetData() + column.GetOffset(), descending, key);
+        continue;
+      }
+    }
+    AppendValue(expr->Evaluate(tuple, schema), descending, key);
+  }
+}
+
+void KeyNormalizer::AppendRaw(TypeId type, const char *data, bool descending, std::vector<char> *key) {
+  auto begin = key->size();
+  if (IsNullRaw(type, data)) {
+    key->push_back(2);
+  } else {
+    key->push_back(1);
+    AppendFixed(type, data, key);
+  }
+  if (descending) {
+    Invert(begin, key);
+  }
+}
+
+void KeyNormalizer::AppendValue(const Value &value, bool descending, std::vector<char> *key) {
+  auto begin = key->size();
+  if (value.IsNull()) {
+    key->push_back(2);
+  } else if (value.GetTypeId() == TypeId::VARCHAR) {
+    key->push_back(1);
+    // The length of a VARCHAR counts its terminating 0.
+    const auto *data = value.GetData();
+    for (uint32_t i = 0; i + 1 < value.GetLength(); i++) {
+      key->push_back(data[i]);
+      if (data[i] == 0) {
+        key->push_back(static_cast<char>(0xFF));
+      }
+    }
+    key->push_back(0);
+    key->push_back(0);
+  } else {
+    key->push_back(1);
+    char data[sizeof(uint64_t)];
+    value.SerializeTo(data);
+    AppendFixed(value.GetTypeId(), data, key);
+  }
+  if (descending) {
+    Invert(begin, key);
+  }
+}
+
+}  // namespace bustub
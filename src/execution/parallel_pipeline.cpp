@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_pipeline.cpp
+//
+// Identification: src/execution/parallel_pipeline.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/parallel_pipeline.h"
+
+#include "execution/executor_factory.h"
+#include "execution/executors/hash_join_executor.h"
+#include "execution/executors/mock_scan_executor.h"
+#include "execution/executors/seq_scan_executor.h"
+
+namespace bustub {
+
+auto ParallelPipeline::Make(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan)
+    -> std::unique_ptr<ParallelPipeline> {
+  auto *scheduler = exec_ctx->GetTaskScheduler();
+  if (scheduler == nullptr || scheduler->NumWorkers() < 2) {
+    return nullptr;
+  }
+  auto num_workers = scheduler->NumWorkers();
+  std::unique_ptr<ParallelPipeline> pipeline(new ParallelPipeline(scheduler));
+
+  // Walk down the pipeline to its scan. A hash join belongs to the pipeline of its probe side, the left one, and
+  // starts a pipeline of its own on its build side.
+  std::unique_ptr<MorselSource> morsels;
+  const auto *node = plan.get();
+  while (morsels == nullptr) {
+    switch (node->GetType()) {
+      case PlanType::Filter:
+      case PlanType::Projection:
+        node = node->GetChildAt(0).get();
+        break;
+      case PlanType::HashJoin:
+        pipeline->shared_states_.emplace_back(node, std::make_unique<SharedJoinTable>());
+        node = node->GetChildAt(0).get();
+        break;
+      case PlanType::SeqScan:
+        morsels = SeqScanExecutor::MakeMorselSource(exec_ctx, dynamic_cast<const SeqScanPlanNode *>(node), num_workers);
+        if (morsels == nullptr) {
+          return nullptr;
+        }
+        break;
+      case PlanType::MockScan:
+        morsels =
+            MockScanExecutor::MakeMorselSource(exec_ctx, dynamic_cast<const MockScanPlanNode *>(node), num_workers);
+        if (morsels == nullptr) {
+          return nullptr;
+        }
+        break;
+      default:
+        return nullptr;
+    }
+  }
+  pipeline->morsels_ = morsels.get();
+  pipeline->shared_states_.emplace_back(node, std::move(morsels));
+
+  // The copies pick up their shared states in Init, in order, so the copy of worker i is the i-th to register with
+  // the scan. The first copy of a hash join builds its table, and the others share it.
+  auto set_shared_states = [&](bool set) {
+    for (const auto &[shared_plan, state] : pipeline->shared_states_) {
+      exec_ctx->SetSharedState(shared_plan, set ? state.get() : nullptr);
+    }
+  };
+  set_shared_states(true);
+  try {
+    for (size_t i = 0; i < num_workers; i++) {
+      pipeline->copies_.push_back(ExecutorFactory::CreateExecutor(exec_ctx, plan));
+      pipeline->copies_.back()->Init();
+    }
+  } catch (...) {
+    set_shared_states(false);
+    throw;
+  }
+  set_shared_states(false);
+  BUSTUB_ASSERT(pipeline->copies_.front()->SupportsBatch(), "the executors of a pipeline over a scan output batches");
+  return pipeline;
+}
+
+void ParallelPipeline::Run(const Consumer &consume) {
+  std::vector<TupleBatch> batches(NumWorkers());
+  std::vector<TaskScheduler::Task> tasks;
+  tasks.reserve(morsels_->NumMorsels());
+  for (size_t morsel = 0; morsel < morsels_->NumMorsels(); morsel++) {
+    tasks.emplace_back([this, morsel, &batches, &consume](size_t worker) {
+      morsels_->Assign(worker, morsel);
+      auto &batch = batches[worker];
+      while (copies_[worker]->NextBatch(&batch)) {
+        consume(worker, batch);
+      }
+    });
+  }
+  scheduler_->RunAll(tasks);
+
+  // The hash joins of the pipeline join the partitions they spilled only at the end of the probe side, so each copy
+  // runs once more after they are told the last morsel is done.
+  bool has_joins = false;
+  for (const auto &[plan, state] : shared_states_) {
+    if (auto *join = dynamic_cast<SharedJoinTable *>(state.get()); join != nullptr) {
+      join->probe_done_ = true;
+      has_joins = true;
+    }
+  }
+  if (!has_joins) {
+    return;
+  }
+  tasks.clear();
+  for (size_t copy = 0; copy < copies_.size(); copy++) {
+    tasks.emplace_back([this, copy, &batches, &consume](size_t worker) {
+      auto &batch = batches[worker];
+      while (copies_[copy]->NextBatch(&batch)) {
+        consume(worker, batch);
+      }
+    });
+  }
+  scheduler_->RunAll(tasks);
+}
+
+}  // namespace bustub
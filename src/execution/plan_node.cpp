@@ -74,7 +74,14 @@ auto AggregationPlanNode::InferAggSchema(const std::vector<AbstractExpressionRef
   }
   for (size_t idx = 0; idx < aggregates.size(); idx++) {
     // TODO(chi): correctly infer agg call return type
-    output.emplace_back(Column("<unnamed>", TypeId::INTEGER));
+    // The MIN or MAX of a VARCHAR is a VARCHAR, which cannot be cast to INTEGER.
+    auto agg_type = agg_types[idx];
+    auto is_min_max = agg_type == AggregationType::MinAggregate || agg_type == AggregationType::MaxAggregate;
+    if (is_min_max && aggregates[idx]->GetReturnType() == TypeId::VARCHAR) {
+      output.emplace_back(Column("<unnamed>", TypeId::VARCHAR, 128));
+    } else {
+      output.emplace_back(Column("<unnamed>", TypeId::INTEGER));
+    }
   }
   return Schema(output);
 }
@@ -13,10 +13,10 @@ void ProjectionExecutor::Init() {
 }
 
 auto ProjectionExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  Tuple child_tuple{};
+  TupleRef child_tuple;
 
-  // Get the next tuple
-  const auto status = child_executor_->Next(&child_tuple, rid);
+  // Get the next tuple, read in place as it is only needed to compute the expressions
+  const auto status = child_executor_->NextRef(&child_tuple, rid);
 
   if (!status) {
     return false;
@@ -26,11 +26,25 @@ auto ProjectionExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   std::vector<Value> values{};
   values.reserve(GetOutputSchema().GetColumnCount());
   for (const auto &expr : plan_->GetExpressions()) {
-    values.push_back(expr->Evaluate(&child_tuple, child_executor_->GetOutputSchema()));
+    values.push_back(expr->Evaluate(child_tuple, child_executor_->GetOutputSchema()));
   }
 
   *tuple = Tuple{values, &GetOutputSchema()};
 
   return true;
 }
+
+auto ProjectionExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset(GetOutputSchema());
+  if (!child_executor_->NextBatch(&child_batch_)) {
+    return false;
+  }
+  // Each expression yields a value per selected row of the child's batch, so all rows of the output are selected.
+  const auto &exprs = plan_->GetExpressions();
+  for (uint32_t i = 0; i < exprs.size(); i++) {
+    exprs[i]->EvaluateBatch(child_batch_, &batch->GetColumn(i));
+  }
+  batch->FinishRows(child_batch_.NumSelected());
+  return true;
+}
 }  // namespace bustub
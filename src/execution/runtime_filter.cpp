@@ -0,0 +1,53 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// runtime_filter.cpp
+//
+// Identification: src/execution/runtime_filter.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/runtime_filter.h"
+
+#include "execution/expressions/column_value_expression.h"
+
+namespace bustub {
+
+TopNFilter::TopNFilter(std::vector<std::pair<OrderByType, AbstractExpressionRef>> order_bys)
+    : normalizer_(order_bys) {
+  const auto &[order_by_type, expr] = order_bys.front();
+  const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(expr.get());
+  if (column_expr != nullptr && column_expr->GetTupleIdx() == 0) {
+    first_column_ = column_expr->GetColIdx();
+  }
+  first_descending_ = order_by_type == OrderByType::DESC;
+}
+
+void TopNFilter::SetThreshold(const std::vector<char> &key, const TupleRef &tuple, const Schema &schema) {
+  threshold_.assign(key.begin(), key.end());
+  if (!first_column_.has_value()) {
+    return;
+  }
+  auto value = tuple.GetValue(&schema, *first_column_);
+  if (value.IsNull()) {
+    // NULLs come last in ascending order, so every value sorts before a NULL threshold, and first in descending
+    // order, so only NULLs do, which no bound on the values expresses.
+    zone_bound_.reset();
+  } else if (first_descending_) {
+    zone_bound_ = ZoneBound{*first_column_, ZoneBound::Op::GE, std::move(value), true};
+  } else {
+    zone_bound_ = ZoneBound{*first_column_, ZoneBound::Op::LE, std::move(value)};
+  }
+}
+
+auto TopNFilter::Passes(const TupleRef &tuple, const Schema &schema) -> bool {
+  if (threshold_.empty()) {
+    return true;
+  }
+  key_.clear();
+  normalizer_.Encode(tuple, schema, &key_);
+  return KeyNormalizer::Compare(key_.data(), key_.size(), threshold_.data(), threshold_.size()) < 0;
+}
+
+}  // namespace bustub
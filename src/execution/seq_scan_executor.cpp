@@ -1,23 +1,231 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// seq_scan_executor.cpp
-//
-// Identification: src/execution/seq_scan_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-
-#include "execution/executors/seq_scan_executor.h"
-
-namespace bustub {
-
-SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx) {}
-
-void SeqScanExecutor::Init() { throw NotImplementedException("SeqScanExecutor is not implemented"); }
-
-auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// seq_scan_executor.cpp
+//
+// Identification: src/execution/seq_scan_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/seq_scan_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/join_hash_table.h"
+
+namespace bustub {
+
+/** Add the bounds `column op constant` that every tuple satisfying `expr` satisfies to `bounds`. */
+static void CollectZoneBounds(const AbstractExpressionRef &expr, std::vector<ZoneBound> *bounds) {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(expr.get()); logic_expr != nullptr) {
+    if (logic_expr->logic_type_ == LogicType::And) {
+      CollectZoneBounds(expr->GetChildAt(0), bounds);
+      CollectZoneBounds(expr->GetChildAt(1), bounds);
+    }
+    return;
+  }
+  const auto *comparison_expr = dynamic_cast<const ComparisonExpression *>(expr.get());
+  if (comparison_expr == nullptr) {
+    return;
+  }
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(expr->GetChildAt(0).get());
+  const auto *constant = dynamic_cast<const ConstantValueExpression *>(expr->GetChildAt(1).get());
+  // `constant op column` is `column op' constant` with the comparison turned around.
+  bool flipped = false;
+  if (column == nullptr || constant == nullptr) {
+    column = dynamic_cast<const ColumnValueExpression *>(expr->GetChildAt(1).get());
+    constant = dynamic_cast<const ConstantValueExpression *>(expr->GetChildAt(0).get());
+    flipped = true;
+  }
+  if (column == nullptr || constant == nullptr) {
+    return;
+  }
+  ZoneBound::Op op;
+  switch (comparison_expr->comp_type_) {
+    case ComparisonType::Equal:
+      op = ZoneBound::Op::EQ;
+      break;
+    case ComparisonType::LessThan:
+      op = flipped ? ZoneBound::Op::GT : ZoneBound::Op::LT;
+      break;
+    case ComparisonType::LessThanOrEqual:
+      op = flipped ? ZoneBound::Op::GE : ZoneBound::Op::LE;
+      break;
+    case ComparisonType::GreaterThan:
+      op = flipped ? ZoneBound::Op::LT : ZoneBound::Op::GT;
+      break;
+    case ComparisonType::GreaterThanOrEqual:
+      op = flipped ? ZoneBound::Op::LE : ZoneBound::Op::GE;
+      break;
+    default:
+      return;
+  }
+  bounds->push_back({column->GetColIdx(), op, constant->val_});
+}
+
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+void SeqScanExecutor::Init() {
+  auto table_info = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid());
+  iterator_.reset();
+  morsels_ = dynamic_cast<TableMorselSource *>(exec_ctx_->GetSharedState(plan_));
+  if (morsels_ != nullptr) {
+    // The tasks of the pipeline assign the morsels to read.
+    worker_ = morsels_->AddCopy();
+  } else {
+    iterator_.emplace(table_info->table_->MakeIterator());
+  }
+  batch_pos_ = batch_.Size();
+  zone_bounds_.clear();
+  if (plan_->filter_predicate_ != nullptr) {
+    CollectZoneBounds(plan_->filter_predicate_, &zone_bounds_);
+  }
+  num_predicate_bounds_ = zone_bounds_.size();
+  runtime_filter_.reset();
+  if (plan_->runtime_filter_.has_value()) {
+    runtime_filter_ = exec_ctx_->GetRuntimeFilter(plan_->runtime_filter_->id_);
+  }
+  topn_filter_.reset();
+  if (plan_->topn_filter_id_.has_value()) {
+    topn_filter_ = exec_ctx_->GetTopNFilter(*plan_->topn_filter_id_);
+  }
+}
+
+auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  TupleRef tuple_ref;
+  if (!NextRef(&tuple_ref, rid)) {
+    return false;
+  }
+  tuple->CopyFrom(tuple_ref);
+  return true;
+}
+
+auto SeqScanExecutor::NextBatch(TupleBatch *batch) -> bool {
+  const auto &column_ids = plan_->column_ids_;
+  const auto *read_column_ids = column_ids.has_value() ? &*column_ids : nullptr;
+  // Fill the batch from the pages of the table until it is full, and start over if no tuple passes the filter.
+  while (true) {
+    batch->Reset(GetOutputSchema());
+    while (!batch->IsFull()) {
+      if (batch_pos_ == batch_.Size() && !NextPage(read_column_ids)) {
+        break;
+      }
+      for (; batch_pos_ < batch_.Size() && !batch->IsFull(); batch_pos_++) {
+        const auto &view = batch_[batch_pos_];
+        if (!view.meta_.is_deleted_ &&
+            (topn_filter_ == nullptr || topn_filter_->Passes(TupleRef{view}, GetOutputSchema()))) {
+          batch->AppendTuple(TupleRef{view}, GetOutputSchema(), read_column_ids);
+        }
+      }
+    }
+    if (batch->NumRows() == 0) {
+      return false;
+    }
+    if (plan_->filter_predicate_ != nullptr) {
+      batch->Select(*plan_->filter_predicate_);
+    }
+    if (runtime_filter_ != nullptr && batch->NumSelected() > 0) {
+      SelectRuntimeFilter(batch);
+    }
+    if (batch->NumSelected() > 0) {
+      return true;
+    }
+  }
+}
+
+auto SeqScanExecutor::NextRef(TupleRef *tuple, RID *rid) -> bool {
+  while (true) {
+    const auto &column_ids = plan_->column_ids_;
+    if (batch_pos_ == batch_.Size() && !NextPage(column_ids.has_value() ? &*column_ids : nullptr)) {
+      return false;
+    }
+    const auto &view = batch_[batch_pos_++];
+    if (view.meta_.is_deleted_) {
+      continue;
+    }
+    if (plan_->filter_predicate_ != nullptr) {
+      auto value = plan_->filter_predicate_->Evaluate(TupleRef{view}, GetOutputSchema());
+      if (value.IsNull() || !value.GetAs<bool>()) {
+        continue;
+      }
+    }
+    if (runtime_filter_ != nullptr && !PassesRuntimeFilter(TupleRef{view})) {
+      continue;
+    }
+    if (topn_filter_ != nullptr && !topn_filter_->Passes(TupleRef{view}, GetOutputSchema())) {
+      continue;
+    }
+    *tuple = view;
+    *rid = view.rid_;
+    return true;
+  }
+}
+
+auto SeqScanExecutor::NextPage(const std::vector<uint32_t> *column_ids) -> bool {
+  // The iterator leaves the page batch empty at the end of the table.
+  batch_pos_ = 0;
+  if (topn_filter_ != nullptr) {
+    // Skip the pages the threshold of the TopN rules out. It may have gone down since the last page.
+    zone_bounds_.erase(zone_bounds_.begin() + num_predicate_bounds_, zone_bounds_.end());
+    if (const auto &bound = topn_filter_->GetZoneBound(); bound.has_value()) {
+      zone_bounds_.push_back(*bound);
+    }
+  }
+  while (!iterator_.has_value() || !iterator_->NextBatch(&batch_, column_ids, &zone_bounds_)) {
+    auto morsel = morsels_ == nullptr ? std::nullopt : morsels_->TakeMorsel(worker_);
+    if (!morsel.has_value()) {
+      return false;
+    }
+    iterator_.reset();
+    iterator_.emplace(morsels_->MakeIterator(*morsel));
+  }
+  return true;
+}
+
+auto SeqScanExecutor::PassesRuntimeFilter(const TupleRef &tuple) -> bool {
+  runtime_filter_keys_.clear();
+  for (const auto &expr : plan_->runtime_filter_->keys_) {
+    runtime_filter_keys_.push_back(expr->Evaluate(tuple, GetOutputSchema()));
+    // A NULL key matches nothing.
+    if (runtime_filter_keys_.back().IsNull()) {
+      return false;
+    }
+  }
+  return runtime_filter_->MayContain(JoinHashTable::HashKeys(runtime_filter_keys_));
+}
+
+void SeqScanExecutor::SelectRuntimeFilter(TupleBatch *batch) {
+  const auto &key_exprs = plan_->runtime_filter_->keys_;
+  std::vector<ColumnVector> key_columns(key_exprs.size());
+  for (uint32_t i = 0; i < key_exprs.size(); i++) {
+    key_exprs[i]->EvaluateBatch(*batch, &key_columns[i]);
+  }
+  std::vector<uint8_t> keep(batch->NumSelected());
+  for (size_t i = 0; i < keep.size(); i++) {
+    runtime_filter_keys_.clear();
+    bool has_null = false;
+    for (const auto &column : key_columns) {
+      runtime_filter_keys_.push_back(column.GetValue(i));
+      has_null = has_null || runtime_filter_keys_.back().IsNull();
+    }
+    keep[i] = !has_null && runtime_filter_->MayContain(JoinHashTable::HashKeys(runtime_filter_keys_)) ? 1 : 0;
+  }
+  batch->Select(keep);
+}
+
+auto SeqScanExecutor::MakeMorselSource(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan, size_t num_workers)
+    -> std::unique_ptr<TableMorselSource> {
+  auto table_info = exec_ctx->GetCatalog()->GetTable(plan->GetTableOid());
+  auto scan = table_info->table_->MakeParallelScan();
+  if (scan->GetNumPages() <= TableHeap::DEFAULT_PAGES_PER_MORSEL) {
+    return nullptr;
+  }
+  return std::make_unique<TableMorselSource>(std::move(scan), TableHeap::DEFAULT_PAGES_PER_MORSEL, num_workers);
+}
+
+}  // namespace bustub
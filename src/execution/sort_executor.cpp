@@ -1,13 +1,189 @@
 #include "execution/executors/sort_executor.h"
 
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
 namespace bustub {
 
+/** The sizes of the chunks of records, which double from the first of a run to the last. A larger record gets a
+    chunk of its own. */
+static constexpr size_t MIN_CHUNK_SIZE = 1024;
+static constexpr size_t MAX_CHUNK_SIZE = 64 * 1024;
+
 SortExecutor::SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan,
                            std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      normalizer_(plan->GetOrderBy()) {}
+
+void SortExecutor::Init() {
+  child_executor_->Init();
+  chunks_.clear();
+  chunk_bytes_ = 0;
+  entries_.clear();
+  next_entry_ = 0;
+  runs_.clear();
+  merger_.reset();
+  min_key_size_ = std::numeric_limits<uint32_t>::max();
+  max_key_size_ = 0;
+
+  auto *bpm = exec_ctx_->GetBufferPoolManager();
+  TupleRef tuple;
+  RID rid;
+  while (child_executor_->NextRef(&tuple, &rid)) {
+    AddRecord(tuple);
+    if (bpm != nullptr && MemoryUsage() > exec_ctx_->GetWorkMem()) {
+      SpillRun();
+    }
+  }
+  if (runs_.empty()) {
+    SortEntries();
+    return;
+  }
+  if (!entries_.empty()) {
+    SpillRun();
+  }
+
+  // Each run being merged holds a page in memory, so merge the first runs into longer ones until they fit.
+  auto fan_in = std::max<size_t>(2, exec_ctx_->GetWorkMem() / BUSTUB_PAGE_SIZE);
+  while (runs_.size() > fan_in) {
+    std::vector<std::unique_ptr<TmpTupleFile>> runs(std::make_move_iterator(runs_.begin()),
+                                                    std::make_move_iterator(runs_.begin() + fan_in));
+    runs_.erase(runs_.begin(), runs_.begin() + fan_in);
+    RunMerger merger(std::move(runs));
+    auto run = std::make_unique<TmpTupleFile>(bpm);
+    for (const auto *record = merger.Next(); record != nullptr; record = merger.Next()) {
+      run->Append(*record);
+    }
+    runs_.push_back(std::move(run));
+  }
+  merger_ = std::make_unique<RunMerger>(std::move(runs_));
+  runs_.clear();
+}
+
+void SortExecutor::AddRecord(const TupleRef &tuple) {
+  key_.clear();
+  normalizer_.Encode(tuple, child_executor_->GetOutputSchema(), &key_);
+  auto key_size = static_cast<uint32_t>(key_.size());
+  auto size = sizeof(key_size) + key_size + tuple.GetLength();
+  if (chunks_.empty() || chunks_.back().capacity() - chunks_.back().size() < size) {
+    auto chunk_size = chunks_.empty() ? MIN_CHUNK_SIZE : std::min(chunks_.back().capacity() * 2, MAX_CHUNK_SIZE);
+    chunks_.emplace_back().reserve(std::max(chunk_size, size));
+    chunk_bytes_ += chunks_.back().capacity();
+  }
+  auto &chunk = chunks_.back();
+  const auto *key_size_bytes = reinterpret_cast<const char *>(&key_size);
+  chunk.insert(chunk.end(), key_size_bytes, key_size_bytes + sizeof(key_size));
+  chunk.insert(chunk.end(), key_.begin(), key_.end());
+  chunk.insert(chunk.end(), tuple.GetData(), tuple.GetData() + tuple.GetLength());
+
+  min_key_size_ = std::min(min_key_size_, key_size);
+  max_key_size_ = std::max(max_key_size_, key_size);
+  entries_.push_back(
+      {KeyNormalizer::Prefix(key_.data(), key_size), chunk.data() + chunk.size() - size, static_cast<uint32_t>(size)});
+}
+
+void SortExecutor::SortEntries() {
+  // Keys of one size that fit into the prefix are equal if their prefixes are.
+  auto may_tie = min_key_size_ != max_key_size_ || max_key_size_ > sizeof(uint64_t);
+  SortByNormalizedKey(&entries_, may_tie, EntryLess);
+}
+
+void SortExecutor::SpillRun() {
+  SortEntries();
+  auto run = std::make_unique<TmpTupleFile>(exec_ctx_->GetBufferPoolManager());
+  for (const auto &entry : entries_) {
+    run->Append(TupleRef{RID{}, entry.record_, entry.size_});
+  }
+  runs_.push_back(std::move(run));
+  entries_.clear();
+  chunks_.clear();
+  chunk_bytes_ = 0;
+}
+
+auto SortExecutor::EntryLess(const SortEntry &a, const SortEntry &b) -> bool {
+  if (a.prefix_ != b.prefix_) {
+    return a.prefix_ < b.prefix_;
+  }
+  auto [a_key, a_size] = GetKey(a.record_);
+  auto [b_key, b_size] = GetKey(b.record_);
+  return KeyNormalizer::Compare(a_key, a_size, b_key, b_size) < 0;
+}
+
+auto SortExecutor::GetKey(const char *record) -> std::pair<const char *, uint32_t> {
+  uint32_t key_size;
+  memcpy(&key_size, record, sizeof(key_size));
+  return {record + sizeof(key_size), key_size};
+}
+
+auto SortExecutor::GetTuple(const char *record, uint32_t size) -> TupleRef {
+  auto [key, key_size] = GetKey(record);
+  auto offset = sizeof(key_size) + key_size;
+  return {RID{}, record + offset, static_cast<uint32_t>(size - offset)};
+}
+
+auto SortExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  TupleRef tuple_ref;
+  if (!NextRef(&tuple_ref, rid)) {
+    return false;
+  }
+  tuple->CopyFrom(tuple_ref);
+  return true;
+}
+
+auto SortExecutor::NextRef(TupleRef *tuple, RID *rid) -> bool {
+  if (merger_ != nullptr) {
+    const auto *record = merger_->Next();
+    if (record == nullptr) {
+      return false;
+    }
+    *tuple = GetTuple(record->GetData(), record->GetLength());
+  } else {
+    if (next_entry_ == entries_.size()) {
+      return false;
+    }
+    const auto &entry = entries_[next_entry_++];
+    *tuple = GetTuple(entry.record_, entry.size_);
+  }
+  *rid = RID{};
+  return true;
+}
+
+SortExecutor::RunMerger::RunMerger(std::vector<std::unique_ptr<TmpTupleFile>> runs)
+    : runs_(std::move(runs)), records_(runs_.size()), done_(runs_.size()), tree_(runs_.size(), Less{this}) {
+  BUSTUB_ASSERT(!runs_.empty(), "there must be a run to merge");
+  for (auto &run : runs_) {
+    readers_.push_back(std::make_unique<TmpTupleFile::Reader>(run.get()));
+  }
+}
+
+auto SortExecutor::RunMerger::Next() -> const Tuple * {
+  if (!started_) {
+    for (size_t run = 0; run < runs_.size(); run++) {
+      Advance(run);
+    }
+    tree_.Init();
+    started_ = true;
+  } else {
+    Advance(tree_.Top());
+    tree_.Replay();
+  }
+  auto top = tree_.Top();
+  return done_[top] ? nullptr : &records_[top];
+}
 
-void SortExecutor::Init() { throw NotImplementedException("SortExecutor is not implemented"); }
+void SortExecutor::RunMerger::Advance(size_t run) { done_[run] = !readers_[run]->Next(&records_[run]); }
 
-auto SortExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto SortExecutor::RunMerger::Less::operator()(size_t a, size_t b) const -> bool {
+  if (merger_->done_[a] || merger_->done_[b]) {
+    return !merger_->done_[a];
+  }
+  auto [a_key, a_size] = GetKey(merger_->records_[a].GetData());
+  auto [b_key, b_size] = GetKey(merger_->records_[b].GetData());
+  return KeyNormalizer::Compare(a_key, a_size, b_key, b_size) < 0;
+}
 
 }  // namespace bustub
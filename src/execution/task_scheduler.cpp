@@ -0,0 +1,115 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// task_scheduler.cpp
+//
+// Identification: src/execution/task_scheduler.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/task_scheduler.h"
+
+namespace bustub {
+
+TaskScheduler::TaskScheduler(size_t num_workers) {
+  BUSTUB_ASSERT(num_workers > 0, "a scheduler has at least one worker");
+  for (size_t i = 0; i < num_workers; i++) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  for (size_t i = 0; i < num_workers; i++) {
+    workers_[i]->thread_ = std::thread([this, i] { WorkerLoop(i); });
+  }
+}
+
+TaskScheduler::~TaskScheduler() {
+  {
+    std::scoped_lock guard(latch_);
+    stopping_ = true;
+  }
+  has_tasks_.notify_all();
+  for (auto &worker : workers_) {
+    worker->thread_.join();
+  }
+}
+
+void TaskScheduler::RunAll(const std::vector<Task> &tasks) {
+  if (tasks.empty()) {
+    return;
+  }
+  TaskGroup group;
+  group.num_pending_ = tasks.size();
+  {
+    std::scoped_lock guard(latch_);
+    auto num_workers = workers_.size();
+    for (size_t i = 0; i < tasks.size(); i++) {
+      auto &worker = *workers_[i * num_workers / tasks.size()];
+      std::scoped_lock worker_guard(worker.latch_);
+      // A worker takes its newest task first, so its first tasks go to the back.
+      worker.tasks_.push_front({&tasks[i], &group});
+    }
+    num_queued_ += tasks.size();
+  }
+  has_tasks_.notify_all();
+
+  std::unique_lock guard(group.latch_);
+  group.done_.wait(guard, [&] { return group.num_pending_ == 0; });
+  if (group.exception_ != nullptr) {
+    std::rethrow_exception(group.exception_);
+  }
+}
+
+void TaskScheduler::WorkerLoop(size_t worker) {
+  QueuedTask task;
+  while (true) {
+    if (TakeTask(worker, &task)) {
+      RunTask(worker, task);
+      continue;
+    }
+    std::unique_lock guard(latch_);
+    has_tasks_.wait(guard, [&] { return stopping_ || num_queued_ > 0; });
+    if (stopping_) {
+      return;
+    }
+  }
+}
+
+auto TaskScheduler::TakeTask(size_t worker, QueuedTask *task) -> bool {
+  for (size_t i = 0; i < workers_.size(); i++) {
+    auto &victim = *workers_[(worker + i) % workers_.size()];
+    std::scoped_lock guard(victim.latch_);
+    if (victim.tasks_.empty()) {
+      continue;
+    }
+    if (i == 0) {
+      *task = victim.tasks_.back();
+      victim.tasks_.pop_back();
+    } else {
+      *task = victim.tasks_.front();
+      victim.tasks_.pop_front();
+    }
+    num_queued_--;
+    return true;
+  }
+  return false;
+}
+
+void TaskScheduler::RunTask(size_t worker, const QueuedTask &task) {
+  auto *group = task.group_;
+  if (!group->failed_) {
+    try {
+      (*task.task_)(worker);
+    } catch (...) {
+      std::scoped_lock guard(group->latch_);
+      if (!group->failed_.exchange(true)) {
+        group->exception_ = std::current_exception();
+      }
+    }
+  }
+  std::scoped_lock guard(group->latch_);
+  if (--group->num_pending_ == 0) {
+    group->done_.notify_all();
+  }
+}
+
+}  // namespace bustub
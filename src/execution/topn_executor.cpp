@@ -1,15 +1,71 @@
 #include "execution/executors/topn_executor.h"
 
+#include <algorithm>
+#include <memory>
+
 namespace bustub {
 
 TopNExecutor::TopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan,
                            std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      normalizer_(plan->GetOrderBy()) {}
 
-void TopNExecutor::Init() { throw NotImplementedException("TopNExecutor is not implemented"); }
+void TopNExecutor::Init() {
+  topn_filter_.reset();
+  if (plan_->topn_filter_id_.has_value()) {
+    // The scan below picks the filter up when it is initialized.
+    topn_filter_ = std::make_shared<TopNFilter>(plan_->GetOrderBy());
+    exec_ctx_->SetTopNFilter(*plan_->topn_filter_id_, topn_filter_);
+  }
+  child_executor_->Init();
+  top_entries_.clear();
+  next_entry_ = 0;
+  auto n = plan_->GetN();
+  const auto &schema = child_executor_->GetOutputSchema();
+  TupleRef tuple;
+  RID rid;
+  while (child_executor_->NextRef(&tuple, &rid)) {
+    if (n == 0) {
+      continue;
+    }
+    key_.clear();
+    normalizer_.Encode(tuple, schema, &key_);
+    if (top_entries_.size() < n) {
+      top_entries_.push_back({key_, tuple.ToTuple()});
+      std::push_heap(top_entries_.begin(), top_entries_.end(), EntryLess);
+      if (topn_filter_ != nullptr && top_entries_.size() == n) {
+        topn_filter_->SetThreshold(top_entries_.front().key_, top_entries_.front().tuple_, schema);
+      }
+      continue;
+    }
+    const auto &largest = top_entries_.front().key_;
+    if (KeyNormalizer::Compare(key_.data(), key_.size(), largest.data(), largest.size()) >= 0) {
+      continue;
+    }
+    // Reuse the memory of the entry that drops out.
+    std::pop_heap(top_entries_.begin(), top_entries_.end(), EntryLess);
+    auto &entry = top_entries_.back();
+    entry.key_.swap(key_);
+    entry.tuple_.CopyFrom(tuple);
+    std::push_heap(top_entries_.begin(), top_entries_.end(), EntryLess);
+    if (topn_filter_ != nullptr) {
+      topn_filter_->SetThreshold(top_entries_.front().key_, top_entries_.front().tuple_, schema);
+    }
+  }
+  std::sort_heap(top_entries_.begin(), top_entries_.end(), EntryLess);
+}
 
-auto TopNExecutor::Next(Tuple *tuple, RID *rid) -> bool { return false; }
+auto TopNExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (next_entry_ == top_entries_.size()) {
+    return false;
+  }
+  *tuple = top_entries_[next_entry_++].tuple_;
+  *rid = tuple->GetRid();
+  return true;
+}
 
-auto TopNExecutor::GetNumInHeap() -> size_t { throw NotImplementedException("TopNExecutor is not implemented"); };
+auto TopNExecutor::GetNumInHeap() -> size_t { return top_entries_.size(); };
 
 }  // namespace bustub
@@ -0,0 +1,367 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.cpp
+//
+// Identification: src/execution/tuple_batch.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/tuple_batch.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "execution/expressions/abstract_expression.h"
+#include "type/limits.h"
+#include "type/type.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the number of 64-bit words for `count` bits */
+auto NumWords(size_t count) -> size_t { return (count + 63) / 64; }
+
+/** Store the unboxed form of non-NULL `value`, of type `type`, at `dst`. */
+void StoreValue(const Value &value, TypeId type, char *dst) {
+  switch (type) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      *reinterpret_cast<int8_t *>(dst) = value.GetAs<int8_t>();
+      break;
+    case TypeId::SMALLINT:
+      *reinterpret_cast<int16_t *>(dst) = value.GetAs<int16_t>();
+      break;
+    case TypeId::INTEGER:
+      *reinterpret_cast<int32_t *>(dst) = value.GetAs<int32_t>();
+      break;
+    case TypeId::BIGINT:
+      *reinterpret_cast<int64_t *>(dst) = value.GetAs<int64_t>();
+      break;
+    case TypeId::DECIMAL:
+      *reinterpret_cast<double *>(dst) = value.GetAs<double>();
+      break;
+    case TypeId::TIMESTAMP:
+      *reinterpret_cast<uint64_t *>(dst) = value.GetAs<uint64_t>();
+      break;
+    default:
+      UNREACHABLE("not a fixed-size type");
+  }
+}
+
+/** @return true if the serialized value at `data`, of fixed-size type `type`, is the NULL sentinel of the type */
+auto IsNullSentinel(const char *data, TypeId type) -> bool {
+  switch (type) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      return *reinterpret_cast<const int8_t *>(data) == BUSTUB_INT8_NULL;
+    case TypeId::SMALLINT:
+      return *reinterpret_cast<const int16_t *>(data) == BUSTUB_INT16_NULL;
+    case TypeId::INTEGER:
+      return *reinterpret_cast<const int32_t *>(data) == BUSTUB_INT32_NULL;
+    case TypeId::BIGINT:
+      return *reinterpret_cast<const int64_t *>(data) == BUSTUB_INT64_NULL;
+    case TypeId::DECIMAL:
+      return *reinterpret_cast<const double *>(data) == BUSTUB_DECIMAL_NULL;
+    case TypeId::TIMESTAMP:
+      return *reinterpret_cast<const uint64_t *>(data) == BUSTUB_TIMESTAMP_NULL;
+    default:
+      UNREACHABLE("not a fixed-size type");
+  }
+}
+
+}  // namespace
+
+auto ColumnVector::GetValue(size_t row) const -> Value {
+  if (width_ == 0) {
+    return values_[row];
+  }
+  if (IsNull(row)) {
+    return ValueFactory::GetNullValueByType(type_);
+  }
+  switch (type_) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      return {type_, GetData<int8_t>()[row]};
+    case TypeId::SMALLINT:
+      return {type_, GetData<int16_t>()[row]};
+    case TypeId::INTEGER:
+      return {type_, GetData<int32_t>()[row]};
+    case TypeId::BIGINT:
+      return {type_, GetData<int64_t>()[row]};
+    case TypeId::DECIMAL:
+      return {type_, GetData<double>()[row]};
+    case TypeId::TIMESTAMP:
+      return {type_, GetData<uint64_t>()[row]};
+    default:
+      UNREACHABLE("not a fixed-size type");
+  }
+}
+
+void ColumnVector::Append(const Value &value) {
+  if (width_ == 0) {
+    values_.push_back(value);
+    size_++;
+    return;
+  }
+  Reserve(size_ + 1);
+  auto row = size_++;
+  if (value.IsNull()) {
+    SetNull(row);
+    return;
+  }
+  if (has_nulls_) {
+    nulls_[row / 64] &= ~(uint64_t{1} << (row % 64));
+  }
+  auto *dst = reinterpret_cast<char *>(data_.data()) + row * width_;
+  if (value.GetTypeId() == type_) {
+    StoreValue(value, type_, dst);
+  } else {
+    StoreValue(value.CastAs(type_), type_, dst);
+  }
+}
+
+void ColumnVector::AppendRaw(const char *data) {
+  BUSTUB_ASSERT(width_ != 0, "only fixed-size values are appended raw");
+  Reserve(size_ + 1);
+  auto row = size_++;
+  if (IsNullSentinel(data, type_)) {
+    SetNull(row);
+    return;
+  }
+  if (has_nulls_) {
+    nulls_[row / 64] &= ~(uint64_t{1} << (row % 64));
+  }
+  memcpy(reinterpret_cast<char *>(data_.data()) + row * width_, data, width_);
+}
+
+void ColumnVector::Reset(TypeId type) {
+  type_ = type;
+  width_ = type == TypeId::INVALID || type == TypeId::VARCHAR ? 0 : Type::GetTypeSize(type);
+  size_ = 0;
+  has_nulls_ = false;
+  values_.clear();
+}
+
+void ColumnVector::Reserve(size_t size) {
+  auto words = NumWords(size * width_ * 8);
+  if (words > data_.size()) {
+    data_.resize(std::max(words, data_.size() * 2));
+  }
+  if (has_nulls_ && NumWords(size) > nulls_.size()) {
+    nulls_.resize(std::max(NumWords(size), nulls_.size() * 2));
+  }
+}
+
+void ColumnVector::Resize(size_t size) {
+  BUSTUB_ASSERT(width_ != 0, "only fixed-size columns are resized");
+  Reserve(size);
+  if (has_nulls_) {
+    for (auto row = size_; row < size; row++) {
+      nulls_[row / 64] &= ~(uint64_t{1} << (row % 64));
+    }
+  }
+  size_ = size;
+}
+
+void ColumnVector::SetNull(size_t row) {
+  if (width_ == 0) {
+    values_[row] = ValueFactory::GetNullValueByType(type_);
+    return;
+  }
+  if (!has_nulls_) {
+    // The bits of the rows after size_ stay clear, so appended rows are not NULL.
+    nulls_.assign(std::max(NumWords(size_), NumWords(data_.size() * 8 / width_)), 0);
+    has_nulls_ = true;
+  }
+  nulls_[row / 64] |= uint64_t{1} << (row % 64);
+}
+
+void ColumnVector::SetNullsFrom(const ColumnVector &lhs, const ColumnVector &rhs) {
+  BUSTUB_ASSERT(width_ != 0 && lhs.width_ != 0 && rhs.width_ != 0, "only fixed-size columns have NULL bitmaps");
+  if (!lhs.has_nulls_ && !rhs.has_nulls_) {
+    has_nulls_ = false;
+    return;
+  }
+  nulls_.assign(std::max(NumWords(size_), nulls_.size()), 0);
+  has_nulls_ = true;
+  for (size_t i = 0; i < NumWords(size_); i++) {
+    nulls_[i] = (lhs.has_nulls_ ? lhs.nulls_[i] : 0) | (rhs.has_nulls_ ? rhs.nulls_[i] : 0);
+  }
+}
+
+namespace {
+
+template <typename T>
+void GatherValues(const T *source, const std::vector<uint32_t> &rows, T *dst) {
+  for (size_t i = 0; i < rows.size(); i++) {
+    dst[i] = source[rows[i]];
+  }
+}
+
+}  // namespace
+
+void ColumnVector::Gather(const ColumnVector &source, const std::vector<uint32_t> &rows) {
+  Reset(source.type_);
+  if (width_ == 0) {
+    values_.reserve(rows.size());
+    for (auto row : rows) {
+      values_.push_back(source.values_[row]);
+    }
+    size_ = rows.size();
+    return;
+  }
+  Resize(rows.size());
+  // The rows are ascending, so if all of them are there they are in place.
+  if (rows.size() == source.size_) {
+    memcpy(data_.data(), source.data_.data(), rows.size() * width_);
+    if (source.has_nulls_) {
+      nulls_.assign(source.nulls_.begin(), source.nulls_.end());
+      has_nulls_ = true;
+    }
+    return;
+  }
+  switch (width_) {
+    case 1:
+      GatherValues(source.GetData<int8_t>(), rows, GetMutableData<int8_t>());
+      break;
+    case 2:
+      GatherValues(source.GetData<int16_t>(), rows, GetMutableData<int16_t>());
+      break;
+    case 4:
+      GatherValues(source.GetData<int32_t>(), rows, GetMutableData<int32_t>());
+      break;
+    default:
+      GatherValues(source.GetData<uint64_t>(), rows, GetMutableData<uint64_t>());
+      break;
+  }
+  if (source.has_nulls_) {
+    for (size_t i = 0; i < rows.size(); i++) {
+      if (source.IsNull(rows[i])) {
+        SetNull(i);
+      }
+    }
+  }
+}
+
+void ColumnVector::Fill(const Value &value, size_t count) {
+  Reset(value.GetTypeId());
+  if (width_ == 0) {
+    values_.assign(count, value);
+    size_ = count;
+    return;
+  }
+  Resize(count);
+  if (value.IsNull()) {
+    for (size_t i = 0; i < count; i++) {
+      SetNull(i);
+    }
+    return;
+  }
+  auto *dst = reinterpret_cast<char *>(data_.data());
+  for (size_t i = 0; i < count; i++) {
+    StoreValue(value, type_, dst + i * width_);
+  }
+}
+
+void TupleBatch::Reset(const Schema &schema) {
+  columns_.resize(schema.GetColumnCount());
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].Reset(schema.GetColumn(i).GetType());
+  }
+  selection_.clear();
+  num_rows_ = 0;
+}
+
+void TupleBatch::AppendRow(std::vector<Value> values) {
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].Append(std::move(values[i]));
+  }
+  FinishRows();
+}
+
+void TupleBatch::AppendTuple(const TupleRef &tuple, const Schema &schema, const std::vector<uint32_t> *column_ids) {
+  if (column_ids == nullptr) {
+    for (uint32_t i = 0; i < columns_.size(); i++) {
+      AppendColumnValue(tuple, schema, i);
+    }
+  } else {
+    auto column_id = column_ids->begin();
+    for (uint32_t i = 0; i < columns_.size(); i++) {
+      if (column_id != column_ids->end() && *column_id == i) {
+        AppendColumnValue(tuple, schema, i);
+        column_id++;
+      } else {
+        columns_[i].Append(ValueFactory::GetNullValueByType(columns_[i].GetType()));
+      }
+    }
+  }
+  FinishRows();
+}
+
+void TupleBatch::AppendColumnValue(const TupleRef &tuple, const Schema &schema, uint32_t column_idx) {
+  auto &column = columns_[column_idx];
+  if (column.IsFixedSize()) {
+    column.AppendRaw(tuple.GetData() + schema.GetColumn(column_idx).GetOffset());
+  } else {
+    column.Append(tuple.GetValue(&schema, column_idx));
+  }
+}
+
+void TupleBatch::Select(const AbstractExpression &predicate) {
+  ColumnVector result;
+  predicate.EvaluateBatch(*this, &result);
+  size_t num_selected = 0;
+  if (result.GetType() == TypeId::BOOLEAN && result.IsFixedSize()) {
+    const auto *data = result.GetData<int8_t>();
+    if (!result.HasNulls()) {
+      for (size_t i = 0; i < selection_.size(); i++) {
+        // Written unconditionally, so the loop has no branch on the predicate.
+        selection_[num_selected] = selection_[i];
+        num_selected += data[i] != 0 ? 1 : 0;
+      }
+    } else {
+      for (size_t i = 0; i < selection_.size(); i++) {
+        selection_[num_selected] = selection_[i];
+        num_selected += data[i] != 0 && !result.IsNull(i) ? 1 : 0;
+      }
+    }
+    selection_.resize(num_selected);
+    return;
+  }
+  for (size_t i = 0; i < selection_.size(); i++) {
+    auto value = result.GetValue(i);
+    if (!value.IsNull() && value.GetAs<bool>()) {
+      selection_[num_selected++] = selection_[i];
+    }
+  }
+  selection_.resize(num_selected);
+}
+
+void TupleBatch::Select(const std::vector<uint8_t> &keep) {
+  BUSTUB_ASSERT(keep.size() == selection_.size(), "one flag per selected row");
+  size_t num_selected = 0;
+  for (size_t i = 0; i < selection_.size(); i++) {
+    selection_[num_selected] = selection_[i];
+    num_selected += keep[i] != 0 ? 1 : 0;
+  }
+  selection_.resize(num_selected);
+}
+
+auto TupleBatch::GetRowValues(uint32_t row) const -> std::vector<Value> {
+  std::vector<Value> values;
+  values.reserve(columns_.size());
+  for (const auto &column : columns_) {
+    values.push_back(column.GetValue(row));
+  }
+  return values;
+}
+
+auto TupleBatch::GetTuple(uint32_t row, const Schema &schema) const -> Tuple {
+  return {GetRowValues(row), &schema};
+}
+
+}  // namespace bustub
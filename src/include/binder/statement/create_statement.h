@@ -12,6 +12,7 @@
 
 #include "binder/bound_statement.h"
 #include "catalog/column.h"
+#include "common/enums/table_layout.h"
 
 namespace duckdb_libpgquery {
 struct PGCreateStmt;
@@ -21,10 +22,12 @@ namespace bustub {
 
 class CreateStatement : public BoundStatement {
  public:
-  explicit CreateStatement(std::string table, std::vector<Column> columns);
+  explicit CreateStatement(std::string table, std::vector<Column> columns, TableLayout layout = TableLayout::ROW);
 
   std::string table_;
   std::vector<Column> columns_;
+  /** How the table stores its tuples, set by `WITH (storage = row | pax)` */
+  TableLayout layout_;
 
   auto ToString() const -> std::string override;
 };
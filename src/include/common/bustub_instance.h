@@ -41,6 +41,7 @@ class LogManager;
 class CheckpointManager;
 class Catalog;
 class ExecutionEngine;
+class TaskScheduler;
 
 class CreateStatement;
 class IndexStatement;
@@ -270,6 +271,12 @@ class BustubInstance {
     return "";
   }
 
+  /**
+   * Set the number of worker threads queries may run on, the `parallelism` session variable. With one worker, queries
+   * run on the calling thread only.
+   */
+  void SetParallelism(size_t num_workers);
+
   auto IsForceStarterRule() -> bool {
     auto variable = StringUtil::Lower(GetSessionVariable("force_optimizer_starter_rule"));
     return variable == "1" || variable == "true" || variable == "yes";
@@ -288,6 +295,11 @@ class BustubInstance {
   void HandleVariableSetStatement(Transaction *txn, const VariableSetStatement &stmt, ResultWriter &writer);
 
   std::unordered_map<std::string, std::string> session_variables_;
+
+  /** The workers of parallel pipelines, or nullptr if queries run on the calling thread only */
+  std::unique_ptr<TaskScheduler> task_scheduler_;
+  /** The memory an executor may use before it spills, the `work_mem` session variable */
+  size_t work_mem_{DEFAULT_WORK_MEM};
 };
 
 }  // namespace bustub
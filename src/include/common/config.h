@@ -21,6 +21,9 @@ namespace bustub {
 /** Cycle detection is performed every CYCLE_DETECTION_INTERVAL milliseconds. */
 extern std::chrono::milliseconds cycle_detection_interval;
 
+/** The background vacuum of the catalog visits its tables every VACUUM_INTERVAL milliseconds. */
+extern std::chrono::milliseconds vacuum_interval;
+
 /** True if logging should be enabled, false otherwise. */
 extern std::atomic<bool> enable_logging;
 
@@ -36,6 +39,8 @@ static constexpr int BUFFER_POOL_SIZE = 10;
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr size_t DEFAULT_WORK_MEM = 64 << 20;  // memory an operator may use before it spills, in bytes
+static constexpr size_t MAX_WORKERS_PER_CORE = 4;     // the parallelism of queries is capped to this many per core
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -0,0 +1,47 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_layout.h
+//
+// Identification: src/include/common/enums/table_layout.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/config.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+//===--------------------------------------------------------------------===//
+// Table Layouts
+//===--------------------------------------------------------------------===//
+enum class TableLayout : uint8_t {
+  ROW,         // slotted pages of whole tuples, see TablePage
+  PAX,         // pages split into one minipage per column, see PaxPage
+  COMPRESSED,  // pages of compressed column blocks and an uncompressed tail, see CompressedPage
+};
+
+}  // namespace bustub
+
+template <>
+struct fmt::formatter<bustub::TableLayout> : formatter<string_view> {
+  template <typename FormatContext>
+  auto format(bustub::TableLayout c, FormatContext &ctx) const {
+    string_view name;
+    switch (c) {
+      case bustub::TableLayout::ROW:
+        name = "row";
+        break;
+      case bustub::TableLayout::PAX:
+        name = "pax";
+        break;
+      case bustub::TableLayout::COMPRESSED:
+        name = "compressed";
+        break;
+    }
+    return formatter<string_view>::format(name, ctx);
+  }
+};
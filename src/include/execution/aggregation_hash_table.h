@@ -0,0 +1,229 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_hash_table.h
+//
+// Identification: src/include/execution/aggregation_hash_table.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "common/macros.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/tmp_tuple_file.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * AggregationHashTable groups rows by their group-by values and keeps the running aggregates of every group.
+ *
+ * The groups are stored flat. Each group is a row of 64-bit words, one per group-by value and one per aggregate
+ * state, followed by a word of NULL bits; the rows of a partition are one vector, and VARCHAR group-by values are
+ * kept in a byte heap next to it. Groups are found through an open-addressing table of (group, hash tag) slots with
+ * linear probing. Counts, and the sums, mins and maxes of integers and decimals are kept unboxed; other aggregates,
+ * e.g. the MIN of a VARCHAR, keep a boxed Value per group.
+ *
+ * The groups are split into NUM_PARTITIONS partitions by the high bits of their hash, so a group is in the same
+ * partition of every table. The workers of a parallel aggregation pre-aggregate into a table each, which are then
+ * merged one partition at a time, in parallel.
+ *
+ * A table that outgrows its memory budget spills its groups, as partial aggregates, to a TmpTupleFile per partition
+ * and starts over empty. The spilled groups of a partition are read back and merged before the partition is output,
+ * so only one partition at a time needs to fit into memory.
+ */
+class AggregationHashTable {
+ public:
+  static constexpr uint32_t RADIX_BITS = 4;
+  static constexpr uint32_t NUM_PARTITIONS = 1 << RADIX_BITS;
+
+  /**
+   * Create an empty table.
+   * @param group_by_types the types of the group-by values
+   * @param agg_types the types of aggregations
+   * @param input_types the types of the inputs of the aggregations
+   * @param bpm the buffer pool to spill to
+   * @param memory_limit the size, in bytes, above which the table spills
+   */
+  AggregationHashTable(std::vector<TypeId> group_by_types, const std::vector<AggregationType> &agg_types,
+                       const std::vector<TypeId> &input_types, BufferPoolManager *bpm, size_t memory_limit);
+
+  DISALLOW_COPY_AND_MOVE(AggregationHashTable);
+
+  /**
+   * Aggregate `num_rows` rows into their groups, spilling if the table grows past its memory limit.
+   * @param group_bys the group-by values of the rows, a column each
+   * @param inputs the inputs of the aggregations, a column each
+   */
+  void Aggregate(const std::vector<ColumnVector> &group_bys, const std::vector<ColumnVector> &inputs,
+                 size_t num_rows);
+
+  /**
+   * Merge partition `partition` of `other`, which aggregated other rows, into the same partition of this table, and
+   * empty it. Only that partition is touched, so different partitions may be merged concurrently. Groups spilled by
+   * `other` are taken over as they are, and merged by Unspill.
+   */
+  void MergePartition(AggregationHashTable *other, uint32_t partition);
+
+  /** Read the groups spilled from `partition` back, merging them into its groups in memory. Not thread-safe. */
+  void Unspill(uint32_t partition);
+
+  /** @return true if any group of this table has been spilled */
+  auto HasSpilled() const -> bool { return has_spilled_; }
+
+  /** @return the number of groups of `partition` in memory */
+  auto NumGroups(uint32_t partition) const -> size_t { return partitions_[partition].hashes_.size(); }
+
+  /** @return the group-by values followed by the aggregates of group `group` of `partition` */
+  auto GetGroup(uint32_t partition, size_t group) const -> std::vector<Value>;
+
+  /** Drop the groups of `partition`, releasing their memory. */
+  void ClearPartition(uint32_t partition);
+
+  /** @return the aggregates of a group that saw no rows, e.g. a count of 0 */
+  auto InitialAggregates() const -> std::vector<Value>;
+
+ private:
+  /** How an aggregation is kept, for the type of its input. */
+  enum class StateKind : uint8_t {
+    COUNT_STAR,
+    COUNT,
+    SUM_INTEGER,
+    MIN_INTEGER,
+    MAX_INTEGER,
+    SUM_DECIMAL,
+    MIN_DECIMAL,
+    MAX_DECIMAL,
+    /** A boxed Value, for the inputs of other types */
+    BOXED,
+  };
+
+  /** A slot of the open-addressing table of a partition. */
+  struct Slot {
+    /** The index of the group plus one, or 0 if the slot is empty */
+    uint32_t group_;
+    /** The high bits of the hash of the group, to skip most groups with another key without comparing it */
+    uint32_t tag_;
+  };
+
+  struct Partition {
+    /** The groups, RowWidth() words each */
+    std::vector<uint64_t> rows_;
+    /** The hash of each group */
+    std::vector<uint64_t> hashes_;
+    std::vector<Slot> slots_;
+    /** The VARCHAR group-by values, each a length followed by the bytes of the value */
+    std::vector<char> heap_;
+    /** The states of the BOXED aggregates, NumBoxed() per group */
+    std::vector<Value> boxed_;
+    /** The groups spilled from this partition, as partial aggregates */
+    std::vector<std::unique_ptr<TmpTupleFile>> spilled_;
+  };
+
+  /** The words of the rows of a batch, to look up their groups by. */
+  struct BatchKeys {
+    /** The group-by values of the rows, a column each, VARCHAR values as an index into `strings_` */
+    std::vector<std::vector<uint64_t>> words_;
+    /** The NULL bits of the group-by values of each row */
+    std::vector<uint64_t> nulls_;
+    std::vector<std::string_view> strings_;
+    std::vector<uint64_t> hashes_;
+    /** The group-by values cast to the types of the group-by columns, for the columns of other types */
+    std::vector<ColumnVector> casts_;
+  };
+
+  auto NumKeys() const -> size_t { return group_by_types_.size(); }
+  auto NumBoxed() const -> size_t { return num_boxed_; }
+  auto RowWidth() const -> size_t { return group_by_types_.size() + kinds_.size() + 1; }
+  auto PartitionOf(uint64_t hash) const -> uint32_t { return hash >> (64 - RADIX_BITS); }
+
+  /** @return how an aggregation of type `agg_type` of inputs of type `input_type` is kept */
+  static auto StateKindOf(AggregationType agg_type, TypeId input_type) -> StateKind;
+
+  /** @return the schema of the spilled groups: the group-by values, then the aggregate states */
+  static auto MakeSpillSchema(const std::vector<TypeId> &group_by_types, const std::vector<AggregationType> &agg_types,
+                              const std::vector<TypeId> &input_types) -> Schema;
+
+  /** Fill `keys_` with the words and hashes of the group-by values of `num_rows` rows. */
+  void EncodeKeys(const std::vector<const ColumnVector *> &group_bys, size_t num_rows);
+
+  /** Find the groups of the rows in `keys_`, inserting the missing ones, and point `group_rows_` at them. */
+  void FindGroups(size_t num_rows);
+
+  /** @return true if group `group` of `partition` has the group-by values of row `row` of `keys_` */
+  auto KeyEquals(const Partition &partition, uint32_t group, size_t row) const -> bool;
+
+  /**
+   * @return the group of `partition` with hash `hash` for which `equals(group)` is true, after inserting it with
+   * `insert()` if there is none
+   */
+  template <class Equals, class Insert>
+  auto FindOrInsert(Partition *partition, uint64_t hash, Equals equals, Insert insert) -> uint32_t;
+
+  /** Double the slots of `partition`, re-inserting its groups. */
+  static void Grow(Partition *partition);
+
+  /** Append a group with the group-by values of row `row` of `keys_` and the initial aggregates to `partition`. */
+  void InsertGroup(Partition *partition, size_t row);
+
+  /** Set the aggregates of the new group `row`, the last one of `partition`, to their initial states. */
+  void InitAggregates(Partition *partition, uint64_t *row);
+
+  /**
+   * Aggregate `column` into the state of aggregation `agg_idx` of the groups in `group_rows_`, one row each.
+   * @param partial true if `column` holds partial aggregates, as they are spilled, rather than inputs
+   */
+  void UpdateStates(uint32_t agg_idx, const ColumnVector &column, size_t num_rows, bool partial);
+
+  /** Merge the state of aggregation `agg_idx` of the group `src` into the one of the group `dst`. */
+  void MergeState(uint32_t agg_idx, uint64_t *dst, Value *dst_boxed, const uint64_t *src, const Value *src_boxed);
+
+  /** Combine the boxed state `value` of an aggregation of type `agg_type` with `input`, a value or partial state. */
+  static void CombineBoxed(AggregationType agg_type, Value *value, const Value &input);
+
+  /** @return the size of the groups in memory, in bytes */
+  auto MemoryUsage() const -> size_t;
+
+  /** Write the groups of all partitions out as partial aggregates, and empty the partitions. */
+  void Spill();
+
+  /** @return the group-by values, then the aggregate states as they are spilled, of group `group` of `partition` */
+  auto GetPartialGroup(const Partition &partition, size_t group) const -> std::vector<Value>;
+
+  /** @return the group-by value `key_idx` of group `row` of `partition` */
+  auto GetKey(const Partition &partition, const uint64_t *row, size_t key_idx) const -> Value;
+
+  /** @return the VARCHAR group-by value stored at `offset` of `heap` */
+  static auto GetString(const std::vector<char> &heap, uint64_t offset) -> std::string_view;
+
+  std::vector<TypeId> group_by_types_;
+  std::vector<AggregationType> agg_types_;
+  std::vector<TypeId> input_types_;
+  std::vector<StateKind> kinds_;
+  /** The index of the state of each BOXED aggregation among the boxed states of a group */
+  std::vector<uint32_t> boxed_index_;
+  size_t num_boxed_{0};
+  /** The group-by values and the partial aggregates of a spilled group */
+  Schema spill_schema_;
+  BufferPoolManager *bpm_;
+  size_t memory_limit_;
+  bool has_spilled_{false};
+  Partition partitions_[NUM_PARTITIONS];
+
+  /** Scratch space for the rows of a batch: their keys, and the group each one belongs to */
+  BatchKeys keys_;
+  std::vector<uint32_t> groups_;
+  std::vector<uint64_t *> group_rows_;
+  std::vector<Value *> group_boxed_;
+};
+
+}  // namespace bustub
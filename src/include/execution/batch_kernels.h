@@ -0,0 +1,44 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// batch_kernels.h
+//
+// Identification: src/include/execution/batch_kernels.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+enum class ComparisonType;
+enum class ArithmeticType;
+enum class LogicType;
+
+/**
+ * BatchKernels evaluate an operator over whole column vectors of unboxed values, one tight loop per combination of
+ * operator and C++ types, which the compiler can vectorize. NULLs are handled with the bitmaps of the vectors, apart
+ * from the loops.
+ *
+ * Each kernel returns false, and leaves `result` untouched, if it has no loop for the types of its inputs. The caller
+ * then evaluates the operator a value at a time.
+ */
+class BatchKernels {
+ public:
+  /** Compare `lhs` and `rhs` row by row into a BOOLEAN vector. Supports INTEGER, BIGINT and DECIMAL, mixed. */
+  static auto Compare(ComparisonType comp_type, const ColumnVector &lhs, const ColumnVector &rhs,
+                      ColumnVector *result) -> bool;
+
+  /** Compute `lhs` op `rhs` row by row. Supports INTEGER, BIGINT and DECIMAL, if both sides have the same type. */
+  static auto Compute(ArithmeticType compute_type, const ColumnVector &lhs, const ColumnVector &rhs,
+                      ColumnVector *result) -> bool;
+
+  /** Combine BOOLEAN vectors `lhs` and `rhs` row by row, with three-valued logic for NULLs. */
+  static auto Combine(LogicType logic_type, const ColumnVector &lhs, const ColumnVector &rhs, ColumnVector *result)
+      -> bool;
+};
+
+}  // namespace bustub
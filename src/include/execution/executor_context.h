@@ -14,6 +14,7 @@
 
 #include <deque>
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -22,10 +23,22 @@
 #include "concurrency/transaction.h"
 #include "execution/check_options.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/runtime_filter.h"
 #include "storage/page/tmp_tuple_page.h"
 
 namespace bustub {
 class AbstractExecutor;
+class AbstractPlanNode;
+class TaskScheduler;
+
+/**
+ * SharedExecutorState is the base class of the state that the copies of an executor share while they run a pipeline
+ * on several workers, such as the morsels of a scan. See ParallelPipeline.
+ */
+class SharedExecutorState {
+ public:
+  virtual ~SharedExecutorState() = default;
+};
 /**
  * ExecutorContext stores all the context necessary to run an executor.
  */
@@ -93,6 +106,51 @@ class ExecutorContext {
 
   auto IsDelete() const -> bool { return is_delete_; }
 
+  /** @return the scheduler to run parallel pipelines on, or nullptr to run all of a plan on the calling thread */
+  auto GetTaskScheduler() const -> TaskScheduler * { return task_scheduler_; }
+
+  void SetTaskScheduler(TaskScheduler *task_scheduler) { task_scheduler_ = task_scheduler; }
+
+  /** @return the memory, in bytes, that an executor may use for its hash tables or sort runs before it spills */
+  auto GetWorkMem() const -> size_t { return work_mem_; }
+
+  void SetWorkMem(size_t work_mem) { work_mem_ = work_mem; }
+
+  /** @return the state shared by the copies of the executor of `plan` in a running ParallelPipeline, or nullptr */
+  auto GetSharedState(const AbstractPlanNode *plan) const -> SharedExecutorState * {
+    auto iter = shared_states_.find(plan);
+    return iter == shared_states_.end() ? nullptr : iter->second;
+  }
+
+  /** Set the state shared by the copies of the executor of `plan`, which the caller owns, or remove it if nullptr. */
+  void SetSharedState(const AbstractPlanNode *plan, SharedExecutorState *state) {
+    if (state == nullptr) {
+      shared_states_.erase(plan);
+    } else {
+      shared_states_[plan] = state;
+    }
+  }
+
+  /** @return the Bloom filter a hash join published under `id`, or nullptr if it has not built one */
+  auto GetRuntimeFilter(uint32_t id) const -> std::shared_ptr<const BloomFilter> {
+    auto iter = runtime_filters_.find(id);
+    return iter == runtime_filters_.end() ? nullptr : iter->second;
+  }
+
+  /** Publish the Bloom filter of a hash join under `id`, or nullptr if the scans it is pushed into must not filter. */
+  void SetRuntimeFilter(uint32_t id, std::shared_ptr<const BloomFilter> filter) {
+    runtime_filters_[id] = std::move(filter);
+  }
+
+  /** @return the filter a TopN published under `id`, or nullptr if it has not published one */
+  auto GetTopNFilter(uint32_t id) const -> std::shared_ptr<TopNFilter> {
+    auto iter = topn_filters_.find(id);
+    return iter == topn_filters_.end() ? nullptr : iter->second;
+  }
+
+  /** Publish the filter of a TopN under `id`, for the scan below it. */
+  void SetTopNFilter(uint32_t id, std::shared_ptr<TopNFilter> filter) { topn_filters_[id] = std::move(filter); }
+
  private:
   /** The transaction context associated with this executor context */
   Transaction *transaction_;
@@ -109,6 +167,19 @@ class ExecutorContext {
   /** The set of check options associated with this executor context */
   std::shared_ptr<CheckOptions> check_options_;
   bool is_delete_;
+  /** The scheduler for parallel pipelines, if any */
+  TaskScheduler *task_scheduler_{nullptr};
+  size_t work_mem_{DEFAULT_WORK_MEM};
+  /**
+   * The shared states of the executors of the parallel pipelines being set up or run. Only the thread that runs the
+   * query uses them, as the copies of the executors are initialized there.
+   */
+  std::unordered_map<const AbstractPlanNode *, SharedExecutorState *> shared_states_;
+  /** The Bloom filters of the hash joins with a runtime filter, by id. The joins publish them before their probe side
+      is initialized, on the thread that runs the query. */
+  std::unordered_map<uint32_t, std::shared_ptr<const BloomFilter>> runtime_filters_;
+  /** The filters of the TopNs with a dynamic filter, by id, published before the TopNs initialize their child */
+  std::unordered_map<uint32_t, std::shared_ptr<TopNFilter>> topn_filters_;
 };
 
 }  // namespace bustub
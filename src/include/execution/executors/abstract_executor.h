@@ -13,6 +13,7 @@
 #pragma once
 
 #include "execution/executor_context.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -21,6 +22,7 @@ class ExecutorContext;
  * The AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
  * This is the base class from which all executors in the BustTub execution
  * engine inherit, and defines the minimal interface that all executors support.
+ * Executors may also produce their output a batch at a time with NextBatch.
  */
 class AbstractExecutor {
  public:
@@ -47,6 +49,44 @@ class AbstractExecutor {
    */
   virtual auto Next(Tuple *tuple, RID *rid) -> bool = 0;
 
+  /**
+   * Yield the next tuple from this executor without copying it, if the executor can. The tuple is valid until the
+   * next call to NextRef or Next. Executors that keep their output in memory anyway (a scan batch, a pass-through
+   * filter) override this; the default reads the tuple with Next into a buffer that is reused across calls.
+   * @param[out] tuple The next tuple produced by this executor
+   * @param[out] rid The next tuple RID produced by this executor
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  virtual auto NextRef(TupleRef *tuple, RID *rid) -> bool {
+    if (!Next(&next_ref_buffer_, rid)) {
+      return false;
+    }
+    *tuple = next_ref_buffer_;
+    return true;
+  }
+
+  /**
+   * @return `true` if NextBatch produces batches without going through Next, for this executor and all executors it
+   * pulls batches from. ExecutionEngine only drives a plan with NextBatch if its root executor returns `true`.
+   */
+  virtual auto SupportsBatch() const -> bool { return false; }
+
+  /**
+   * Yield the next batch of up to TUPLE_BATCH_SIZE tuples from this executor. Executors for which SupportsBatch is
+   * `true` override this; the default fills the batch from Next, a tuple at a time.
+   * @param[out] batch The next tuples produced by this executor, as the selected rows of the batch
+   * @return `true` if the batch has at least one selected row, `false` if there are no more tuples, in which case the
+   * batch is left without rows
+   */
+  virtual auto NextBatch(TupleBatch *batch) -> bool {
+    batch->Reset(GetOutputSchema());
+    RID rid;
+    while (!batch->IsFull() && Next(&next_ref_buffer_, &rid)) {
+      batch->AppendTuple(next_ref_buffer_, GetOutputSchema());
+    }
+    return batch->NumSelected() > 0;
+  }
+
   /** @return The schema of the tuples that this executor produces */
   virtual auto GetOutputSchema() const -> const Schema & = 0;
 
@@ -56,5 +96,9 @@ class AbstractExecutor {
  protected:
   /** The executor context in which the executor runs */
   ExecutorContext *exec_ctx_;
+
+ private:
+  /** Holds the tuple of the default NextRef and NextBatch. */
+  Tuple next_ref_buffer_;
 };
 }  // namespace bustub
@@ -48,6 +48,15 @@ class FilterExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /** Yield the next tuple that passes the filter as the child's view of it, without copying it. */
+  auto NextRef(TupleRef *tuple, RID *rid) -> bool override;
+
+  /** Filter the batches of the child. */
+  auto SupportsBatch() const -> bool override { return child_executor_->SupportsBatch(); }
+
+  /** Yield the next batch of the child with at least one tuple that passes the filter. */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the filter plan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
@@ -14,16 +14,38 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/join_hash_table.h"
 #include "execution/plans/hash_join_plan.h"
+#include "storage/table/tmp_tuple_file.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
+/** The state shared by the copies of a HashJoinExecutor in a ParallelPipeline: the table the first copy builds. */
+class SharedJoinTable : public SharedExecutorState {
+ public:
+  std::shared_ptr<const JoinHashTable> table_;
+  /**
+   * Set by the pipeline once all copies have read their probe side to its end, before it runs them a last time to
+   * join the partitions they spilled. Until then, the end of the probe side is only the end of a morsel.
+   */
+  bool probe_done_{false};
+};
+
 /**
- * HashJoinExecutor executes a nested-loop JOIN on two tables.
+ * HashJoinExecutor executes an equi-JOIN on two tables: it builds a JoinHashTable of the right side's tuples by their
+ * join keys in Init, and probes it with each tuple of the left side.
+ *
+ * The build side runs as a ParallelPipeline if it can, each worker building a table of its own which are merged at the
+ * end. In a parallel pipeline of the probe side, the copies of the executor share one table.
+ *
+ * If the table spills partitions, the left tuples of those partitions are spilled as well, and each spilled partition
+ * is joined once the left side is read to its end: its right tuples are read back into a table of the next level,
+ * which is probed with its left tuples. That table may spill in turn, the way of a Grace hash join.
  */
 class HashJoinExecutor : public AbstractExecutor {
  public:
@@ -48,12 +70,89 @@ class HashJoinExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /** Probe with the batches of the left child. The right child is read in batches in Init if it can be. */
+  auto SupportsBatch() const -> bool override { return left_executor_->SupportsBatch(); }
+
+  /** Yield the next joined tuples, probing with a batch of the left child at a time. */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the join */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
  private:
-  /** The NestedLoopJoin plan node to be executed. */
+  /** A spilled partition of a table, joined after the left side is read to its end. */
+  struct SpilledJoin {
+    /** The table the right tuples of the partition were spilled from */
+    std::shared_ptr<const JoinHashTable> table_;
+    uint32_t partition_;
+    /** The left tuples of the partition */
+    std::unique_ptr<TmpTupleFile> left_;
+  };
+
+  /** @return the hash table of the right child's tuples */
+  auto BuildTable() -> std::shared_ptr<const JoinHashTable>;
+
+  /** Insert the selected rows of `batch` of the right child into `table`. */
+  void BuildBatch(const TupleBatch &batch, JoinHashTable *table) const;
+
+  /** Insert the tuple with `values` and join keys `keys` into `table`, unless a key is NULL. */
+  static void Build(const std::vector<Value> &keys, const std::vector<Value> &values, JoinHashTable *table);
+
+  /**
+   * Read the next batch of left tuples into `left_batch_`, from the left child or from the left tuples of a spilled
+   * partition. Spilled partitions are started once there are no more.
+   * @return false if all left tuples have been probed with
+   */
+  auto NextLeftBatch() -> bool;
+
+  /** Read left tuples, from the spilled partition being joined or the left child, into `left_batch_`. */
+  auto ReadLeftBatch() -> bool;
+
+  /** Start joining the next spilled partition, if any, loading its right tuples into a table of their own. */
+  auto StartSpilledJoin() -> bool;
+
+  /** Probe with the next row of `left_batch_`, appending it to `batch` if it has no match in a left join. */
+  void Probe(TupleBatch *batch);
+
+  /** Append the left row `left_row` of `left_batch_` joined with the right `row`, or NULLs, to `batch`. */
+  void AppendJoinedRow(uint32_t left_row, const JoinHashTable::Row *row, TupleBatch *batch) const;
+
+  /** The HashJoin plan node to be executed. */
   const HashJoinPlanNode *plan_;
+
+  /** The child executor whose tuples probe the hash table */
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  /** The child executor whose tuples are put into the hash table */
+  std::unique_ptr<AbstractExecutor> right_executor_;
+
+  /** The schema of the rows of the hash table */
+  Schema build_schema_;
+  /** The state shared with the other copies of the executor, in a parallel pipeline */
+  SharedJoinTable *shared_{nullptr};
+  /** The hash table being probed, which the copies of the executor may share */
+  std::shared_ptr<const JoinHashTable> ht_;
+  /** The left tuples of the partitions `ht_` spilled, by partition */
+  std::vector<std::unique_ptr<TmpTupleFile>> spilled_left_;
+  /** The spilled partitions to join, the next one last */
+  std::vector<SpilledJoin> spilled_joins_;
+  /** The spilled partition being joined, and the reader of its left tuples */
+  std::unique_ptr<TmpTupleFile> left_file_;
+  std::unique_ptr<TmpTupleFile::Reader> left_reader_;
+
+  /** The current batch of left tuples, their join keys and the position of the next row to probe with */
+  TupleBatch left_batch_;
+  std::vector<ColumnVector> left_key_columns_;
+  size_t probe_pos_{0};
+  /** The row of `left_batch_` being probed with, its join keys and their hash */
+  uint32_t left_row_{0};
+  std::vector<Value> probe_keys_;
+  uint64_t probe_hash_{0};
+  /** The next match of the row being probed with, or nullptr */
+  const JoinHashTable::Row *match_{nullptr};
+
+  /** The joined tuples returned by Next, and the position of the next one */
+  TupleBatch output_;
+  size_t output_pos_{0};
 };
 
 }  // namespace bustub
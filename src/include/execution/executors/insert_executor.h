@@ -24,7 +24,8 @@ namespace bustub {
 
 /**
  * InsertExecutor executes an insert on a table.
- * Inserted values are always pulled from a child executor.
+ * Inserted values are always pulled from a child executor. They are inserted in batches with TableHeap::BulkInsert,
+ * and each index gets the keys of a batch at once, see Index::InsertEntries.
  */
 class InsertExecutor : public AbstractExecutor {
  public:
@@ -55,8 +56,15 @@ class InsertExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
  private:
+  /** The number of tuples pulled from the child and inserted together. */
+  static constexpr size_t BULK_INSERT_BATCH_SIZE = 4096;
+
   /** The insert plan node to be executed*/
   const InsertPlanNode *plan_;
+  /** The child executor from which inserted tuples are pulled */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** Whether the number of inserted rows has been produced */
+  bool done_{false};
 };
 
 }  // namespace bustub
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor.h
+//
+// Identification: src/include/execution/executors/merge_join_executor.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/merge_join_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * MergeJoinExecutor executes an equi-JOIN on two inputs sorted in ascending order on their join keys, reading both in
+ * step. For each left tuple, the right side is advanced past the smaller keys, and the run of right tuples with the
+ * same key is kept to be joined with it and with the left tuples of the same key that follow. Only that run is held
+ * in memory, without a hash table.
+ *
+ * The keys of both sides are compared as normalized keys, see KeyNormalizer, which order them the way the sort of the
+ * inputs does. NULL keys match nothing.
+ */
+class MergeJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new MergeJoinExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The merge join plan to be executed
+   * @param left_executor The child executor that produces tuples for the left side of join
+   * @param right_executor The child executor that produces tuples for the right side of join
+   */
+  MergeJoinExecutor(ExecutorContext *exec_ctx, const MergeJoinPlanNode *plan,
+                    std::unique_ptr<AbstractExecutor> &&left_executor,
+                    std::unique_ptr<AbstractExecutor> &&right_executor);
+
+  /** Initialize the join */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the join.
+   * @param[out] tuple The next tuple produced by the join
+   * @param[out] rid The next tuple RID, not used by merge join.
+   * @return `true` if a tuple was produced, `false` if there are no more tuples.
+   */
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+  /** @return The output schema for the join */
+  auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
+
+ private:
+  /**
+   * Set `key` to the normalized key of `exprs` evaluated on `tuple`, of schema `schema`.
+   * @return false if one of the keys is NULL
+   */
+  static auto EncodeKey(const std::vector<AbstractExpressionRef> &exprs, const Tuple &tuple, const Schema &schema,
+                        std::vector<char> *key) -> bool;
+
+  /** Read the next right tuple and its key, or set `right_done_` at the end of the right side. */
+  void NextRight();
+
+  /** Set the run to the right tuples with key `left_key_`, skipping the right tuples before it. */
+  void FindRun();
+
+  /** @return `left_tuple_` joined with the right tuple `right`, or with NULLs if it is nullptr */
+  auto MakeJoinedTuple(const Tuple *right) const -> Tuple;
+
+  /** The merge join plan node to be executed. */
+  const MergeJoinPlanNode *plan_;
+
+  /** The child executors of the left and right sides */
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  std::unique_ptr<AbstractExecutor> right_executor_;
+
+  /** The current left tuple and its key */
+  Tuple left_tuple_;
+  std::vector<char> left_key_;
+  /** The next right tuple not in the run and its key, which is empty if it has a NULL */
+  Tuple right_tuple_;
+  std::vector<char> right_key_;
+  bool right_done_{false};
+  /** The right tuples with key `run_key_`, and the one to join the current left tuple with next */
+  std::vector<Tuple> run_;
+  std::vector<char> run_key_;
+  size_t run_pos_{0};
+};
+
+}  // namespace bustub
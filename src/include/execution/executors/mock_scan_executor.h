@@ -13,11 +13,14 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/parallel_pipeline.h"
 #include "execution/plans/mock_scan_plan.h"
 #include "storage/table/tuple.h"
 
@@ -26,6 +29,25 @@ namespace bustub {
 extern const char *mock_table_list[];
 auto GetMockTableSchemaOf(const std::string &table) -> Schema;
 
+/** The morsels of a MockScanExecutor in a ParallelPipeline: ranges of rows, in the order of one shared shuffle. */
+class MockMorselSource : public MorselSource {
+ public:
+  MockMorselSource(size_t size, size_t rows_per_morsel, std::vector<size_t> shuffled_idx, size_t num_workers)
+      : MorselSource((size + rows_per_morsel - 1) / rows_per_morsel, num_workers),
+        rows_per_morsel_(rows_per_morsel),
+        shuffled_idx_(std::move(shuffled_idx)) {}
+
+  /** @return the number of rows of a morsel, all but the last one */
+  auto RowsPerMorsel() const -> size_t { return rows_per_morsel_; }
+
+  /** @return the shuffled row order, or an empty vector if the rows are not shuffled */
+  auto ShuffledIdx() const -> const std::vector<size_t> & { return shuffled_idx_; }
+
+ private:
+  size_t rows_per_morsel_;
+  std::vector<size_t> shuffled_idx_;
+};
+
 /**
  * The MockScanExecutor executor executes a sequential table scan for tests.
  */
@@ -49,10 +71,29 @@ class MockScanExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /** The mock rows are generated straight into the columns of a batch. */
+  auto SupportsBatch() const -> bool override { return true; }
+
+  /** Yield the next rows of the mock table. */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
+  /** @return the morsels to split the scan of `plan` into for `num_workers` workers, or nullptr if it is too small */
+  static auto MakeMorselSource(ExecutorContext *exec_ctx, const MockScanPlanNode *plan, size_t num_workers)
+      -> std::unique_ptr<MockMorselSource>;
+
  private:
+  /** The number of rows of a morsel in a parallel pipeline */
+  static constexpr size_t ROWS_PER_MORSEL = 16 * TUPLE_BATCH_SIZE;
+
+  /** Move on to the next assigned morsel in a parallel pipeline. @return false if there is none */
+  auto NextMorsel() -> bool;
+
+  /** @return the row to output at position `cursor` */
+  auto RowAt(size_t cursor) const -> size_t { return shuffled_idx_->empty() ? cursor : (*shuffled_idx_)[cursor]; }
+
   /** @return A dummy tuple according to the output schema */
   auto MakeDummyTuple() const -> Tuple;
 
@@ -70,15 +111,21 @@ class MockScanExecutor : public AbstractExecutor {
 
   /** The cursor for the current mock scan */
   std::size_t cursor_{0};
+  /** Where the scan, or the current morsel in a parallel pipeline, ends */
+  std::size_t end_{0};
+  /** The morsels of the scan in a parallel pipeline, or nullptr, and the worker this copy of the scan runs on */
+  MockMorselSource *morsels_{nullptr};
+  size_t worker_{0};
 
-  /** The table function */
-  std::function<Tuple(std::size_t)> func_;
+  /** The table function, which yields the values of a row */
+  std::function<std::vector<Value>(std::size_t)> func_;
 
   /** The size of the mock table */
   std::size_t size_;
 
-  /** The shuffled output */
-  std::vector<size_t> shuffled_idx_;
+  /** The shuffled output of this scan, made by the first Init, and the one in use, which a parallel scan shares */
+  std::vector<size_t> own_shuffled_idx_;
+  const std::vector<size_t> *shuffled_idx_{&own_shuffled_idx_};
 };
 
 }  // namespace bustub
@@ -47,6 +47,12 @@ class ProjectionExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /** Compute the expressions over the batches of the child. */
+  auto SupportsBatch() const -> bool override { return child_executor_->SupportsBatch(); }
+
+  /** Yield the projection of the next batch of the child, a column at a time. */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the projection plan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
@@ -56,5 +62,8 @@ class ProjectionExecutor : public AbstractExecutor {
 
   /** The child executor from which tuples are obtained */
   std::unique_ptr<AbstractExecutor> child_executor_;
+
+  /** The batch of the child being projected */
+  TupleBatch child_batch_;
 };
 }  // namespace bustub
@@ -12,15 +12,41 @@
 
 #pragma once
 
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <utility>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/parallel_pipeline.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
+#include "storage/table/zone_map.h"
 
 namespace bustub {
 
+/** The morsels of a SeqScanExecutor in a ParallelPipeline: ranges of pages of a ParallelTableScan. */
+class TableMorselSource : public MorselSource {
+ public:
+  TableMorselSource(std::unique_ptr<ParallelTableScan> scan, size_t pages_per_morsel, size_t num_workers)
+      : MorselSource((scan->GetNumPages() + pages_per_morsel - 1) / pages_per_morsel, num_workers),
+        scan_(std::move(scan)),
+        pages_per_morsel_(pages_per_morsel) {}
+
+  /** @return an iterator over the pages of morsel `morsel` */
+  auto MakeIterator(size_t morsel) -> TableIterator {
+    auto begin = morsel * pages_per_morsel_;
+    return scan_->MakeIterator(begin, std::min(begin + pages_per_morsel_, scan_->GetNumPages()));
+  }
+
+ private:
+  std::unique_ptr<ParallelTableScan> scan_;
+  size_t pages_per_morsel_;
+};
+
 /**
  * The SeqScanExecutor executor executes a sequential table scan.
  */
@@ -44,11 +70,51 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /** Yield the next tuple as a view into the current batch, without copying it. */
+  auto NextRef(TupleRef *tuple, RID *rid) -> bool override;
+
+  /** The scan reads a page at a time anyway. */
+  auto SupportsBatch() const -> bool override { return true; }
+
+  /** Yield the next tuples that pass the filter predicate, decoded into the columns of `batch`. */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
+  /** @return the morsels to split the scan of `plan` into for `num_workers` workers, or nullptr if it is too small */
+  static auto MakeMorselSource(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan, size_t num_workers)
+      -> std::unique_ptr<TableMorselSource>;
+
  private:
+  /** Read the next page into `batch_`, moving on to the next assigned morsel in a parallel pipeline. */
+  auto NextPage(const std::vector<uint32_t> *column_ids) -> bool;
+
+  /** @return false if the runtime filter shows `tuple` has no match in the hash join it comes from */
+  auto PassesRuntimeFilter(const TupleRef &tuple) -> bool;
+
+  /** Drop the selected rows of `batch` that the runtime filter shows have no match. */
+  void SelectRuntimeFilter(TupleBatch *batch);
+
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
+  /** The iterator over the scanned table, or over the current morsel in a parallel pipeline */
+  std::optional<TableIterator> iterator_;
+  /** The morsels of the scan in a parallel pipeline, or nullptr, and the worker this copy of the scan runs on */
+  TableMorselSource *morsels_{nullptr};
+  size_t worker_{0};
+  /** The tuples of the current page, read a page at a time */
+  TupleViewBatch batch_;
+  /** The position of the next tuple in `batch_` */
+  size_t batch_pos_{0};
+  /** The bounds implied by the filter predicate, then the bound of the TopN filter, to skip pages by their zones */
+  std::vector<ZoneBound> zone_bounds_;
+  size_t num_predicate_bounds_{0};
+  /** The Bloom filter of the hash join the scan feeds, or nullptr if the plan has none or the join did not build it */
+  std::shared_ptr<const BloomFilter> runtime_filter_;
+  /** The join keys of the tuple being checked against the runtime filter, kept to reuse their memory across tuples */
+  std::vector<Value> runtime_filter_keys_;
+  /** The filter of the TopN the scan feeds, or nullptr if the plan has none */
+  std::shared_ptr<TopNFilter> topn_filter_;
 };
 }  // namespace bustub
@@ -17,14 +17,23 @@
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/loser_tree.h"
+#include "execution/normalized_key.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "execution/plans/sort_plan.h"
+#include "storage/table/tmp_tuple_file.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
  * The SortExecutor executor executes a sort.
+ *
+ * Each input tuple is stored as a record: the size of its normalized key, the normalized key, then the tuple. The
+ * records are copied into chunks of memory, radix sorted by the first bytes of their keys, and by memcmp of the whole
+ * keys if those tie. When the records outgrow the memory budget of the query, they are sorted and spilled to a
+ * TmpTupleFile as a run, and the runs are merged with a loser tree at the end, in several passes if there are more
+ * runs than pages in the budget.
  */
 class SortExecutor : public AbstractExecutor {
  public:
@@ -46,11 +55,90 @@ class SortExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /** Yield the next tuple as a view into its record, without copying it. */
+  auto NextRef(TupleRef *tuple, RID *rid) -> bool override;
+
   /** @return The output schema for the sort */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** A record in memory, with the first bytes of its key to compare most records without following the pointer. */
+  struct SortEntry {
+    /** The first 8 bytes of the key, big-endian, padded with zeros */
+    uint64_t prefix_;
+    const char *record_;
+    uint32_t size_;
+  };
+
+  /** RunMerger merges sorted runs of records with a loser tree. */
+  class RunMerger {
+   public:
+    explicit RunMerger(std::vector<std::unique_ptr<TmpTupleFile>> runs);
+
+    DISALLOW_COPY_AND_MOVE(RunMerger);
+
+    /** @return the next record in order, valid until the next call, or nullptr after the last one */
+    auto Next() -> const Tuple *;
+
+   private:
+    struct Less {
+      const RunMerger *merger_;
+      auto operator()(size_t a, size_t b) const -> bool;
+    };
+
+    /** Read the next record of run `run`. */
+    void Advance(size_t run);
+
+    std::vector<std::unique_ptr<TmpTupleFile>> runs_;
+    std::vector<std::unique_ptr<TmpTupleFile::Reader>> readers_;
+    /** The current record of each run */
+    std::vector<Tuple> records_;
+    std::vector<bool> done_;
+    LoserTree<Less> tree_;
+    bool started_{false};
+  };
+
+  /** Copy `tuple` and its normalized key into a record in memory. */
+  void AddRecord(const TupleRef &tuple);
+
+  /** Sort the records in memory by their keys, radix sorting them by their prefixes. */
+  void SortEntries();
+
+  /** Sort the records in memory, and write them out as a run. */
+  void SpillRun();
+
+  /** @return the size of the memory of the records, in bytes. The entries keep their capacity across runs. */
+  auto MemoryUsage() const -> size_t { return chunk_bytes_ + entries_.size() * sizeof(SortEntry); }
+
+  /** @return true if the record of `a` comes before the one of `b` */
+  static auto EntryLess(const SortEntry &a, const SortEntry &b) -> bool;
+
+  /** @return the key of record `record` */
+  static auto GetKey(const char *record) -> std::pair<const char *, uint32_t>;
+
+  /** @return the tuple of record `record` of size `size` */
+  static auto GetTuple(const char *record, uint32_t size) -> TupleRef;
+
   /** The sort plan node to be executed */
   const SortPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  KeyNormalizer normalizer_;
+  /**
+   * The memory of the records. A chunk is never grown past the capacity it is allocated with, so records do not
+   * move.
+   */
+  std::vector<std::vector<char>> chunks_;
+  size_t chunk_bytes_{0};
+  /** The records in memory, sorted once the input is read if no run was spilled */
+  std::vector<SortEntry> entries_;
+  /** The range of the sizes of the keys of the records */
+  uint32_t min_key_size_;
+  uint32_t max_key_size_;
+  size_t next_entry_{0};
+  /** The spilled runs, until they are merged */
+  std::vector<std::unique_ptr<TmpTupleFile>> runs_;
+  /** The merge of the runs, if any were spilled */
+  std::unique_ptr<RunMerger> merger_;
+  std::vector<char> key_;
 };
 }  // namespace bustub
@@ -18,6 +18,8 @@
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/normalized_key.h"
+#include "execution/runtime_filter.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "execution/plans/topn_plan.h"
 #include "storage/table/tuple.h"
@@ -26,6 +28,10 @@ namespace bustub {
 
 /**
  * The TopNExecutor executor executes a topn.
+ *
+ * The executor keeps the first N tuples seen so far in a max-heap by their normalized keys, so a tuple that does not
+ * make it is rejected with a memcmp against the largest one, without being copied. If the plan has a TopN filter, the
+ * largest key is also published to the scan below, which then drops such tuples before they are produced.
  */
 class TopNExecutor : public AbstractExecutor {
  public:
@@ -63,5 +69,23 @@ class TopNExecutor : public AbstractExecutor {
   const TopNPlanNode *plan_;
   /** The child executor from which tuples are obtained */
   std::unique_ptr<AbstractExecutor> child_executor_;
+
+  struct TopEntry {
+    std::vector<char> key_;
+    Tuple tuple_;
+  };
+
+  /** @return true if `a` comes before `b` */
+  static auto EntryLess(const TopEntry &a, const TopEntry &b) -> bool {
+    return KeyNormalizer::Compare(a.key_.data(), a.key_.size(), b.key_.data(), b.key_.size()) < 0;
+  }
+
+  KeyNormalizer normalizer_;
+  /** The first N tuples by key, a max-heap while the input is read, then sorted */
+  std::vector<TopEntry> top_entries_;
+  size_t next_entry_{0};
+  std::vector<char> key_;
+  /** The filter published to the scan below, or nullptr if the plan has none */
+  std::shared_ptr<TopNFilter> topn_filter_;
 };
 }  // namespace bustub
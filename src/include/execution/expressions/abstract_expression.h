@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "execution/tuple_batch.h"
 #include "fmt/format.h"
 #include "storage/table/tuple.h"
 
@@ -52,7 +53,12 @@ class AbstractExpression {
   virtual ~AbstractExpression() = default;
 
   /** @return The value obtained by evaluating the tuple with the given schema */
-  virtual auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value = 0;
+  auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value {
+    return Evaluate(tuple == nullptr ? TupleRef{} : TupleRef{*tuple}, schema);
+  }
+
+  /** @return The value obtained by evaluating the tuple with the given schema, read in place */
+  virtual auto Evaluate(const TupleRef &tuple, const Schema &schema) const -> Value = 0;
 
   /**
    * Returns the value obtained by evaluating a JOIN.
@@ -62,9 +68,22 @@ class AbstractExpression {
    * @param right_schema The right tuple's schema
    * @return The value obtained by evaluating a JOIN on the left and right
    */
-  virtual auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
+  auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
+                    const Schema &right_schema) const -> Value {
+    return EvaluateJoin(TupleRef{*left_tuple}, left_schema, TupleRef{*right_tuple}, right_schema);
+  }
+
+  /** Returns the value obtained by evaluating a JOIN, with both tuples read in place. */
+  virtual auto EvaluateJoin(const TupleRef &left_tuple, const Schema &left_schema, const TupleRef &right_tuple,
                             const Schema &right_schema) const -> Value = 0;
 
+  /**
+   * Evaluate the expression for the selected rows of a batch, a column at a time. A column value reads the column of
+   * `batch` whatever its tuple index, so the batch has the schema the expression is evaluated with.
+   * @param[out] result the value for each selected row of `batch`, in the order of the selection
+   */
+  virtual void EvaluateBatch(const TupleBatch &batch, ColumnVector *result) const = 0;
+
   /** @return the child_idx'th child of this expression */
   auto GetChildAt(uint32_t child_idx) const -> const AbstractExpressionRef & { return children_[child_idx]; }
 
@@ -20,6 +20,7 @@
 #include "catalog/schema.h"
 #include "common/exception.h"
 #include "common/macros.h"
+#include "execution/batch_kernels.h"
 #include "execution/expressions/abstract_expression.h"
 #include "fmt/format.h"
 #include "storage/table/tuple.h"
@@ -44,7 +45,7 @@ class ArithmeticExpression : public AbstractExpression {
     }
   }
 
-  auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value override {
+  auto Evaluate(const TupleRef &tuple, const Schema &schema) const -> Value override {
     Value lhs = GetChildAt(0)->Evaluate(tuple, schema);
     Value rhs = GetChildAt(1)->Evaluate(tuple, schema);
     auto res = PerformComputation(lhs, rhs);
@@ -54,7 +55,7 @@ class ArithmeticExpression : public AbstractExpression {
     return ValueFactory::GetIntegerValue(*res);
   }
 
-  auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
+  auto EvaluateJoin(const TupleRef &left_tuple, const Schema &left_schema, const TupleRef &right_tuple,
                     const Schema &right_schema) const -> Value override {
     Value lhs = GetChildAt(0)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
     Value rhs = GetChildAt(1)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
@@ -65,6 +66,22 @@ class ArithmeticExpression : public AbstractExpression {
     return ValueFactory::GetIntegerValue(*res);
   }
 
+  void EvaluateBatch(const TupleBatch &batch, ColumnVector *result) const override {
+    ColumnVector lhs;
+    ColumnVector rhs;
+    GetChildAt(0)->EvaluateBatch(batch, &lhs);
+    GetChildAt(1)->EvaluateBatch(batch, &rhs);
+    if (lhs.GetType() == TypeId::INTEGER && BatchKernels::Compute(compute_type_, lhs, rhs, result)) {
+      return;
+    }
+    result->Reset(TypeId::INTEGER);
+    for (size_t i = 0; i < lhs.Size(); i++) {
+      auto res = PerformComputation(lhs.GetValue(i), rhs.GetValue(i));
+      result->Append(res == std::nullopt ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                                         : ValueFactory::GetIntegerValue(*res));
+    }
+  }
+
   /** @return the string representation of the expression node and its children */
   auto ToString() const -> std::string override {
     return fmt::format("({}{}{})", *GetChildAt(0), compute_type_, *GetChildAt(1));
@@ -79,11 +96,14 @@ class ArithmeticExpression : public AbstractExpression {
     if (lhs.IsNull() || rhs.IsNull()) {
       return std::nullopt;
     }
+    // Computed unsigned, so an overflow wraps around as it does in BatchKernels::Compute, instead of being UB.
+    auto l = static_cast<uint32_t>(lhs.GetAs<int32_t>());
+    auto r = static_cast<uint32_t>(rhs.GetAs<int32_t>());
     switch (compute_type_) {
       case ArithmeticType::Plus:
-        return lhs.GetAs<int32_t>() + rhs.GetAs<int32_t>();
+        return static_cast<int32_t>(l + r);
       case ArithmeticType::Minus:
-        return lhs.GetAs<int32_t>() - rhs.GetAs<int32_t>();
+        return static_cast<int32_t>(l - r);
       default:
         UNREACHABLE("Unsupported arithmetic type.");
     }
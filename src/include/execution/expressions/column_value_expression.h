@@ -35,14 +35,26 @@ class ColumnValueExpression : public AbstractExpression {
   ColumnValueExpression(uint32_t tuple_idx, uint32_t col_idx, TypeId ret_type)
       : AbstractExpression({}, ret_type), tuple_idx_{tuple_idx}, col_idx_{col_idx} {}
 
-  auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value override {
-    return tuple->GetValue(&schema, col_idx_);
+  auto Evaluate(const TupleRef &tuple, const Schema &schema) const -> Value override {
+    return tuple.GetValue(&schema, col_idx_);
   }
 
-  auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
+  auto EvaluateJoin(const TupleRef &left_tuple, const Schema &left_schema, const TupleRef &right_tuple,
                     const Schema &right_schema) const -> Value override {
-    return tuple_idx_ == 0 ? left_tuple->GetValue(&left_schema, col_idx_)
-                           : right_tuple->GetValue(&right_schema, col_idx_);
+    return tuple_idx_ == 0 ? left_tuple.GetValue(&left_schema, col_idx_)
+                           : right_tuple.GetValue(&right_schema, col_idx_);
+  }
+
+  void EvaluateBatch(const TupleBatch &batch, ColumnVector *result) const override {
+    const auto &column = batch.GetColumn(col_idx_);
+    if (column.GetType() == GetReturnType()) {
+      result->Gather(column, batch.GetSelection());
+      return;
+    }
+    result->Reset(GetReturnType());
+    for (auto row : batch.GetSelection()) {
+      result->Append(column.GetValue(row));
+    }
   }
 
   auto GetTupleIdx() const -> uint32_t { return tuple_idx_; }
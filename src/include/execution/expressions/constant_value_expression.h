@@ -27,13 +27,17 @@ class ConstantValueExpression : public AbstractExpression {
   /** Creates a new constant value expression wrapping the given value. */
   explicit ConstantValueExpression(const Value &val) : AbstractExpression({}, val.GetTypeId()), val_(val) {}
 
-  auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value override { return val_; }
+  auto Evaluate(const TupleRef &tuple, const Schema &schema) const -> Value override { return val_; }
 
-  auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
+  auto EvaluateJoin(const TupleRef &left_tuple, const Schema &left_schema, const TupleRef &right_tuple,
                     const Schema &right_schema) const -> Value override {
     return val_;
   }
 
+  void EvaluateBatch(const TupleBatch &batch, ColumnVector *result) const override {
+    result->Fill(val_, batch.NumSelected());
+  }
+
   /** @return the string representation of the plan node and its children */
   auto ToString() const -> std::string override { return val_.ToString(); }
 
@@ -55,19 +55,28 @@ class StringExpression : public AbstractExpression {
     return result;
   }
 
-  auto Evaluate(const Tuple *tuple, const Schema &schema) const -> Value override {
+  auto Evaluate(const TupleRef &tuple, const Schema &schema) const -> Value override {
     Value val = GetChildAt(0)->Evaluate(tuple, schema);
     auto str = val.GetAs<char *>();
     return ValueFactory::GetVarcharValue(Compute(str));
   }
 
-  auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
+  auto EvaluateJoin(const TupleRef &left_tuple, const Schema &left_schema, const TupleRef &right_tuple,
                     const Schema &right_schema) const -> Value override {
     Value val = GetChildAt(0)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
     auto str = val.GetAs<char *>();
     return ValueFactory::GetVarcharValue(Compute(str));
   }
 
+  void EvaluateBatch(const TupleBatch &batch, ColumnVector *result) const override {
+    ColumnVector args;
+    GetChildAt(0)->EvaluateBatch(batch, &args);
+    result->Reset(TypeId::VARCHAR);
+    for (size_t i = 0; i < args.Size(); i++) {
+      result->Append(ValueFactory::GetVarcharValue(Compute(args.GetValue(i).GetAs<char *>())));
+    }
+  }
+
   /** @return the string representation of the expression node and its children */
   auto ToString() const -> std::string override { return fmt::format("{}({})", expr_type_, *GetChildAt(0)); }
 
@@ -0,0 +1,176 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_hash_table.h
+//
+// Identification: src/include/execution/join_hash_table.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "common/macros.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/runtime_filter.h"
+#include "storage/table/tmp_tuple_file.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * JoinHashTable holds the build side of a hash join: the rows of the build side by the hash of their join keys.
+ *
+ * Each row is a tuple of the build schema, its hash followed by its join keys and its values, copied into chunks of
+ * memory that never move. The rows are split into NUM_PARTITIONS partitions by the high bits of their hash, and each
+ * partition gets a directory of its own, sized to its rows, so a probe only touches the directory of one partition.
+ * The rows of a bucket are chained through a pointer in front of each row, and the directory holds the pointer to
+ * the first one in its low 48 bits. The high 16 bits are a tag, with one bit set per hash in the chain, so most
+ * probes of a key that is not in the table stop at the directory.
+ *
+ * A table that outgrows its memory budget spills its largest partitions, one at a time, to TmpTupleFiles, and
+ * appends the later rows of a spilled partition to its file. The hash join then spills the probe rows of the
+ * partition as well, and joins the two once the rest is done, building a table of the next level from the spilled
+ * rows. That table partitions them by the next bits of the hash, so a partition too large for the budget is split
+ * again.
+ */
+class JoinHashTable {
+ public:
+  static constexpr uint32_t RADIX_BITS = 4;
+  static constexpr uint32_t NUM_PARTITIONS = 1 << RADIX_BITS;
+  /** The deepest level that spills. A table of this level keeps all its rows, e.g. of one key, in memory. */
+  static constexpr uint32_t MAX_LEVEL = 5;
+
+  /**
+   * Create an empty table.
+   * @param build_schema the schema of the rows, see MakeBuildSchema
+   * @param num_keys the number of join keys
+   * @param bpm the buffer pool to spill to
+   * @param memory_limit the size, in bytes, above which the table spills
+   * @param level the number of times the rows have been partitioned before, 0 for the build side of a join
+   */
+  JoinHashTable(const Schema &build_schema, size_t num_keys, BufferPoolManager *bpm, size_t memory_limit,
+                uint32_t level = 0);
+
+  DISALLOW_COPY_AND_MOVE(JoinHashTable);
+
+  /** @return the schema of the rows of the table: the hash, the join keys, then the columns of `schema` */
+  static auto MakeBuildSchema(const std::vector<AbstractExpressionRef> &key_exprs, const Schema &schema) -> Schema;
+
+  /** @return the hash of the join keys `keys`, none of which is NULL */
+  static auto HashKeys(const std::vector<Value> &keys) -> uint64_t;
+
+  /** @return the row of the build schema for a tuple with the join keys `keys`, of hash `hash`, and values `values` */
+  auto MakeRow(uint64_t hash, const std::vector<Value> &keys, const std::vector<Value> &values) const -> Tuple;
+
+  /** Insert `row`, a tuple of the build schema, spilling if the table grows past its memory limit. */
+  void Insert(const TupleRef &row);
+
+  /** Take over the rows of `other`, which has the same schema and level, leaving it empty. */
+  void Merge(JoinHashTable *other);
+
+  /** Build the directories of the partitions in memory, after the last row is inserted. */
+  void Finalize();
+
+  /** @return a Bloom filter of the hashes of the rows, once finalized, or nullptr if some rows have been spilled */
+  auto MakeBloomFilter() const -> std::shared_ptr<const BloomFilter>;
+
+  /** @return the level of the table */
+  auto Level() const -> uint32_t { return level_; }
+
+  /** @return the partition of the rows with hash `hash` */
+  auto PartitionOf(uint64_t hash) const -> uint32_t {
+    return (hash >> (64 - RADIX_BITS * (level_ + 1))) & (NUM_PARTITIONS - 1);
+  }
+
+  /** @return true if the rows of `partition` have been spilled */
+  auto IsSpilled(uint32_t partition) const -> bool { return partitions_[partition].spilled_; }
+
+  /** @return the files the rows of the spilled partition `partition` are in */
+  auto GetSpilledRows(uint32_t partition) const -> const std::vector<std::unique_ptr<TmpTupleFile>> & {
+    return partitions_[partition].files_;
+  }
+
+  /** A row of the table. The tuple follows the header. */
+  struct Row {
+    /** The next row of the bucket, or nullptr */
+    const Row *next_;
+    uint32_t size_;
+    uint32_t padding_;
+  };
+
+  /**
+   * Find the rows with the join keys `keys` with hash `hash`, in a partition in memory.
+   * @param row the last match, or nullptr to find the first one
+   * @return the next match after `row`, or nullptr if there is none
+   */
+  auto FindNext(uint64_t hash, const std::vector<Value> &keys, const Row *row) const -> const Row *;
+
+  /** @return the tuple of `row`, of the build schema */
+  static auto GetTuple(const Row *row) -> TupleRef {
+    return {RID{}, reinterpret_cast<const char *>(row + 1), row->size_};
+  }
+
+ private:
+  static constexpr size_t MIN_CHUNK_SIZE = 1024;
+  static constexpr size_t MAX_CHUNK_SIZE = 64 * 1024;
+  static constexpr uint64_t POINTER_MASK = (uint64_t{1} << 48) - 1;
+
+  struct Partition {
+    /** The memory of the rows. A chunk is never grown past the capacity it is allocated with, so rows do not move. */
+    std::vector<std::vector<char>> chunks_;
+    size_t num_rows_{0};
+    /** The first row of each bucket and the tag of its hashes, once the table is finalized */
+    std::vector<uint64_t> directory_;
+    bool spilled_{false};
+    /** The rows of a spilled partition. Rows inserted after it is spilled are appended to the last file. */
+    std::vector<std::unique_ptr<TmpTupleFile>> files_;
+  };
+
+  /** @return the hash of a row, its first column */
+  static auto GetHash(const TupleRef &row) -> uint64_t {
+    return *reinterpret_cast<const uint64_t *>(row.GetData());
+  }
+
+  /** @return the bit of the tag of a bucket for hash `hash` */
+  static auto TagOf(uint64_t hash) -> uint64_t { return uint64_t{1} << (48 + ((hash >> 32) & 15)); }
+
+  /** @return the size of a row with a tuple of `size` bytes in a chunk, rounded up to keep the rows aligned */
+  static auto RowSize(uint32_t size) -> size_t { return sizeof(Row) + ((size + 7) & ~size_t{7}); }
+
+  /** @return true if the rows of `partition` may be spilled */
+  auto CanSpill() const -> bool { return bpm_ != nullptr && level_ < MAX_LEVEL; }
+
+  /** Copy `row` into the chunks of `partition`. */
+  void Append(Partition *partition, const TupleRef &row);
+
+  /** Call `f(row)` on every row in the chunks of `partition`, in the order they were appended. */
+  template <class F>
+  static void ForEachRow(Partition *partition, F f);
+
+  /** Spill the largest partitions in memory while the table is over its memory limit. */
+  void SpillIfNeeded();
+
+  /** Write the rows of `partition` out, release their memory and append its later rows to its file. */
+  void Spill(Partition *partition);
+
+  /** @return the size of the chunks of `partition`, in bytes */
+  static auto ChunkBytes(const Partition &partition) -> size_t;
+
+  Schema build_schema_;
+  size_t num_keys_;
+  BufferPoolManager *bpm_;
+  size_t memory_limit_;
+  uint32_t level_;
+  /** The size of the chunks of the partitions in memory, in bytes */
+  size_t memory_usage_{0};
+  Partition partitions_[NUM_PARTITIONS];
+};
+
+}  // namespace bustub
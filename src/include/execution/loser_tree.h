@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// loser_tree.h
+//
+// Identification: src/include/execution/loser_tree.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * LoserTree picks the smallest of the current elements of `k` sorted sources for a k-way merge. Each inner node of
+ * the tree holds the source that lost the match played there, and the root the overall winner, so replacing the
+ * winner only replays the matches on the path from its leaf to the root: log2(k) comparisons, one per level, without
+ * the two per level of a binary heap.
+ *
+ * The tree does not see the elements. `less(a, b)` tells if the current element of source `a` comes before the one of
+ * source `b`, and must treat an exhausted source as larger than any element.
+ */
+template <class Less>
+class LoserTree {
+ public:
+  LoserTree(size_t k, Less less) : k_(k), less_(std::move(less)), tree_(k) {}
+
+  /** Play all matches, once every source has its first element. */
+  void Init() { tree_[0] = Build(1); }
+
+  /** @return the source with the smallest current element */
+  auto Top() const -> size_t { return tree_[0]; }
+
+  /** Replay the matches of the winner, after it moved on to its next element. */
+  void Replay() {
+    auto winner = tree_[0];
+    for (auto node = (winner + k_) / 2; node > 0; node /= 2) {
+      if (less_(tree_[node], winner)) {
+        std::swap(tree_[node], winner);
+      }
+    }
+    tree_[0] = winner;
+  }
+
+ private:
+  /** Play the matches below `node`. The leaves are the nodes k to 2k - 1. @return the winner */
+  auto Build(size_t node) -> size_t {
+    if (node >= k_) {
+      return node - k_;
+    }
+    auto winner = Build(2 * node);
+    auto loser = Build(2 * node + 1);
+    if (less_(loser, winner)) {
+      std::swap(winner, loser);
+    }
+    tree_[node] = loser;
+    return winner;
+  }
+
+  size_t k_;
+  Less less_;
+  /** The loser of the match at each inner node, 1 to k - 1, and the winner at 0 */
+  std::vector<size_t> tree_;
+};
+
+}  // namespace bustub
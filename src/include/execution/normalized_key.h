@@ -0,0 +1,139 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// normalized_key.h
+//
+// Identification: src/include/execution/normalized_key.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "binder/bound_order_by.h"
+#include "catalog/schema.h"
+#include "execution/expressions/abstract_expression.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * KeyNormalizer encodes the ORDER BY keys of a tuple into a normalized key: a byte string such that comparing the
+ * normalized keys of two tuples with memcmp orders them as the keys would, so a sort compares bytes instead of
+ * dispatching to the Type of each Value.
+ *
+ * Each key is a NULL byte followed by its value. Integers are stored big-endian with the sign bit flipped, decimals
+ * by the bits of the double flipped to order as unsigned integers, and VARCHARs as their bytes, with 0 escaped as
+ * 0x00 0xFF, followed by 0x00 0x00, so a string comes before its extensions. The bytes of a DESC key are inverted.
+ * NULLs come last in ascending order and first in descending order.
+ *
+ * A key that is a fixed-size column is encoded from the bytes of the tuple, without evaluating it to a Value.
+ */
+class KeyNormalizer {
+ public:
+  explicit KeyNormalizer(std::vector<std::pair<OrderByType, AbstractExpressionRef>> order_bys);
+
+  /** Append the normalized key of `tuple`, of schema `schema`, to `key`. */
+  void Encode(const TupleRef &tuple, const Schema &schema, std::vector<char> *key) const;
+
+  /** Append the normalized form of `value` to `key`, inverted if `descending`. */
+  static void AppendValue(const Value &value, bool descending, std::vector<char> *key);
+
+  /**
+   * Append the normalized form of the value of fixed-size type `type` serialized at `data` to `key`, inverted if
+   * `descending`.
+   */
+  static void AppendRaw(TypeId type, const char *data, bool descending, std::vector<char> *key);
+
+  /** @return a negative number, zero or a positive number as normalized key `a` is before, equal to or after `b` */
+  static auto Compare(const char *a, size_t a_size, const char *b, size_t b_size) -> int {
+    auto result = memcmp(a, b, std::min(a_size, b_size));
+    if (result != 0 || a_size == b_size) {
+      return result;
+    }
+    return a_size < b_size ? -1 : 1;
+  }
+
+  /** @return the first 8 bytes of normalized key `key` as a big-endian integer, padded with zeros */
+  static auto Prefix(const char *key, size_t size) -> uint64_t {
+    uint64_t prefix = 0;
+    for (size_t i = 0; i < std::min<size_t>(size, sizeof(prefix)); i++) {
+      prefix |= static_cast<uint64_t>(static_cast<uint8_t>(key[i])) << (56 - 8 * i);
+    }
+    return prefix;
+  }
+
+ private:
+  std::vector<std::pair<OrderByType, AbstractExpressionRef>> order_bys_;
+  /** The column each key reads, if it is a column of the tuple, or -1 */
+  std::vector<int64_t> column_ids_;
+};
+
+/**
+ * Sort `entries` by normalized key. Each entry has the prefix of its key, see KeyNormalizer::Prefix, in `prefix_`.
+ *
+ * The entries are radix sorted by their prefixes, a byte at a time from the last one, skipping the bytes all of them
+ * share. If `may_tie` is set, some keys are longer than their prefix, or of different sizes, and the runs of entries
+ * with the same prefix are then sorted with `less`.
+ */
+template <class Entry, class Less>
+void SortByNormalizedKey(std::vector<Entry> *entries, bool may_tie, Less less) {
+  // Below a few hundred entries, the passes over the counts cost more than comparing.
+  static constexpr size_t MIN_RADIX_SORT_SIZE = 256;
+  auto &items = *entries;
+  auto size = items.size();
+  if (size < MIN_RADIX_SORT_SIZE) {
+    std::sort(items.begin(), items.end(), less);
+    return;
+  }
+
+  std::vector<std::array<size_t, 256>> counts(8);
+  for (auto &count : counts) {
+    count.fill(0);
+  }
+  for (const auto &entry : items) {
+    for (size_t byte = 0; byte < 8; byte++) {
+      counts[byte][(entry.prefix_ >> (8 * byte)) & 0xFF]++;
+    }
+  }
+  std::vector<Entry> buffer(size);
+  for (size_t byte = 0; byte < 8; byte++) {
+    auto &count = counts[byte];
+    if (count[(items[0].prefix_ >> (8 * byte)) & 0xFF] == size) {
+      continue;
+    }
+    size_t offset = 0;
+    for (auto &bucket : count) {
+      auto bucket_size = bucket;
+      bucket = offset;
+      offset += bucket_size;
+    }
+    for (const auto &entry : items) {
+      buffer[count[(entry.prefix_ >> (8 * byte)) & 0xFF]++] = entry;
+    }
+    items.swap(buffer);
+  }
+
+  if (!may_tie) {
+    return;
+  }
+  for (size_t begin = 0; begin < size;) {
+    auto end = begin + 1;
+    while (end < size && items[end].prefix_ == items[begin].prefix_) {
+      end++;
+    }
+    if (end - begin > 1) {
+      std::sort(items.begin() + begin, items.begin() + end, less);
+    }
+    begin = end;
+  }
+}
+
+}  // namespace bustub
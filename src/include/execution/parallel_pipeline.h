@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_pipeline.h
+//
+// Identification: src/include/execution/parallel_pipeline.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/task_scheduler.h"
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * MorselSource is the state shared by the copies of a scan in a ParallelPipeline: the scan is split into morsels,
+ * numbered from 0, and each task of the pipeline assigns one to the copy of the scan of its worker.
+ */
+class MorselSource : public SharedExecutorState {
+ public:
+  MorselSource(size_t num_morsels, size_t num_workers) : num_morsels_(num_morsels), assigned_(num_workers) {}
+
+  /** @return the number of morsels */
+  auto NumMorsels() const -> size_t { return num_morsels_; }
+
+  /** Register a copy of the scan, in its Init. @return the worker the copy runs on */
+  auto AddCopy() -> size_t {
+    BUSTUB_ASSERT(num_copies_ < assigned_.size(), "one copy of the scan per worker");
+    return num_copies_++;
+  }
+
+  /** Have the copy of the scan of `worker` read morsel `morsel` next. */
+  void Assign(size_t worker, size_t morsel) { assigned_[worker] = morsel; }
+
+  /** @return the morsel assigned to the copy of the scan of `worker`, once, or nullopt if there is none */
+  auto TakeMorsel(size_t worker) -> std::optional<size_t> {
+    auto morsel = assigned_[worker];
+    assigned_[worker].reset();
+    return morsel;
+  }
+
+ private:
+  size_t num_morsels_;
+  size_t num_copies_{0};
+  /** The morsel for each worker. Each slot is only used by the thread of its worker while the pipeline runs. */
+  std::vector<std::optional<size_t>> assigned_;
+};
+
+/**
+ * ParallelPipeline runs a pipeline, a scan with the filters, projections and hash join probes on top of it, on all the
+ * workers of the TaskScheduler of a query, so the pipeline breaker it feeds, e.g. an aggregation or the build side of
+ * a hash join, can consume it on all cores.
+ *
+ * Every worker gets its own copy of the executors of the pipeline. The scan is split into morsels, one task each,
+ * which the scheduler balances across the workers by work stealing. The copies share what they only need once, the
+ * morsels of the scan and the hash tables of the joins, through ExecutorContext::GetSharedState. The consumer keeps
+ * state per worker, e.g. a partial hash table, and merges it once Run returns.
+ */
+class ParallelPipeline {
+ public:
+  /** Called for each batch the pipeline outputs, on the worker that output it. */
+  using Consumer = std::function<void(size_t worker, const TupleBatch &batch)>;
+
+  /**
+   * Set up the pipeline rooted at `plan`, initializing the copies of its executors.
+   * @return the pipeline, or nullptr if `plan` should run on the calling thread: there is no scheduler with more than
+   * one worker, `plan` is not a pipeline over a scan, or the scan is too small to split.
+   */
+  static auto Make(ExecutorContext *exec_ctx, const AbstractPlanNodeRef &plan) -> std::unique_ptr<ParallelPipeline>;
+
+  DISALLOW_COPY_AND_MOVE(ParallelPipeline);
+
+  /** @return the number of workers, the indexes of which Run passes to the consumer */
+  auto NumWorkers() const -> size_t { return scheduler_->NumWorkers(); }
+
+  /** Run the pipeline to the end, passing every batch it outputs to `consume`. */
+  void Run(const Consumer &consume);
+
+ private:
+  explicit ParallelPipeline(TaskScheduler *scheduler) : scheduler_(scheduler) {}
+
+  TaskScheduler *scheduler_;
+  /** The states shared by the copies of the executors, by plan node */
+  std::vector<std::pair<const AbstractPlanNode *, std::unique_ptr<SharedExecutorState>>> shared_states_;
+  MorselSource *morsels_{nullptr};
+  /** The copy of the pipeline of each worker. Declared after the shared states, so it is destroyed first. */
+  std::vector<std::unique_ptr<AbstractExecutor>> copies_;
+};
+
+}  // namespace bustub
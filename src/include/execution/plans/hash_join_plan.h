@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -76,6 +77,9 @@ class HashJoinPlanNode : public AbstractPlanNode {
   /** The join type */
   JoinType join_type_;
 
+  /** The id to publish the Bloom filter of the build side's join keys under, set by the RuntimeFilter rule */
+  std::optional<uint32_t> runtime_filter_id_;
+
  protected:
   auto PlanNodeToString() const -> std::string override;
 };
@@ -13,14 +13,18 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "binder/table_ref/bound_base_table_ref.h"
 #include "catalog/catalog.h"
 #include "catalog/schema.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/runtime_filter.h"
+#include "fmt/ranges.h"
 
 namespace bustub {
 
@@ -62,12 +66,33 @@ class SeqScanPlanNode : public AbstractPlanNode {
   */
   AbstractExpressionRef filter_predicate_;
 
+  /** The columns read by the parent and the filter, set by the PruneScanColumns rule. The other columns of the output
+      may be NULL or not read from out of line, and must not be read. nullopt means all columns are read.
+  */
+  std::optional<std::vector<uint32_t>> column_ids_;
+
+  /** The Bloom filter of the build side of a hash join the tuples must pass, set by the RuntimeFilter rule */
+  std::optional<RuntimeFilterProbe> runtime_filter_;
+
+  /** The id of the filter of the TopN the scan feeds, set by the SortLimitAsTopN rule */
+  std::optional<uint32_t> topn_filter_id_;
+
  protected:
   auto PlanNodeToString() const -> std::string override {
+    std::string columns;
+    if (column_ids_.has_value()) {
+      columns = fmt::format(", columns={}", *column_ids_);
+    }
+    if (runtime_filter_.has_value()) {
+      columns += fmt::format(", runtime_filter=#{} on {}", runtime_filter_->id_, runtime_filter_->keys_);
+    }
+    if (topn_filter_id_.has_value()) {
+      columns += fmt::format(", topn_filter=#{}", *topn_filter_id_);
+    }
     if (filter_predicate_) {
-      return fmt::format("SeqScan {{ table={}, filter={} }}", table_name_, filter_predicate_);
+      return fmt::format("SeqScan {{ table={}, filter={}{} }}", table_name_, filter_predicate_, columns);
     }
-    return fmt::format("SeqScan {{ table={} }}", table_name_);
+    return fmt::format("SeqScan {{ table={}{} }}", table_name_, columns);
   }
 };
 
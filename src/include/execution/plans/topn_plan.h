@@ -13,6 +13,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -61,6 +62,9 @@ class TopNPlanNode : public AbstractPlanNode {
   std::vector<std::pair<OrderByType, AbstractExpressionRef>> order_bys_;
   std::size_t n_;
 
+  /** The id under which the TopN publishes its threshold to the scan below it, set by the SortLimitAsTopN rule */
+  std::optional<uint32_t> topn_filter_id_;
+
  protected:
   auto PlanNodeToString() const -> std::string override;
 };
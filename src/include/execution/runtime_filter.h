@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// runtime_filter.h
+//
+// Identification: src/include/execution/runtime_filter.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "binder/bound_order_by.h"
+#include "catalog/schema.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/normalized_key.h"
+#include "storage/table/tuple.h"
+#include "storage/table/zone_map.h"
+
+namespace bustub {
+
+/**
+ * BloomFilter is a blocked Bloom filter of 64-bit hashes. A hash picks one 256-bit block by its high half and sets one
+ * bit in each of the eight 32-bit words of the block by its low half, so an insert or a lookup touches a single cache
+ * line. With BITS_PER_KEY bits per key, well under one percent of the hashes that were not inserted pass.
+ */
+class BloomFilter {
+ public:
+  static constexpr size_t BITS_PER_KEY = 16;
+
+  /** Create a filter sized for `num_keys` keys. */
+  explicit BloomFilter(size_t num_keys) : blocks_(std::max<size_t>(1, num_keys * BITS_PER_KEY / 256)) {}
+
+  void Insert(uint64_t hash) {
+    auto &block = blocks_[BlockOf(hash)];
+    for (uint32_t i = 0; i < 8; i++) {
+      block.words_[i] |= BitOf(hash, i);
+    }
+  }
+
+  /** @return false if `hash` was certainly not inserted */
+  auto MayContain(uint64_t hash) const -> bool {
+    const auto &block = blocks_[BlockOf(hash)];
+    uint32_t missing = 0;
+    for (uint32_t i = 0; i < 8; i++) {
+      missing |= ~block.words_[i] & BitOf(hash, i);
+    }
+    return missing == 0;
+  }
+
+ private:
+  struct alignas(32) Block {
+    uint32_t words_[8];
+  };
+
+  /** Odd constants to multiply the low half of a hash by, one per word, as in Parquet's split block Bloom filter */
+  static constexpr uint32_t SALT[8] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                       0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+  auto BlockOf(uint64_t hash) const -> size_t { return ((hash >> 32) * blocks_.size()) >> 32; }
+
+  static auto BitOf(uint64_t hash, uint32_t word) -> uint32_t {
+    return uint32_t{1} << ((static_cast<uint32_t>(hash) * SALT[word]) >> 27);
+  }
+
+  std::vector<Block> blocks_;
+};
+
+/**
+ * RuntimeFilterProbe is a runtime filter pushed into the scan of the probe side of a hash join, see the
+ * RuntimeFilter rule. The join publishes the Bloom filter of the hashes of its build side's join keys under `id_` once
+ * it is built, and the scan drops the tuples whose join keys `keys_` are not in it, which the join would not match.
+ */
+struct RuntimeFilterProbe {
+  uint32_t id_;
+  /** The join keys of the probe side, which read the output of the scan */
+  std::vector<AbstractExpressionRef> keys_;
+};
+
+/**
+ * TopNFilter is the dynamic filter a TopN pushes into the scan below it, see the SortLimitAsTopN rule. Once the heap of
+ * the TopN is full, only a tuple that sorts before the largest one in it, the threshold, can still enter it. The TopN
+ * lowers the threshold as it reads on, and the scan drops the tuples that do not sort before it. If the first key is a
+ * column, the scan also skips the pages whose zones show that none of their tuples can.
+ *
+ * The TopN and its scan run on one thread, so the filter is not synchronized.
+ */
+class TopNFilter {
+ public:
+  explicit TopNFilter(std::vector<std::pair<OrderByType, AbstractExpressionRef>> order_bys);
+
+  /** Set the threshold to `tuple`, of schema `schema`, whose normalized key is `key`. */
+  void SetThreshold(const std::vector<char> &key, const TupleRef &tuple, const Schema &schema);
+
+  /** @return false if `tuple`, of schema `schema`, does not sort before the threshold, so it cannot enter the TopN */
+  auto Passes(const TupleRef &tuple, const Schema &schema) -> bool;
+
+  /** @return the bound on the first key that the tuples before the threshold satisfy, or nullopt if there is none */
+  auto GetZoneBound() const -> const std::optional<ZoneBound> & { return zone_bound_; }
+
+ private:
+  KeyNormalizer normalizer_;
+  /** The column of the first key if it is a column of the tuple, and if it is descending */
+  std::optional<uint32_t> first_column_;
+  bool first_descending_{false};
+  /** The normalized key of the threshold, empty until the heap is full */
+  std::vector<char> threshold_;
+  std::optional<ZoneBound> zone_bound_;
+  /** The normalized key of the tuple being checked, kept to reuse its memory */
+  std::vector<char> key_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// task_scheduler.h
+//
+// Identification: src/include/execution/task_scheduler.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * TaskScheduler runs tasks on a fixed set of worker threads. Each worker has its own deque of tasks: it takes tasks
+ * from the back of its own deque, and once that is empty steals from the front of the deques of the other workers, so
+ * a worker that is done early takes over work from slower ones instead of idling.
+ */
+class TaskScheduler {
+ public:
+  /** A task, called with the index of the worker that runs it. */
+  using Task = std::function<void(size_t worker)>;
+
+  /** Start `num_workers` worker threads. */
+  explicit TaskScheduler(size_t num_workers);
+
+  /** Stop and join the workers. No RunAll may be running. */
+  ~TaskScheduler();
+
+  DISALLOW_COPY_AND_MOVE(TaskScheduler);
+
+  /** @return the number of workers, the indexes of which are 0 to NumWorkers() - 1 */
+  auto NumWorkers() const -> size_t { return workers_.size(); }
+
+  /**
+   * Run `tasks` on the workers and wait until all of them are done. The tasks are dealt to the workers in contiguous
+   * ranges, so neighbouring tasks, e.g. morsels of neighbouring pages, start out on the same worker. Must not be called
+   * from a task.
+   *
+   * If a task throws, the tasks that have not started yet are skipped, and the exception is rethrown.
+   */
+  void RunAll(const std::vector<Task> &tasks);
+
+ private:
+  /** The tasks of one call to RunAll. */
+  struct TaskGroup {
+    std::mutex latch_;
+    std::condition_variable done_;
+    size_t num_pending_;
+    std::atomic<bool> failed_{false};
+    std::exception_ptr exception_;
+  };
+
+  struct QueuedTask {
+    const Task *task_;
+    TaskGroup *group_;
+  };
+
+  struct Worker {
+    std::mutex latch_;
+    std::deque<QueuedTask> tasks_;
+    std::thread thread_;
+  };
+
+  void WorkerLoop(size_t worker);
+
+  /** Take a task for `worker`: the newest one of its own, or else the oldest one of another worker. */
+  auto TakeTask(size_t worker, QueuedTask *task) -> bool;
+
+  /** Run `task` on `worker`, and mark it done in its group. */
+  static void RunTask(size_t worker, const QueuedTask &task);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  /** Protects `stopping_`, and is held while tasks are queued, so an idle worker cannot miss them. */
+  std::mutex latch_;
+  std::condition_variable has_tasks_;
+  /** The number of tasks in the deques */
+  std::atomic<size_t> num_queued_{0};
+  bool stopping_{false};
+};
+
+}  // namespace bustub
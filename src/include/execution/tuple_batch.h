@@ -0,0 +1,191 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/execution/tuple_batch.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/macros.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+class AbstractExpression;
+
+/** The number of rows an executor puts into a TupleBatch at most. */
+static constexpr size_t TUPLE_BATCH_SIZE = 1024;
+
+/**
+ * ColumnVector holds the values of one column for the rows of a TupleBatch, or the results of an expression.
+ *
+ * Values of a fixed-size type are stored unboxed in a contiguous array of their C++ type (int8_t for BOOLEAN and
+ * TINYINT, int16_t, int32_t, int64_t, double for DECIMAL, uint64_t for TIMESTAMP), with NULLs kept in a separate
+ * bitmap, so kernels can run over them in tight loops (see BatchKernels). VARCHAR values are stored as Values.
+ */
+class ColumnVector {
+ public:
+  ColumnVector() = default;
+
+  explicit ColumnVector(TypeId type) { Reset(type); }
+
+  /** @return the type of the values */
+  auto GetType() const -> TypeId { return type_; }
+
+  /** @return the number of values */
+  auto Size() const -> size_t { return size_; }
+
+  /** @return true if the values are stored unboxed, and GetData can be used */
+  auto IsFixedSize() const -> bool { return width_ != 0; }
+
+  /** @return true if any value may be NULL. If false, no value is. */
+  auto HasNulls() const -> bool { return has_nulls_; }
+
+  /** @return true if the value of row `row` is NULL */
+  auto IsNull(size_t row) const -> bool {
+    if (width_ == 0) {
+      return values_[row].IsNull();
+    }
+    return has_nulls_ && ((nulls_[row / 64] >> (row % 64)) & 1) != 0;
+  }
+
+  /** @return the value of row `row` */
+  auto GetValue(size_t row) const -> Value;
+
+  /** @return the value of row `row` of a column that is not fixed-size, without copying it */
+  auto GetBoxedValue(size_t row) const -> const Value & { return values_[row]; }
+
+  /** Append `value` as the value of the next row. A value of another type is cast to the type of the column. */
+  void Append(const Value &value);
+
+  /** Append the value serialized at `data`, which is inlined in a tuple, as the value of the next row. */
+  void AppendRaw(const char *data);
+
+  /** Remove all values, and set their type to `type`. The memory is kept for the next values. */
+  void Reset(TypeId type);
+
+  /**
+   * Resize a fixed-size column to `size` rows, for a kernel to write them through GetMutableData. The values of new
+   * rows are undefined and not NULL.
+   */
+  void Resize(size_t size);
+
+  /** Set the value of row `row` to NULL. The stored value does not matter anymore. */
+  void SetNull(size_t row);
+
+  /** Mark the rows which are NULL in `lhs` or in `rhs`, which have the size of this column, as NULL. */
+  void SetNullsFrom(const ColumnVector &lhs, const ColumnVector &rhs);
+
+  /** Replace the values with the values of `source` at the rows `rows`, in order. */
+  void Gather(const ColumnVector &source, const std::vector<uint32_t> &rows);
+
+  /** Replace the values with `count` copies of `value`. */
+  void Fill(const Value &value, size_t count);
+
+  /** @return the unboxed values of a fixed-size column, as an array of the C++ type of the column type */
+  template <typename T>
+  auto GetData() const -> const T * {
+    BUSTUB_ASSERT(sizeof(T) == width_, "wrong C++ type for the column type");
+    return reinterpret_cast<const T *>(data_.data());
+  }
+
+  template <typename T>
+  auto GetMutableData() -> T * {
+    BUSTUB_ASSERT(sizeof(T) == width_, "wrong C++ type for the column type");
+    return reinterpret_cast<T *>(data_.data());
+  }
+
+ private:
+  /** Make room for `size` fixed-size values and their NULL bits. */
+  void Reserve(size_t size);
+
+  TypeId type_{TypeId::INVALID};
+  /** The size of a value of a fixed-size type, or 0 if the values are boxed in values_ */
+  uint32_t width_{0};
+  size_t size_{0};
+  /** The fixed-size values, in 64-bit words so any of the C++ types is aligned */
+  std::vector<uint64_t> data_;
+  /** One bit per row, set if the value is NULL. Only meaningful if has_nulls_ is true. */
+  std::vector<uint64_t> nulls_;
+  bool has_nulls_{false};
+  /** The boxed values of a VARCHAR column */
+  std::vector<Value> values_;
+};
+
+/**
+ * TupleBatch holds up to TUPLE_BATCH_SIZE rows, stored a column at a time, for executors that implement
+ * AbstractExecutor::NextBatch. A selection vector lists the rows of the batch that are part of the output, in order,
+ * so a filter drops rows without moving any value.
+ */
+class TupleBatch {
+ public:
+  /** Remove all rows, and set the batch up for rows of `schema`. */
+  void Reset(const Schema &schema);
+
+  /** @return the number of rows, selected or not */
+  auto NumRows() const -> size_t { return num_rows_; }
+
+  /** @return the number of columns */
+  auto NumColumns() const -> size_t { return columns_.size(); }
+
+  /** @return true if no more rows should be added */
+  auto IsFull() const -> bool { return num_rows_ >= TUPLE_BATCH_SIZE; }
+
+  /** @return the column `column_idx` */
+  auto GetColumn(uint32_t column_idx) const -> const ColumnVector & { return columns_[column_idx]; }
+  auto GetColumn(uint32_t column_idx) -> ColumnVector & { return columns_[column_idx]; }
+
+  /** @return the selected rows, in ascending order */
+  auto GetSelection() const -> const std::vector<uint32_t> & { return selection_; }
+
+  /** @return the number of selected rows */
+  auto NumSelected() const -> size_t { return selection_.size(); }
+
+  /** Append a selected row with `values`, one per column. */
+  void AppendRow(std::vector<Value> values);
+
+  /**
+   * Append a selected row with the values of `tuple`, which has the same schema as the batch.
+   * @param column_ids the columns to read, or nullptr for all. The other columns are NULL.
+   */
+  void AppendTuple(const TupleRef &tuple, const Schema &schema, const std::vector<uint32_t> *column_ids = nullptr);
+
+  /** Add `num_rows` selected rows to the batch, after their values have been appended to each column directly. */
+  void FinishRows(size_t num_rows = 1) {
+    for (size_t i = 0; i < num_rows; i++) {
+      selection_.push_back(num_rows_++);
+    }
+  }
+
+  /** Drop the selected rows for which `predicate` is not true. */
+  void Select(const AbstractExpression &predicate);
+
+  /** Drop the selected rows for which `keep`, one flag per selected row, is 0. */
+  void Select(const std::vector<uint8_t> &keep);
+
+  /** @return the values of row `row` */
+  auto GetRowValues(uint32_t row) const -> std::vector<Value>;
+
+  /** @return row `row` as a tuple of `schema`, which must be the schema of the batch */
+  auto GetTuple(uint32_t row, const Schema &schema) const -> Tuple;
+
+ private:
+  /** Append the value of column `column_idx` of `tuple` to the column. */
+  void AppendColumnValue(const TupleRef &tuple, const Schema &schema, uint32_t column_idx);
+
+  std::vector<ColumnVector> columns_;
+  std::vector<uint32_t> selection_;
+  size_t num_rows_{0};
+};
+
+}  // namespace bustub
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -88,10 +89,37 @@ class Optimizer {
       -> std::optional<std::tuple<index_oid_t, std::string>>;
 
   /**
-   * @brief optimize sort + limit as top N
+   * @brief record in a seq scan of a PAX or COMPRESSED table, or of a table with VARCHAR columns, which columns its
+   * parent projection or aggregation reads, so the scan can skip the other columns and their out-of-line values
+   */
+  auto OptimizePruneScanColumns(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief optimize sort + limit as top N, and push the threshold of the top N into the seq scan below it, if any
    */
   auto OptimizeSortLimitAsTopN(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
+  /**
+   * @brief turn a hash join whose inputs are both sorted on the join keys, by a sort, a top N or an index scan, into a
+   * merge join
+   */
+  auto OptimizeHashJoinAsMergeJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief push a Bloom filter of the join keys of the build side of an inner hash join into the seq scan of its probe
+   * side, if the build side is estimated to match a small enough fraction of the probe side
+   */
+  auto OptimizeRuntimeFilter(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief estimate the number of rows `plan` outputs, from the estimated cardinality or the size of the tables it
+   * scans and a fixed selectivity per filter
+   *
+   * @param apply_filters false to estimate the rows before the filters of the plan
+   * @return the estimate, or nullopt if the plan has a node the estimate does not know
+   */
+  auto EstimatePlanRows(const AbstractPlanNodeRef &plan, bool apply_filters) -> std::optional<double>;
+
   /**
    * @brief get the estimated cardinality for a table based on the table name. Useful when join reordering. BusTub
    * doesn't support statistics for now, so it's the only way for you to get the table size :(
@@ -107,6 +135,9 @@ class Optimizer {
   const Catalog &catalog_;
 
   const bool force_starter_rule_;
+
+  /** The id of the next runtime filter the RuntimeFilter or SortLimitAsTopN rule adds to the plan */
+  uint32_t next_runtime_filter_id_{0};
 };
 
 }  // namespace bustub
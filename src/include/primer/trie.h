@@ -1,15 +1,17 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <future>  // NOLINT
-#include <map>
 #include <memory>
 #include <optional>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <variant>
 #include <vector>
 
 namespace bustub {
@@ -40,6 +42,140 @@ class MoveBlocked {
   std::future<int> wait_;
 };
 
+class TrieNode;
+
+// TrieChildren is the child table of a TrieNode. It maps the next byte of the key to the child node and adapts its
+// layout to the fan-out, in the style of an adaptive radix tree:
+//
+// - Node1:   no child or a single child, stored inline in the node.
+// - Node4:   up to 4 children, sorted keys and child pointers in one out-of-line block.
+// - Node16:  up to 16 children, laid out like Node4.
+// - Node48:  up to 48 children, a 256-entry byte index into 48 child slots.
+// - Node256: a child pointer for every possible byte.
+//
+// Most trie nodes are leaves or have a single child, so the common case costs no allocation beyond the node itself,
+// and the table only takes 32 bytes in the node. Children are always enumerated in unsigned byte order, which is the
+// order `std::string` compares keys in.
+class TrieChildren {
+ public:
+  using NodePtr = std::shared_ptr<const TrieNode>;
+
+  TrieChildren() = default;
+  ~TrieChildren() = default;
+
+  // Copying a child table shares the children and picks the smallest layout that fits them.
+  TrieChildren(const TrieChildren &that);
+  auto operator=(const TrieChildren &that) -> TrieChildren &;
+  TrieChildren(TrieChildren &&that) noexcept = default;
+  auto operator=(TrieChildren &&that) noexcept -> TrieChildren & = default;
+
+  // Returns the child for `key`, or nullptr if there is none. This does not touch any reference count.
+  auto Find(char key) const -> const TrieNode *;
+
+  // Returns the owning pointer of the child for `key`, or nullptr if there is none.
+  auto FindShared(char key) const -> const NodePtr *;
+
+  // Returns the child with the smallest key byte that is not less than `from` (compared as unsigned bytes, so 256
+  // means past the end) and stores its key in `*key`. Returns nullptr if there is no such child.
+  auto LowerBound(uint16_t from, char *key) const -> const TrieNode *;
+
+  // Inserts or overwrites the child for `key`, growing the layout if it is full.
+  void Set(char key, NodePtr child);
+
+  // Removes the child for `key` if present, shrinking the layout if the children fit into a smaller one.
+  void Erase(char key);
+
+  auto Size() const -> size_t { return size_; }
+  auto Empty() const -> bool { return size_ == 0; }
+
+  // Calls `f(char key, const NodePtr &child)` for every child, in unsigned byte order.
+  template <class F>
+  void ForEach(F &&f) const {
+    auto for_each_sorted = [this, &f](const auto &node) {
+      for (size_t i = 0; i < size_; i++) {
+        f(static_cast<char>(node.keys_[i]), node.children_[i]);
+      }
+    };
+    switch (Kind()) {
+      case NODE1:
+        if (size_ == 1) {
+          f(static_cast<char>(key1_), std::get<NODE1>(table_));
+        }
+        break;
+      case NODE4:
+        for_each_sorted(*std::get<NODE4>(table_));
+        break;
+      case NODE16:
+        for_each_sorted(*std::get<NODE16>(table_));
+        break;
+      case NODE48: {
+        const auto &node = *std::get<NODE48>(table_);
+        for (size_t b = 0; b < BYTE_FANOUT; b++) {
+          if (node.index_[b] != 0) {
+            f(static_cast<char>(b), node.children_[node.index_[b] - 1]);
+          }
+        }
+        break;
+      }
+      case NODE256: {
+        const auto &node = *std::get<NODE256>(table_);
+        for (size_t b = 0; b < BYTE_FANOUT; b++) {
+          if (node.children_[b] != nullptr) {
+            f(static_cast<char>(b), node.children_[b]);
+          }
+        }
+        break;
+      }
+    }
+  }
+
+ private:
+  static constexpr size_t BYTE_FANOUT = 256;
+  static constexpr size_t NODE1_CAPACITY = 1;
+  static constexpr size_t NODE4_CAPACITY = 4;
+  static constexpr size_t NODE16_CAPACITY = 16;
+  static constexpr size_t NODE48_CAPACITY = 48;
+
+  // Layout tags, which are also the indices of `table_`.
+  static constexpr size_t NODE1 = 0;
+  static constexpr size_t NODE4 = 1;
+  static constexpr size_t NODE16 = 2;
+  static constexpr size_t NODE48 = 3;
+  static constexpr size_t NODE256 = 4;
+
+  // Node4 and Node16: the keys are sorted, and the child of `keys_[i]` is `children_[i]`.
+  template <size_t N>
+  struct SortedNode {
+    std::array<uint8_t, N> keys_{};
+    std::array<NodePtr, N> children_;
+  };
+  using Node4 = SortedNode<NODE4_CAPACITY>;
+  using Node16 = SortedNode<NODE16_CAPACITY>;
+
+  struct Node48 {
+    // 0 means no child, otherwise the child lives in `children_[index_[b] - 1]`.
+    std::array<uint8_t, BYTE_FANOUT> index_{};
+    std::array<NodePtr, NODE48_CAPACITY> children_;
+  };
+
+  struct Node256 {
+    std::array<NodePtr, BYTE_FANOUT> children_;
+  };
+
+  auto Kind() const -> size_t { return table_.index(); }
+
+  // Rebuilds the table in the smallest layout able to hold `capacity` children.
+  void Resize(size_t capacity);
+
+  uint16_t size_{0};
+  // The key of the only child of a Node1.
+  uint8_t key1_{0};
+  // A Node1 is its only child, or nullptr if it has none.
+  std::variant<NodePtr, std::unique_ptr<Node4>, std::unique_ptr<Node16>, std::unique_ptr<Node48>,
+               std::unique_ptr<Node256>>
+      table_;
+};
+
 // A TrieNode is a node in a Trie.
 class TrieNode {
  public:
@@ -47,7 +183,7 @@ class TrieNode {
   TrieNode() = default;
 
   // Create a TrieNode with some children.
-  explicit TrieNode(std::map<char, std::shared_ptr<const TrieNode>> children) : children_(std::move(children)) {}
+  explicit TrieNode(TrieChildren children) : children_(std::move(children)) {}
 
   virtual ~TrieNode() = default;
 
@@ -60,8 +196,18 @@ class TrieNode {
   // Note: if you want to convert `unique_ptr` into `shared_ptr`, you can use `std::shared_ptr<T>(std::move(ptr))`.
   virtual auto Clone() const -> std::unique_ptr<TrieNode> { return std::make_unique<TrieNode>(children_); }
 
-  // A map of children, where the key is the next character in the key, and the value is the next TrieNode.
-  std::map<char, std::shared_ptr<const TrieNode>> children_;
+  // CloneShared is the same as Clone, but allocates the node and its reference count in a single block. Path copying
+  // uses this one.
+  virtual auto CloneShared() const -> std::shared_ptr<TrieNode> { return std::make_shared<TrieNode>(children_); }
+
+  // CloneWithChildren returns a copy of this TrieNode, keeping its value if it has one, with `children` as its
+  // children. Unlike Clone, it does not copy the old children.
+  virtual auto CloneWithChildren(TrieChildren children) const -> std::shared_ptr<const TrieNode> {
+    return std::make_shared<const TrieNode>(std::move(children));
+  }
+
+  // The children of this node, keyed by the next character in the key.
+  TrieChildren children_;
 
   // Indicates if the node is the terminal node.
   bool is_value_node_{false};
@@ -78,7 +224,7 @@ class TrieNodeWithValue : public TrieNode {
   explicit TrieNodeWithValue(std::shared_ptr<T> value) : value_(std::move(value)) { this->is_value_node_ = true; }
 
   // Create a trie node with children and a value.
-  TrieNodeWithValue(std::map<char, std::shared_ptr<const TrieNode>> children, std::shared_ptr<T> value)
+  TrieNodeWithValue(TrieChildren children, std::shared_ptr<T> value)
       : TrieNode(std::move(children)), value_(std::move(value)) {
     this->is_value_node_ = true;
   }
@@ -90,14 +236,30 @@ class TrieNodeWithValue : public TrieNode {
     return std::make_unique<TrieNodeWithValue<T>>(children_, value_);
   }
 
+  auto CloneShared() const -> std::shared_ptr<TrieNode> override {
+    return std::make_shared<TrieNodeWithValue<T>>(children_, value_);
+  }
+
+  auto CloneWithChildren(TrieChildren children) const -> std::shared_ptr<const TrieNode> override {
+    return std::make_shared<const TrieNodeWithValue<T>>(std::move(children), value_);
+  }
+
   // The value associated with this trie node.
   std::shared_ptr<T> value_;
 };
 
+template <class T>
+class TrieIterator;
+class WriteBatch;
+
 // A Trie is a data structure that maps strings to values of type T. All operations on a Trie should not
 // modify the trie itself. It should reuse the existing nodes as much as possible, and create new nodes to
 // represent the new trie.
 class Trie {
+  template <class T>
+  friend class TrieIterator;
+  friend class TrieSnapshot;
+
  private:
   // The root of the trie.
   std::shared_ptr<const TrieNode> root_{nullptr};
@@ -124,6 +286,68 @@ class Trie {
   // Remove the key from the trie. If the key does not exist, return the original trie.
   // Otherwise, returns the new trie.
   auto Remove(std::string_view key) const -> Trie;
+
+  // Apply all puts and removes in `batch` and return the new trie. The writes are sorted and applied in one pass,
+  // so every node on the affected paths is copied once, no matter how many writes go through it.
+  auto Apply(const WriteBatch &batch) const -> Trie;
+
+  // Iterate, in key order, over all keys starting with `prefix` whose value is of type T. Values of other
+  // types are skipped.
+  template <class T>
+  auto ScanPrefix(std::string_view prefix) const -> TrieIterator<T>;
+
+  // Iterate, in key order, over all keys in [lo, hi) whose value is of type T. Values of other types are
+  // skipped.
+  template <class T>
+  auto Range(std::string_view lo, std::string_view hi) const -> TrieIterator<T>;
+};
+
+// A TrieIterator walks a trie in key order without copying it. Like ValueGuard, it holds a reference to the root,
+// so the keys and values it yields stay valid even if the trie it came from is replaced.
+template <class T>
+class TrieIterator {
+ public:
+  // Whether the iterator has run past the last key.
+  auto IsEnd() const -> bool { return stack_.empty(); }
+
+  // The key at the current position.
+  auto Key() const -> const std::string & { return key_; }
+
+  // The value at the current position.
+  auto Value() const -> const T &;
+
+  auto operator++() -> TrieIterator &;
+
+ private:
+  friend class Trie;
+
+  struct Frame {
+    const TrieNode *node_;
+    // The smallest child byte not visited yet, 256 if all children were visited.
+    uint16_t next_;
+  };
+
+  explicit TrieIterator(Trie trie) : trie_(std::move(trie)) {}
+
+  // Position on the first key in the subtree of `prefix`.
+  void SeekPrefix(std::string_view prefix);
+
+  // Position on the first key not less than `lo`.
+  void SeekLowerBound(std::string_view lo);
+
+  // Whether the node on top of the stack holds a value of type T within the upper bound.
+  auto AtValue() const -> bool;
+
+  // Move to the next node in pre-order (which is key order), without checking for a value.
+  void Step();
+
+  // Step until positioned on a value, or at the end.
+  void SkipToValue();
+
+  Trie trie_;
+  std::vector<Frame> stack_;
+  std::string key_;
+  std::optional<std::string> upper_bound_;
 };
 
 }  // namespace bustub
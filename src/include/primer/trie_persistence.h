@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "primer/trie.h"
+
+namespace bustub {
+
+// The value types that a durable TrieStore can write to disk.
+enum class TrieValueType : uint8_t { UINT32 = 1, UINT64 = 2, STRING = 3 };
+
+// TrieValueCodec<T> describes how values of type T are encoded in the log and in snapshots. Types without a
+// specialization cannot be stored in a durable TrieStore.
+template <class T>
+struct TrieValueCodec {
+  static constexpr bool SERIALIZABLE = false;
+};
+
+template <>
+struct TrieValueCodec<uint32_t> {
+  static constexpr bool SERIALIZABLE = true;
+  static constexpr TrieValueType TYPE = TrieValueType::UINT32;
+  static void Encode(const uint32_t &value, std::string *out) {
+    out->append(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+};
+
+template <>
+struct TrieValueCodec<uint64_t> {
+  static constexpr bool SERIALIZABLE = true;
+  static constexpr TrieValueType TYPE = TrieValueType::UINT64;
+  static void Encode(const uint64_t &value, std::string *out) {
+    out->append(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+};
+
+template <>
+struct TrieValueCodec<std::string> {
+  static constexpr bool SERIALIZABLE = true;
+  static constexpr TrieValueType TYPE = TrieValueType::STRING;
+  static void Encode(const std::string &value, std::string *out) {
+    auto size = static_cast<uint32_t>(value.size());
+    out->append(reinterpret_cast<const char *>(&size), sizeof(size));
+    out->append(value);
+  }
+};
+
+/**
+ * TrieLog is the write-ahead log of a durable TrieStore. It is a sequence of segment files `wal.<first lsn>` in one
+ * directory. Records are appended without syncing; `Sync` makes everything appended so far durable, so a whole
+ * commit group pays for a single fsync.
+ *
+ * Record format (size in bytes):
+ *  -------------------------------------------------------------------------
+ *  | Checksum (8) | Length (4) | LSN (8) | Op (1) | KeyLength (4) | Key | Value |
+ *  -------------------------------------------------------------------------
+ * The checksum covers everything after it. The value is only present for puts and starts with its TrieValueType.
+ */
+class TrieLog {
+ public:
+  /**
+   * Open the log in `directory` for appending. New records start at `next_lsn` in a fresh segment, so a torn tail
+   * left by a crash is never appended to.
+   */
+  TrieLog(std::string directory, uint64_t next_lsn);
+  ~TrieLog();
+
+  TrieLog(const TrieLog &) = delete;
+  auto operator=(const TrieLog &) -> TrieLog & = delete;
+
+  /** @return a log payload that puts `value` under `key` */
+  template <class T>
+  static auto EncodePut(std::string_view key, const T &value) -> std::string {
+    static_assert(TrieValueCodec<T>::SERIALIZABLE);
+    auto payload = EncodeKey(OP_PUT, key);
+    payload.push_back(static_cast<char>(TrieValueCodec<T>::TYPE));
+    TrieValueCodec<T>::Encode(value, &payload);
+    return payload;
+  }
+
+  /** @return a log payload that removes `key` */
+  static auto EncodeRemove(std::string_view key) -> std::string { return EncodeKey(OP_REMOVE, key); }
+
+  /** @return `trie` with the operation in `payload` applied */
+  static auto ApplyRecord(const Trie &trie, std::string_view payload) -> Trie;
+
+  /** Append a record, not durable until the next Sync. @return the LSN of the record */
+  auto Append(std::string_view payload) -> uint64_t;
+
+  /** Make all appended records durable. */
+  void Sync();
+
+  /** Close the current segment and start a new one at the next LSN. */
+  void Rotate();
+
+  /** Delete the segments that only contain records up to and including `lsn`. */
+  void Truncate(uint64_t lsn);
+
+  /**
+   * Call `apply(lsn, payload)` for every intact record in `directory` with an LSN greater than `after_lsn`, in LSN
+   * order. A torn record ends its segment; replay continues with the next one.
+   * @return the largest LSN replayed, or `after_lsn` if there was none
+   */
+  static auto Replay(const std::string &directory, uint64_t after_lsn,
+                     const std::function<void(uint64_t, std::string_view)> &apply) -> uint64_t;
+
+ private:
+  static constexpr char OP_PUT = 'P';
+  static constexpr char OP_REMOVE = 'R';
+  static constexpr size_t RECORD_HEADER_SIZE = sizeof(uint64_t) + sizeof(uint32_t) + sizeof(uint64_t);
+
+  static auto EncodeKey(char op, std::string_view key) -> std::string;
+
+  void OpenSegment();
+
+  std::string directory_;
+
+  /** Protects everything below. */
+  std::mutex latch_;
+  int fd_{-1};
+  uint64_t next_lsn_;
+};
+
+/**
+ * TrieSnapshot reads and writes a whole Trie as one compact file, meant to be mmap-ed back on restart.
+ *
+ * File format (size in bytes):
+ *  --------------------------------------------------------------
+ *  | Magic (8) | LSN (8) | PayloadSize (8) | Checksum (8) | Nodes |
+ *  --------------------------------------------------------------
+ * Nodes are stored in pre-order, which is key order:
+ *  | HasValue (1) | [Type (1) | Value] | NumChildren (2) | Key_1 (1) | Child_1 | Key_2 (1) | Child_2 | ... |
+ *
+ * Integers are stored in host byte order.
+ */
+class TrieSnapshot {
+ public:
+  /** Durably write `trie`, which includes every log record up to `lsn`, to `path`. */
+  static void Write(const Trie &trie, uint64_t lsn, const std::string &path);
+
+  /**
+   * Map the snapshot at `path` and rebuild the trie from it in one pass, without going through Put.
+   * @return the trie and its LSN, or std::nullopt if there is no valid snapshot at `path`
+   */
+  static auto Load(const std::string &path) -> std::optional<std::pair<Trie, uint64_t>>;
+};
+
+}  // namespace bustub
@@ -1,10 +1,23 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <chrono>  // NOLINT
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
 #include <optional>
 #include <shared_mutex>
+#include <string>
+#include <thread>  // NOLINT
 #include <utility>
+#include <vector>
 
 #include "primer/trie.h"
+#include "primer/trie_persistence.h"
+#include "primer/write_batch.h"
 
 namespace bustub {
 
@@ -22,10 +35,33 @@ class ValueGuard {
 };
 
 // This class is a thread-safe wrapper around the Trie class. It provides a simple interface for
-// accessing the trie. It should allow concurrent reads and a single write operation at the same
-// time.
+// accessing the trie. Reads take none of the store's locks: they atomically load the current root
+// and run on that version. This is not lock-free, since std::atomic_load on a shared_ptr is
+// implemented with a small pool of mutexes, but those are held only while the pointer is copied, so
+// a read never waits for a commit. Writes are group-committed: concurrent `Put`/`Remove` calls queue
+// up, one of them becomes the leader, applies the whole queue to the latest version and publishes a
+// single new root for all of them.
+//
+// A TrieStore created with a directory is durable. Every group is appended to a write-ahead log and
+// synced once before it is published, and a background thread periodically writes the current
+// snapshot to disk so the log can be truncated. Opening the same directory again loads the last
+// snapshot and replays the log written after it. Only values with a TrieValueCodec (uint32_t,
+// uint64_t and std::string) can be stored in a durable TrieStore.
 class TrieStore {
  public:
+  // Create an in-memory TrieStore.
+  TrieStore() = default;
+
+  // Open or create a durable TrieStore in `directory`. A snapshot is taken in the background every
+  // `checkpoint_interval` writes, or only by explicit `Checkpoint` calls if it is 0. If `sync` is
+  // false, the log is never fsync-ed, which is only useful for tests.
+  explicit TrieStore(const std::string &directory, size_t checkpoint_interval = 4096, bool sync = true);
+
+  ~TrieStore();
+
+  TrieStore(const TrieStore &) = delete;
+  auto operator=(const TrieStore &) -> TrieStore & = delete;
+
   // This function returns a ValueGuard object that holds a reference to the value in the trie. If
   // the key does not exist in the trie, it will return std::nullopt.
   template <class T>
@@ -39,16 +75,88 @@ class TrieStore {
   // This function will remove the key-value pair from the trie.
   void Remove(std::string_view key);
 
+  // Apply all writes in `batch` atomically: readers see either none or all of them. This is much
+  // cheaper than calling Put and Remove for each key when loading many keys at once.
+  void Apply(WriteBatch batch);
+
+  // Iterate over the keys starting with `prefix` in the current version. The iterator keeps that
+  // version alive and does not see later writes.
+  template <class T>
+  auto ScanPrefix(std::string_view prefix) const -> TrieIterator<T> {
+    return Snapshot().ScanPrefix<T>(prefix);
+  }
+
+  // Iterate over the keys in [lo, hi) in the current version. The iterator keeps that version alive
+  // and does not see later writes.
+  template <class T>
+  auto Range(std::string_view lo, std::string_view hi) const -> TrieIterator<T> {
+    return Snapshot().Range<T>(lo, hi);
+  }
+
+  // Returns the current version of the trie. The snapshot stays valid no matter what is written
+  // to the store afterwards.
+  auto Snapshot() const -> Trie;
+
+  // Write the current version to disk and drop the log records it covers. Does nothing for an
+  // in-memory TrieStore. Writers are not blocked while the snapshot is written.
+  void Checkpoint();
+
  private:
-  // This mutex protects the root. Every time you want to access the trie root or modify it, you
-  // will need to take this lock.
-  std::mutex root_lock_;
+  // A write waiting in the commit queue. It lives on the stack of the thread that issued it.
+  struct PendingWrite {
+    explicit PendingWrite(WriteBatch batch) : batch_(std::move(batch)) {}
 
-  // This mutex sequences all writes operations and allows only one write operation at a time.
-  std::mutex write_lock_;
+    WriteBatch batch_;
+    // The payloads to append to the log, empty for an in-memory TrieStore.
+    std::vector<std::string> log_records_;
+    bool done_{false};
+    // Set by the leader if committing the group of this write failed.
+    std::exception_ptr error_;
+    std::condition_variable cv_;
+  };
 
-  // Stores the current root for the trie.
-  Trie root_;
+  // Encodes the log records of `write`, queues it and blocks until it is part of a published root.
+  // Throws if the group it was committed with could not be logged or applied, in every thread of the group.
+  void Commit(PendingWrite *write);
+
+  // Logs and applies the writes of `group`, without the queue lock. Called by the leader of the group.
+  void CommitGroup(const std::vector<PendingWrite *> &group);
+
+  // The current version. Only ever accessed with `std::atomic_load` / `std::atomic_store`, so readers
+  // never wait for a commit to finish. Only the commit leader stores to it.
+  std::shared_ptr<const Trie> root_{std::make_shared<const Trie>()};
+
+  // This mutex protects the commit queue. The writer at the front of the queue is the leader.
+  std::mutex queue_lock_;
+
+  // Writes waiting to be committed, in arrival order.
+  std::deque<PendingWrite *> writers_;
+
+  // Background checkpointing for a durable TrieStore.
+  void CheckpointLoop();
+
+  // How long the checkpoint thread waits before it tries again after a failed checkpoint.
+  static constexpr std::chrono::seconds CHECKPOINT_RETRY_DELAY{1};
+
+  // The directory of a durable TrieStore, empty if the store is in-memory.
+  std::string directory_;
+  std::unique_ptr<TrieLog> log_;
+  bool sync_{true};
+
+  // The LSN of the last log record included in the published root. It is updated after the root,
+  // so a root loaded after reading it contains at least every record up to it.
+  std::atomic<uint64_t> committed_lsn_{0};
+
+  // Serializes checkpoints.
+  std::mutex checkpoint_write_lock_;
+
+  // Protects the fields below, which tell the checkpoint thread when to run.
+  std::mutex checkpoint_lock_;
+  std::condition_variable checkpoint_cv_;
+  size_t checkpoint_interval_{0};
+  size_t writes_since_checkpoint_{0};
+  bool stopped_{false};
+  std::thread checkpoint_thread_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "primer/trie.h"
+#include "primer/trie_persistence.h"
+
+namespace bustub {
+
+// A WriteBatch is an ordered list of puts and removes that `Trie::Apply` turns into a new version of a trie in a
+// single pass. If a key is written more than once, the last write wins.
+class WriteBatch {
+ public:
+  // Put `value` under `key`. The value is moved into the batch right away.
+  template <class T>
+  void Put(std::string_view key, T value) {
+    auto shared_value = std::make_shared<T>(std::move(value));
+    Mutation mutation;
+    mutation.key_ = std::string(key);
+    mutation.make_node_ = [shared_value](TrieChildren children) -> std::shared_ptr<const TrieNode> {
+      return std::make_shared<const TrieNodeWithValue<T>>(std::move(children), shared_value);
+    };
+    if constexpr (TrieValueCodec<T>::SERIALIZABLE) {
+      mutation.encode_ = [key = mutation.key_, shared_value] { return TrieLog::EncodePut<T>(key, *shared_value); };
+    }
+    mutations_.push_back(std::move(mutation));
+  }
+
+  // Remove `key`, if it exists.
+  void Remove(std::string_view key) {
+    Mutation mutation;
+    mutation.key_ = std::string(key);
+    mutations_.push_back(std::move(mutation));
+  }
+
+  // Append all writes of `other` after the writes of this batch.
+  void Merge(WriteBatch &&other) {
+    mutations_.insert(mutations_.end(), std::make_move_iterator(other.mutations_.begin()),
+                      std::make_move_iterator(other.mutations_.end()));
+    other.mutations_.clear();
+  }
+
+  // Encode every write of this batch as a TrieLog payload. Returns false if a value cannot be persisted.
+  auto EncodeLogRecords(std::vector<std::string> *records) const -> bool {
+    for (const auto &mutation : mutations_) {
+      if (mutation.make_node_ == nullptr) {
+        records->push_back(TrieLog::EncodeRemove(mutation.key_));
+      } else if (mutation.encode_ != nullptr) {
+        records->push_back(mutation.encode_());
+      } else {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  auto Size() const -> size_t { return mutations_.size(); }
+  auto Empty() const -> bool { return mutations_.empty(); }
+
+ private:
+  friend class Trie;
+
+  struct Mutation {
+    std::string key_;
+    // Builds the new value node for `key_` given its children. nullptr for a remove.
+    std::function<std::shared_ptr<const TrieNode>(TrieChildren)> make_node_;
+    // Encodes the write as a log payload. nullptr for a remove or a value that cannot be persisted.
+    std::function<std::string()> encode_;
+  };
+
+  std::vector<Mutation> mutations_;
+};
+
+}  // namespace bustub
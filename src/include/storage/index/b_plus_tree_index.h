@@ -31,6 +31,9 @@ class BPlusTreeIndex : public Index {
 
   auto InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool override;
 
+  /** Insert the entries in key order, so consecutive inserts go down the same path to neighbouring leaves. */
+  auto InsertEntries(std::vector<std::pair<Tuple, RID>> *entries, Transaction *transaction) -> size_t override;
+
   void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
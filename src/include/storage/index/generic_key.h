@@ -14,7 +14,10 @@
 
 #include <cstring>
 
+#include "common/exception.h"
 #include "storage/table/tuple.h"
+#include "type/limits.h"
+#include "type/type_util.h"
 #include "type/value.h"
 
 namespace bustub {
@@ -72,6 +75,10 @@ class GenericKey {
 
 /**
  * Function object returns true if lhs < rhs, used for trees
+ *
+ * The serialized values of the columns are compared in place by their type, without making a Value of each. They are
+ * ordered as the normalized keys of a sort would order them (see KeyNormalizer): NULLs last, -0.0 equal to 0.0, and
+ * VARCHARs by their bytes, then by their length.
  */
 template <size_t KeySize>
 class GenericComparator {
@@ -80,14 +87,12 @@ class GenericComparator {
     uint32_t column_count = key_schema_->GetColumnCount();
 
     for (uint32_t i = 0; i < column_count; i++) {
-      Value lhs_value = (lhs.ToValue(key_schema_, i));
-      Value rhs_value = (rhs.ToValue(key_schema_, i));
-
-      if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
-        return -1;
-      }
-      if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
-        return 1;
+      const auto &column = key_schema_->GetColumn(i);
+      auto result = column.IsInlined() ? CompareFixed(column.GetType(), lhs.data_ + column.GetOffset(),
+                                                      rhs.data_ + column.GetOffset())
+                                       : CompareVarlen(GetVarlen(lhs, column), GetVarlen(rhs, column));
+      if (result != 0) {
+        return result;
       }
     }
     // equals
@@ -100,6 +105,62 @@ class GenericComparator {
   explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
 
  private:
+  /** @return the order of the values of type T at `lhs` and `rhs`, one of which may be the NULL value `null` */
+  template <class T>
+  static auto CompareNullable(const char *lhs, const char *rhs, T null) -> int {
+    T lhs_value;
+    T rhs_value;
+    memcpy(&lhs_value, lhs, sizeof(T));
+    memcpy(&rhs_value, rhs, sizeof(T));
+    if (lhs_value == null || rhs_value == null) {
+      return (lhs_value == null ? 1 : 0) - (rhs_value == null ? 1 : 0);
+    }
+    return lhs_value < rhs_value ? -1 : (rhs_value < lhs_value ? 1 : 0);
+  }
+
+  /** @return the order of the values of fixed-size type `type` serialized at `lhs` and `rhs` */
+  static auto CompareFixed(TypeId type, const char *lhs, const char *rhs) -> int {
+    switch (type) {
+      case TypeId::BOOLEAN:
+        return CompareNullable<int8_t>(lhs, rhs, BUSTUB_BOOLEAN_NULL);
+      case TypeId::TINYINT:
+        return CompareNullable<int8_t>(lhs, rhs, BUSTUB_INT8_NULL);
+      case TypeId::SMALLINT:
+        return CompareNullable<int16_t>(lhs, rhs, BUSTUB_INT16_NULL);
+      case TypeId::INTEGER:
+        return CompareNullable<int32_t>(lhs, rhs, BUSTUB_INT32_NULL);
+      case TypeId::BIGINT:
+        return CompareNullable<int64_t>(lhs, rhs, BUSTUB_INT64_NULL);
+      case TypeId::DECIMAL:
+        return CompareNullable<double>(lhs, rhs, BUSTUB_DECIMAL_NULL);
+      case TypeId::TIMESTAMP:
+        return CompareNullable<uint64_t>(lhs, rhs, BUSTUB_TIMESTAMP_NULL);
+      default:
+        throw Exception(ExceptionType::MISMATCH_TYPE, "cannot compare keys of this type");
+    }
+  }
+
+  /** @return the serialized VARCHAR of `column` in `key`: its length, counting a terminating 0, then its bytes */
+  static auto GetVarlen(const GenericKey<KeySize> &key, const Column &column) -> const char * {
+    int32_t offset;
+    memcpy(&offset, key.data_ + column.GetOffset(), sizeof(offset));
+    return key.data_ + offset;
+  }
+
+  /** @return the order of the VARCHARs serialized at `lhs` and `rhs` */
+  static auto CompareVarlen(const char *lhs, const char *rhs) -> int {
+    uint32_t lhs_length;
+    uint32_t rhs_length;
+    memcpy(&lhs_length, lhs, sizeof(lhs_length));
+    memcpy(&rhs_length, rhs, sizeof(rhs_length));
+    if (lhs_length == BUSTUB_VALUE_NULL || rhs_length == BUSTUB_VALUE_NULL) {
+      return (lhs_length == BUSTUB_VALUE_NULL ? 1 : 0) - (rhs_length == BUSTUB_VALUE_NULL ? 1 : 0);
+    }
+    auto result = TypeUtil::CompareStrings(lhs + sizeof(uint32_t), static_cast<int>(lhs_length) - 1,
+                                           rhs + sizeof(uint32_t), static_cast<int>(rhs_length) - 1);
+    return result < 0 ? -1 : (result > 0 ? 1 : 0);
+  }
+
   Schema *key_schema_;
 };
 
@@ -160,6 +160,21 @@ class Index {
    */
   virtual auto InsertEntry(const Tuple &key, RID rid, Transaction *transaction) -> bool = 0;
 
+  /**
+   * Insert a batch of entries, e.g. those of a bulk insert into the table. An index may reorder `entries` to insert
+   * them in the order that suits it best.
+   * @param entries The index keys and their RIDs
+   * @param transaction The transaction context
+   * @returns the number of entries inserted
+   */
+  virtual auto InsertEntries(std::vector<std::pair<Tuple, RID>> *entries, Transaction *transaction) -> size_t {
+    size_t num_inserted = 0;
+    for (const auto &[key, rid] : *entries) {
+      num_inserted += InsertEntry(key, rid, transaction) ? 1 : 0;
+    }
+    return num_inserted;
+  }
+
   /**
    * Delete an index entry by key.
    * @param key The index key
@@ -0,0 +1,158 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page.h
+//
+// Identification: src/include/storage/page/compressed_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+static constexpr uint64_t COMPRESSED_PAGE_HEADER_SIZE = 16;
+
+/** How the values of a column are stored in a CompressedPage. */
+enum class ColumnEncoding : uint8_t { PLAIN, FRAME_OF_REFERENCE, RUN_LENGTH, DICTIONARY };
+
+/**
+ * Compressed page format:
+ *  ---------------------------------------------------------------------------------------------------------------
+ *  | HEADER | TUPLE METAS | BLOCK OFFSETS | COLUMN 1 BLOCK | ... | COLUMN N BLOCK | TAIL SLOTS | ... | TAIL DATA |
+ *  ---------------------------------------------------------------------------------------------------------------
+ *
+ *  Header format (size in bytes):
+ *  ------------------------------------------------------------------------------------------------------------
+ *  | NextPageId (4) | NumTuples(2) | NumCompressedTuples(2) | NumDeletedTuples(2) | TailSlotsStart(2) |
+ *  ------------------------------------------------------------------------------------------------------------
+ *  -----------------------------------------
+ *  | FreeSpacePointer(2) | Unused(2) |
+ *  -----------------------------------------
+ *
+ * New tuples are inserted uncompressed into the tail, as in a TablePage: the tail slots grow towards the end of the
+ * page and the tuple data grows from the end of the page towards them. When the page is full, `Compress` rewrites
+ * all of its tuples into one block per column, which leaves room for more tail tuples. The first NumCompressedTuples
+ * tuples are the rows of the blocks, with their metas in TUPLE METAS; tuple i after them is in tail slot i. Tuples
+ * keep their slot, so compressing a page changes no RID.
+ *
+ * A block stores the values of its column as they are in a tuple (the bytes of an inlined value, or the length and
+ * data of a VARCHAR value), in whichever of these encodings is smallest, given by its first byte:
+ *  - PLAIN: the values one after the other; VARCHAR values are preceded by the offset of the end of each (2 bytes).
+ *  - FRAME_OF_REFERENCE (integer columns): the smallest value (8), the bit width (1), and the difference of each value
+ *    to the smallest bit-packed into 8-byte words.
+ *  - RUN_LENGTH (inlined columns): the number of runs (2), the row after the end of each run (2 bytes each), and the
+ *    value of each run.
+ *  - DICTIONARY: the number of distinct values (2), the bit width (1), the distinct values as in PLAIN, and the index
+ *    of the value of each row bit-packed into 8-byte words.
+ *
+ * NextPageId and NumTuples are at the same offsets as in a TablePage, see TableIterator.
+ */
+class CompressedPage {
+ public:
+  /** Initialize an empty page. */
+  void Init();
+
+  /** @return number of tuples in this page */
+  auto GetNumTuples() const -> uint32_t { return num_tuples_; }
+
+  /** @return number of tuples stored in the column blocks */
+  auto GetNumCompressedTuples() const -> uint32_t { return num_compressed_tuples_; }
+
+  /** @return the page ID of the next table page */
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+  /** Set the page id of the next page in the table. */
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  /** @return the size of the largest tuple that can be inserted into the tail */
+  auto GetFreeSpace() const -> size_t;
+
+  /** @return the encoding of column `column_idx`, if the page has compressed tuples */
+  auto GetEncoding(uint32_t column_idx) const -> ColumnEncoding;
+
+  /**
+   * Insert a tuple into the tail.
+   * @return the slot of the tuple, or nullopt if the tail is full
+   */
+  auto InsertTuple(const TupleMeta &meta, const Tuple &tuple) -> std::optional<uint16_t>;
+
+  /**
+   * Rewrite all tuples of the page into compressed column blocks. Nothing is changed if the tail is empty or the
+   * tuples would take more space compressed.
+   * @return the number of bytes freed
+   */
+  auto Compress(const Schema &schema) -> size_t;
+
+  void UpdateTupleMeta(const TupleMeta &meta, const RID &rid);
+
+  auto GetTupleMeta(const RID &rid) const -> TupleMeta;
+
+  auto GetTuple(const Schema &schema, const RID &rid) const -> std::pair<TupleMeta, Tuple>;
+
+  /**
+   * Update a tuple in place. A tail tuple must keep its size; a compressed tuple may change it, as the page is
+   * compressed again. Throws if the page cannot hold the new tuple.
+   */
+  void UpdateTupleInPlaceUnsafe(const Schema &schema, const TupleMeta &meta, const Tuple &tuple, const RID &rid);
+
+  /**
+   * Append a view of each tuple in slots [first_slot, end_slot) to `views`. Compressed tuples are decoded a column at
+   * a time into `tuple_data`, tail tuples are pointed to in place.
+   * @param page_id the id of this page, used for the RIDs of the views
+   * @param column_ids the columns to decode, or nullptr for all. The others are NULL in decoded tuples.
+   */
+  void GetTupleViews(const Schema &schema, page_id_t page_id, uint32_t first_slot, uint32_t end_slot,
+                     const std::vector<uint32_t> *column_ids, std::vector<char> *tuple_data,
+                     std::vector<TupleView> *views) const;
+
+  static_assert(sizeof(page_id_t) == 4);
+
+ private:
+  using TupleInfo = std::tuple<uint16_t, uint16_t, TupleMeta>;
+  static constexpr size_t TUPLE_INFO_SIZE = 16;
+  static_assert(sizeof(TupleInfo) == TUPLE_INFO_SIZE);
+
+  auto Metas() const -> const TupleMeta * {
+    return reinterpret_cast<const TupleMeta *>(page_start_ + COMPRESSED_PAGE_HEADER_SIZE);
+  }
+  auto Metas() -> TupleMeta * { return reinterpret_cast<TupleMeta *>(page_start_ + COMPRESSED_PAGE_HEADER_SIZE); }
+  auto BlockOffsets() const -> const uint16_t * {
+    return reinterpret_cast<const uint16_t *>(page_start_ + COMPRESSED_PAGE_HEADER_SIZE +
+                                              num_compressed_tuples_ * TUPLE_META_SIZE);
+  }
+  auto TailSlots() const -> const TupleInfo * {
+    return reinterpret_cast<const TupleInfo *>(page_start_ + tail_slots_start_);
+  }
+  auto TailSlots() -> TupleInfo * { return reinterpret_cast<TupleInfo *>(page_start_ + tail_slots_start_); }
+
+  /**
+   * Write `tuples` into `page` as a page with only compressed tuples and the same next page.
+   * @return false if they do not fit into a page
+   */
+  auto Build(const Schema &schema, const std::vector<TupleView> &tuples, char *page) const -> bool;
+
+  char page_start_[0];
+  page_id_t next_page_id_;
+  uint16_t num_tuples_;
+  uint16_t num_compressed_tuples_;
+  uint16_t num_deleted_tuples_;
+  uint16_t tail_slots_start_;
+  uint16_t free_space_pointer_;
+  uint16_t unused_;
+};
+
+static_assert(sizeof(CompressedPage) == COMPRESSED_PAGE_HEADER_SIZE);
+
+}  // namespace bustub
@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// overflow_page.h
+//
+// Identification: src/include/storage/page/overflow_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+
+#include "common/config.h"
+
+namespace bustub {
+
+static constexpr uint64_t OVERFLOW_PAGE_HEADER_SIZE = 8;
+
+/**
+ * Overflow page format:
+ *  ----------------------------------------------
+ *  | NextPageId (4) | Size (4) | ... DATA ... |
+ *  ----------------------------------------------
+ *
+ * A value too large to be kept in its tuple is split over a chain of overflow pages, see ToastStore. Each page holds
+ * the next `Size` bytes of the value; the last page of the chain has no next page.
+ */
+class OverflowPage {
+ public:
+  /** The number of bytes of a value that fit into one page. */
+  static constexpr uint32_t CAPACITY = BUSTUB_PAGE_SIZE - OVERFLOW_PAGE_HEADER_SIZE;
+
+  /** Fill the page with `size` bytes of a value, followed by the page `next_page_id`. */
+  void Init(page_id_t next_page_id, const char *data, uint32_t size) {
+    next_page_id_ = next_page_id;
+    size_ = size;
+    memcpy(data_, data, size);
+  }
+
+  /** @return the page id of the next page of the chain, or INVALID_PAGE_ID */
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+  /** @return the number of bytes stored in this page */
+  auto GetSize() const -> uint32_t { return size_; }
+
+  auto GetData() const -> const char * { return data_; }
+
+ private:
+  page_id_t next_page_id_;
+  uint32_t size_;
+  char data_[0];
+};
+
+static_assert(sizeof(OverflowPage) == OVERFLOW_PAGE_HEADER_SIZE);
+
+}  // namespace bustub
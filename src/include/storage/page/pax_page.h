@@ -0,0 +1,200 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_page.h
+//
+// Identification: src/include/storage/page/pax_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+static constexpr uint64_t PAX_PAGE_HEADER_SIZE = 16;
+
+/**
+ * PaxLayout places the minipages of a PaxPage. Every page of a table has the same layout, which only depends on the
+ * schema, so it is computed once per table.
+ */
+class PaxLayout {
+  friend class PaxPage;
+
+ public:
+  explicit PaxLayout(const Schema &schema);
+
+  auto GetSchema() const -> const Schema & { return schema_; }
+
+  /** @return the number of rows that fit into a page, if their VARCHAR values are not longer than expected */
+  auto GetCapacity() const -> uint32_t { return capacity_; }
+
+  /** A VARCHAR value is expected to take this fraction of its declared length when sizing the minipages. */
+  static constexpr uint32_t VARCHAR_EXPECTED_FRACTION = 2;
+
+  /** The size of the NumValues, Min and Max fields at the start of each minipage. */
+  static constexpr uint32_t COLUMN_STATS_SIZE = 20;
+
+ private:
+  struct ColumnLayout {
+    TypeId type_;
+    /** The bytes each row takes in the value minipage. An inlined value is stored as in a tuple. */
+    uint32_t width_;
+    /** The offset of the column in a tuple, see Tuple. */
+    uint32_t tuple_offset_;
+    bool inlined_;
+    uint32_t stats_offset_;
+    uint32_t null_bitmap_offset_;
+    uint32_t values_offset_;
+    /** How a NULL of an inlined column is stored in a tuple. */
+    std::vector<char> null_value_;
+  };
+
+  /** Place all minipages for `capacity` rows. @return the end of the last minipage */
+  auto Place(uint32_t capacity) -> uint32_t;
+
+  Schema schema_;
+  uint32_t capacity_;
+  /** VARCHAR data is stored between the end of the minipages and the end of the page. */
+  uint32_t minipages_end_{0};
+  std::vector<ColumnLayout> columns_;
+};
+
+/**
+ * PAX (Partition Attributes Across) page format:
+ *  ----------------------------------------------------------------------------------------------
+ *  | HEADER | TUPLE METAS | COLUMN 1 MINIPAGE | ... | COLUMN N MINIPAGE | ... VARCHAR DATA ... |
+ *  ----------------------------------------------------------------------------------------------
+ *
+ *  Header format (size in bytes):
+ *  ---------------------------------------------------------------------------------------------
+ *  | NextPageId (4) | NumTuples(2) | NumDeletedTuples(2) | VarDataPointer(2) | Unused(6) |
+ *  ---------------------------------------------------------------------------------------------
+ *
+ *  Column minipage format:
+ *  ----------------------------------------------------------------------------------------
+ *  | NumValues(4) | Min(8) | Max(8) | NULL bitmap (1 bit per row) | values (width per row) |
+ *  ----------------------------------------------------------------------------------------
+ *
+ * Each column's values are stored together, so a scan that reads a few columns of a wide table touches only their
+ * minipages. An inlined value takes the same bytes as in a tuple. A VARCHAR value is an (offset, length) pair that
+ * points into the VARCHAR data, which grows from the end of the page towards the minipages. NumValues counts the
+ * non-NULL values, and Min and Max hold the smallest and largest of them for inlined columns. A VARCHAR value stored
+ * out of line (see ToastStore) is kept as its ToastPointer, marked by VARCHAR_TOASTED in the length. Deletes do not
+ * shrink Min and Max, so they always bound the live values.
+ *
+ * NextPageId and NumTuples are at the same offsets as in a TablePage, so code that only follows the page chain or
+ * counts the tuples of a page (TableIterator) works on either format. RIDs are (page, row) pairs, and rows are never
+ * moved or reused, so the vacuum leaves PAX pages alone.
+ */
+class PaxPage {
+ public:
+  /** Initialize an empty page. */
+  void Init(const PaxLayout &layout);
+
+  /** @return number of tuples in this page */
+  auto GetNumTuples() const -> uint32_t { return num_tuples_; }
+
+  /** @return the page ID of the next table page */
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+
+  /** Set the page id of the next page in the table. */
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  /**
+   * Insert a tuple as the last row of the page.
+   * @return the row number, or nullopt if the rows or the VARCHAR data of the page are full
+   */
+  auto InsertTuple(const PaxLayout &layout, const TupleMeta &meta, const Tuple &tuple) -> std::optional<uint16_t>;
+
+  void UpdateTupleMeta(const TupleMeta &meta, const RID &rid);
+
+  auto GetTupleMeta(const RID &rid) const -> TupleMeta;
+
+  /** Read a row of the page and put it back together as a tuple. */
+  auto GetTuple(const PaxLayout &layout, const RID &rid) const -> std::pair<TupleMeta, Tuple>;
+
+  /**
+   * Overwrite a row. New VARCHAR values are appended to the VARCHAR data; throws if they do not fit.
+   */
+  void UpdateTupleInPlaceUnsafe(const PaxLayout &layout, const TupleMeta &meta, const Tuple &tuple, const RID &rid);
+
+  /**
+   * Put rows [first_slot, end_slot) back together as tuples stored in `tuple_data`, and append a view of each to
+   * `views`. Only the columns in `column_ids` are read, the others are NULL in the tuples.
+   * @param page_id the id of this page, used for the RIDs of the views
+   * @param column_ids the columns to read, or nullptr to read all of them
+   */
+  void GetTupleViews(const PaxLayout &layout, page_id_t page_id, uint32_t first_slot, uint32_t end_slot,
+                     const std::vector<uint32_t> *column_ids, std::vector<char> *tuple_data,
+                     std::vector<TupleView> *views) const;
+
+  /** @return true if the value of column `column_idx` is NULL in row `slot` */
+  auto IsNull(const PaxLayout &layout, uint32_t column_idx, uint32_t slot) const -> bool;
+
+  /**
+   * @return the smallest and largest non-NULL value ever inserted into column `column_idx` of this page, or nullopt
+   * if there is none or the column is not inlined
+   */
+  auto GetMinMax(const PaxLayout &layout, uint32_t column_idx) const -> std::optional<std::pair<Value, Value>>;
+
+  static_assert(sizeof(page_id_t) == 4);
+
+ private:
+  struct ColumnStats {
+    uint32_t num_values_;
+    char min_[8];
+    char max_[8];
+  };
+  static_assert(sizeof(ColumnStats) == PaxLayout::COLUMN_STATS_SIZE);
+
+  struct VarcharRef {
+    uint16_t offset_;
+    uint16_t size_;
+  };
+  /** Set in VarcharRef::size_ if the data is a ToastPointer. Pages are smaller than this, so no size has it set. */
+  static constexpr uint16_t VARCHAR_TOASTED = 0x8000;
+  static_assert(BUSTUB_PAGE_SIZE <= VARCHAR_TOASTED);
+
+  auto Metas() const -> const TupleMeta * {
+    return reinterpret_cast<const TupleMeta *>(page_start_ + PAX_PAGE_HEADER_SIZE);
+  }
+  auto Metas() -> TupleMeta * { return reinterpret_cast<TupleMeta *>(page_start_ + PAX_PAGE_HEADER_SIZE); }
+  auto Stats(const PaxLayout::ColumnLayout &column) -> ColumnStats * {
+    return reinterpret_cast<ColumnStats *>(page_start_ + column.stats_offset_);
+  }
+  auto Stats(const PaxLayout::ColumnLayout &column) const -> const ColumnStats * {
+    return reinterpret_cast<const ColumnStats *>(page_start_ + column.stats_offset_);
+  }
+
+  /** Store the values of `tuple` in row `slot`. Fails if the VARCHAR data does not fit, leaving the page as is. */
+  auto WriteRow(const PaxLayout &layout, const Tuple &tuple, uint32_t slot) -> bool;
+
+  /** @return the size of row `slot` as a tuple, if only the columns set in `read` are read */
+  auto RowSize(const PaxLayout &layout, uint32_t slot, const std::vector<bool> &read) const -> uint32_t;
+
+  /** Put row `slot` together as a tuple at `out`, which is zeroed and has room for `RowSize` bytes. */
+  void ReadRow(const PaxLayout &layout, uint32_t slot, const std::vector<bool> &read, char *out) const;
+
+  char page_start_[0];
+  page_id_t next_page_id_;
+  uint16_t num_tuples_;
+  uint16_t num_deleted_tuples_;
+  uint16_t var_data_pointer_;
+  uint16_t unused_[3];
+};
+
+static_assert(sizeof(PaxPage) == PAX_PAGE_HEADER_SIZE);
+
+}  // namespace bustub
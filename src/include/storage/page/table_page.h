@@ -16,6 +16,7 @@
 #include <optional>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include "common/config.h"
 #include "common/rid.h"
@@ -27,7 +28,7 @@
 
 namespace bustub {
 
-static constexpr uint64_t TABLE_PAGE_HEADER_SIZE = 8;
+static constexpr uint64_t TABLE_PAGE_HEADER_SIZE = 16;
 
 /**
  * Slotted page format:
@@ -39,14 +40,23 @@ static constexpr uint64_t TABLE_PAGE_HEADER_SIZE = 8;
  *
  *  Header format (size in bytes):
  *  ----------------------------------------------------------------------------
- *  | NextPageId (4)| NumTuples(2) | NumDeletedTuples(2) |
+ *  | NextPageId (4)| NumTuples(2) | NumDeletedTuples(2) | NumDeadTuples(2) | ReclaimableBytes(2) |
  *  ----------------------------------------------------------------------------
+ *  ----------------------------------------------
+ *  | NumFreeSlots(2) | FreeSpacePointer(2) |
+ *  ----------------------------------------------
  *  ----------------------------------------------------------------
  *  | Tuple_1 offset+size (4) | Tuple_2 offset+size (4) | ... |
  *  ----------------------------------------------------------------
  *
  * Tuple format:
  * | meta | data |
+ *
+ * A deleted tuple whose deletion has completed (`delete_txn_id_` is INVALID_TXN_ID) is dead. `Compact` drops the
+ * data of dead tuples and packs the remaining data at the end of the page. The slot of a dead tuple stays, so the
+ * RIDs of all other tuples are unchanged, and becomes a free slot: an insert may reuse it, and free slots at the end
+ * of the slot array can be trimmed. Once compaction has run, tuple data is no longer stored in slot order, which is
+ * why the start of the tuple data is kept in the header.
  */
 
 class TablePage {
@@ -65,15 +75,43 @@ class TablePage {
   /** Set the page id of the next page in the table. */
   void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
 
+  /** @return the size of the largest tuple that can be inserted without compacting the page */
+  auto GetFreeSpace() const -> size_t;
+
+  /** @return the number of bytes of dead tuple data that `Compact` would reclaim */
+  auto GetReclaimableSpace() const -> size_t { return reclaimable_bytes_; }
+
+  /** @return the number of dead tuples whose data has not been reclaimed yet */
+  auto GetNumDeadTuples() const -> uint32_t { return num_dead_tuples_; }
+
+  /** @return the number of slots that an insert can reuse */
+  auto GetNumFreeSlots() const -> uint32_t { return num_free_slots_; }
+
+  /** @return the fraction of the tuples in this page that are dead and not yet reclaimed */
+  auto GetDeadTupleRatio() const -> double {
+    return num_tuples_ == 0 ? 0 : static_cast<double>(num_dead_tuples_) / num_tuples_;
+  }
+
+  /**
+   * Drop the data of all dead tuples and move the remaining data together at the end of the page. Slot numbers do
+   * not change, so the RIDs of the other tuples stay valid.
+   * @param trim_free_slots also drop the free slots at the end of the slot array. Only safe if nobody is positioned
+   * on one of them, e.g. no iterator is open.
+   */
+  void Compact(bool trim_free_slots = false);
+
   /** Get the next offset to insert, return nullopt if this tuple cannot fit in this page */
   auto GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) const -> std::optional<uint16_t>;
 
   /**
    * Insert a tuple into the table.
    * @param tuple tuple to insert
+   * The page is compacted first if the tuple only fits once dead tuples are reclaimed.
+   * @param reuse_free_slots put the tuple into a free slot if there is one, instead of a new slot at the end
    * @return true if the insert is successful (i.e. there is enough space)
    */
-  auto InsertTuple(const TupleMeta &meta, const Tuple &tuple) -> std::optional<uint16_t>;
+  auto InsertTuple(const TupleMeta &meta, const Tuple &tuple, bool reuse_free_slots = false)
+      -> std::optional<uint16_t>;
 
   /**
    * Update a tuple.
@@ -85,6 +123,12 @@ class TablePage {
    */
   auto GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple>;
 
+  /**
+   * Append a view of each tuple in slots [first_slot, end_slot) to `views`. The views point into this page.
+   * @param page_id the id of this page, used for the RIDs of the views
+   */
+  void GetTupleViews(page_id_t page_id, uint32_t first_slot, uint32_t end_slot, std::vector<TupleView> *views) const;
+
   /**
    * Read a tuple meta from a table.
    */
@@ -95,14 +139,37 @@ class TablePage {
    */
   void UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid);
 
+  /** @return true if the tuple is deleted and its deletion has completed, so its data can be reclaimed */
+  static auto IsDead(const TupleMeta &meta) -> bool {
+    return meta.is_deleted_ && meta.delete_txn_id_ == INVALID_TXN_ID;
+  }
+
   static_assert(sizeof(page_id_t) == 4);
 
+  /**
+   * Where the next page id and the number of tuples are in the header. PaxPage and CompressedPage keep theirs at the
+   * same offsets, so a table heap reads them through a TablePage whatever the layout of the page.
+   */
+  static constexpr size_t NEXT_PAGE_ID_OFFSET = 0;
+  static constexpr size_t NUM_TUPLES_OFFSET = sizeof(page_id_t);
+
  private:
   using TupleInfo = std::tuple<uint16_t, uint16_t, TupleMeta>;
+
+  /** Replace the meta of a tuple, keeping the deletion counters up to date. */
+  void SetTupleMeta(uint16_t tuple_id, const TupleMeta &meta);
+
+  /** Add `delta` to the dead tuple or free slot counters if a tuple with `meta` and `size` bytes of data is dead. */
+  void CountDead(const TupleMeta &meta, uint16_t size, int delta);
+
   char page_start_[0];
   page_id_t next_page_id_;
   uint16_t num_tuples_;
   uint16_t num_deleted_tuples_;
+  uint16_t num_dead_tuples_;
+  uint16_t reclaimable_bytes_;
+  uint16_t num_free_slots_;
+  uint16_t free_space_pointer_;
   TupleInfo tuple_info_[0];
 
   static constexpr size_t TUPLE_INFO_SIZE = 16;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstring>
+
 #include "storage/page/page.h"
 #include "storage/table/tmp_tuple.h"
 #include "storage/table/tuple.h"
@@ -20,16 +22,48 @@ namespace bustub {
  */
 class TmpTuplePage : public Page {
  public:
+  static constexpr uint32_t OFFSET_FREE_SPACE = sizeof(page_id_t) + sizeof(lsn_t);
+  static constexpr uint32_t HEADER_SIZE = OFFSET_FREE_SPACE + sizeof(uint32_t);
+
   void Init(page_id_t page_id, uint32_t page_size) {
     memcpy(GetData(), &page_id, sizeof(page_id_t));
-    memcpy(GetData() + sizeof(page_id_t), &page_size, sizeof(uint32_t));
+    SetLSN(INVALID_LSN);
+    SetFreeSpacePointer(page_size);
   }
 
-  auto GetTablePageId() -> page_id_t { return INVALID_PAGE_ID; }
+  auto GetTablePageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData()); }
 
-  auto Insert(const Tuple &tuple, TmpTuple *out) -> bool { return false; }
+  /** @return the offset of the last tuple inserted, the start of the tuples, as the page fills from its end */
+  auto GetFreeSpacePointer() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
+
+  /**
+   * Insert `tuple` below the tuples inserted before.
+   * @param[out] out where the tuple is stored
+   * @return false if there is not enough space left
+   */
+  auto Insert(const TupleRef &tuple, TmpTuple *out) -> bool {
+    auto size = sizeof(uint32_t) + tuple.GetLength();
+    auto free_space_pointer = GetFreeSpacePointer();
+    if (free_space_pointer < HEADER_SIZE + size) {
+      return false;
+    }
+    free_space_pointer -= size;
+    auto length = tuple.GetLength();
+    memcpy(GetData() + free_space_pointer, &length, sizeof(uint32_t));
+    memcpy(GetData() + free_space_pointer + sizeof(uint32_t), tuple.GetData(), length);
+    SetFreeSpacePointer(free_space_pointer);
+    *out = TmpTuple(GetTablePageId(), free_space_pointer);
+    return true;
+  }
+
+  /** Read the tuple stored at `offset` into `tuple`. */
+  void Get(size_t offset, Tuple *tuple) { tuple->DeserializeFrom(GetData() + offset); }
 
  private:
+  void SetFreeSpacePointer(uint32_t free_space_pointer) {
+    memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
+  }
+
   static_assert(sizeof(page_id_t) == 4);
 };
 
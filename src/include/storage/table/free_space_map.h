@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.h
+//
+// Identification: src/include/storage/table/free_space_map.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * FreeSpaceMap tracks roughly how many bytes each page of a TableHeap can still take, so inserts can find a page
+ * with room without visiting the pages themselves.
+ *
+ * Like the PostgreSQL FSM, free space is stored in one byte per page, in units of CATEGORY_SIZE bytes and rounded
+ * down, so a page is never reported to have more room than it had when it was last updated. The categories are the
+ * leaves of a max-tree, which answers "first page at or after position i with at least n bytes" in O(log #pages).
+ *
+ * The map is only a hint: the page must still be checked under its write latch, and `Update` corrects the map when
+ * the hint was stale. It lives in memory next to the rest of the TableHeap state and can be rebuilt from the pages.
+ */
+class FreeSpaceMap {
+ public:
+  /** Free space is tracked in units of this many bytes. */
+  static constexpr size_t CATEGORY_SIZE = BUSTUB_PAGE_SIZE / 256;
+
+  /** Track a new page with `free_bytes` free. Pages keep the position they were added at. */
+  void AddPage(page_id_t page_id, size_t free_bytes);
+
+  /** Record that `page_id` now has `free_bytes` free. Unknown pages are ignored. */
+  void Update(page_id_t page_id, size_t free_bytes);
+
+  /**
+   * Find a page with at least `size` free bytes. The search starts at position `start` and wraps around, so callers
+   * starting at different positions are spread over different pages.
+   * @return the page, or INVALID_PAGE_ID if no page has enough room
+   */
+  auto FindPage(size_t size, size_t start) const -> page_id_t;
+
+  /** @return the number of tracked pages */
+  auto GetNumPages() const -> size_t;
+
+  /** @return the free space recorded for `page_id`, rounded down to CATEGORY_SIZE; 0 for an unknown page */
+  auto GetFreeSpace(page_id_t page_id) const -> size_t;
+
+ private:
+  static auto ToCategory(size_t free_bytes) -> uint8_t;
+  void SetCategory(size_t position, uint8_t category);
+  auto FindFrom(size_t node, size_t lo, size_t hi, size_t start, uint8_t category) const -> size_t;
+
+  mutable std::mutex latch_;
+  std::unordered_map<page_id_t, size_t> positions_;
+  std::vector<page_id_t> page_ids_;
+  /** The max-tree: tree_[1] is the root, the children of node i are 2i and 2i+1, leaves start at `capacity_`. */
+  std::vector<uint8_t> tree_;
+  size_t capacity_{0};
+};
+
+}  // namespace bustub
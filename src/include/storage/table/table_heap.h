@@ -12,31 +12,66 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <memory>
 #include <mutex>  // NOLINT
 #include <optional>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "common/config.h"
+#include "common/enums/table_layout.h"
 #include "concurrency/lock_manager.h"
 #include "concurrency/transaction.h"
 #include "recovery/log_manager.h"
+#include "storage/page/compressed_page.h"
+#include "storage/page/page_guard.h"
+#include "storage/page/pax_page.h"
 #include "storage/page/table_page.h"
+#include "storage/table/free_space_map.h"
 #include "storage/table/table_iterator.h"
+#include "storage/table/toast_store.h"
 #include "storage/table/tuple.h"
+#include "storage/table/zone_map.h"
 
 namespace bustub {
 
 /**
  * TableHeap represents a physical table on disk.
  * This is just a doubly-linked list of pages.
+ *
+ * Inserts go through a FreeSpaceMap, so space freed by deletes in any page is reused, and concurrent inserters are
+ * spread over several pages instead of all waiting for the last one. While a scan bounded by `MakeIterator` is
+ * open, inserts only append to the end of the heap, as the scan relies on new tuples landing after its stop RID.
+ *
+ * `Vacuum` compacts the pages with many dead tuples in place, and can run in the background. Live tuples keep their
+ * RIDs, so indexes need no maintenance; the slots of dead tuples are reused by later inserts.
+ *
+ * The table heap also keeps a directory of its pages in chain order, so `MakeParallelScan` can split a scan into
+ * ranges of pages for several threads without walking the chain.
+ *
+ * A table heap created with a schema summarizes the numeric columns of each page in a ZoneMap, so a scan with a
+ * filter can skip the pages that hold no match, see TableIterator::NextBatch.
+ *
+ * A table heap created with TableLayout::PAX stores its tuples column by column in PaxPages instead. Those pages
+ * are filled in order and never compacted, so inserts always append and the vacuum skips them.
+ *
+ * A table heap created with TableLayout::COMPRESSED stores its tuples in CompressedPages. Inserts append to the
+ * uncompressed tail of the last page; when it is full, the page is compressed and the insert retried before a new
+ * page is added. The vacuum compresses the tails of the other pages.
+ *
+ * A table heap created with a schema keeps large VARCHAR values out of line in a ToastStore, so tuples longer than a
+ * page can be inserted. Readers get the values back transparently: `GetTuple` reads all of them, and
+ * TableIterator::NextBatch only those of the columns the scan reads.
  */
 class TableHeap {
   friend class TableIterator;
+  friend class ParallelTableScan;
 
  public:
-  ~TableHeap() = default;
-
   /**
    * Create a table heap without a transaction. (open table)
    * @param buffer_pool_manager the buffer pool manager
@@ -45,7 +80,15 @@ class TableHeap {
   explicit TableHeap(BufferPoolManager *bpm);
 
   /**
-   * Insert a tuple into the table. If the tuple is too large (>= page_size), return std::nullopt.
+   * Create a table heap whose pages use `layout`.
+   * @param schema the schema of the tuples, which decides how a PAX page is laid out and which values can be stored
+   * out of line
+   */
+  TableHeap(BufferPoolManager *bpm, const Schema &schema, TableLayout layout);
+
+  /**
+   * Insert a tuple into the table. Large VARCHAR values are moved out of line first if the table heap has a schema;
+   * if the tuple is still too large (>= page_size), throw.
    * @param meta tuple meta
    * @param tuple tuple to insert
    * @return rid of the inserted tuple
@@ -53,6 +96,15 @@ class TableHeap {
   auto InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManager *lock_mgr = nullptr,
                    Transaction *txn = nullptr, table_oid_t oid = 0) -> std::optional<RID>;
 
+  /**
+   * Insert many tuples at once, e.g. for INSERT ... SELECT or loading a table. The tuples are written into new pages,
+   * which are linked to the end of the heap in one step, so the inserts need neither the table latch nor the free
+   * space map; a batch smaller than BULK_INSERT_MIN_SIZE bytes is inserted tuple by tuple instead.
+   * @return the rids of the tuples, in the order of `tuples`
+   */
+  auto BulkInsert(const TupleMeta &meta, const std::vector<Tuple> &tuples, LockManager *lock_mgr = nullptr,
+                  Transaction *txn = nullptr, table_oid_t oid = 0) -> std::vector<RID>;
+
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
    * @param meta new tuple meta
@@ -81,6 +133,27 @@ class TableHeap {
   /** @return the iterator of this table, use this for project 4 except updates */
   auto MakeEagerIterator() -> TableIterator;
 
+  /**
+   * Split a scan of this table into morsels of `pages_per_morsel` pages, for several threads to scan it at once.
+   * @return the scan, which must be destroyed before the table heap
+   */
+  auto MakeParallelScan(size_t pages_per_morsel = DEFAULT_PAGES_PER_MORSEL) -> std::unique_ptr<ParallelTableScan>;
+
+  /** @return the number of pages of this table */
+  auto GetNumPages() -> size_t;
+
+  /** @return the layout of the pages of a PAX table, or nullptr if the table stores whole tuples */
+  auto GetPaxLayout() const -> const PaxLayout * { return pax_layout_.get(); }
+
+  /** @return how the pages of this table store their tuples */
+  auto GetLayout() const -> TableLayout { return layout_; }
+
+  /** @return the zone map of this table, or nullptr if the table heap has no schema */
+  auto GetZoneMap() const -> const ZoneMap * { return zone_map_.get(); }
+
+  /** @return how many pages the scans of this table have read so far, not counting those the zone map let them skip */
+  auto GetNumPagesScanned() const -> size_t { return pages_scanned_.load(std::memory_order_relaxed); }
+
   /** @return the id of the first page of this table */
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
@@ -92,12 +165,113 @@ class TableHeap {
    */
   void UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid);
 
+  /**
+   * Compact every page whose dead tuple ratio is at least `min_dead_ratio`, see TablePage::Compact, or compress the
+   * tails of the pages of a COMPRESSED table. Readers and writers of other pages are not blocked. If no scan is open,
+   * the overflow pages of out-of-line values of dead or overwritten tuples are deleted as well.
+   * @return the number of bytes reclaimed
+   */
+  auto Vacuum(double min_dead_ratio = VACUUM_MIN_DEAD_RATIO) -> size_t;
+
+  /**
+   * @return true if `Vacuum` may have something to reclaim: tuples died since the last vacuum, values were released,
+   * or tuples were added to the tails of compressed pages. Cheap enough to ask every table often, see VacuumWorker.
+   */
+  auto NeedsVacuum() -> bool;
+
+  /** @return the number of dead tuples in the pages of a ROW table that the vacuum has not reclaimed yet */
+  auto GetNumDeadTuples() const -> size_t { return num_dead_tuples_.load(std::memory_order_relaxed); }
+
+  /** Pages with at least this fraction of dead tuples are compacted by default. */
+  static constexpr double VACUUM_MIN_DEAD_RATIO = 0.2;
+
+  /** BulkInsert fills new pages for batches of at least this many bytes. */
+  static constexpr size_t BULK_INSERT_MIN_SIZE = BUSTUB_PAGE_SIZE;
+
+  /** The default size of the morsels of a ParallelTableScan. */
+  static constexpr size_t DEFAULT_PAGES_PER_MORSEL = 16;
+
  private:
+  /** Inserters are spread over this many candidate pages, picked by a hash of the thread id. */
+  static constexpr size_t NUM_INSERT_SLOTS = 8;
+  /** How many pages an insert tries through the free space map before it appends to the end of the heap. */
+  static constexpr size_t MAX_FREE_PAGE_ATTEMPTS = 4;
+  /** A full compressed page is compressed again once 1 / this of its tuples are in its tail. */
+  static constexpr uint32_t MIN_COMPRESS_TAIL_FRACTION = 8;
+
+  /** Insert into a page found through the free space map. Fills `guard` with the latched page on success. */
+  auto InsertIntoFreePage(const TupleMeta &meta, const Tuple &tuple, WritePageGuard *guard) -> std::optional<RID>;
+
+  /** Insert into the last page, adding pages as needed. Fills `guard` with the latched page. */
+  auto AppendTuple(const TupleMeta &meta, const Tuple &tuple, WritePageGuard *guard) -> RID;
+
+  /** Insert into the page of `guard`, in the layout of the table. @return the slot, or nullopt if the page is full */
+  auto InsertIntoPage(WritePageGuard *guard, const TupleMeta &meta, const Tuple &tuple) -> std::optional<uint16_t>;
+
+  /** Link the page `next_page_id` after the page of `guard`. */
+  void LinkPage(WritePageGuard *guard, page_id_t next_page_id);
+
+  /** Link a new empty page after the last page and return its id. Must be called with `latch_` held. */
+  auto AppendPage() -> page_id_t;
+
+  /** Compress the tail of every page of a COMPRESSED table. @return the number of bytes freed */
+  auto CompressPages() -> size_t;
+
+  /** @return the id of the page at `index` in the page chain, which must exist */
+  auto GetPageIdAt(size_t index) -> page_id_t;
+
+  /** @return the id of the page after `page_id` in the page chain, looked up in the page directory */
+  auto GetPageIdAfter(page_id_t page_id) -> page_id_t;
+
+  /** Add `page_ids`, linked in this order after the last page, to the page directory. Must hold `latch_`. */
+  void AddToDirectory(const std::vector<page_id_t> &page_ids);
+
+  /** Allocate and initialize an empty page, and add it to the free space map unless `track_free_space` is false. */
+  auto NewPage(bool track_free_space = true) -> page_id_t;
+
+  /**
+   * Read the out-of-line values of the columns in `column_ids` (all if nullptr) of the live tuples in `views` into
+   * `tuples`, and point the views there instead.
+   */
+  void DetoastViews(const std::vector<uint32_t> *column_ids, std::vector<TupleView> *views,
+                    std::vector<Tuple> *tuples) const;
+
   BufferPoolManager *bpm_;
+  /** The schema of the tuples, nullptr if the table heap was created without one. */
+  std::unique_ptr<const Schema> schema_;
+  /** Where large values are stored, only used if `schema_` is set. */
+  ToastStore toast_;
+  TableLayout layout_{TableLayout::ROW};
+  /** How the tuples of a PAX table are laid out in a page, nullptr for a table of TablePages. */
+  std::unique_ptr<const PaxLayout> pax_layout_;
   page_id_t first_page_id_{INVALID_PAGE_ID};
 
   std::mutex latch_;
   page_id_t last_page_id_{INVALID_PAGE_ID}; /* protected by latch_ */
+  /** The ids of all pages in the order of the page chain. Pages are never unlinked, so it only grows. */
+  std::vector<page_id_t> page_directory_; /* protected by latch_ */
+  /** The index of each page in page_directory_. */
+  std::unordered_map<page_id_t, size_t> page_indexes_; /* protected by latch_ */
+  /** The summaries of the pages, only kept if `schema_` is set. */
+  std::unique_ptr<ZoneMap> zone_map_;
+
+  FreeSpaceMap free_space_map_;
+  /** The page each insert slot last inserted into, tried first by the next insert of that slot. */
+  std::array<std::atomic<page_id_t>, NUM_INSERT_SLOTS> insert_pages_;
+  /** The number of open iterators, and how many of them have a stop RID. */
+  std::atomic<size_t> open_scans_{0};
+  std::atomic<size_t> bounded_scans_{0};
+  /** The number of pages read by TableIterator::NextBatch. */
+  std::atomic<size_t> pages_scanned_{0};
+
+  /**
+   * The dead tuples not reclaimed yet, kept up to date next to the free space map of ROW tables, and how many of them
+   * the last vacuum left behind in pages below its dead ratio.
+   */
+  std::atomic<size_t> num_dead_tuples_{0};
+  std::atomic<size_t> num_dead_tuples_after_vacuum_{0};
+  /** Set when a tuple goes into the tail of a compressed page, cleared by the vacuum that compresses it. */
+  std::atomic<bool> has_uncompressed_tails_{false};
 };
 
 }  // namespace bustub
@@ -12,19 +12,49 @@
 
 #pragma once
 
+#include <atomic>
 #include <cassert>
 #include <memory>
+#include <optional>
 #include <utility>
+#include <vector>
 
+#include "common/config.h"
 #include "common/macros.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
 #include "storage/table/tuple.h"
+#include "storage/table/zone_map.h"
 
 namespace bustub {
 
 class TableHeap;
 
+/**
+ * TupleViewBatch holds the tuples of one table page, filled by TableIterator::NextBatch. The batch owns a copy of the
+ * page, so its views stay valid after the page latch is released and until the batch is refilled or destroyed.
+ * Refilling reuses the copy and the view array, so a scan through a batch does not allocate per tuple. The tuples of
+ * a PAX page, compressed tuples, and tuples whose values are read from out of line are put back together in buffers
+ * of the batch as well.
+ */
+class TupleViewBatch {
+  friend class TableIterator;
+
+ public:
+  TupleViewBatch() : page_(new char[BUSTUB_PAGE_SIZE]) {}
+
+  /** @return the number of tuples in the batch, deleted ones included */
+  auto Size() const -> size_t { return views_.size(); }
+
+  auto operator[](size_t i) const -> const TupleView & { return views_[i]; }
+
+ private:
+  std::unique_ptr<char[]> page_;
+  std::vector<char> tuple_data_;
+  std::vector<Tuple> detoasted_tuples_;
+  std::vector<TupleView> views_;
+};
+
 /**
  * TableIterator enables the sequential scan of a TableHeap.
  */
@@ -34,10 +64,11 @@ class TableIterator {
  public:
   DISALLOW_COPY(TableIterator);
 
+  /** Only created by TableHeap, which counts the open iterators; the destructor uncounts them. */
   TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid);
-  TableIterator(TableIterator &&) = default;
+  TableIterator(TableIterator &&that) noexcept;
 
-  ~TableIterator() = default;
+  ~TableIterator();
 
   auto GetTuple() -> std::pair<TupleMeta, Tuple>;
 
@@ -47,7 +78,23 @@ class TableIterator {
 
   auto operator++() -> TableIterator &;
 
+  /**
+   * Fill `batch` with the tuples from the current position to the end of its page and move to the next page. The
+   * page is fetched once for the whole batch, instead of once per tuple as with GetTuple and operator++.
+   * @param column_ids the columns the caller reads, or nullptr for all. The other columns must not be read: in a PAX
+   * table, and in the compressed tuples of a COMPRESSED table, they are not read at all and are NULL in the batch,
+   * and elsewhere their values stored out of line are not read either.
+   * @param bounds bounds all tuples the caller keeps satisfy, or nullptr. Pages whose zone shows they hold no such
+   * tuple are skipped without being fetched; the others are returned whole, the caller still has to filter them.
+   * @return false if the iterator is at the end, in which case the batch is empty
+   */
+  auto NextBatch(TupleViewBatch *batch, const std::vector<uint32_t> *column_ids = nullptr,
+                 const std::vector<ZoneBound> *bounds = nullptr) -> bool;
+
  private:
+  /** Move rid_ to the first tuple at or after it, skipping pages without tuples, or to the end. */
+  void SkipEmptyPages();
+
   TableHeap *table_heap_;
   RID rid_;
 
@@ -57,4 +104,44 @@ class TableIterator {
   RID stop_at_rid_;
 };
 
+/**
+ * ParallelTableScan splits a scan of a TableHeap into morsels, disjoint ranges of consecutive pages that several
+ * workers scan at the same time, each with a TableIterator of its own. The ranges are cut out of the page directory of
+ * the table heap, so handing one out takes O(1) instead of a walk of the page chain.
+ *
+ * Like TableHeap::MakeIterator, the scan sees the tuples that were in the table when it was created: while it is
+ * alive, inserts only append to the end of the heap, behind its last page.
+ */
+class ParallelTableScan {
+  friend class TableHeap;
+
+ public:
+  DISALLOW_COPY_AND_MOVE(ParallelTableScan);
+
+  ~ParallelTableScan();
+
+  /** @return the number of pages the scan covers */
+  auto GetNumPages() const -> size_t { return num_pages_; }
+
+  /**
+   * Hand out the next morsel of `pages_per_morsel` pages. Thread safe.
+   * @return an iterator over the morsel, or nullopt once all pages have been handed out
+   */
+  auto NextMorsel() -> std::optional<TableIterator>;
+
+  /** @return an iterator over pages [begin, end) of the scan, which must not be past GetNumPages */
+  auto MakeIterator(size_t begin, size_t end) -> TableIterator;
+
+ private:
+  ParallelTableScan(TableHeap *table_heap, size_t pages_per_morsel);
+
+  TableHeap *table_heap_;
+  size_t pages_per_morsel_;
+  size_t num_pages_;
+  /** Where the scan ends in its last page. */
+  RID stop_at_rid_;
+  /** The first page of the next morsel. */
+  std::atomic<size_t> next_page_{0};
+};
+
 }  // namespace bustub
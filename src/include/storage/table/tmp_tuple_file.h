@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_file.h
+//
+// Identification: src/include/storage/table/tmp_tuple_file.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TmpTupleFile holds tuples that an executor spills out of memory, e.g. a partition of a hash table larger than its
+ * memory budget, in TmpTuplePages of the buffer pool. Tuples are appended, then read back in the order they were
+ * appended with a Reader. The pages are deleted with the file.
+ *
+ * The page being filled is kept outside of the buffer pool until it is full, so an open file pins no frame.
+ */
+class TmpTupleFile {
+ public:
+  explicit TmpTupleFile(BufferPoolManager *bpm);
+
+  ~TmpTupleFile();
+
+  DISALLOW_COPY_AND_MOVE(TmpTupleFile);
+
+  /** Append `tuple`, which must fit into a page. */
+  void Append(const TupleRef &tuple);
+
+  /** @return the number of tuples appended */
+  auto NumTuples() const -> size_t { return num_tuples_; }
+
+  /** @return the number of pages written to the buffer pool */
+  auto NumPages() const -> size_t { return page_ids_.size(); }
+
+  /** Reader reads the tuples of a file in order. The file must not be appended to while it is read. */
+  class Reader {
+   public:
+    explicit Reader(TmpTupleFile *file) : file_(file) {}
+
+    /** Read the next tuple into `tuple`. @return false if all tuples have been read */
+    auto Next(Tuple *tuple) -> bool;
+
+   private:
+    /** Copy the next page, the buffered one after the pages of the buffer pool, into `page_`. */
+    auto LoadPage() -> bool;
+
+    TmpTupleFile *file_;
+    /** The index of the next page to load, counting the buffered page last */
+    size_t next_page_{0};
+    TmpTuplePage page_;
+    /** The offsets of the tuples of `page_` not read yet, the next one last */
+    std::vector<size_t> offsets_;
+  };
+
+ private:
+  BufferPoolManager *bpm_;
+  /** The full pages, in order */
+  std::vector<page_id_t> page_ids_;
+  /** The page being filled */
+  TmpTuplePage page_;
+  size_t num_tuples_{0};
+};
+
+}  // namespace bustub
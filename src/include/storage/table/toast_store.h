@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// toast_store.h
+//
+// Identification: src/include/storage/table/toast_store.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * The high bit of the length of a VARCHAR value in a tuple marks a value stored out of line. The low bits still give
+ * the number of bytes that follow the length, which are a ToastPointer instead of the characters.
+ */
+static constexpr uint32_t TOAST_FLAG = 1U << 31;
+
+/** Where a VARCHAR value stored out of line is, see ToastStore. */
+struct ToastPointer {
+  /** The first page of the chain of overflow pages holding the value. */
+  page_id_t first_page_id_;
+  /** The length of the value. */
+  uint32_t raw_size_;
+  /** The number of bytes in the overflow pages, less than `raw_size_` if the value is compressed. */
+  uint32_t stored_size_;
+  uint32_t is_compressed_;
+};
+
+/**
+ * ToastStore keeps the large VARCHAR values of a TableHeap out of line, like PostgreSQL's TOAST ("The Oversized
+ * Attribute Storage Technique").
+ *
+ * A tuple longer than TOAST_TUPLE_THRESHOLD has its largest VARCHAR values moved into chains of OverflowPages until
+ * it is short enough, so tuples of any length fit into a table page and pages of tuples with large values are still
+ * well filled. A value that compresses well is compressed first. In the tuple, the value is replaced by a
+ * ToastPointer flagged by TOAST_FLAG; only readers of that column need to follow it, so a scan that does not read a
+ * large column never touches its overflow pages.
+ *
+ * The overflow pages of values whose tuple was deleted or overwritten are released, and deleted by `FreeReleased`
+ * once no reader can still hold a pointer to them.
+ */
+class ToastStore {
+ public:
+  explicit ToastStore(BufferPoolManager *bpm) : bpm_(bpm) {}
+
+  /** Tuples longer than this have values moved out of line. */
+  static constexpr uint32_t TOAST_TUPLE_THRESHOLD = BUSTUB_PAGE_SIZE / 4;
+
+  /** Values shorter than this always stay in their tuple. */
+  static constexpr uint32_t TOAST_MIN_VALUE_SIZE = 128;
+
+  /**
+   * Move the largest VARCHAR values of `tuple` out of line until it is at most TOAST_TUPLE_THRESHOLD bytes long.
+   * @return the tuple with pointers in place of the moved values, or nullopt if `tuple` is short enough as it is
+   */
+  auto Toast(const Schema &schema, const Tuple &tuple) -> std::optional<Tuple>;
+
+  /**
+   * Read the values of `tuple` that are stored out of line back into it. Only the columns in `column_ids` are read;
+   * the values of other columns are left as pointers and must not be read.
+   * @param column_ids the columns to read, or nullptr to read all of them
+   */
+  auto Detoast(const Schema &schema, const TupleRef &tuple, const std::vector<uint32_t> *column_ids = nullptr) const
+      -> Tuple;
+
+  /**
+   * @return true if a value of `tuple` among `columns` is stored out of line
+   * @param columns indexes of VARCHAR columns of `schema`
+   */
+  static auto IsToasted(const Schema &schema, const TupleRef &tuple, const std::vector<uint32_t> &columns) -> bool;
+
+  /** Release the overflow pages of the values of `tuple` that are stored out of line, see `FreeReleased`. */
+  void Release(const Schema &schema, const TupleRef &tuple);
+
+  /**
+   * Delete the overflow pages of all released values. Only safe when nobody can still read those values, e.g. no
+   * scan of the table is open.
+   * @return the number of pages deleted
+   */
+  auto FreeReleased() -> size_t;
+
+  /** @return true if values were released and `FreeReleased` has not deleted them yet */
+  auto HasReleased() -> bool;
+
+  /** @return false if no value was ever stored out of line, in which case tuples never need to be detoasted */
+  auto HasToastedValues() const -> bool { return has_toasted_values_; }
+
+ private:
+  /** Write `size` bytes into a new chain of overflow pages. @return the first page of the chain */
+  auto WriteChain(const char *data, uint32_t size) -> page_id_t;
+
+  /** Read the value that `pointer` points to into `out`, which has room for its raw size. */
+  void ReadValue(const ToastPointer &pointer, char *out) const;
+
+  BufferPoolManager *bpm_;
+  std::atomic<bool> has_toasted_values_{false};
+
+  std::mutex latch_;
+  /** The first pages of the chains released and not deleted yet. Protected by latch_. */
+  std::vector<page_id_t> released_chains_;
+};
+
+}  // namespace bustub
@@ -21,6 +21,8 @@
 
 namespace bustub {
 
+class TupleRef;
+
 static constexpr size_t TUPLE_META_SIZE = 12;
 
 struct TupleMeta {
@@ -42,6 +44,17 @@ struct TupleMeta {
 
 static_assert(sizeof(TupleMeta) == TUPLE_META_SIZE);
 
+/**
+ * A tuple that is read in place rather than copied out, see TablePage::GetTupleViews. `data_` is only valid as long
+ * as the memory it points into is.
+ */
+struct TupleView {
+  RID rid_;
+  TupleMeta meta_;
+  const char *data_;
+  uint32_t size_;
+};
+
 /**
  * Tuple format:
  * ---------------------------------------------------------------------
@@ -80,6 +93,9 @@ class Tuple {
   // deserialize tuple data(deep copy)
   void DeserializeFrom(const char *storage);
 
+  // replace this tuple with a copy of `tuple`, reusing the buffer of this tuple when it is large enough
+  void CopyFrom(const TupleRef &tuple);
+
   // return RID of current tuple
   inline auto GetRid() const -> RID { return rid_; }
 
@@ -104,12 +120,51 @@ class Tuple {
 
   auto ToString(const Schema *schema) const -> std::string;
 
+ private:
+  RID rid_{};  // if pointing to the table heap, the rid is valid
+  std::vector<char> data_;
+};
+
+/**
+ * TupleRef reads a tuple in place without owning it. It can point into a page, a TupleViewBatch, or a buffer of an
+ * executor, and is only valid as long as that memory is. Executors pass TupleRefs down the pipeline (see
+ * AbstractExecutor::NextRef) and only make an owning Tuple, with `ToTuple` or `Tuple::CopyFrom`, when they keep it.
+ */
+class TupleRef {
+ public:
+  TupleRef() = default;
+
+  TupleRef(RID rid, const char *data, uint32_t size) : rid_(rid), data_(data), size_(size) {}
+
+  TupleRef(const Tuple &tuple)  // NOLINT: a tuple can be used wherever a reference to one is expected
+      : rid_(tuple.GetRid()), data_(tuple.GetData()), size_(tuple.GetLength()) {}
+
+  TupleRef(const TupleView &view)  // NOLINT: a view is a reference to a tuple in a batch
+      : rid_(view.rid_), data_(view.data_), size_(view.size_) {}
+
+  inline auto GetRid() const -> RID { return rid_; }
+
+  inline auto GetData() const -> const char * { return data_; }
+
+  inline auto GetLength() const -> uint32_t { return size_; }
+
+  // Get the value of a specified column, see Tuple::GetValue
+  auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value;
+
+  inline auto IsNull(const Schema *schema, uint32_t column_idx) const -> bool {
+    return GetValue(schema, column_idx).IsNull();
+  }
+
+  // Make an owning copy of the tuple
+  auto ToTuple() const -> Tuple;
+
  private:
   // Get the starting storage address of specific column
   auto GetDataPtr(const Schema *schema, uint32_t column_idx) const -> const char *;
 
-  RID rid_{};  // if pointing to the table heap, the rid is valid
-  std::vector<char> data_;
+  RID rid_{};
+  const char *data_{nullptr};
+  uint32_t size_{0};
 };
 
 }  // namespace bustub
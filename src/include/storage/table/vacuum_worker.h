@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vacuum_worker.h
+//
+// Identification: src/include/storage/table/vacuum_worker.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
+#include <thread>              // NOLINT
+#include <vector>
+
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+/**
+ * VacuumWorker runs TableHeap::Vacuum in the background for all the tables of a catalog, from a single thread. Every
+ * `interval` it vacuums the tables that have something to reclaim, see TableHeap::NeedsVacuum, so a database of
+ * many tables that are only read costs it a few atomic loads per table.
+ */
+class VacuumWorker {
+ public:
+  /**
+   * @param interval how long the worker sleeps between two rounds over the tables
+   * @param min_dead_ratio pages with at least this fraction of dead tuples are compacted
+   */
+  explicit VacuumWorker(std::chrono::milliseconds interval,
+                        double min_dead_ratio = TableHeap::VACUUM_MIN_DEAD_RATIO)
+      : interval_(interval), min_dead_ratio_(min_dead_ratio) {}
+
+  /** Stop the worker, waiting for the table it is vacuuming, if any. */
+  ~VacuumWorker();
+
+  VacuumWorker(const VacuumWorker &) = delete;
+  auto operator=(const VacuumWorker &) -> VacuumWorker & = delete;
+
+  /** Vacuum `table` from now on. The table must outlive the worker. Starts the thread with the first table. */
+  void AddTable(TableHeap *table);
+
+  /**
+   * Vacuum each table that needs it once, in the calling thread.
+   * @return the number of bytes reclaimed
+   */
+  auto VacuumTables() -> size_t;
+
+ private:
+  std::chrono::milliseconds interval_;
+  double min_dead_ratio_;
+
+  std::mutex latch_;
+  std::condition_variable cv_;
+  /** The tables to vacuum, in the order they were added. Protected by latch_. */
+  std::vector<TableHeap *> tables_;
+  bool stopped_{false}; /* protected by latch_ */
+  std::thread thread_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.h
+//
+// Identification: src/include/storage/table/zone_map.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * A condition `column op value` that every tuple produced by a scan satisfies, e.g. from `WHERE column < 10`, or
+ * `column op value OR column IS NULL` if `or_null_` is set.
+ */
+struct ZoneBound {
+  enum class Op : uint8_t { EQ, LT, LE, GT, GE };
+
+  uint32_t column_idx_;
+  Op op_;
+  Value value_;
+  bool or_null_{false};
+};
+
+/**
+ * ZoneMap summarizes the tuples of each page of a TableHeap: for every numeric column, the smallest and largest value
+ * and the number of NULLs. A scan whose filter implies some ZoneBounds skips the pages whose zones cannot satisfy them,
+ * without reading them at all.
+ *
+ * Zones are widened as tuples are inserted or updated, but not narrowed when tuples are deleted, so a zone covers at
+ * least the values of its page; `Rebuild` narrows it down to the live tuples again.
+ */
+class ZoneMap {
+ public:
+  /** The range of the values of a column in a page. min_ and max_ are nullopt if all of them are NULL. */
+  struct ColumnZone {
+    std::optional<Value> min_;
+    std::optional<Value> max_;
+    uint32_t num_tuples_{0};
+    uint32_t num_nulls_{0};
+  };
+
+  explicit ZoneMap(const Schema &schema);
+
+  /** @return true if the values of the column `column_idx` are summarized */
+  auto IsTracked(uint32_t column_idx) const -> bool { return column_zone_idx_[column_idx] != UNTRACKED; }
+
+  /** Widen the zone of `page_id` to cover `tuple`. */
+  void Add(page_id_t page_id, const TupleRef &tuple);
+
+  /** Replace the zone of `page_id` by one that covers exactly `tuples`. */
+  void Rebuild(page_id_t page_id, const std::vector<TupleView> &tuples);
+
+  /** @return false if no tuple of `page_id` can satisfy all of `bounds` */
+  auto MayMatch(page_id_t page_id, const std::vector<ZoneBound> &bounds) const -> bool;
+
+  /** @return the zone of column `column_idx` in `page_id`, or nullopt if the column is untracked or the page empty */
+  auto GetZone(page_id_t page_id, uint32_t column_idx) const -> std::optional<ColumnZone>;
+
+ private:
+  static constexpr uint32_t UNTRACKED = UINT32_MAX;
+
+  /** @return the values of the tracked columns of `tuple` */
+  auto TrackedValues(const TupleRef &tuple) const -> std::vector<Value>;
+
+  /** Widen `zones` to cover `values`. */
+  static void Widen(const std::vector<Value> &values, std::vector<ColumnZone> *zones);
+
+  const Schema schema_;
+  /** The columns that are summarized, and for each column its index among them or UNTRACKED. */
+  std::vector<uint32_t> columns_;
+  std::vector<uint32_t> column_zone_idx_;
+
+  mutable std::mutex latch_;
+  /** The zones of each page, one per column in columns_. Protected by latch_. */
+  std::unordered_map<page_id_t, std::vector<ColumnZone>> zones_;
+};
+
+}  // namespace bustub
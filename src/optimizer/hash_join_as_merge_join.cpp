@@ -0,0 +1,103 @@
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/merge_join_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/topn_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+/** Add the leading column keys of `order_bys` that are in ascending order to `column_ids`. */
+static void CollectSortedColumns(const std::vector<std::pair<OrderByType, AbstractExpressionRef>> &order_bys,
+                                 std::vector<uint32_t> *column_ids) {
+  for (const auto &[order_by_type, expr] : order_bys) {
+    const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(expr.get());
+    if (order_by_type == OrderByType::DESC || column_expr == nullptr) {
+      return;
+    }
+    column_ids->push_back(column_expr->GetColIdx());
+  }
+}
+
+/** @return the columns that the tuples `plan` outputs are in ascending order of, the first one first */
+static auto SortedColumns(const Catalog &catalog, const AbstractPlanNodeRef &plan) -> std::vector<uint32_t> {
+  std::vector<uint32_t> column_ids;
+  switch (plan->GetType()) {
+    case PlanType::Sort:
+      CollectSortedColumns(dynamic_cast<const SortPlanNode &>(*plan).GetOrderBy(), &column_ids);
+      break;
+    case PlanType::TopN:
+      CollectSortedColumns(dynamic_cast<const TopNPlanNode &>(*plan).GetOrderBy(), &column_ids);
+      break;
+    case PlanType::IndexScan: {
+      // The OrderByAsIndexScan rule scans an index in key order, outputting the tuples of its table.
+      const auto *index_info = catalog.GetIndex(dynamic_cast<const IndexScanPlanNode &>(*plan).GetIndexOid());
+      if (index_info != Catalog::NULL_INDEX_INFO) {
+        column_ids = index_info->index_->GetKeyAttrs();
+      }
+      break;
+    }
+    case PlanType::Filter:
+    case PlanType::Limit:
+      return SortedColumns(catalog, plan->GetChildAt(0));
+    case PlanType::MergeJoin:
+      // The output of a merge join is in the order of its left side, whose columns come first.
+      return SortedColumns(catalog, plan->GetChildAt(0));
+    default:
+      break;
+  }
+  return column_ids;
+}
+
+/** @return true if the tuples of `plan` are in ascending order of the column keys `keys` */
+static auto IsSortedOn(const Catalog &catalog, const AbstractPlanNodeRef &plan,
+                       const std::vector<AbstractExpressionRef> &keys) -> bool {
+  auto column_ids = SortedColumns(catalog, plan);
+  if (column_ids.size() < keys.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < keys.size(); i++) {
+    const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(keys[i].get());
+    if (column_expr == nullptr || column_expr->GetColIdx() != column_ids[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto Optimizer::OptimizeHashJoinAsMergeJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeHashJoinAsMergeJoin(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+  if (optimized_plan->GetType() != PlanType::HashJoin) {
+    return optimized_plan;
+  }
+  const auto &join_plan = dynamic_cast<const HashJoinPlanNode &>(*optimized_plan);
+  if (join_plan.GetJoinType() != JoinType::INNER && join_plan.GetJoinType() != JoinType::LEFT) {
+    return optimized_plan;
+  }
+  const auto &left_keys = join_plan.LeftJoinKeyExpressions();
+  const auto &right_keys = join_plan.RightJoinKeyExpressions();
+  // The keys are compared by their normalized keys, which only agree for values of the same type.
+  for (size_t i = 0; i < left_keys.size(); i++) {
+    if (left_keys[i]->GetReturnType() != right_keys[i]->GetReturnType()) {
+      return optimized_plan;
+    }
+  }
+  if (!IsSortedOn(catalog_, join_plan.GetLeftPlan(), left_keys) ||
+      !IsSortedOn(catalog_, join_plan.GetRightPlan(), right_keys)) {
+    return optimized_plan;
+  }
+  return std::make_shared<MergeJoinPlanNode>(join_plan.output_schema_, join_plan.GetLeftPlan(),
+                                             join_plan.GetRightPlan(), left_keys, right_keys,
+                                             join_plan.GetJoinType());
+}
+
+}  // namespace bustub
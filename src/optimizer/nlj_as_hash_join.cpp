@@ -7,6 +7,7 @@
 #include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/comparison_expression.h"
 #include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
 #include "execution/plans/abstract_plan.h"
 #include "execution/plans/filter_plan.h"
 #include "execution/plans/hash_join_plan.h"
@@ -17,12 +18,49 @@
 
 namespace bustub {
 
+/**
+ * Split the predicate of a join into the keys of a hash join: comparisons for equality of a column of each side,
+ * combined with AND.
+ * @return false if the predicate has any other form
+ */
+static auto ExtractJoinKeys(const AbstractExpressionRef &expr, std::vector<AbstractExpressionRef> *left_keys,
+                            std::vector<AbstractExpressionRef> *right_keys) -> bool {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(expr.get()); logic_expr != nullptr) {
+    return logic_expr->logic_type_ == LogicType::And && ExtractJoinKeys(expr->GetChildAt(0), left_keys, right_keys) &&
+           ExtractJoinKeys(expr->GetChildAt(1), left_keys, right_keys);
+  }
+  const auto *comparison_expr = dynamic_cast<const ComparisonExpression *>(expr.get());
+  if (comparison_expr == nullptr || comparison_expr->comp_type_ != ComparisonType::Equal) {
+    return false;
+  }
+  const auto *lhs = dynamic_cast<const ColumnValueExpression *>(expr->GetChildAt(0).get());
+  const auto *rhs = dynamic_cast<const ColumnValueExpression *>(expr->GetChildAt(1).get());
+  if (lhs == nullptr || rhs == nullptr || lhs->GetTupleIdx() == rhs->GetTupleIdx()) {
+    return false;
+  }
+  left_keys->push_back(lhs->GetTupleIdx() == 0 ? expr->GetChildAt(0) : expr->GetChildAt(1));
+  right_keys->push_back(lhs->GetTupleIdx() == 0 ? expr->GetChildAt(1) : expr->GetChildAt(0));
+  return true;
+}
+
 auto Optimizer::OptimizeNLJAsHashJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
-  // TODO(student): implement NestedLoopJoin -> HashJoin optimizer rule
-  // Note for 2023 Spring: You should at least support join keys of the form:
-  // 1. <column expr> = <column expr>
-  // 2. <column expr> = <column expr> AND <column expr> = <column expr>
-  return plan;
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeNLJAsHashJoin(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() == PlanType::NestedLoopJoin) {
+    const auto &nlj_plan = dynamic_cast<const NestedLoopJoinPlanNode &>(*optimized_plan);
+    std::vector<AbstractExpressionRef> left_keys;
+    std::vector<AbstractExpressionRef> right_keys;
+    if (ExtractJoinKeys(nlj_plan.Predicate(), &left_keys, &right_keys)) {
+      return std::make_shared<HashJoinPlanNode>(nlj_plan.output_schema_, nlj_plan.GetLeftPlan(),
+                                                nlj_plan.GetRightPlan(), std::move(left_keys), std::move(right_keys),
+                                                nlj_plan.GetJoinType());
+    }
+  }
+  return optimized_plan;
 }
 
 }  // namespace bustub
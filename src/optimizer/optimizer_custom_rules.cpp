@@ -12,8 +12,13 @@ auto Optimizer::OptimizeCustom(const AbstractPlanNodeRef &plan) -> AbstractPlanN
   p = OptimizeMergeProjection(p);
   p = OptimizeMergeFilterNLJ(p);
   p = OptimizeNLJAsHashJoin(p);
+  // Before the rules below, which set up the scans, since it makes a new scan from the filter.
+  p = OptimizeMergeFilterScan(p);
   p = OptimizeOrderByAsIndexScan(p);
   p = OptimizeSortLimitAsTopN(p);
+  p = OptimizeHashJoinAsMergeJoin(p);
+  p = OptimizePruneScanColumns(p);
+  p = OptimizeRuntimeFilter(p);
   return p;
 }
 
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+/** Add the columns that `expr` reads from its (only) input to `column_ids`. */
+static void CollectColumns(const AbstractExpressionRef &expr, std::vector<uint32_t> *column_ids) {
+  if (expr == nullptr) {
+    return;
+  }
+  if (const auto *column_value_expr = dynamic_cast<const ColumnValueExpression *>(expr.get());
+      column_value_expr != nullptr) {
+    column_ids->push_back(column_value_expr->GetColIdx());
+  }
+  for (const auto &child : expr->GetChildren()) {
+    CollectColumns(child, column_ids);
+  }
+}
+
+auto Optimizer::OptimizePruneScanColumns(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizePruneScanColumns(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  // Only a projection or an aggregation drops columns; the scan may sit below a filter.
+  std::vector<uint32_t> column_ids;
+  if (optimized_plan->GetType() == PlanType::Projection) {
+    for (const auto &expr : dynamic_cast<const ProjectionPlanNode &>(*optimized_plan).GetExpressions()) {
+      CollectColumns(expr, &column_ids);
+    }
+  } else if (optimized_plan->GetType() == PlanType::Aggregation) {
+    const auto &agg_plan = dynamic_cast<const AggregationPlanNode &>(*optimized_plan);
+    for (const auto &expr : agg_plan.GetGroupBys()) {
+      CollectColumns(expr, &column_ids);
+    }
+    for (const auto &expr : agg_plan.GetAggregates()) {
+      CollectColumns(expr, &column_ids);
+    }
+  } else {
+    return optimized_plan;
+  }
+
+  auto child_plan = optimized_plan->GetChildAt(0);
+  const FilterPlanNode *filter_plan = nullptr;
+  if (child_plan->GetType() == PlanType::Filter) {
+    filter_plan = dynamic_cast<const FilterPlanNode *>(child_plan.get());
+    CollectColumns(filter_plan->GetPredicate(), &column_ids);
+    child_plan = child_plan->GetChildAt(0);
+  }
+  if (child_plan->GetType() != PlanType::SeqScan) {
+    return optimized_plan;
+  }
+  const auto &seq_scan_plan = dynamic_cast<const SeqScanPlanNode &>(*child_plan);
+  // Reading fewer columns only saves work when the table stores each column separately (PAX and COMPRESSED), or may
+  // keep VARCHAR values out of line.
+  const auto *table_info = catalog_.GetTable(seq_scan_plan.GetTableOid());
+  if (seq_scan_plan.column_ids_.has_value() || table_info == Catalog::NULL_TABLE_INFO ||
+      table_info->table_ == nullptr ||
+      (table_info->table_->GetLayout() == TableLayout::ROW && table_info->schema_.IsInlined())) {
+    return optimized_plan;
+  }
+  CollectColumns(seq_scan_plan.filter_predicate_, &column_ids);
+  std::sort(column_ids.begin(), column_ids.end());
+  column_ids.erase(std::unique(column_ids.begin(), column_ids.end()), column_ids.end());
+
+  auto pruned_scan = std::make_shared<SeqScanPlanNode>(seq_scan_plan);
+  pruned_scan->column_ids_ = std::move(column_ids);
+  AbstractPlanNodeRef new_child = pruned_scan;
+  if (filter_plan != nullptr) {
+    new_child = filter_plan->CloneWithChildren({new_child});
+  }
+  return optimized_plan->CloneWithChildren({new_child});
+}
+
+}  // namespace bustub
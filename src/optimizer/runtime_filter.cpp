@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/limit_plan.h"
+#include "execution/plans/mock_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/values_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+/** The fraction of its input a filter is assumed to pass, without statistics on the values of the columns */
+static constexpr double FILTER_SELECTIVITY = 1.0 / 3;
+
+/** The largest fraction of the probe side a join may be estimated to match for a runtime filter to pay off */
+static constexpr double MAX_RUNTIME_FILTER_SELECTIVITY = 0.5;
+
+auto Optimizer::EstimatePlanRows(const AbstractPlanNodeRef &plan, bool apply_filters) -> std::optional<double> {
+  switch (plan->GetType()) {
+    case PlanType::SeqScan: {
+      const auto &seq_scan_plan = dynamic_cast<const SeqScanPlanNode &>(*plan);
+      std::optional<double> rows = EstimatedCardinality(seq_scan_plan.table_name_);
+      if (!rows.has_value()) {
+        const auto *table_info = catalog_.GetTable(seq_scan_plan.GetTableOid());
+        if (table_info == Catalog::NULL_TABLE_INFO || table_info->table_ == nullptr) {
+          return std::nullopt;
+        }
+        // Without a count of the tuples, assume full pages of tuples with their values inlined.
+        auto tuple_size = table_info->schema_.GetLength() + sizeof(uint64_t);
+        rows = static_cast<double>(table_info->table_->GetNumPages()) * BUSTUB_PAGE_SIZE / tuple_size;
+      }
+      if (apply_filters && seq_scan_plan.filter_predicate_ != nullptr) {
+        *rows *= FILTER_SELECTIVITY;
+      }
+      return rows;
+    }
+    case PlanType::MockScan: {
+      auto rows = EstimatedCardinality(dynamic_cast<const MockScanPlanNode &>(*plan).GetTable());
+      return rows.has_value() ? std::make_optional<double>(*rows) : std::nullopt;
+    }
+    case PlanType::Values:
+      return dynamic_cast<const ValuesPlanNode &>(*plan).GetValues().size();
+    case PlanType::Filter: {
+      auto rows = EstimatePlanRows(plan->GetChildAt(0), apply_filters);
+      if (rows.has_value() && apply_filters) {
+        *rows *= FILTER_SELECTIVITY;
+      }
+      return rows;
+    }
+    case PlanType::Limit: {
+      auto rows = EstimatePlanRows(plan->GetChildAt(0), apply_filters);
+      auto limit = static_cast<double>(dynamic_cast<const LimitPlanNode &>(*plan).GetLimit());
+      return rows.has_value() ? std::min(*rows, limit) : limit;
+    }
+    case PlanType::Aggregation:
+      if (dynamic_cast<const AggregationPlanNode &>(*plan).GetGroupBys().empty()) {
+        return 1;
+      }
+      return EstimatePlanRows(plan->GetChildAt(0), apply_filters);
+    case PlanType::Projection:
+    case PlanType::Sort:
+    case PlanType::TopN:
+      return EstimatePlanRows(plan->GetChildAt(0), apply_filters);
+    case PlanType::HashJoin:
+    case PlanType::MergeJoin:
+    case PlanType::NestedLoopJoin:
+    case PlanType::NestedIndexJoin:
+      // Most joins look up a key of the right side for each row of the left side.
+      return EstimatePlanRows(plan->GetChildAt(0), apply_filters);
+    default:
+      return std::nullopt;
+  }
+}
+
+auto Optimizer::OptimizeRuntimeFilter(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeRuntimeFilter(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+  if (optimized_plan->GetType() != PlanType::HashJoin) {
+    return optimized_plan;
+  }
+  const auto &join_plan = dynamic_cast<const HashJoinPlanNode &>(*optimized_plan);
+  // A left join outputs every left tuple, matched or not.
+  if (join_plan.GetJoinType() != JoinType::INNER) {
+    return optimized_plan;
+  }
+
+  // Filters keep the schema of their input, so the join keys of the left side can be evaluated on the scan below them.
+  std::vector<const FilterPlanNode *> filters;
+  auto child_plan = join_plan.GetLeftPlan();
+  while (child_plan->GetType() == PlanType::Filter) {
+    filters.push_back(dynamic_cast<const FilterPlanNode *>(child_plan.get()));
+    child_plan = child_plan->GetChildAt(0);
+  }
+  if (child_plan->GetType() != PlanType::SeqScan) {
+    return optimized_plan;
+  }
+  // The join keys are read by the join, so a scan with pruned columns still reads them.
+  const auto &seq_scan_plan = dynamic_cast<const SeqScanPlanNode &>(*child_plan);
+
+  // If the right side is filtered down to a fraction of its table, the left side, joined to it on a foreign key, is
+  // estimated to match about the same fraction. Only then does the filter drop enough tuples to pay for itself.
+  auto build_rows = EstimatePlanRows(join_plan.GetRightPlan(), true);
+  auto build_table_rows = EstimatePlanRows(join_plan.GetRightPlan(), false);
+  auto probe_rows = EstimatePlanRows(join_plan.GetLeftPlan(), true);
+  if (!build_rows.has_value() || !build_table_rows.has_value() || !probe_rows.has_value() ||
+      *build_table_rows == 0 || *build_rows / *build_table_rows > MAX_RUNTIME_FILTER_SELECTIVITY ||
+      *probe_rows < *build_rows) {
+    return optimized_plan;
+  }
+
+  auto filtered_scan = std::make_shared<SeqScanPlanNode>(seq_scan_plan);
+  filtered_scan->runtime_filter_ = RuntimeFilterProbe{next_runtime_filter_id_, join_plan.LeftJoinKeyExpressions()};
+  AbstractPlanNodeRef new_left = filtered_scan;
+  for (auto filter = filters.rbegin(); filter != filters.rend(); ++filter) {
+    new_left = (*filter)->CloneWithChildren({new_left});
+  }
+  auto new_join = std::make_shared<HashJoinPlanNode>(join_plan);
+  new_join->children_ = {new_left, join_plan.GetRightPlan()};
+  new_join->runtime_filter_id_ = next_runtime_filter_id_++;
+  return new_join;
+}
+
+}  // namespace bustub
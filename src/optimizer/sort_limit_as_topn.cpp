@@ -1,10 +1,50 @@
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/limit_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/topn_plan.h"
 #include "optimizer/optimizer.h"
 
 namespace bustub {
 
 auto Optimizer::OptimizeSortLimitAsTopN(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
-  // TODO(student): implement sort + limit -> top N optimizer rule
-  return plan;
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeSortLimitAsTopN(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() == PlanType::Limit) {
+    const auto &limit_plan = dynamic_cast<const LimitPlanNode &>(*optimized_plan);
+    BUSTUB_ENSURE(limit_plan.children_.size() == 1, "Limit with multiple children?? That's weird!");
+    const auto &child_plan = limit_plan.GetChildPlan();
+    if (child_plan->GetType() == PlanType::Sort) {
+      const auto &sort_plan = dynamic_cast<const SortPlanNode &>(*child_plan);
+      auto topn_plan = std::make_shared<TopNPlanNode>(limit_plan.output_schema_, sort_plan.GetChildPlan(),
+                                                      sort_plan.GetOrderBy(), limit_plan.GetLimit());
+
+      // Filters keep the schema of their input, so the order by keys can be evaluated on the scan below them.
+      std::vector<const FilterPlanNode *> filters;
+      auto scan_plan = topn_plan->GetChildPlan();
+      while (scan_plan->GetType() == PlanType::Filter) {
+        filters.push_back(dynamic_cast<const FilterPlanNode *>(scan_plan.get()));
+        scan_plan = scan_plan->GetChildAt(0);
+      }
+      if (scan_plan->GetType() != PlanType::SeqScan || topn_plan->GetN() == 0) {
+        return topn_plan;
+      }
+      auto filtered_scan = std::make_shared<SeqScanPlanNode>(dynamic_cast<const SeqScanPlanNode &>(*scan_plan));
+      filtered_scan->topn_filter_id_ = next_runtime_filter_id_;
+      AbstractPlanNodeRef new_child = filtered_scan;
+      for (auto filter = filters.rbegin(); filter != filters.rend(); ++filter) {
+        new_child = (*filter)->CloneWithChildren({new_child});
+      }
+      topn_plan->children_ = {new_child};
+      topn_plan->topn_filter_id_ = next_runtime_filter_id_++;
+      return topn_plan;
+    }
+  }
+  return optimized_plan;
 }
 
 }  // namespace bustub
@@ -1,100 +1,565 @@
 #include "primer/trie.h"
+#include <algorithm>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string_view>
 #include <vector>
 #include "common/exception.h"
+#include "common/macros.h"
+#include "primer/write_batch.h"
 
 namespace bustub {
 
+TrieChildren::TrieChildren(const TrieChildren &that) {
+  Resize(that.size_);
+  that.ForEach([this](char key, const NodePtr &child) { Set(key, child); });
+}
+
+auto TrieChildren::operator=(const TrieChildren &that) -> TrieChildren & {
+  if (this != &that) {
+    TrieChildren copy(that);
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+auto TrieChildren::FindShared(char key) const -> const NodePtr * {
+  auto byte = static_cast<uint8_t>(key);
+  auto find_sorted = [this, byte](const auto &node) -> const NodePtr * {
+    auto end = node.keys_.begin() + size_;
+    auto it = std::lower_bound(node.keys_.begin(), end, byte);
+    return it != end && *it == byte ? &node.children_[it - node.keys_.begin()] : nullptr;
+  };
+  switch (Kind()) {
+    case NODE1:
+      return size_ == 1 && key1_ == byte ? &std::get<NODE1>(table_) : nullptr;
+    case NODE4:
+      return find_sorted(*std::get<NODE4>(table_));
+    case NODE16:
+      return find_sorted(*std::get<NODE16>(table_));
+    case NODE48: {
+      const auto &node = *std::get<NODE48>(table_);
+      return node.index_[byte] != 0 ? &node.children_[node.index_[byte] - 1] : nullptr;
+    }
+    case NODE256: {
+      const auto &node = *std::get<NODE256>(table_);
+      return node.children_[byte] != nullptr ? &node.children_[byte] : nullptr;
+    }
+  }
+  return nullptr;
+}
+
+auto TrieChildren::Find(char key) const -> const TrieNode * {
+  const auto *child = FindShared(key);
+  return child != nullptr ? child->get() : nullptr;
+}
+
+auto TrieChildren::LowerBound(uint16_t from, char *key) const -> const TrieNode * {
+  if (from >= BYTE_FANOUT) {
+    return nullptr;
+  }
+  auto byte = static_cast<uint8_t>(from);
+  auto lower_bound_sorted = [this, byte, key](const auto &node) -> const TrieNode * {
+    auto end = node.keys_.begin() + size_;
+    auto it = std::lower_bound(node.keys_.begin(), end, byte);
+    if (it == end) {
+      return nullptr;
+    }
+    *key = static_cast<char>(*it);
+    return node.children_[it - node.keys_.begin()].get();
+  };
+  switch (Kind()) {
+    case NODE1:
+      if (size_ == 0 || key1_ < byte) {
+        return nullptr;
+      }
+      *key = static_cast<char>(key1_);
+      return std::get<NODE1>(table_).get();
+    case NODE4:
+      return lower_bound_sorted(*std::get<NODE4>(table_));
+    case NODE16:
+      return lower_bound_sorted(*std::get<NODE16>(table_));
+    case NODE48: {
+      const auto &node = *std::get<NODE48>(table_);
+      for (size_t b = from; b < BYTE_FANOUT; b++) {
+        if (node.index_[b] != 0) {
+          *key = static_cast<char>(b);
+          return node.children_[node.index_[b] - 1].get();
+        }
+      }
+      return nullptr;
+    }
+    case NODE256: {
+      const auto &node = *std::get<NODE256>(table_);
+      for (size_t b = from; b < BYTE_FANOUT; b++) {
+        if (node.children_[b] != nullptr) {
+          *key = static_cast<char>(b);
+          return node.children_[b].get();
+        }
+      }
+      return nullptr;
+    }
+  }
+  return nullptr;
+}
+
+// Inserts `child` into a sorted key/child array of `size` entries with room for at least one more. Returns false if
+// `key` already existed, in which case its child is overwritten instead.
+template <size_t N>
+static auto SortedArraySet(std::array<uint8_t, N> *keys, std::array<TrieChildren::NodePtr, N> *children, size_t size,
+                           uint8_t key, TrieChildren::NodePtr child) -> bool {
+  auto end = keys->begin() + size;
+  auto it = std::lower_bound(keys->begin(), end, key);
+  auto pos = it - keys->begin();
+  if (it != end && *it == key) {
+    (*children)[pos] = std::move(child);
+    return false;
+  }
+  std::move_backward(keys->begin() + pos, end, end + 1);
+  std::move_backward(children->begin() + pos, children->begin() + size, children->begin() + size + 1);
+  (*keys)[pos] = key;
+  (*children)[pos] = std::move(child);
+  return true;
+}
+
+// Removes `key` from a sorted key/child array of `size` entries. Returns false if `key` did not exist.
+template <size_t N>
+static auto SortedArrayErase(std::array<uint8_t, N> *keys, std::array<TrieChildren::NodePtr, N> *children,
+                             size_t size, uint8_t key) -> bool {
+  auto end = keys->begin() + size;
+  auto it = std::lower_bound(keys->begin(), end, key);
+  if (it == end || *it != key) {
+    return false;
+  }
+  auto pos = it - keys->begin();
+  std::move(keys->begin() + pos + 1, end, keys->begin() + pos);
+  std::move(children->begin() + pos + 1, children->begin() + size, children->begin() + pos);
+  (*children)[size - 1] = nullptr;
+  return true;
+}
+
+void TrieChildren::Set(char key, NodePtr child) {
+  auto byte = static_cast<uint8_t>(key);
+  switch (Kind()) {
+    case NODE1:
+      if (size_ == 1 && key1_ != byte) {
+        Resize(size_ + 1);
+        Set(key, std::move(child));
+        return;
+      }
+      key1_ = byte;
+      std::get<NODE1>(table_) = std::move(child);
+      size_ = 1;
+      return;
+    case NODE4: {
+      auto &node = *std::get<NODE4>(table_);
+      if (size_ == NODE4_CAPACITY && FindShared(key) == nullptr) {
+        Resize(size_ + 1);
+        Set(key, std::move(child));
+        return;
+      }
+      size_ += SortedArraySet(&node.keys_, &node.children_, size_, byte, std::move(child)) ? 1 : 0;
+      return;
+    }
+    case NODE16: {
+      auto &node = *std::get<NODE16>(table_);
+      if (size_ == NODE16_CAPACITY && FindShared(key) == nullptr) {
+        Resize(size_ + 1);
+        Set(key, std::move(child));
+        return;
+      }
+      size_ += SortedArraySet(&node.keys_, &node.children_, size_, byte, std::move(child)) ? 1 : 0;
+      return;
+    }
+    case NODE48: {
+      auto &node = *std::get<NODE48>(table_);
+      if (node.index_[byte] != 0) {
+        node.children_[node.index_[byte] - 1] = std::move(child);
+        return;
+      }
+      if (size_ == NODE48_CAPACITY) {
+        Resize(size_ + 1);
+        Set(key, std::move(child));
+        return;
+      }
+      // Slots are kept dense, so the next free slot is always `size_`.
+      node.children_[size_] = std::move(child);
+      node.index_[byte] = ++size_;
+      return;
+    }
+    case NODE256: {
+      auto &node = *std::get<NODE256>(table_);
+      size_ += node.children_[byte] == nullptr ? 1 : 0;
+      node.children_[byte] = std::move(child);
+      return;
+    }
+  }
+}
+
+void TrieChildren::Erase(char key) {
+  auto byte = static_cast<uint8_t>(key);
+  switch (Kind()) {
+    case NODE1:
+      if (size_ == 1 && key1_ == byte) {
+        std::get<NODE1>(table_) = nullptr;
+        size_ = 0;
+      }
+      return;
+    case NODE4: {
+      auto &node = *std::get<NODE4>(table_);
+      size_ -= SortedArrayErase(&node.keys_, &node.children_, size_, byte) ? 1 : 0;
+      if (size_ <= NODE1_CAPACITY) {
+        Resize(size_);
+      }
+      return;
+    }
+    case NODE16: {
+      auto &node = *std::get<NODE16>(table_);
+      size_ -= SortedArrayErase(&node.keys_, &node.children_, size_, byte) ? 1 : 0;
+      if (size_ < NODE4_CAPACITY) {
+        Resize(size_);
+      }
+      return;
+    }
+    case NODE48: {
+      auto &node = *std::get<NODE48>(table_);
+      if (node.index_[byte] == 0) {
+        return;
+      }
+      // Keep the slots dense by moving the last slot into the hole.
+      uint8_t hole = node.index_[byte];
+      uint8_t last = size_--;
+      node.index_[byte] = 0;
+      if (hole != last) {
+        for (auto &slot : node.index_) {
+          if (slot == last) {
+            slot = hole;
+            break;
+          }
+        }
+        node.children_[hole - 1] = std::move(node.children_[last - 1]);
+      }
+      node.children_[last - 1] = nullptr;
+      if (size_ < NODE16_CAPACITY) {
+        Resize(size_);
+      }
+      return;
+    }
+    case NODE256: {
+      auto &node = *std::get<NODE256>(table_);
+      if (node.children_[byte] == nullptr) {
+        return;
+      }
+      node.children_[byte] = nullptr;
+      if (--size_ < NODE48_CAPACITY) {
+        Resize(size_);
+      }
+      return;
+    }
+  }
+}
+
+void TrieChildren::Resize(size_t capacity) {
+  std::vector<std::pair<char, NodePtr>> entries;
+  entries.reserve(size_);
+  ForEach([&entries](char key, const NodePtr &child) { entries.emplace_back(key, child); });
+
+  size_ = 0;
+  if (capacity <= NODE1_CAPACITY) {
+    table_ = NodePtr{};
+  } else if (capacity <= NODE4_CAPACITY) {
+    table_ = std::make_unique<Node4>();
+  } else if (capacity <= NODE16_CAPACITY) {
+    table_ = std::make_unique<Node16>();
+  } else if (capacity <= NODE48_CAPACITY) {
+    table_ = std::make_unique<Node48>();
+  } else {
+    table_ = std::make_unique<Node256>();
+  }
+  for (auto &[key, child] : entries) {
+    Set(key, std::move(child));
+  }
+}
+
 template <class T>
 auto Trie::Get(std::string_view key) const -> const T * {
-  // throw NotImplementedException("Trie::Get is not implemented.");
-  auto node = root_;
+  // Walk raw pointers: the trie is immutable and `root_` keeps every node alive, so there is no need to touch the
+  // reference counts on the way down.
+  const TrieNode *node = root_.get();
   for (char ch : key) {
     if (node == nullptr) {
       return nullptr;
     }
-    node = node->children_.find(ch) != node->children_.end() ? node->children_.at(ch) : nullptr;
+    node = node->children_.Find(ch);
   }
   if (node == nullptr) {
     return nullptr;
   }
-  auto val_node = dynamic_cast<const TrieNodeWithValue<T> *>(node.get());
+  const auto *val_node = dynamic_cast<const TrieNodeWithValue<T> *>(node);
   if (val_node == nullptr) {
     return nullptr;
   }
   return val_node->is_value_node_ ? val_node->value_.get() : nullptr;
-  // You should walk through the trie to find the node corresponding to the key. If the node doesn't exist, return
-  // nullptr. After you find the node, you should use `dynamic_cast` to cast it to `const TrieNodeWithValue<T> *`. If
-  // dynamic_cast returns `nullptr`, it means the type of the value is mismatched, and you should return nullptr.
-  // Otherwise, return the value.
 }
 
 template <class T>
 auto Trie::Put(std::string_view key, T value) const -> Trie {
   // Note that `T` might be a non-copyable type. Always use `std::move` when creating `shared_ptr` on that value.
-  // throw NotImplementedException("Trie::Put is not implemented.");
-  auto node = root_;
-  std::vector<std::shared_ptr<const TrieNode>> copy_node;
+  const TrieNode *node = root_.get();
+  std::vector<const TrieNode *> copy_node;
+  copy_node.reserve(key.size());
   auto key_size = key.size();
   decltype(key_size) idx = 0;
-  while (idx < key_size && node) {
-    char c = key[idx++];
+  while (idx < key_size && node != nullptr) {
     copy_node.push_back(node);
-    node = node->children_.find(c) != node->children_.end() ? node->children_.at(c) : nullptr;
+    node = node->children_.Find(key[idx++]);
   }
-  auto leaf_node =
-      node ? std::make_shared<const TrieNodeWithValue<T>>(node->children_, std::make_shared<T>(std::move(value)))
-           : std::make_shared<const TrieNodeWithValue<T>>(std::make_shared<T>(std::move(value)));
+  std::shared_ptr<const TrieNode> child_node =
+      node != nullptr
+          ? std::make_shared<const TrieNodeWithValue<T>>(node->children_, std::make_shared<T>(std::move(value)))
+          : std::make_shared<const TrieNodeWithValue<T>>(std::make_shared<T>(std::move(value)));
 
-  std::shared_ptr<const TrieNode> child_node = leaf_node;
+  // The rest of the key does not exist yet, build a fresh chain of nodes for it.
   while (idx < key_size) {
-    char c = key[--key_size];
-    std::map<char, std::shared_ptr<const TrieNode>> children{{c, child_node}};
-    node = std::make_shared<const TrieNode>(children);
-    child_node = node;
+    auto new_node = std::make_shared<TrieNode>();
+    new_node->children_.Set(key[--key_size], std::move(child_node));
+    child_node = std::move(new_node);
   }
-  // usul node will update in for loop below
-  // when key is "",child node will be new root, there is no node to be copied, so we should update node
-  node = child_node;
-  for (int i = idx - 1; i >= 0; i--) {
-    char c = key[i];
-    node = std::shared_ptr<const TrieNode>(copy_node[i]->Clone());
-    const_cast<TrieNode *>(node.get())->children_[c] = child_node;
-    child_node = node;
+  // Copy the existing path bottom-up. When key is "", the leaf itself becomes the new root.
+  for (auto i = static_cast<int64_t>(idx) - 1; i >= 0; i--) {
+    auto new_node = copy_node[i]->CloneShared();
+    new_node->children_.Set(key[i], std::move(child_node));
+    child_node = std::move(new_node);
   }
-  return Trie(node);
-  // You should walk through the trie and create new nodes if necessary. If the node corresponding to the key already
-  // exists, you should create a new `TrieNodeWithValue`.
+  return Trie(std::move(child_node));
 }
 
 auto Trie::Remove(std::string_view key) const -> Trie {
-  // throw NotImplementedException("Trie::Remove is not implemented.");
-  auto node = root_;
-  std::vector<std::shared_ptr<const TrieNode>> copy_node;
+  const TrieNode *node = root_.get();
+  std::vector<const TrieNode *> copy_node;
+  copy_node.reserve(key.size());
   auto key_size = key.size();
   decltype(key_size) idx = 0;
-  while (idx < key_size && node) {
-    char c = key[idx++];
+  while (idx < key_size && node != nullptr) {
     copy_node.push_back(node);
-    node = node->children_.find(c) != node->children_.end() ? node->children_.at(c) : nullptr;
+    node = node->children_.Find(key[idx++]);
   }
   // not exist the key
   if (idx != key_size || node == nullptr || !(node->is_value_node_)) {
     return *this;
   }
-  auto leaf_node = node->children_.empty() ? nullptr : std::make_shared<const TrieNode>(node->children_);
+  std::shared_ptr<const TrieNode> child_node =
+      node->children_.Empty() ? nullptr : std::make_shared<const TrieNode>(node->children_);
+
+  // Copy the path bottom-up, pruning nodes that end up with neither a value nor children.
+  for (auto i = static_cast<int64_t>(idx) - 1; i >= 0; i--) {
+    auto new_node = copy_node[i]->CloneShared();
+    if (child_node != nullptr) {
+      new_node->children_.Set(key[i], std::move(child_node));
+    } else {
+      new_node->children_.Erase(key[i]);
+    }
+    if (new_node->children_.Empty() && !new_node->is_value_node_) {
+      child_node = nullptr;
+    } else {
+      child_node = std::move(new_node);
+    }
+  }
+  return Trie(std::move(child_node));
+}
+
+namespace {
+
+// A write of a WriteBatch, with the key sorted into place. `make_node_` is empty for a remove.
+struct SortedWrite {
+  std::string_view key_;
+  const std::function<std::shared_ptr<const TrieNode>(TrieChildren)> *make_node_;
+};
+
+// Apply the writes in [begin, end), which all share the first `depth` bytes of their keys, to `node`, the subtree at
+// that depth. Returns the new subtree, which is `node` itself if nothing changed or nullptr if it became empty.
+auto ApplySorted(const std::shared_ptr<const TrieNode> &node, size_t depth, const SortedWrite *begin,
+                 const SortedWrite *end) -> std::shared_ptr<const TrieNode> {
+  static const std::shared_ptr<const TrieNode> NO_NODE;
+
+  // Keys are sorted, so a write to this node itself comes first.
+  const SortedWrite *self = nullptr;
+  if (begin != end && begin->key_.size() == depth) {
+    self = begin++;
+  }
 
-  std::shared_ptr<const TrieNode> child_node = leaf_node;
-  for (int i = idx - 1; i >= 0; i--) {
-    char c = key[i];
-    node = std::shared_ptr<const TrieNode>(copy_node[i]->Clone());
-    const_cast<TrieNode *>(node.get())->children_[c] = child_node;
-    child_node = node;
+  std::optional<TrieChildren> children;
+  while (begin != end) {
+    char ch = begin->key_[depth];
+    const SortedWrite *group_end = std::find_if(begin, end, [depth, ch](const SortedWrite &write) {
+      return write.key_[depth] != ch;
+    });
+    const auto *child = node != nullptr ? node->children_.FindShared(ch) : nullptr;
+    const auto &old_child = child != nullptr ? *child : NO_NODE;
+    auto new_child = ApplySorted(old_child, depth + 1, begin, group_end);
+    if (new_child != old_child) {
+      if (!children.has_value()) {
+        children = node != nullptr ? node->children_ : TrieChildren();
+      }
+      if (new_child != nullptr) {
+        children->Set(ch, std::move(new_child));
+      } else {
+        children->Erase(ch);
+      }
+    }
+    begin = group_end;
+  }
+
+  bool had_value = node != nullptr && node->is_value_node_;
+  if (self != nullptr && *self->make_node_) {
+    return (*self->make_node_)(children.has_value() ? std::move(*children) : node != nullptr ? node->children_
+                                                                                                 : TrieChildren());
+  }
+  bool removed = self != nullptr && had_value;
+  if (!children.has_value() && !removed) {
+    return node;
+  }
+  if (!children.has_value()) {
+    children = node->children_;
+  }
+  if (had_value && !removed) {
+    return node->CloneWithChildren(std::move(*children));
+  }
+  if (children->Empty()) {
+    return nullptr;
+  }
+  return std::make_shared<const TrieNode>(std::move(*children));
+}
+
+}  // namespace
+
+auto Trie::Apply(const WriteBatch &batch) const -> Trie {
+  std::vector<SortedWrite> writes;
+  writes.reserve(batch.mutations_.size());
+  for (const auto &mutation : batch.mutations_) {
+    writes.push_back({mutation.key_, &mutation.make_node_});
+  }
+  std::stable_sort(writes.begin(), writes.end(),
+                   [](const SortedWrite &a, const SortedWrite &b) { return a.key_ < b.key_; });
+  // Of several writes to the same key, only the last one counts.
+  std::vector<SortedWrite> unique_writes;
+  unique_writes.reserve(writes.size());
+  for (size_t i = 0; i < writes.size(); i++) {
+    if (i + 1 == writes.size() || writes[i + 1].key_ != writes[i].key_) {
+      unique_writes.push_back(writes[i]);
+    }
+  }
+  return Trie(ApplySorted(root_, 0, unique_writes.data(), unique_writes.data() + unique_writes.size()));
+}
+
+template <class T>
+auto Trie::ScanPrefix(std::string_view prefix) const -> TrieIterator<T> {
+  TrieIterator<T> iter(*this);
+  iter.SeekPrefix(prefix);
+  return iter;
+}
+
+template <class T>
+auto Trie::Range(std::string_view lo, std::string_view hi) const -> TrieIterator<T> {
+  TrieIterator<T> iter(*this);
+  if (lo < hi) {
+    iter.upper_bound_ = std::string(hi);
+    iter.SeekLowerBound(lo);
+  }
+  return iter;
+}
+
+template <class T>
+auto TrieIterator<T>::Value() const -> const T & {
+  BUSTUB_ASSERT(!IsEnd(), "iterator is at the end");
+  return *dynamic_cast<const TrieNodeWithValue<T> *>(stack_.back().node_)->value_;
+}
+
+template <class T>
+auto TrieIterator<T>::operator++() -> TrieIterator & {
+  Step();
+  SkipToValue();
+  return *this;
+}
+
+template <class T>
+void TrieIterator<T>::SeekPrefix(std::string_view prefix) {
+  const TrieNode *node = trie_.root_.get();
+  for (char ch : prefix) {
+    if (node == nullptr) {
+      return;
+    }
+    node = node->children_.Find(ch);
+  }
+  if (node == nullptr) {
+    return;
+  }
+  stack_.push_back({node, 0});
+  key_ = prefix;
+  SkipToValue();
+}
+
+template <class T>
+void TrieIterator<T>::SeekLowerBound(std::string_view lo) {
+  const TrieNode *node = trie_.root_.get();
+  if (node == nullptr) {
+    return;
+  }
+  for (char ch : lo) {
+    // Everything under this node that sorts after `lo` is in the children after `ch`, or under `ch` itself.
+    stack_.push_back({node, static_cast<uint16_t>(static_cast<uint8_t>(ch) + 1)});
+    const TrieNode *child = node->children_.Find(ch);
+    if (child == nullptr) {
+      Step();
+      SkipToValue();
+      return;
+    }
+    key_.push_back(ch);
+    node = child;
+  }
+  stack_.push_back({node, 0});
+  SkipToValue();
+}
+
+template <class T>
+auto TrieIterator<T>::AtValue() const -> bool {
+  const TrieNode *node = stack_.back().node_;
+  return node->is_value_node_ && dynamic_cast<const TrieNodeWithValue<T> *>(node) != nullptr;
+}
+
+template <class T>
+void TrieIterator<T>::Step() {
+  while (!stack_.empty()) {
+    auto &top = stack_.back();
+    char ch;
+    const TrieNode *child = top.node_->children_.LowerBound(top.next_, &ch);
+    if (child != nullptr) {
+      top.next_ = static_cast<uint16_t>(static_cast<uint8_t>(ch) + 1);
+      stack_.push_back({child, 0});
+      key_.push_back(ch);
+      return;
+    }
+    stack_.pop_back();
+    if (!stack_.empty()) {
+      key_.pop_back();
+    }
+  }
+}
+
+template <class T>
+void TrieIterator<T>::SkipToValue() {
+  while (!stack_.empty()) {
+    if (upper_bound_.has_value() && key_ >= *upper_bound_) {
+      // Pre-order is key order, so every remaining key is out of range too.
+      stack_.clear();
+      return;
+    }
+    if (AtValue()) {
+      return;
+    }
+    Step();
   }
-  return Trie(node);
-  // You should walk through the trie and remove nodes if necessary. If the node doesn't contain a value any more,
-  // you should convert it to `TrieNode`. If a node doesn't have children any more, you should remove it.
 }
 
 // Below are explicit instantiation of template functions.
@@ -106,12 +571,21 @@ auto Trie::Remove(std::string_view key) const -> Trie {
 
 template auto Trie::Put(std::string_view key, uint32_t value) const -> Trie;
 template auto Trie::Get(std::string_view key) const -> const uint32_t *;
+template auto Trie::ScanPrefix(std::string_view prefix) const -> TrieIterator<uint32_t>;
+template auto Trie::Range(std::string_view lo, std::string_view hi) const -> TrieIterator<uint32_t>;
+template class TrieIterator<uint32_t>;
 
 template auto Trie::Put(std::string_view key, uint64_t value) const -> Trie;
 template auto Trie::Get(std::string_view key) const -> const uint64_t *;
+template auto Trie::ScanPrefix(std::string_view prefix) const -> TrieIterator<uint64_t>;
+template auto Trie::Range(std::string_view lo, std::string_view hi) const -> TrieIterator<uint64_t>;
+template class TrieIterator<uint64_t>;
 
 template auto Trie::Put(std::string_view key, std::string value) const -> Trie;
 template auto Trie::Get(std::string_view key) const -> const std::string *;
+template auto Trie::ScanPrefix(std::string_view prefix) const -> TrieIterator<std::string>;
+template auto Trie::Range(std::string_view lo, std::string_view hi) const -> TrieIterator<std::string>;
+template class TrieIterator<std::string>;
 
 // If your solution cannot compile for non-copy tests, you can remove the below lines to get partial score.
 
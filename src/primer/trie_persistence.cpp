@@ -0,0 +1,419 @@
+#include "primer/trie_persistence.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/util/hash_util.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+namespace {
+
+constexpr char SNAPSHOT_MAGIC[8] = {'B', 'U', 'S', 'T', 'R', 'I', 'E', '1'};
+constexpr size_t SNAPSHOT_HEADER_SIZE = sizeof(SNAPSHOT_MAGIC) + 3 * sizeof(uint64_t);
+constexpr std::string_view SEGMENT_PREFIX = "wal.";
+
+// Reads fixed-size integers and byte strings from a buffer, failing instead of reading past its end.
+class ByteReader {
+ public:
+  ByteReader(const char *data, size_t size) : cur_(data), end_(data + size) {}
+
+  template <class T>
+  auto Read(T *out) -> bool {
+    if (Remaining() < sizeof(T)) {
+      return false;
+    }
+    memcpy(out, cur_, sizeof(T));
+    cur_ += sizeof(T);
+    return true;
+  }
+
+  auto ReadBytes(size_t size, std::string_view *out) -> bool {
+    if (Remaining() < size) {
+      return false;
+    }
+    *out = std::string_view(cur_, size);
+    cur_ += size;
+    return true;
+  }
+
+  auto Remaining() const -> size_t { return end_ - cur_; }
+
+ private:
+  const char *cur_;
+  const char *end_;
+};
+
+template <class T>
+void AppendInt(T value, std::string *out) {
+  out->append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void WriteFully(int fd, const char *data, size_t size, const std::string &path) {
+  while (size > 0) {
+    auto written = write(fd, data, size);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written < 0) {
+      throw Exception(fmt::format("failed to write {}", path));
+    }
+    data += written;
+    size -= written;
+  }
+}
+
+void SyncDirectory(const std::string &directory) {
+  int fd = open(directory.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    fsync(fd);
+    close(fd);
+  }
+}
+
+// @return the log segments in `directory` as (first lsn, path), in LSN order
+auto ListSegments(const std::string &directory) -> std::vector<std::pair<uint64_t, std::string>> {
+  std::vector<std::pair<uint64_t, std::string>> segments;
+  if (!std::filesystem::exists(directory)) {
+    return segments;
+  }
+  for (const auto &entry : std::filesystem::directory_iterator(directory)) {
+    auto name = entry.path().filename().string();
+    if (name.compare(0, SEGMENT_PREFIX.size(), SEGMENT_PREFIX) != 0) {
+      continue;
+    }
+    // Anything other than the prefix and a whole LSN, such as a temporary or a backup file, is not a segment.
+    uint64_t first_lsn;
+    const char *begin = name.data() + SEGMENT_PREFIX.size();
+    const char *end = name.data() + name.size();
+    auto [ptr, ec] = std::from_chars(begin, end, first_lsn);
+    if (begin != end && ptr == end && ec == std::errc()) {
+      segments.emplace_back(first_lsn, entry.path().string());
+    }
+  }
+  std::sort(segments.begin(), segments.end());
+  return segments;
+}
+
+// A value read from the log or a snapshot. String values point into the input buffer.
+struct EncodedValue {
+  TrieValueType type_;
+  uint64_t integer_;
+  std::string_view string_;
+};
+
+auto ReadValue(ByteReader *reader, EncodedValue *value) -> bool {
+  uint8_t type;
+  if (!reader->Read(&type)) {
+    return false;
+  }
+  value->type_ = static_cast<TrieValueType>(type);
+  switch (value->type_) {
+    case TrieValueType::UINT32: {
+      uint32_t integer;
+      if (!reader->Read(&integer)) {
+        return false;
+      }
+      value->integer_ = integer;
+      return true;
+    }
+    case TrieValueType::UINT64:
+      return reader->Read(&value->integer_);
+    case TrieValueType::STRING: {
+      uint32_t size;
+      return reader->Read(&size) && reader->ReadBytes(size, &value->string_);
+    }
+  }
+  return false;
+}
+
+auto MakeValueNode(const EncodedValue &value, TrieChildren children) -> std::shared_ptr<const TrieNode> {
+  switch (value.type_) {
+    case TrieValueType::UINT32:
+      return std::make_shared<const TrieNodeWithValue<uint32_t>>(
+          std::move(children), std::make_shared<uint32_t>(static_cast<uint32_t>(value.integer_)));
+    case TrieValueType::UINT64:
+      return std::make_shared<const TrieNodeWithValue<uint64_t>>(std::move(children),
+                                                                 std::make_shared<uint64_t>(value.integer_));
+    case TrieValueType::STRING:
+      return std::make_shared<const TrieNodeWithValue<std::string>>(std::move(children),
+                                                                    std::make_shared<std::string>(value.string_));
+  }
+  return nullptr;
+}
+
+void EncodeNodeValue(const TrieNode *node, std::string *out) {
+  if (const auto *value_node = dynamic_cast<const TrieNodeWithValue<uint32_t> *>(node); value_node != nullptr) {
+    out->push_back(static_cast<char>(TrieValueType::UINT32));
+    TrieValueCodec<uint32_t>::Encode(*value_node->value_, out);
+  } else if (const auto *value_node = dynamic_cast<const TrieNodeWithValue<uint64_t> *>(node); value_node != nullptr) {
+    out->push_back(static_cast<char>(TrieValueType::UINT64));
+    TrieValueCodec<uint64_t>::Encode(*value_node->value_, out);
+  } else if (const auto *value_node = dynamic_cast<const TrieNodeWithValue<std::string> *>(node);
+             value_node != nullptr) {
+    out->push_back(static_cast<char>(TrieValueType::STRING));
+    TrieValueCodec<std::string>::Encode(*value_node->value_, out);
+  } else {
+    throw Exception("trie holds a value that cannot be persisted");
+  }
+}
+
+void EncodeNode(const TrieNode *node, std::string *out) {
+  out->push_back(static_cast<char>(node->is_value_node_));
+  if (node->is_value_node_) {
+    EncodeNodeValue(node, out);
+  }
+  AppendInt(static_cast<uint16_t>(node->children_.Size()), out);
+  node->children_.ForEach([out](char key, const TrieChildren::NodePtr &child) {
+    out->push_back(key);
+    EncodeNode(child.get(), out);
+  });
+}
+
+// Rebuilds a node and its subtree bottom-up. @return nullptr if the input is malformed
+auto DecodeNode(ByteReader *reader) -> std::shared_ptr<const TrieNode> {
+  uint8_t has_value;
+  EncodedValue value{};
+  if (!reader->Read(&has_value) || (has_value != 0 && !ReadValue(reader, &value))) {
+    return nullptr;
+  }
+  uint16_t num_children;
+  if (!reader->Read(&num_children)) {
+    return nullptr;
+  }
+  TrieChildren children;
+  for (uint16_t i = 0; i < num_children; i++) {
+    char key;
+    if (!reader->Read(&key)) {
+      return nullptr;
+    }
+    auto child = DecodeNode(reader);
+    if (child == nullptr) {
+      return nullptr;
+    }
+    children.Set(key, std::move(child));
+  }
+  if (has_value != 0) {
+    return MakeValueNode(value, std::move(children));
+  }
+  return std::make_shared<const TrieNode>(std::move(children));
+}
+
+}  // namespace
+
+/*****************************************************************************
+ * TrieLog
+ *****************************************************************************/
+
+TrieLog::TrieLog(std::string directory, uint64_t next_lsn) : directory_(std::move(directory)), next_lsn_(next_lsn) {
+  std::filesystem::create_directories(directory_);
+  OpenSegment();
+}
+
+TrieLog::~TrieLog() {
+  if (fd_ >= 0) {
+    fdatasync(fd_);
+    close(fd_);
+  }
+}
+
+auto TrieLog::EncodeKey(char op, std::string_view key) -> std::string {
+  std::string payload;
+  payload.push_back(op);
+  AppendInt(static_cast<uint32_t>(key.size()), &payload);
+  payload.append(key);
+  return payload;
+}
+
+auto TrieLog::ApplyRecord(const Trie &trie, std::string_view payload) -> Trie {
+  ByteReader reader(payload.data(), payload.size());
+  char op;
+  uint32_t key_size;
+  std::string_view key;
+  if (!reader.Read(&op) || !reader.Read(&key_size) || !reader.ReadBytes(key_size, &key)) {
+    throw Exception("malformed trie log record");
+  }
+  if (op == OP_REMOVE) {
+    return trie.Remove(key);
+  }
+  EncodedValue value;
+  if (op != OP_PUT || !ReadValue(&reader, &value)) {
+    throw Exception("malformed trie log record");
+  }
+  switch (value.type_) {
+    case TrieValueType::UINT32:
+      return trie.Put<uint32_t>(key, static_cast<uint32_t>(value.integer_));
+    case TrieValueType::UINT64:
+      return trie.Put<uint64_t>(key, value.integer_);
+    case TrieValueType::STRING:
+      return trie.Put<std::string>(key, std::string(value.string_));
+  }
+  throw Exception("malformed trie log record");
+}
+
+void TrieLog::OpenSegment() {
+  auto path = fmt::format("{}/{}{:020}", directory_, SEGMENT_PREFIX, next_lsn_);
+  int fd = open(path.c_str(), O_CREAT | O_WRONLY | O_TRUNC | O_APPEND, 0644);
+  if (fd < 0) {
+    throw Exception(fmt::format("failed to open {}", path));
+  }
+  fd_ = fd;
+  SyncDirectory(directory_);
+}
+
+auto TrieLog::Append(std::string_view payload) -> uint64_t {
+  std::scoped_lock lock(latch_);
+  auto lsn = next_lsn_++;
+  std::string record;
+  record.reserve(RECORD_HEADER_SIZE + payload.size());
+  AppendInt(uint64_t{0}, &record);
+  AppendInt(static_cast<uint32_t>(payload.size()), &record);
+  AppendInt(lsn, &record);
+  record.append(payload);
+  uint64_t checksum = HashUtil::HashBytes(record.data() + sizeof(uint64_t), record.size() - sizeof(uint64_t));
+  memcpy(record.data(), &checksum, sizeof(checksum));
+  WriteFully(fd_, record.data(), record.size(), directory_);
+  return lsn;
+}
+
+void TrieLog::Sync() {
+  std::scoped_lock lock(latch_);
+  fdatasync(fd_);
+}
+
+void TrieLog::Rotate() {
+  std::scoped_lock lock(latch_);
+  // Records appended before the rotation may not have been synced yet, and Sync only covers the current segment.
+  fdatasync(fd_);
+  // Keep appending to the current segment if the next one cannot be created.
+  auto old_fd = fd_;
+  OpenSegment();
+  close(old_fd);
+}
+
+void TrieLog::Truncate(uint64_t lsn) {
+  std::scoped_lock lock(latch_);
+  auto segments = ListSegments(directory_);
+  // A segment ends right before the next one starts. The last segment is the one being appended to.
+  for (size_t i = 0; i + 1 < segments.size(); i++) {
+    if (segments[i + 1].first - 1 <= lsn) {
+      std::filesystem::remove(segments[i].second);
+    }
+  }
+}
+
+auto TrieLog::Replay(const std::string &directory, uint64_t after_lsn,
+                     const std::function<void(uint64_t, std::string_view)> &apply) -> uint64_t {
+  auto max_lsn = after_lsn;
+  for (const auto &[first_lsn, path] : ListSegments(directory)) {
+    std::ifstream input(path, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    ByteReader reader(data.data(), data.size());
+    bool torn = false;
+    while (!torn && reader.Remaining() > 0) {
+      const char *record_start = data.data() + (data.size() - reader.Remaining());
+      uint64_t checksum;
+      uint32_t size;
+      uint64_t lsn;
+      std::string_view payload;
+      if (!reader.Read(&checksum) || !reader.Read(&size) || !reader.Read(&lsn) || !reader.ReadBytes(size, &payload) ||
+          HashUtil::HashBytes(record_start + sizeof(uint64_t), RECORD_HEADER_SIZE - sizeof(uint64_t) + size) !=
+              checksum) {
+        // A write torn by a crash. It was never acknowledged, and the log was reopened in a new segment
+        // after the crash, so the rest of this segment is garbage but later segments are intact.
+        torn = true;
+        continue;
+      }
+      if (lsn > after_lsn) {
+        apply(lsn, payload);
+        max_lsn = std::max(max_lsn, lsn);
+      }
+    }
+  }
+  return max_lsn;
+}
+
+/*****************************************************************************
+ * TrieSnapshot
+ *****************************************************************************/
+
+void TrieSnapshot::Write(const Trie &trie, uint64_t lsn, const std::string &path) {
+  std::string payload;
+  if (trie.root_ != nullptr) {
+    EncodeNode(trie.root_.get(), &payload);
+  }
+  std::string header(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+  AppendInt(lsn, &header);
+  AppendInt(static_cast<uint64_t>(payload.size()), &header);
+  AppendInt(static_cast<uint64_t>(HashUtil::HashBytes(payload.data(), payload.size())), &header);
+
+  // Write the new snapshot next to the old one and atomically replace it, so a crash leaves one of them intact.
+  auto tmp_path = path + ".tmp";
+  int fd = open(tmp_path.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0644);
+  if (fd < 0) {
+    throw Exception(fmt::format("failed to open {}", tmp_path));
+  }
+  WriteFully(fd, header.data(), header.size(), tmp_path);
+  WriteFully(fd, payload.data(), payload.size(), tmp_path);
+  fsync(fd);
+  close(fd);
+  std::filesystem::rename(tmp_path, path);
+  SyncDirectory(std::filesystem::path(path).parent_path().string());
+}
+
+auto TrieSnapshot::Load(const std::string &path) -> std::optional<std::pair<Trie, uint64_t>> {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return std::nullopt;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < SNAPSHOT_HEADER_SIZE) {
+    close(fd);
+    return std::nullopt;
+  }
+  auto size = static_cast<size_t>(st.st_size);
+  void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return std::nullopt;
+  }
+
+  std::optional<std::pair<Trie, uint64_t>> result;
+  ByteReader reader(static_cast<const char *>(data), size);
+  std::string_view magic;
+  uint64_t lsn;
+  uint64_t payload_size;
+  uint64_t checksum;
+  std::string_view payload;
+  if (reader.ReadBytes(sizeof(SNAPSHOT_MAGIC), &magic) &&
+      magic == std::string_view(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) && reader.Read(&lsn) &&
+      reader.Read(&payload_size) && reader.Read(&checksum) && reader.ReadBytes(payload_size, &payload) &&
+      HashUtil::HashBytes(payload.data(), payload.size()) == checksum) {
+    if (payload.empty()) {
+      result.emplace(Trie(), lsn);
+    } else {
+      ByteReader node_reader(payload.data(), payload.size());
+      auto root = DecodeNode(&node_reader);
+      if (root != nullptr) {
+        result.emplace(Trie(std::move(root)), lsn);
+      }
+    }
+  }
+  munmap(data, size);
+  return result;
+}
+
+}  // namespace bustub
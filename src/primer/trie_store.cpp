@@ -1,65 +1,198 @@
 #include "primer/trie_store.h"
+#include <exception>
+#include <memory>
 #include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
 #include "common/exception.h"
+#include "common/logger.h"
 
 namespace bustub {
 
+TrieStore::TrieStore(const std::string &directory, size_t checkpoint_interval, bool sync)
+    : directory_(directory), sync_(sync), checkpoint_interval_(checkpoint_interval) {
+  Trie root;
+  uint64_t lsn = 0;
+  if (auto snapshot = TrieSnapshot::Load(directory_ + "/snapshot"); snapshot.has_value()) {
+    std::tie(root, lsn) = std::move(*snapshot);
+  }
+  lsn = TrieLog::Replay(directory_, lsn,
+                        [&root](uint64_t, std::string_view payload) { root = TrieLog::ApplyRecord(root, payload); });
+  root_ = std::make_shared<const Trie>(std::move(root));
+  committed_lsn_ = lsn;
+  log_ = std::make_unique<TrieLog>(directory_, lsn + 1);
+  checkpoint_thread_ = std::thread([this] { CheckpointLoop(); });
+}
+
+TrieStore::~TrieStore() {
+  if (checkpoint_thread_.joinable()) {
+    {
+      std::scoped_lock lock(checkpoint_lock_);
+      stopped_ = true;
+    }
+    checkpoint_cv_.notify_one();
+    checkpoint_thread_.join();
+  }
+}
+
+auto TrieStore::Snapshot() const -> Trie { return *std::atomic_load(&root_); }
+
+void TrieStore::Checkpoint() {
+  if (log_ == nullptr) {
+    return;
+  }
+  std::scoped_lock lock(checkpoint_write_lock_);
+  // Start a new segment, so that the records covered by this snapshot end up in older segments which
+  // can be deleted as a whole.
+  log_->Rotate();
+  // Read the LSN before the root. The root may contain records after the LSN too, which is fine:
+  // every record is a blind put or remove, so replaying them again yields the same trie.
+  auto lsn = committed_lsn_.load();
+  TrieSnapshot::Write(Snapshot(), lsn, directory_ + "/snapshot");
+  log_->Truncate(lsn);
+}
+
+void TrieStore::CheckpointLoop() {
+  std::unique_lock lock(checkpoint_lock_);
+  while (true) {
+    checkpoint_cv_.wait(lock, [this] {
+      return stopped_ || (checkpoint_interval_ > 0 && writes_since_checkpoint_ >= checkpoint_interval_);
+    });
+    if (stopped_) {
+      return;
+    }
+    auto num_writes = writes_since_checkpoint_;
+    writes_since_checkpoint_ = 0;
+    lock.unlock();
+    bool failed = false;
+    try {
+      Checkpoint();
+    } catch (const std::exception &e) {
+      // The log still has every write, so nothing is lost; it just keeps growing until a checkpoint succeeds.
+      LOG_WARN("checkpoint of %s failed, retrying later: %s", directory_.c_str(), e.what());
+      failed = true;
+    }
+    lock.lock();
+    if (failed) {
+      writes_since_checkpoint_ += num_writes;
+      checkpoint_cv_.wait_for(lock, CHECKPOINT_RETRY_DELAY, [this] { return stopped_; });
+    }
+  }
+}
+
 template <class T>
 auto TrieStore::Get(std::string_view key) -> std::optional<ValueGuard<T>> {
-  // Pseudo-code:
-  // (1) Take the root lock, get the root, and release the root lock. Don't lookup the value in the
-  //     trie while holding the root lock.
-  // (2) Lookup the value in the trie.
-  // (3) If the value is found, return a ValueGuard object that holds a reference to the value and the
-  //     root. Otherwise, return std::nullopt.
-  std::unique_lock<std::mutex> lk(root_lock_);
-  Trie root = root_;
-  lk.unlock();
+  // Take a snapshot without any lock, then lookup the value in it. The ValueGuard keeps the snapshot
+  // alive, so the reference stays valid after later writes.
+  Trie root = Snapshot();
   const T *result = root.Get<T>(key);
   if (result == nullptr) {
     return std::nullopt;
   }
-  return std::optional<ValueGuard<T>>(ValueGuard<T>(root, std::move(*result)));
-  // throw NotImplementedException("TrieStore::Get is not implemented.");
+  return std::optional<ValueGuard<T>>(ValueGuard<T>(root, *result));
 }
 
 template <class T>
 void TrieStore::Put(std::string_view key, T value) {
-  // You will need to ensure there is only one writer at a time. Think of how you can achieve this.
-  // The logic should be somehow similar to `TrieStore::Get`.
-  std::unique_lock<std::mutex> write_lk(write_lock_);
+  // The value is moved out of the caller before queueing, so a slow move never holds up the group.
+  WriteBatch batch;
+  batch.Put<T>(key, std::move(value));
+  Apply(std::move(batch));
+}
 
-  std::unique_lock<std::mutex> read_lk(root_lock_);
-  Trie root = root_;
-  read_lk.unlock();
+void TrieStore::Remove(std::string_view key) {
+  WriteBatch batch;
+  batch.Remove(key);
+  Apply(std::move(batch));
+}
 
-  auto result = root.Put(key, std::move(value));
+void TrieStore::Apply(WriteBatch batch) {
+  PendingWrite write(std::move(batch));
+  Commit(&write);
+}
 
-  read_lk.lock();
-  root_ = result;
-  read_lk.unlock();
+void TrieStore::Commit(PendingWrite *write) {
+  if (log_ != nullptr && !write->batch_.EncodeLogRecords(&write->log_records_)) {
+    throw Exception("this value type cannot be stored in a durable TrieStore");
+  }
 
-  write_lk.unlock();
-  // throw NotImplementedException("TrieStore::Put is not implemented.");
-}
+  std::unique_lock<std::mutex> lk(queue_lock_);
+  writers_.push_back(write);
+  while (!write->done_ && write != writers_.front()) {
+    write->cv_.wait(lk);
+  }
+  if (write->done_) {
+    // A leader committed this write as part of its group, or failed to.
+    if (write->error_ != nullptr) {
+      std::rethrow_exception(write->error_);
+    }
+    return;
+  }
 
-void TrieStore::Remove(std::string_view key) {
-  // You will need to ensure there is only one writer at a time. Think of how you can achieve this.
-  // The logic should be somehow similar to `TrieStore::Get`.
-  std::unique_lock<std::mutex> write_lk(write_lock_);
+  // This thread is the leader. Everything queued so far forms the group; later arrivals wait for the
+  // next leader. The group is applied without holding the queue lock.
+  auto group = std::vector<PendingWrite *>(writers_.begin(), writers_.end());
+  lk.unlock();
 
-  std::unique_lock<std::mutex> read_lk(root_lock_);
-  Trie root = root_;
-  read_lk.unlock();
+  std::exception_ptr error;
+  try {
+    CommitGroup(group);
+  } catch (...) {
+    error = std::current_exception();
+  }
 
-  auto result = root.Remove(key);
+  // Dequeue the group on every path, so that its members and the next leader do not wait forever.
+  lk.lock();
+  for (auto *member : group) {
+    writers_.pop_front();
+    if (member != write) {
+      member->error_ = error;
+      member->done_ = true;
+      member->cv_.notify_one();
+    }
+  }
+  if (!writers_.empty()) {
+    writers_.front()->cv_.notify_one();
+  }
+  lk.unlock();
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
 
-  read_lk.lock();
-  root_ = result;
-  read_lk.unlock();
+void TrieStore::CommitGroup(const std::vector<PendingWrite *> &group) {
+  // The whole group is made durable with a single sync before any of it becomes visible.
+  uint64_t lsn = committed_lsn_.load();
+  if (log_ != nullptr) {
+    for (auto *member : group) {
+      for (const auto &record : member->log_records_) {
+        lsn = log_->Append(record);
+      }
+    }
+    if (sync_) {
+      log_->Sync();
+    }
+  }
 
-  write_lk.unlock();
-  // throw NotImplementedException("TrieStore::Remove is not implemented.");
+  // Merge the group into one batch in queue order, so the new root is built in a single pass and a
+  // later write to the same key still wins.
+  WriteBatch merged;
+  size_t num_writes = 0;
+  for (auto *member : group) {
+    num_writes += member->batch_.Size();
+    merged.Merge(std::move(member->batch_));
+  }
+  std::atomic_store(&root_, std::make_shared<const Trie>(std::atomic_load(&root_)->Apply(merged)));
+
+  if (log_ != nullptr) {
+    committed_lsn_ = lsn;
+    std::scoped_lock checkpoint_lock(checkpoint_lock_);
+    writes_since_checkpoint_ += num_writes;
+    if (checkpoint_interval_ > 0 && writes_since_checkpoint_ >= checkpoint_interval_) {
+      checkpoint_cv_.notify_one();
+    }
+  }
 }
 
 // Below are explicit instantiation of template functions.
@@ -67,6 +200,9 @@ void TrieStore::Remove(std::string_view key) {
 template auto TrieStore::Get(std::string_view key) -> std::optional<ValueGuard<uint32_t>>;
 template void TrieStore::Put(std::string_view key, uint32_t value);
 
+template auto TrieStore::Get(std::string_view key) -> std::optional<ValueGuard<uint64_t>>;
+template void TrieStore::Put(std::string_view key, uint64_t value);
+
 template auto TrieStore::Get(std::string_view key) -> std::optional<ValueGuard<std::string>>;
 template void TrieStore::Put(std::string_view key, std::string value);
 
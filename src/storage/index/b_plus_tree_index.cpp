@@ -9,6 +9,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+
 #include "storage/index/b_plus_tree_index.h"
 
 namespace bustub {
@@ -33,6 +35,24 @@ auto BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *t
   return container_->Insert(index_key, rid, transaction);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::InsertEntries(std::vector<std::pair<Tuple, RID>> *entries, Transaction *transaction)
+    -> size_t {
+  std::vector<std::pair<KeyType, RID>> index_entries(entries->size());
+  for (size_t i = 0; i < entries->size(); i++) {
+    index_entries[i].first.SetFromKey((*entries)[i].first);
+    index_entries[i].second = (*entries)[i].second;
+  }
+  std::stable_sort(index_entries.begin(), index_entries.end(),
+                   [this](const auto &a, const auto &b) { return comparator_(a.first, b.first) < 0; });
+
+  size_t num_inserted = 0;
+  for (const auto &[index_key, rid] : index_entries) {
+    num_inserted += container_->Insert(index_key, rid, transaction) ? 1 : 0;
+  }
+  return num_inserted;
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct delete index key
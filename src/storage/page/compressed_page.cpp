@@ -0,0 +1,616 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page.cpp
+//
+// Identification: src/storage/page/compressed_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/compressed_page.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "storage/page/table_page.h"
+#include "storage/table/toast_store.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+static auto AlignUp(uint32_t offset) -> uint32_t { return (offset + 7) & ~7U; }
+
+/** @return true if the values of `type` are integers, so frame of reference encoding applies to them */
+static auto IsInteger(TypeId type) -> bool {
+  switch (type) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+    case TypeId::SMALLINT:
+    case TypeId::INTEGER:
+    case TypeId::BIGINT:
+    case TypeId::TIMESTAMP:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/** @return the number of bytes `value` takes in a tuple, the length of a VARCHAR value included */
+static auto ValueSize(const Column &column, const char *value) -> uint32_t {
+  if (column.IsInlined()) {
+    return column.GetFixedLength();
+  }
+  uint32_t len;
+  memcpy(&len, value, sizeof(uint32_t));
+  return sizeof(uint32_t) + (len == BUSTUB_VALUE_NULL ? 0 : len & ~TOAST_FLAG);
+}
+
+static auto ReadInt(const char *value, uint32_t width) -> int64_t {
+  switch (width) {
+    case 1: {
+      int8_t v;
+      memcpy(&v, value, sizeof(v));
+      return v;
+    }
+    case 2: {
+      int16_t v;
+      memcpy(&v, value, sizeof(v));
+      return v;
+    }
+    case 4: {
+      int32_t v;
+      memcpy(&v, value, sizeof(v));
+      return v;
+    }
+    default: {
+      int64_t v;
+      memcpy(&v, value, sizeof(v));
+      return v;
+    }
+  }
+}
+
+static auto BitWidth(uint64_t max) -> uint8_t { return max == 0 ? 0 : 64 - __builtin_clzll(max); }
+
+static auto PackedSize(size_t count, uint8_t bit_width) -> size_t { return (count * bit_width + 63) / 64 * 8; }
+
+static void Pack(const std::vector<uint64_t> &values, uint8_t bit_width, std::vector<char> *out) {
+  std::vector<uint64_t> words(PackedSize(values.size(), bit_width) / 8, 0);
+  for (size_t i = 0; i < values.size() && bit_width > 0; i++) {
+    auto bit = i * bit_width;
+    auto shift = bit % 64;
+    words[bit / 64] |= values[i] << shift;
+    if (shift + bit_width > 64) {
+      words[bit / 64 + 1] |= values[i] >> (64 - shift);
+    }
+  }
+  auto *bytes = reinterpret_cast<const char *>(words.data());
+  out->insert(out->end(), bytes, bytes + words.size() * 8);
+}
+
+/** Unpack values [first, end) of `bit_width` bits each from the words at `packed` into `out`. */
+static void Unpack(const char *packed, uint8_t bit_width, uint32_t first, uint32_t end, uint64_t *out) {
+  if (bit_width == 0) {
+    std::fill(out, out + (end - first), 0);
+    return;
+  }
+  const uint64_t mask = bit_width == 64 ? ~0ULL : (1ULL << bit_width) - 1;
+  for (uint32_t i = first; i < end; i++) {
+    auto bit = static_cast<size_t>(i) * bit_width;
+    auto shift = bit % 64;
+    uint64_t word;
+    memcpy(&word, packed + bit / 64 * 8, sizeof(word));
+    uint64_t value = word >> shift;
+    if (shift + bit_width > 64) {
+      memcpy(&word, packed + (bit / 64 + 1) * 8, sizeof(word));
+      value |= word << (64 - shift);
+    }
+    out[i - first] = value & mask;
+  }
+}
+
+/** Write `base` plus each delta as a T, one after the other. */
+template <typename T>
+static void StoreInts(int64_t base, const std::vector<uint64_t> &deltas, char *out) {
+  for (size_t i = 0; i < deltas.size(); i++) {
+    auto value = static_cast<T>(static_cast<uint64_t>(base) + deltas[i]);
+    memcpy(out + i * sizeof(T), &value, sizeof(T));
+  }
+}
+
+static auto PlainSize(const Column &column, const std::vector<const char *> &values) -> size_t {
+  size_t size = column.IsInlined() ? 0 : values.size() * sizeof(uint16_t);
+  for (const auto *value : values) {
+    size += ValueSize(column, value);
+  }
+  return size;
+}
+
+static void WritePlain(const Column &column, const std::vector<const char *> &values, std::vector<char> *out) {
+  if (!column.IsInlined()) {
+    uint16_t end = 0;
+    for (const auto *value : values) {
+      end += ValueSize(column, value);
+      out->insert(out->end(), reinterpret_cast<const char *>(&end), reinterpret_cast<const char *>(&end) + 2);
+    }
+  }
+  for (const auto *value : values) {
+    out->insert(out->end(), value, value + ValueSize(column, value));
+  }
+}
+
+/** @return value `i` of the `count` values of `column` stored at `data` as in PLAIN encoding */
+static auto PlainValue(const Column &column, const char *data, uint32_t count, uint32_t i) -> const char * {
+  if (column.IsInlined()) {
+    return data + i * column.GetFixedLength();
+  }
+  uint16_t start = 0;
+  if (i > 0) {
+    memcpy(&start, data + (i - 1) * sizeof(uint16_t), sizeof(uint16_t));
+  }
+  return data + count * sizeof(uint16_t) + start;
+}
+
+/** @return the size of the `count` values of `column` stored at `data` as in PLAIN encoding */
+static auto PlainSizeAt(const Column &column, const char *data, uint32_t count) -> size_t {
+  if (column.IsInlined()) {
+    return count * column.GetFixedLength();
+  }
+  uint16_t end = 0;
+  if (count > 0) {
+    memcpy(&end, data + (count - 1) * sizeof(uint16_t), sizeof(uint16_t));
+  }
+  return count * sizeof(uint16_t) + end;
+}
+
+/** Encode `values` of `column` in the encoding that takes the least space. */
+static auto EncodeColumn(const Column &column, const std::vector<const char *> &values) -> std::vector<char> {
+  auto num_values = values.size();
+  auto width = column.GetFixedLength();
+  auto best = ColumnEncoding::PLAIN;
+  auto best_size = PlainSize(column, values);
+
+  int64_t min = 0;
+  uint8_t for_width = 64;
+  if (IsInteger(column.GetType()) && num_values > 0) {
+    min = ReadInt(values[0], width);
+    auto max = min;
+    for (const auto *value : values) {
+      auto v = ReadInt(value, width);
+      min = std::min(min, v);
+      max = std::max(max, v);
+    }
+    for_width = BitWidth(static_cast<uint64_t>(max) - static_cast<uint64_t>(min));
+    auto size = sizeof(int64_t) + 1 + PackedSize(num_values, for_width);
+    if (for_width < 64 && size < best_size) {
+      best = ColumnEncoding::FRAME_OF_REFERENCE;
+      best_size = size;
+    }
+  }
+
+  std::vector<uint16_t> run_ends;
+  if (column.IsInlined()) {
+    for (size_t i = 1; i <= num_values; i++) {
+      if (i == num_values || memcmp(values[i], values[i - 1], width) != 0) {
+        run_ends.push_back(i);
+      }
+    }
+    auto size = sizeof(uint16_t) + run_ends.size() * (sizeof(uint16_t) + width);
+    if (size < best_size) {
+      best = ColumnEncoding::RUN_LENGTH;
+      best_size = size;
+    }
+  }
+
+  std::unordered_map<std::string_view, uint64_t> codes;
+  std::vector<const char *> dictionary;
+  std::vector<uint64_t> indexes;
+  indexes.reserve(num_values);
+  for (const auto *value : values) {
+    auto [it, inserted] = codes.emplace(std::string_view(value, ValueSize(column, value)), dictionary.size());
+    if (inserted) {
+      dictionary.push_back(value);
+    }
+    indexes.push_back(it->second);
+  }
+  auto dictionary_width = BitWidth(dictionary.empty() ? 0 : dictionary.size() - 1);
+  auto dictionary_size =
+      sizeof(uint16_t) + 1 + PlainSize(column, dictionary) + PackedSize(num_values, dictionary_width);
+  if (dictionary.size() <= UINT16_MAX && dictionary_size < best_size) {
+    best = ColumnEncoding::DICTIONARY;
+  }
+
+  std::vector<char> block{static_cast<char>(best)};
+  switch (best) {
+    case ColumnEncoding::PLAIN:
+      WritePlain(column, values, &block);
+      break;
+    case ColumnEncoding::FRAME_OF_REFERENCE: {
+      std::vector<uint64_t> deltas;
+      deltas.reserve(num_values);
+      for (const auto *value : values) {
+        deltas.push_back(static_cast<uint64_t>(ReadInt(value, width)) - static_cast<uint64_t>(min));
+      }
+      block.insert(block.end(), reinterpret_cast<const char *>(&min), reinterpret_cast<const char *>(&min) + 8);
+      block.push_back(static_cast<char>(for_width));
+      Pack(deltas, for_width, &block);
+      break;
+    }
+    case ColumnEncoding::RUN_LENGTH: {
+      auto num_runs = static_cast<uint16_t>(run_ends.size());
+      block.insert(block.end(), reinterpret_cast<const char *>(&num_runs),
+                   reinterpret_cast<const char *>(&num_runs) + sizeof(uint16_t));
+      block.insert(block.end(), reinterpret_cast<const char *>(run_ends.data()),
+                   reinterpret_cast<const char *>(run_ends.data() + run_ends.size()));
+      for (auto run_end : run_ends) {
+        block.insert(block.end(), values[run_end - 1], values[run_end - 1] + width);
+      }
+      break;
+    }
+    case ColumnEncoding::DICTIONARY: {
+      auto num_entries = static_cast<uint16_t>(dictionary.size());
+      block.insert(block.end(), reinterpret_cast<const char *>(&num_entries),
+                   reinterpret_cast<const char *>(&num_entries) + sizeof(uint16_t));
+      block.push_back(static_cast<char>(dictionary_width));
+      WritePlain(column, dictionary, &block);
+      Pack(indexes, dictionary_width, &block);
+      break;
+    }
+  }
+  return block;
+}
+
+/**
+ * Decode rows [first, end) of the block at `block`, which holds `num_rows` values of `column`. Inlined values are
+ * written one after the other to `fixed`; VARCHAR values are returned in `varlen` as pointers into the block.
+ */
+static void DecodeColumn(const Column &column, const char *block, uint32_t num_rows, uint32_t first, uint32_t end,
+                         char *fixed, const char **varlen) {
+  auto width = column.GetFixedLength();
+  auto count = end - first;
+  const char *data = block + 1;
+  switch (static_cast<ColumnEncoding>(block[0])) {
+    case ColumnEncoding::PLAIN:
+      if (column.IsInlined()) {
+        memcpy(fixed, data + first * width, count * width);
+        return;
+      }
+      for (auto i = first; i < end; i++) {
+        varlen[i - first] = PlainValue(column, data, num_rows, i);
+      }
+      return;
+    case ColumnEncoding::FRAME_OF_REFERENCE: {
+      int64_t min;
+      memcpy(&min, data, sizeof(min));
+      auto bit_width = static_cast<uint8_t>(data[sizeof(min)]);
+      std::vector<uint64_t> deltas(count);
+      Unpack(data + sizeof(min) + 1, bit_width, first, end, deltas.data());
+      switch (width) {
+        case 1:
+          StoreInts<int8_t>(min, deltas, fixed);
+          break;
+        case 2:
+          StoreInts<int16_t>(min, deltas, fixed);
+          break;
+        case 4:
+          StoreInts<int32_t>(min, deltas, fixed);
+          break;
+        default:
+          StoreInts<int64_t>(min, deltas, fixed);
+          break;
+      }
+      return;
+    }
+    case ColumnEncoding::RUN_LENGTH: {
+      uint16_t num_runs;
+      memcpy(&num_runs, data, sizeof(num_runs));
+      auto run_end = [&](uint32_t run) {
+        uint16_t end;
+        memcpy(&end, data + sizeof(uint16_t) * (run + 1), sizeof(uint16_t));
+        return end;
+      };
+      const char *run_values = data + sizeof(uint16_t) * (num_runs + 1);
+      // Binary search for the run of the first row, then walk the runs.
+      uint32_t lo = 0;
+      uint32_t hi = num_runs;
+      while (lo < hi) {
+        auto mid = (lo + hi) / 2;
+        if (run_end(mid) <= first) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      for (auto i = first, run = lo; i < end; run++) {
+        auto run_stop = std::min<uint32_t>(run_end(run), end);
+        for (; i < run_stop; i++) {
+          memcpy(fixed + (i - first) * width, run_values + run * width, width);
+        }
+      }
+      return;
+    }
+    case ColumnEncoding::DICTIONARY: {
+      uint16_t num_entries;
+      memcpy(&num_entries, data, sizeof(num_entries));
+      auto bit_width = static_cast<uint8_t>(data[sizeof(num_entries)]);
+      const char *dictionary = data + sizeof(num_entries) + 1;
+      std::vector<uint64_t> indexes(count);
+      Unpack(dictionary + PlainSizeAt(column, dictionary, num_entries), bit_width, first, end, indexes.data());
+      if (column.IsInlined()) {
+        for (uint32_t i = 0; i < count; i++) {
+          memcpy(fixed + i * width, dictionary + indexes[i] * width, width);
+        }
+      } else {
+        for (uint32_t i = 0; i < count; i++) {
+          varlen[i] = PlainValue(column, dictionary, num_entries, indexes[i]);
+        }
+      }
+      return;
+    }
+  }
+  UNREACHABLE("unknown column encoding");
+}
+
+void CompressedPage::Init() {
+  static_assert(offsetof(CompressedPage, next_page_id_) == TablePage::NEXT_PAGE_ID_OFFSET);
+  static_assert(offsetof(CompressedPage, num_tuples_) == TablePage::NUM_TUPLES_OFFSET);
+  next_page_id_ = INVALID_PAGE_ID;
+  num_tuples_ = 0;
+  num_compressed_tuples_ = 0;
+  num_deleted_tuples_ = 0;
+  tail_slots_start_ = COMPRESSED_PAGE_HEADER_SIZE;
+  free_space_pointer_ = BUSTUB_PAGE_SIZE;
+  unused_ = 0;
+}
+
+auto CompressedPage::GetFreeSpace() const -> size_t {
+  size_t slots_end = tail_slots_start_ + (num_tuples_ - num_compressed_tuples_ + 1) * TUPLE_INFO_SIZE;
+  return free_space_pointer_ > slots_end ? free_space_pointer_ - slots_end : 0;
+}
+
+auto CompressedPage::GetEncoding(uint32_t column_idx) const -> ColumnEncoding {
+  BUSTUB_ASSERT(num_compressed_tuples_ > 0, "the page has no compressed tuples");
+  return static_cast<ColumnEncoding>(page_start_[BlockOffsets()[column_idx]]);
+}
+
+auto CompressedPage::InsertTuple(const TupleMeta &meta, const Tuple &tuple) -> std::optional<uint16_t> {
+  if (num_tuples_ == UINT16_MAX || GetFreeSpace() < tuple.GetLength()) {
+    return std::nullopt;
+  }
+  free_space_pointer_ -= tuple.GetLength();
+  TailSlots()[num_tuples_ - num_compressed_tuples_] =
+      std::make_tuple(free_space_pointer_, static_cast<uint16_t>(tuple.GetLength()), meta);
+  memcpy(page_start_ + free_space_pointer_, tuple.GetData(), tuple.GetLength());
+  if (meta.is_deleted_) {
+    num_deleted_tuples_++;
+  }
+  return num_tuples_++;
+}
+
+auto CompressedPage::Compress(const Schema &schema) -> size_t {
+  if (num_tuples_ == num_compressed_tuples_) {
+    return 0;
+  }
+  std::vector<char> tuple_data;
+  std::vector<TupleView> tuples;
+  GetTupleViews(schema, INVALID_PAGE_ID, 0, num_tuples_, nullptr, &tuple_data, &tuples);
+  auto page = std::make_unique<char[]>(BUSTUB_PAGE_SIZE);
+  if (!Build(schema, tuples, page.get())) {
+    return 0;
+  }
+  auto free_space = reinterpret_cast<const CompressedPage *>(page.get())->GetFreeSpace();
+  if (free_space <= GetFreeSpace()) {
+    return 0;
+  }
+  auto freed = free_space - GetFreeSpace();
+  memcpy(page_start_, page.get(), BUSTUB_PAGE_SIZE);
+  return freed;
+}
+
+auto CompressedPage::Build(const Schema &schema, const std::vector<TupleView> &tuples, char *page) const -> bool {
+  auto num_tuples = static_cast<uint32_t>(tuples.size());
+  auto header = reinterpret_cast<CompressedPage *>(page);
+  header->next_page_id_ = next_page_id_;
+  header->num_tuples_ = num_tuples;
+  header->num_compressed_tuples_ = num_tuples;
+  header->num_deleted_tuples_ =
+      std::count_if(tuples.begin(), tuples.end(), [](const auto &tuple) { return tuple.meta_.is_deleted_; });
+  header->free_space_pointer_ = BUSTUB_PAGE_SIZE;
+  header->unused_ = 0;
+
+  uint32_t offset = COMPRESSED_PAGE_HEADER_SIZE + num_tuples * TUPLE_META_SIZE;
+  auto block_offsets = offset;
+  offset += schema.GetColumnCount() * sizeof(uint16_t);
+  if (offset > BUSTUB_PAGE_SIZE) {
+    return false;
+  }
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    memcpy(page + COMPRESSED_PAGE_HEADER_SIZE + i * TUPLE_META_SIZE, &tuples[i].meta_, TUPLE_META_SIZE);
+  }
+
+  std::vector<const char *> values(num_tuples);
+  for (uint32_t column_idx = 0; column_idx < schema.GetColumnCount(); column_idx++) {
+    const auto &column = schema.GetColumn(column_idx);
+    for (uint32_t i = 0; i < num_tuples; i++) {
+      const char *data = tuples[i].data_;
+      if (column.IsInlined()) {
+        values[i] = data + column.GetOffset();
+      } else {
+        uint32_t var_offset;
+        memcpy(&var_offset, data + column.GetOffset(), sizeof(uint32_t));
+        values[i] = data + var_offset;
+      }
+    }
+    auto block = EncodeColumn(column, values);
+    if (offset + block.size() > BUSTUB_PAGE_SIZE) {
+      return false;
+    }
+    auto block_offset = static_cast<uint16_t>(offset);
+    memcpy(page + block_offsets + column_idx * sizeof(uint16_t), &block_offset, sizeof(uint16_t));
+    memcpy(page + offset, block.data(), block.size());
+    offset += block.size();
+  }
+  offset = AlignUp(offset);
+  if (offset > BUSTUB_PAGE_SIZE) {
+    return false;
+  }
+  header->tail_slots_start_ = offset;
+  return true;
+}
+
+void CompressedPage::UpdateTupleMeta(const TupleMeta &meta, const RID &rid) {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  auto &old_meta = tuple_id < num_compressed_tuples_ ? Metas()[tuple_id]
+                                                     : std::get<2>(TailSlots()[tuple_id - num_compressed_tuples_]);
+  if (!old_meta.is_deleted_ && meta.is_deleted_) {
+    num_deleted_tuples_++;
+  } else if (old_meta.is_deleted_ && !meta.is_deleted_) {
+    num_deleted_tuples_--;
+  }
+  old_meta = meta;
+}
+
+auto CompressedPage::GetTupleMeta(const RID &rid) const -> TupleMeta {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  return tuple_id < num_compressed_tuples_ ? Metas()[tuple_id]
+                                           : std::get<2>(TailSlots()[tuple_id - num_compressed_tuples_]);
+}
+
+auto CompressedPage::GetTuple(const Schema &schema, const RID &rid) const -> std::pair<TupleMeta, Tuple> {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  std::vector<char> tuple_data;
+  std::vector<TupleView> views;
+  GetTupleViews(schema, rid.GetPageId(), tuple_id, tuple_id + 1, nullptr, &tuple_data, &views);
+  Tuple tuple;
+  tuple.CopyFrom(views[0]);
+  return std::make_pair(views[0].meta_, std::move(tuple));
+}
+
+void CompressedPage::UpdateTupleInPlaceUnsafe(const Schema &schema, const TupleMeta &meta, const Tuple &tuple,
+                                              const RID &rid) {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  if (tuple_id >= num_compressed_tuples_) {
+    auto &[offset, size, old_meta] = TailSlots()[tuple_id - num_compressed_tuples_];
+    if (size != tuple.GetLength()) {
+      throw bustub::Exception("Tuple size mismatch");
+    }
+    UpdateTupleMeta(meta, rid);
+    memcpy(page_start_ + offset, tuple.GetData(), tuple.GetLength());
+    return;
+  }
+
+  std::vector<char> tuple_data;
+  std::vector<TupleView> tuples;
+  GetTupleViews(schema, INVALID_PAGE_ID, 0, num_tuples_, nullptr, &tuple_data, &tuples);
+  tuples[tuple_id].meta_ = meta;
+  tuples[tuple_id].data_ = tuple.GetData();
+  tuples[tuple_id].size_ = tuple.GetLength();
+  auto page = std::make_unique<char[]>(BUSTUB_PAGE_SIZE);
+  if (!Build(schema, tuples, page.get())) {
+    throw bustub::Exception("not enough space to update the tuple in place");
+  }
+  memcpy(page_start_, page.get(), BUSTUB_PAGE_SIZE);
+}
+
+void CompressedPage::GetTupleViews(const Schema &schema, page_id_t page_id, uint32_t first_slot, uint32_t end_slot,
+                                   const std::vector<uint32_t> *column_ids, std::vector<char> *tuple_data,
+                                   std::vector<TupleView> *views) const {
+  end_slot = std::min<uint32_t>(end_slot, num_tuples_);
+  auto compressed_end = std::min<uint32_t>(end_slot, num_compressed_tuples_);
+  if (first_slot < compressed_end) {
+    auto count = compressed_end - first_slot;
+    auto num_columns = schema.GetColumnCount();
+    std::vector<bool> read(num_columns, column_ids == nullptr);
+    if (column_ids != nullptr) {
+      for (auto column_idx : *column_ids) {
+        read[column_idx] = true;
+      }
+    }
+
+    // Decode a column at a time, then put the tuples together in the same format as the Tuple constructor.
+    std::vector<std::vector<char>> fixed(num_columns);
+    std::vector<std::vector<const char *>> varlen(num_columns);
+    std::vector<uint32_t> sizes(count, schema.GetLength());
+    for (uint32_t column_idx = 0; column_idx < num_columns; column_idx++) {
+      const auto &column = schema.GetColumn(column_idx);
+      if (!read[column_idx]) {
+        if (column.IsInlined()) {
+          fixed[column_idx].resize(column.GetFixedLength());
+          ValueFactory::GetNullValueByType(column.GetType()).SerializeTo(fixed[column_idx].data());
+        } else {
+          std::for_each(sizes.begin(), sizes.end(), [](uint32_t &size) { size += sizeof(uint32_t); });
+        }
+        continue;
+      }
+      const char *block = page_start_ + BlockOffsets()[column_idx];
+      if (column.IsInlined()) {
+        fixed[column_idx].resize(count * column.GetFixedLength());
+        DecodeColumn(column, block, num_compressed_tuples_, first_slot, compressed_end, fixed[column_idx].data(),
+                     nullptr);
+      } else {
+        varlen[column_idx].resize(count);
+        DecodeColumn(column, block, num_compressed_tuples_, first_slot, compressed_end, nullptr,
+                     varlen[column_idx].data());
+        for (uint32_t i = 0; i < count; i++) {
+          sizes[i] += ValueSize(column, varlen[column_idx][i]);
+        }
+      }
+    }
+
+    size_t total_size = 0;
+    for (auto size : sizes) {
+      total_size += size;
+    }
+    tuple_data->assign(total_size, 0);
+    char *out = tuple_data->data();
+    for (uint32_t i = 0; i < count; i++) {
+      uint32_t var_offset = schema.GetLength();
+      for (uint32_t column_idx = 0; column_idx < num_columns; column_idx++) {
+        const auto &column = schema.GetColumn(column_idx);
+        if (column.IsInlined()) {
+          auto width = column.GetFixedLength();
+          memcpy(out + column.GetOffset(), fixed[column_idx].data() + (read[column_idx] ? i * width : 0), width);
+          continue;
+        }
+        memcpy(out + column.GetOffset(), &var_offset, sizeof(uint32_t));
+        if (read[column_idx]) {
+          auto size = ValueSize(column, varlen[column_idx][i]);
+          memcpy(out + var_offset, varlen[column_idx][i], size);
+          var_offset += size;
+        } else {
+          uint32_t len = BUSTUB_VALUE_NULL;
+          memcpy(out + var_offset, &len, sizeof(uint32_t));
+          var_offset += sizeof(uint32_t);
+        }
+      }
+      views->push_back(TupleView{RID{page_id, first_slot + i}, Metas()[first_slot + i], out, sizes[i]});
+      out += sizes[i];
+    }
+  }
+
+  for (auto tuple_id = std::max<uint32_t>(first_slot, num_compressed_tuples_); tuple_id < end_slot; tuple_id++) {
+    auto &[offset, size, meta] = TailSlots()[tuple_id - num_compressed_tuples_];
+    views->push_back(TupleView{RID{page_id, tuple_id}, meta, page_start_ + offset, size});
+  }
+}
+
+}  // namespace bustub
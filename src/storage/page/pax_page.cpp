@@ -0,0 +1,287 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_page.cpp
+//
+// Identification: src/storage/page/pax_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/pax_page.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "storage/page/table_page.h"
+#include "storage/table/toast_store.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+static auto AlignUp(uint32_t offset) -> uint32_t { return (offset + 7) & ~7U; }
+
+PaxLayout::PaxLayout(const Schema &schema) : schema_(schema) {
+  uint32_t row_size = TUPLE_META_SIZE;
+  for (const auto &column : schema_.GetColumns()) {
+    ColumnLayout layout;
+    layout.type_ = column.GetType();
+    layout.inlined_ = column.IsInlined();
+    layout.width_ = layout.inlined_ ? column.GetFixedLength() : sizeof(uint32_t);
+    layout.tuple_offset_ = column.GetOffset();
+    if (layout.inlined_) {
+      layout.null_value_.resize(layout.width_);
+      ValueFactory::GetNullValueByType(layout.type_).SerializeTo(layout.null_value_.data());
+    }
+    // One more byte per row covers the NULL bitmap of up to eight columns and the rounding of the minipages.
+    row_size += layout.width_ + 1;
+    if (!layout.inlined_) {
+      // Longer values are stored out of line.
+      row_size += std::min(column.GetVariableLength(), ToastStore::TOAST_TUPLE_THRESHOLD) / VARCHAR_EXPECTED_FRACTION;
+    }
+    columns_.push_back(std::move(layout));
+  }
+
+  capacity_ = std::min<uint32_t>((BUSTUB_PAGE_SIZE - PAX_PAGE_HEADER_SIZE) / row_size,
+                                 std::numeric_limits<uint16_t>::max());
+  while (capacity_ > 0 && Place(capacity_) > BUSTUB_PAGE_SIZE) {
+    capacity_--;
+  }
+  BUSTUB_ENSURE(capacity_ > 0, "the schema has too many columns for a PAX page");
+  minipages_end_ = Place(capacity_);
+}
+
+auto PaxLayout::Place(uint32_t capacity) -> uint32_t {
+  uint32_t offset = PAX_PAGE_HEADER_SIZE + capacity * TUPLE_META_SIZE;
+  for (auto &column : columns_) {
+    offset = AlignUp(offset);
+    column.stats_offset_ = offset;
+    offset += COLUMN_STATS_SIZE;
+    column.null_bitmap_offset_ = offset;
+    offset = AlignUp(offset + (capacity + 7) / 8);
+    column.values_offset_ = offset;
+    offset += capacity * column.width_;
+  }
+  return offset;
+}
+
+void PaxPage::Init(const PaxLayout &layout) {
+  static_assert(offsetof(PaxPage, next_page_id_) == TablePage::NEXT_PAGE_ID_OFFSET);
+  static_assert(offsetof(PaxPage, num_tuples_) == TablePage::NUM_TUPLES_OFFSET);
+  memset(page_start_, 0, layout.minipages_end_);
+  next_page_id_ = INVALID_PAGE_ID;
+  var_data_pointer_ = BUSTUB_PAGE_SIZE;
+}
+
+auto PaxPage::InsertTuple(const PaxLayout &layout, const TupleMeta &meta, const Tuple &tuple)
+    -> std::optional<uint16_t> {
+  if (num_tuples_ == layout.capacity_ || !WriteRow(layout, tuple, num_tuples_)) {
+    return std::nullopt;
+  }
+  Metas()[num_tuples_] = meta;
+  if (meta.is_deleted_) {
+    num_deleted_tuples_++;
+  }
+  return num_tuples_++;
+}
+
+auto PaxPage::WriteRow(const PaxLayout &layout, const Tuple &tuple, uint32_t slot) -> bool {
+  const char *data = tuple.GetData();
+
+  // Check that the VARCHAR values fit before anything is written.
+  uint32_t var_size = 0;
+  for (const auto &column : layout.columns_) {
+    if (!column.inlined_) {
+      auto offset = *reinterpret_cast<const uint32_t *>(data + column.tuple_offset_);
+      auto len = *reinterpret_cast<const uint32_t *>(data + offset);
+      var_size += len == BUSTUB_VALUE_NULL ? 0 : len & ~TOAST_FLAG;
+    }
+  }
+  if (var_data_pointer_ < layout.minipages_end_ + var_size) {
+    return false;
+  }
+
+  for (const auto &column : layout.columns_) {
+    auto stats = Stats(column);
+    auto *null_bitmap = reinterpret_cast<uint8_t *>(page_start_ + column.null_bitmap_offset_);
+    char *value = page_start_ + column.values_offset_ + slot * column.width_;
+    bool is_null;
+    if (column.inlined_) {
+      memcpy(value, data + column.tuple_offset_, column.width_);
+      is_null = memcmp(value, column.null_value_.data(), column.width_) == 0;
+    } else {
+      auto offset = *reinterpret_cast<const uint32_t *>(data + column.tuple_offset_);
+      auto len = *reinterpret_cast<const uint32_t *>(data + offset);
+      is_null = len == BUSTUB_VALUE_NULL;
+      VarcharRef ref{0, 0};
+      if (!is_null) {
+        auto size = len & ~TOAST_FLAG;
+        var_data_pointer_ -= size;
+        memcpy(page_start_ + var_data_pointer_, data + offset + sizeof(uint32_t), size);
+        auto flags = (len & TOAST_FLAG) != 0 ? VARCHAR_TOASTED : 0;
+        ref = VarcharRef{var_data_pointer_, static_cast<uint16_t>(size | flags)};
+      }
+      memcpy(value, &ref, sizeof(ref));
+    }
+
+    if (is_null) {
+      null_bitmap[slot / 8] |= 1 << (slot % 8);
+      continue;
+    }
+    null_bitmap[slot / 8] &= ~(1 << (slot % 8));
+    if (column.inlined_) {
+      auto new_value = Value::DeserializeFrom(value, column.type_);
+      if (stats->num_values_ == 0 ||
+          new_value.CompareLessThan(Value::DeserializeFrom(stats->min_, column.type_)) == CmpBool::CmpTrue) {
+        memcpy(stats->min_, value, column.width_);
+      }
+      if (stats->num_values_ == 0 ||
+          new_value.CompareGreaterThan(Value::DeserializeFrom(stats->max_, column.type_)) == CmpBool::CmpTrue) {
+        memcpy(stats->max_, value, column.width_);
+      }
+    }
+    stats->num_values_++;
+  }
+  return true;
+}
+
+void PaxPage::UpdateTupleMeta(const TupleMeta &meta, const RID &rid) {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  auto &old_meta = Metas()[tuple_id];
+  if (!old_meta.is_deleted_ && meta.is_deleted_) {
+    num_deleted_tuples_++;
+  } else if (old_meta.is_deleted_ && !meta.is_deleted_) {
+    num_deleted_tuples_--;
+  }
+  old_meta = meta;
+}
+
+auto PaxPage::GetTupleMeta(const RID &rid) const -> TupleMeta {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  return Metas()[tuple_id];
+}
+
+auto PaxPage::GetTuple(const PaxLayout &layout, const RID &rid) const -> std::pair<TupleMeta, Tuple> {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  std::vector<bool> read(layout.columns_.size(), true);
+  std::vector<char> data(RowSize(layout, tuple_id, read), 0);
+  ReadRow(layout, tuple_id, read, data.data());
+  Tuple tuple;
+  tuple.CopyFrom(TupleView{rid, Metas()[tuple_id], data.data(), static_cast<uint32_t>(data.size())});
+  return std::make_pair(Metas()[tuple_id], std::move(tuple));
+}
+
+void PaxPage::UpdateTupleInPlaceUnsafe(const PaxLayout &layout, const TupleMeta &meta, const Tuple &tuple,
+                                       const RID &rid) {
+  auto tuple_id = rid.GetSlotNum();
+  if (tuple_id >= num_tuples_) {
+    throw bustub::Exception("Tuple ID out of range");
+  }
+  if (!WriteRow(layout, tuple, tuple_id)) {
+    throw bustub::Exception("not enough space to update the tuple in place");
+  }
+  // The overwritten values are still counted in NumValues and Min/Max, which keeps them an upper bound.
+  UpdateTupleMeta(meta, rid);
+}
+
+void PaxPage::GetTupleViews(const PaxLayout &layout, page_id_t page_id, uint32_t first_slot, uint32_t end_slot,
+                            const std::vector<uint32_t> *column_ids, std::vector<char> *tuple_data,
+                            std::vector<TupleView> *views) const {
+  std::vector<bool> read(layout.columns_.size(), column_ids == nullptr);
+  if (column_ids != nullptr) {
+    for (auto column_idx : *column_ids) {
+      read[column_idx] = true;
+    }
+  }
+  end_slot = std::min<uint32_t>(end_slot, num_tuples_);
+
+  // Size all tuples first, so the views can point into `tuple_data` once it no longer moves.
+  size_t total_size = 0;
+  for (auto tuple_id = first_slot; tuple_id < end_slot; tuple_id++) {
+    total_size += RowSize(layout, tuple_id, read);
+  }
+  tuple_data->assign(total_size, 0);
+  char *out = tuple_data->data();
+  for (auto tuple_id = first_slot; tuple_id < end_slot; tuple_id++) {
+    auto size = RowSize(layout, tuple_id, read);
+    ReadRow(layout, tuple_id, read, out);
+    views->push_back(TupleView{RID{page_id, tuple_id}, Metas()[tuple_id], out, size});
+    out += size;
+  }
+}
+
+auto PaxPage::RowSize(const PaxLayout &layout, uint32_t slot, const std::vector<bool> &read) const -> uint32_t {
+  uint32_t size = layout.schema_.GetLength();
+  for (size_t i = 0; i < layout.columns_.size(); i++) {
+    const auto &column = layout.columns_[i];
+    if (column.inlined_) {
+      continue;
+    }
+    size += sizeof(uint32_t);
+    if (read[i] && !IsNull(layout, i, slot)) {
+      VarcharRef ref;
+      memcpy(&ref, page_start_ + column.values_offset_ + slot * column.width_, sizeof(ref));
+      size += ref.size_ & ~VARCHAR_TOASTED;
+    }
+  }
+  return size;
+}
+
+void PaxPage::ReadRow(const PaxLayout &layout, uint32_t slot, const std::vector<bool> &read, char *out) const {
+  // Same format as the Tuple constructor: inlined values first, then a (length, data) pair per VARCHAR value.
+  uint32_t var_offset = layout.schema_.GetLength();
+  for (size_t i = 0; i < layout.columns_.size(); i++) {
+    const auto &column = layout.columns_[i];
+    const char *value = page_start_ + column.values_offset_ + slot * column.width_;
+    if (column.inlined_) {
+      memcpy(out + column.tuple_offset_, read[i] ? value : column.null_value_.data(), column.width_);
+      continue;
+    }
+    memcpy(out + column.tuple_offset_, &var_offset, sizeof(uint32_t));
+    if (!read[i] || IsNull(layout, i, slot)) {
+      uint32_t len = BUSTUB_VALUE_NULL;
+      memcpy(out + var_offset, &len, sizeof(uint32_t));
+      var_offset += sizeof(uint32_t);
+      continue;
+    }
+    VarcharRef ref;
+    memcpy(&ref, value, sizeof(ref));
+    uint32_t len = ref.size_ & ~VARCHAR_TOASTED;
+    uint32_t stored_len = (ref.size_ & VARCHAR_TOASTED) != 0 ? len | TOAST_FLAG : len;
+    memcpy(out + var_offset, &stored_len, sizeof(uint32_t));
+    memcpy(out + var_offset + sizeof(uint32_t), page_start_ + ref.offset_, len);
+    var_offset += sizeof(uint32_t) + len;
+  }
+}
+
+auto PaxPage::IsNull(const PaxLayout &layout, uint32_t column_idx, uint32_t slot) const -> bool {
+  const auto &column = layout.columns_[column_idx];
+  auto null_bitmap = reinterpret_cast<const uint8_t *>(page_start_ + column.null_bitmap_offset_);
+  return (null_bitmap[slot / 8] & (1 << (slot % 8))) != 0;
+}
+
+auto PaxPage::GetMinMax(const PaxLayout &layout, uint32_t column_idx) const
+    -> std::optional<std::pair<Value, Value>> {
+  const auto &column = layout.columns_[column_idx];
+  auto stats = Stats(column);
+  if (!column.inlined_ || stats->num_values_ == 0) {
+    return std::nullopt;
+  }
+  return std::make_pair(Value::DeserializeFrom(stats->min_, column.type_),
+                        Value::DeserializeFrom(stats->max_, column.type_));
+}
+
+}  // namespace bustub
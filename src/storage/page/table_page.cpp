@@ -12,47 +12,148 @@
 
 #include "storage/page/table_page.h"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstring>
 #include <optional>
 #include <tuple>
 #include "common/config.h"
 #include "common/exception.h"
+#include "common/macros.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 void TablePage::Init() {
+  // The slots hold std::tuples, so TablePage is not standard-layout and offsetof cannot check these at compile time.
+  BUSTUB_ASSERT(reinterpret_cast<char *>(&next_page_id_) == page_start_ + NEXT_PAGE_ID_OFFSET, "header moved");
+  BUSTUB_ASSERT(reinterpret_cast<char *>(&num_tuples_) == page_start_ + NUM_TUPLES_OFFSET, "header moved");
   next_page_id_ = INVALID_PAGE_ID;
   num_tuples_ = 0;
   num_deleted_tuples_ = 0;
+  num_dead_tuples_ = 0;
+  reclaimable_bytes_ = 0;
+  num_free_slots_ = 0;
+  free_space_pointer_ = BUSTUB_PAGE_SIZE;
 }
 
-auto TablePage::GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) const -> std::optional<uint16_t> {
-  size_t slot_end_offset;
-  if (num_tuples_ > 0) {
+auto TablePage::GetFreeSpace() const -> size_t {
+  auto offset_size = TABLE_PAGE_HEADER_SIZE + TUPLE_INFO_SIZE * (num_tuples_ + 1);
+  return free_space_pointer_ > offset_size ? free_space_pointer_ - offset_size : 0;
+}
+
+void TablePage::Compact(bool trim_free_slots) {
+  std::array<uint16_t, BUSTUB_PAGE_SIZE / TUPLE_INFO_SIZE> order;
+  size_t num_moved = 0;
+  for (uint16_t tuple_id = 0; tuple_id < num_tuples_; tuple_id++) {
+    auto &[offset, size, meta] = tuple_info_[tuple_id];
+    if (IsDead(meta) && size > 0) {
+      CountDead(meta, size, -1);
+      size = 0;
+      CountDead(meta, size, 1);
+    }
+    if (size > 0) {
+      order[num_moved++] = tuple_id;
+    }
+  }
+
+  // Move the remaining data up against the end of the page, highest offset first. Data only ever moves up, so a
+  // tuple never overwrites one that has not been moved yet.
+  std::sort(order.begin(), order.begin() + num_moved,
+            [this](uint16_t a, uint16_t b) { return std::get<0>(tuple_info_[a]) > std::get<0>(tuple_info_[b]); });
+  size_t data_end = BUSTUB_PAGE_SIZE;
+  for (size_t i = 0; i < num_moved; i++) {
+    auto &[offset, size, meta] = tuple_info_[order[i]];
+    auto new_offset = static_cast<uint16_t>(data_end - size);
+    if (new_offset != offset) {
+      memmove(page_start_ + new_offset, page_start_ + offset, size);
+      offset = new_offset;
+    }
+    data_end = new_offset;
+  }
+  free_space_pointer_ = data_end;
+
+  while (trim_free_slots && num_tuples_ > 0) {
     auto &[offset, size, meta] = tuple_info_[num_tuples_ - 1];
-    slot_end_offset = offset;
+    if (!IsDead(meta) || size > 0) {
+      break;
+    }
+    CountDead(meta, size, -1);
+    num_deleted_tuples_--;
+    num_tuples_--;
+  }
+}
+
+void TablePage::CountDead(const TupleMeta &meta, uint16_t size, int delta) {
+  if (!IsDead(meta)) {
+    return;
+  }
+  if (size > 0) {
+    num_dead_tuples_ += delta;
+    reclaimable_bytes_ += delta * size;
   } else {
-    slot_end_offset = BUSTUB_PAGE_SIZE;
+    num_free_slots_ += delta;
+  }
+}
+
+void TablePage::SetTupleMeta(uint16_t tuple_id, const TupleMeta &meta) {
+  auto &[offset, size, old_meta] = tuple_info_[tuple_id];
+  if (!old_meta.is_deleted_ && meta.is_deleted_) {
+    num_deleted_tuples_++;
+  } else if (old_meta.is_deleted_ && !meta.is_deleted_) {
+    num_deleted_tuples_--;
   }
-  auto tuple_offset = slot_end_offset - tuple.GetLength();
+  CountDead(old_meta, size, -1);
+  CountDead(meta, size, 1);
+  old_meta = meta;
+}
+
+auto TablePage::GetNextTupleOffset(const TupleMeta &meta, const Tuple &tuple) const -> std::optional<uint16_t> {
   auto offset_size = TABLE_PAGE_HEADER_SIZE + TUPLE_INFO_SIZE * (num_tuples_ + 1);
-  if (tuple_offset < offset_size) {
+  if (free_space_pointer_ < offset_size + tuple.GetLength()) {
     return std::nullopt;
   }
-  return tuple_offset;
+  return free_space_pointer_ - tuple.GetLength();
 }
 
-auto TablePage::InsertTuple(const TupleMeta &meta, const Tuple &tuple) -> std::optional<uint16_t> {
-  auto tuple_offset = GetNextTupleOffset(meta, tuple);
-  if (tuple_offset == std::nullopt) {
+auto TablePage::InsertTuple(const TupleMeta &meta, const Tuple &tuple, bool reuse_free_slots)
+    -> std::optional<uint16_t> {
+  auto space_needed = [&tuple](size_t num_slots) {
+    return TABLE_PAGE_HEADER_SIZE + TUPLE_INFO_SIZE * num_slots + tuple.GetLength();
+  };
+  if (free_space_pointer_ < space_needed(num_tuples_ + 1) && reclaimable_bytes_ > 0) {
+    Compact();
+  }
+
+  std::optional<uint16_t> free_slot;
+  for (uint16_t tuple_id = 0; reuse_free_slots && num_free_slots_ > 0 && tuple_id < num_tuples_; tuple_id++) {
+    auto &[offset, size, old_meta] = tuple_info_[tuple_id];
+    if (IsDead(old_meta) && size == 0) {
+      free_slot = tuple_id;
+      break;
+    }
+  }
+  if (free_space_pointer_ < space_needed(free_slot.has_value() ? num_tuples_ : num_tuples_ + 1)) {
     return std::nullopt;
   }
-  auto tuple_id = num_tuples_;
-  tuple_info_[tuple_id] = std::make_tuple(*tuple_offset, tuple.GetLength(), meta);
-  num_tuples_++;
-  memcpy(page_start_ + *tuple_offset, tuple.data_.data(), tuple.GetLength());
+
+  uint16_t tuple_id;
+  if (free_slot.has_value()) {
+    tuple_id = *free_slot;
+    num_free_slots_--;
+    num_deleted_tuples_--;
+  } else {
+    tuple_id = num_tuples_++;
+  }
+  auto tuple_offset = static_cast<uint16_t>(free_space_pointer_ - tuple.GetLength());
+  free_space_pointer_ = tuple_offset;
+  tuple_info_[tuple_id] = std::make_tuple(tuple_offset, tuple.GetLength(), meta);
+  if (meta.is_deleted_) {
+    num_deleted_tuples_++;
+  }
+  CountDead(meta, tuple.GetLength(), 1);
+  memcpy(page_start_ + tuple_offset, tuple.data_.data(), tuple.GetLength());
   return tuple_id;
 }
 
@@ -61,11 +162,7 @@ void TablePage::UpdateTupleMeta(const TupleMeta &meta, const RID &rid) {
   if (tuple_id >= num_tuples_) {
     throw bustub::Exception("Tuple ID out of range");
   }
-  auto &[offset, size, old_meta] = tuple_info_[tuple_id];
-  if (!old_meta.is_deleted_ && meta.is_deleted_) {
-    num_deleted_tuples_++;
-  }
-  tuple_info_[tuple_id] = std::make_tuple(offset, size, meta);
+  SetTupleMeta(tuple_id, meta);
 }
 
 auto TablePage::GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple> {
@@ -81,6 +178,15 @@ auto TablePage::GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple> {
   return std::make_pair(meta, std::move(tuple));
 }
 
+void TablePage::GetTupleViews(page_id_t page_id, uint32_t first_slot, uint32_t end_slot,
+                              std::vector<TupleView> *views) const {
+  end_slot = std::min<uint32_t>(end_slot, num_tuples_);
+  for (auto tuple_id = first_slot; tuple_id < end_slot; tuple_id++) {
+    auto &[offset, size, meta] = tuple_info_[tuple_id];
+    views->push_back(TupleView{RID{page_id, tuple_id}, meta, page_start_ + offset, size});
+  }
+}
+
 auto TablePage::GetTupleMeta(const RID &rid) const -> TupleMeta {
   auto tuple_id = rid.GetSlotNum();
   if (tuple_id >= num_tuples_) {
@@ -99,10 +205,7 @@ void TablePage::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tup
   if (size != tuple.GetLength()) {
     throw bustub::Exception("Tuple size mismatch");
   }
-  if (!old_meta.is_deleted_ && meta.is_deleted_) {
-    num_deleted_tuples_++;
-  }
-  tuple_info_[tuple_id] = std::make_tuple(offset, size, meta);
+  SetTupleMeta(tuple_id, meta);
   memcpy(page_start_ + offset, tuple.data_.data(), tuple.GetLength());
 }
 
@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.cpp
+//
+// Identification: src/storage/table/free_space_map.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/free_space_map.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace bustub {
+
+static constexpr size_t NOT_FOUND = std::numeric_limits<size_t>::max();
+
+auto FreeSpaceMap::ToCategory(size_t free_bytes) -> uint8_t {
+  return static_cast<uint8_t>(std::min<size_t>(free_bytes / CATEGORY_SIZE, std::numeric_limits<uint8_t>::max()));
+}
+
+void FreeSpaceMap::AddPage(page_id_t page_id, size_t free_bytes) {
+  std::scoped_lock lock(latch_);
+  if (positions_.count(page_id) != 0) {
+    SetCategory(positions_[page_id], ToCategory(free_bytes));
+    return;
+  }
+  if (page_ids_.size() == capacity_) {
+    // Double the tree and rebuild the inner nodes from the old leaves.
+    auto new_capacity = std::max<size_t>(capacity_ * 2, 64);
+    std::vector<uint8_t> new_tree(new_capacity * 2, 0);
+    std::copy(tree_.begin() + capacity_, tree_.end(), new_tree.begin() + new_capacity);
+    for (size_t node = new_capacity - 1; node > 0; node--) {
+      new_tree[node] = std::max(new_tree[node * 2], new_tree[node * 2 + 1]);
+    }
+    tree_ = std::move(new_tree);
+    capacity_ = new_capacity;
+  }
+  positions_[page_id] = page_ids_.size();
+  page_ids_.push_back(page_id);
+  SetCategory(page_ids_.size() - 1, ToCategory(free_bytes));
+}
+
+void FreeSpaceMap::Update(page_id_t page_id, size_t free_bytes) {
+  std::scoped_lock lock(latch_);
+  auto it = positions_.find(page_id);
+  if (it != positions_.end()) {
+    SetCategory(it->second, ToCategory(free_bytes));
+  }
+}
+
+void FreeSpaceMap::SetCategory(size_t position, uint8_t category) {
+  auto node = capacity_ + position;
+  tree_[node] = category;
+  for (node /= 2; node > 0; node /= 2) {
+    auto max = std::max(tree_[node * 2], tree_[node * 2 + 1]);
+    if (tree_[node] == max) {
+      break;
+    }
+    tree_[node] = max;
+  }
+}
+
+auto FreeSpaceMap::FindFrom(size_t node, size_t lo, size_t hi, size_t start, uint8_t category) const -> size_t {
+  if (hi <= start || tree_[node] < category) {
+    return NOT_FOUND;
+  }
+  if (hi - lo == 1) {
+    return lo;
+  }
+  auto mid = lo + (hi - lo) / 2;
+  auto found = FindFrom(node * 2, lo, mid, start, category);
+  if (found != NOT_FOUND) {
+    return found;
+  }
+  return FindFrom(node * 2 + 1, mid, hi, start, category);
+}
+
+auto FreeSpaceMap::FindPage(size_t size, size_t start) const -> page_id_t {
+  // A page in category c has at least c * CATEGORY_SIZE bytes, so round the request up.
+  auto needed = (std::max<size_t>(size, 1) + CATEGORY_SIZE - 1) / CATEGORY_SIZE;
+  if (needed > std::numeric_limits<uint8_t>::max()) {
+    return INVALID_PAGE_ID;
+  }
+  std::scoped_lock lock(latch_);
+  if (page_ids_.empty()) {
+    return INVALID_PAGE_ID;
+  }
+  auto category = static_cast<uint8_t>(needed);
+  auto position = FindFrom(1, 0, capacity_, start % page_ids_.size(), category);
+  if (position == NOT_FOUND) {
+    position = FindFrom(1, 0, capacity_, 0, category);
+  }
+  return position == NOT_FOUND ? INVALID_PAGE_ID : page_ids_[position];
+}
+
+auto FreeSpaceMap::GetNumPages() const -> size_t {
+  std::scoped_lock lock(latch_);
+  return page_ids_.size();
+}
+
+auto FreeSpaceMap::GetFreeSpace(page_id_t page_id) const -> size_t {
+  std::scoped_lock lock(latch_);
+  auto it = positions_.find(page_id);
+  if (it == positions_.end()) {
+    return 0;
+  }
+  return tree_[capacity_ + it->second] * CATEGORY_SIZE;
+}
+
+}  // namespace bustub
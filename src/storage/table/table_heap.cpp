@@ -10,8 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
 #include <mutex>  // NOLINT
+#include <thread>  // NOLINT
 #include <utility>
 
 #include "common/config.h"
@@ -20,107 +23,513 @@
 #include "common/macros.h"
 #include "concurrency/transaction.h"
 #include "fmt/format.h"
+#include "storage/page/compressed_page.h"
 #include "storage/page/page_guard.h"
+#include "storage/page/pax_page.h"
 #include "storage/page/table_page.h"
 #include "storage/table/table_heap.h"
+#include "storage/table/zone_map.h"
 
 namespace bustub {
 
-TableHeap::TableHeap(BufferPoolManager *bpm) : bpm_(bpm) {
+TableHeap::TableHeap(BufferPoolManager *bpm) : bpm_(bpm), toast_(bpm) {
   // Initialize the first table page.
-  auto guard = bpm->NewPageGuarded(&first_page_id_);
+  first_page_id_ = NewPage();
   last_page_id_ = first_page_id_;
-  auto first_page = guard.AsMut<TablePage>();
-  BUSTUB_ASSERT(first_page != nullptr,
+  AddToDirectory({first_page_id_});
+  for (auto &page_id : insert_pages_) {
+    page_id = first_page_id_;
+  }
+}
+
+TableHeap::TableHeap(BufferPoolManager *bpm, const Schema &schema, TableLayout layout)
+    : bpm_(bpm),
+      schema_(std::make_unique<Schema>(schema)),
+      toast_(bpm),
+      layout_(layout),
+      pax_layout_(layout == TableLayout::PAX ? std::make_unique<PaxLayout>(schema) : nullptr),
+      zone_map_(std::make_unique<ZoneMap>(schema)) {
+  first_page_id_ = NewPage();
+  last_page_id_ = first_page_id_;
+  AddToDirectory({first_page_id_});
+  for (auto &page_id : insert_pages_) {
+    page_id = first_page_id_;
+  }
+}
+
+auto TableHeap::NewPage(bool track_free_space) -> page_id_t {
+  page_id_t page_id = INVALID_PAGE_ID;
+  auto guard = bpm_->NewPageGuarded(&page_id);
+  BUSTUB_ASSERT(page_id != INVALID_PAGE_ID,
                 "Couldn't create a page for the table heap. Have you completed the buffer pool manager project?");
-  first_page->Init();
+  if (pax_layout_ != nullptr) {
+    guard.AsMut<PaxPage>()->Init(*pax_layout_);
+    return page_id;
+  }
+  if (layout_ == TableLayout::COMPRESSED) {
+    guard.AsMut<CompressedPage>()->Init();
+    return page_id;
+  }
+  auto page = guard.AsMut<TablePage>();
+  page->Init();
+  if (track_free_space) {
+    free_space_map_.AddPage(page_id, page->GetFreeSpace());
+  }
+  return page_id;
 }
 
 auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManager *lock_mgr, Transaction *txn,
                             table_oid_t oid) -> std::optional<RID> {
-  std::unique_lock<std::mutex> guard(latch_);
-  auto page_guard = bpm_->FetchPageWrite(last_page_id_);
-  while (true) {
-    auto page = page_guard.AsMut<TablePage>();
-    if (page->GetNextTupleOffset(meta, tuple) != std::nullopt) {
-      break;
+  // Large values are written out of line before any page is latched.
+  std::optional<Tuple> toasted;
+  if (schema_ != nullptr) {
+    toasted = toast_.Toast(*schema_, tuple);
+  }
+  const auto &stored_tuple = toasted.has_value() ? *toasted : tuple;
+
+  WritePageGuard page_guard;
+  std::optional<RID> rid;
+  if (bounded_scans_ == 0 && layout_ == TableLayout::ROW) {
+    rid = InsertIntoFreePage(meta, stored_tuple, &page_guard);
+  }
+  if (!rid.has_value()) {
+    rid = AppendTuple(meta, stored_tuple, &page_guard);
+  }
+
+  if (zone_map_ != nullptr) {
+    zone_map_->Add(rid->GetPageId(), stored_tuple);
+  }
+
+  // Lock the row before the page is released, so nobody else can see the tuple unlocked.
+  if (lock_mgr != nullptr) {
+    BUSTUB_ENSURE(lock_mgr->LockRow(txn, LockManager::LockMode::EXCLUSIVE, oid, *rid),
+                  "failed to lock when inserting new tuple");
+  }
+
+  page_guard.Drop();
+
+  return rid;
+}
+
+auto TableHeap::InsertIntoFreePage(const TupleMeta &meta, const Tuple &tuple, WritePageGuard *guard)
+    -> std::optional<RID> {
+  auto slot = std::hash<std::thread::id>()(std::this_thread::get_id()) % NUM_INSERT_SLOTS;
+  page_id_t page_id = insert_pages_[slot];
+  for (size_t attempt = 0; attempt < MAX_FREE_PAGE_ATTEMPTS; attempt++) {
+    if (page_id == INVALID_PAGE_ID) {
+      // Each slot starts its search at a different part of the heap, so inserters do not pile onto one page.
+      page_id = free_space_map_.FindPage(tuple.GetLength(), slot * free_space_map_.GetNumPages() / NUM_INSERT_SLOTS);
+    }
+    if (page_id == INVALID_PAGE_ID) {
+      std::scoped_lock lock(latch_);
+      page_id = AppendPage();
+    }
+
+    *guard = bpm_->FetchPageWrite(page_id);
+    auto page = guard->AsMut<TablePage>();
+    auto slot_id = page->InsertTuple(meta, tuple, true);
+    free_space_map_.Update(page_id, page->GetFreeSpace() + page->GetReclaimableSpace());
+    if (slot_id.has_value()) {
+      insert_pages_[slot] = page_id;
+      return RID(page_id, *slot_id);
     }
 
     // if there's no tuple in the page, and we can't insert the tuple, then this tuple is too large.
     BUSTUB_ENSURE(page->GetNumTuples() != 0, "tuple is too large, cannot insert");
+    guard->Drop();
+    page_id = INVALID_PAGE_ID;
+  }
+  return std::nullopt;
+}
 
-    page_id_t next_page_id = INVALID_PAGE_ID;
-    auto npg = bpm_->NewPage(&next_page_id);
-    BUSTUB_ENSURE(next_page_id != INVALID_PAGE_ID, "cannot allocate page");
-
-    page->SetNextPageId(next_page_id);
-
-    auto next_page = reinterpret_cast<TablePage *>(npg->GetData());
-    next_page->Init();
+auto TableHeap::AppendTuple(const TupleMeta &meta, const Tuple &tuple, WritePageGuard *guard) -> RID {
+  // only allow one append at a time, so that the tuples appended while a scan is open stay behind its stop RID.
+  std::scoped_lock lock(latch_);
+  while (true) {
+    auto page_id = last_page_id_;
+    *guard = bpm_->FetchPageWrite(page_id);
+    auto slot_id = InsertIntoPage(guard, meta, tuple);
+    if (slot_id.has_value()) {
+      return RID(page_id, *slot_id);
+    }
 
-    page_guard.Drop();
+    // if there's no tuple in the page, and we can't insert the tuple, then this tuple is too large.
+    // All page layouts keep the tuple count at the same place as TablePage.
+    BUSTUB_ENSURE(guard->As<TablePage>()->GetNumTuples() != 0, "tuple is too large, cannot insert");
+    guard->Drop();
+    AppendPage();
+  }
+}
 
-    // acquire latch here as TSAN complains. Given we only have one insertion thread, this is fine.
-    npg->WLatch();
-    auto next_page_guard = WritePageGuard{bpm_, npg};
+auto TableHeap::InsertIntoPage(WritePageGuard *guard, const TupleMeta &meta, const Tuple &tuple)
+    -> std::optional<uint16_t> {
+  if (pax_layout_ != nullptr) {
+    return guard->AsMut<PaxPage>()->InsertTuple(*pax_layout_, meta, tuple);
+  }
+  if (layout_ == TableLayout::COMPRESSED) {
+    auto page = guard->AsMut<CompressedPage>();
+    auto slot_id = page->InsertTuple(meta, tuple);
+    has_uncompressed_tails_ = true;
+    // A full page is compressed to make room in its tail before a new page is added, unless few of its tuples are
+    // in the tail: compressing them would free little space, for the cost of compressing the whole page again.
+    auto num_tail_tuples = page->GetNumTuples() - page->GetNumCompressedTuples();
+    if (!slot_id.has_value() && num_tail_tuples * MIN_COMPRESS_TAIL_FRACTION >= page->GetNumTuples() &&
+        page->Compress(*schema_) > 0) {
+      slot_id = page->InsertTuple(meta, tuple);
+    }
+    return slot_id;
+  }
+  auto page = guard->AsMut<TablePage>();
+  auto slot_id = page->InsertTuple(meta, tuple);
+  free_space_map_.Update(guard->PageId(), page->GetFreeSpace() + page->GetReclaimableSpace());
+  return slot_id;
+}
 
-    last_page_id_ = next_page_id;
-    page_guard = std::move(next_page_guard);
+void TableHeap::LinkPage(WritePageGuard *guard, page_id_t next_page_id) {
+  if (pax_layout_ != nullptr) {
+    guard->AsMut<PaxPage>()->SetNextPageId(next_page_id);
+  } else if (layout_ == TableLayout::COMPRESSED) {
+    guard->AsMut<CompressedPage>()->SetNextPageId(next_page_id);
+  } else {
+    guard->AsMut<TablePage>()->SetNextPageId(next_page_id);
   }
-  auto last_page_id = last_page_id_;
+}
 
-  auto page = page_guard.AsMut<TablePage>();
-  auto slot_id = *page->InsertTuple(meta, tuple);
+auto TableHeap::BulkInsert(const TupleMeta &meta, const std::vector<Tuple> &tuples, LockManager *lock_mgr,
+                           Transaction *txn, table_oid_t oid) -> std::vector<RID> {
+  std::vector<RID> rids;
+  rids.reserve(tuples.size());
+  size_t total_size = 0;
+  for (const auto &tuple : tuples) {
+    total_size += tuple.GetLength();
+  }
+  // A new page for a few tuples would mostly stay empty.
+  if (total_size < BULK_INSERT_MIN_SIZE) {
+    for (const auto &tuple : tuples) {
+      rids.push_back(*InsertTuple(meta, tuple, lock_mgr, txn, oid));
+    }
+    return rids;
+  }
 
-  // only allow one insertion at a time, otherwise it will deadlock.
-  guard.unlock();
+  // Fill new pages that nobody else can reach yet, so no insert needs the table latch or a page of the table.
+  std::vector<page_id_t> page_ids;
+  std::vector<size_t> free_spaces;
+  WritePageGuard guard;
+  auto finish_page = [&]() {
+    if (layout_ == TableLayout::ROW) {
+      auto page = guard.As<TablePage>();
+      free_spaces.push_back(page->GetFreeSpace() + page->GetReclaimableSpace());
+    }
+  };
+  for (const auto &tuple : tuples) {
+    std::optional<Tuple> toasted;
+    if (schema_ != nullptr) {
+      toasted = toast_.Toast(*schema_, tuple);
+    }
+    const auto &stored_tuple = toasted.has_value() ? *toasted : tuple;
 
-  if (lock_mgr != nullptr) {
-    BUSTUB_ENSURE(lock_mgr->LockRow(txn, LockManager::LockMode::EXCLUSIVE, oid, RID{last_page_id, slot_id}),
-                  "failed to lock when inserting new tuple");
+    auto slot_id = page_ids.empty() ? std::nullopt : InsertIntoPage(&guard, meta, stored_tuple);
+    if (!slot_id.has_value()) {
+      BUSTUB_ENSURE(page_ids.empty() || guard.As<TablePage>()->GetNumTuples() != 0,
+                    "tuple is too large, cannot insert");
+      auto page_id = NewPage(false);
+      if (!page_ids.empty()) {
+        finish_page();
+        LinkPage(&guard, page_id);
+      }
+      page_ids.push_back(page_id);
+      guard = bpm_->FetchPageWrite(page_id);
+      slot_id = InsertIntoPage(&guard, meta, stored_tuple);
+      BUSTUB_ENSURE(slot_id.has_value(), "tuple is too large, cannot insert");
+    }
+    RID rid(page_ids.back(), *slot_id);
+    if (zone_map_ != nullptr) {
+      zone_map_->Add(rid.GetPageId(), stored_tuple);
+    }
+    if (lock_mgr != nullptr) {
+      BUSTUB_ENSURE(lock_mgr->LockRow(txn, LockManager::LockMode::EXCLUSIVE, oid, rid),
+                    "failed to lock when inserting new tuple");
+    }
+    rids.push_back(rid);
   }
+  finish_page();
+  guard.Drop();
 
-  page_guard.Drop();
+  // Link the new pages in one step.
+  {
+    std::scoped_lock lock(latch_);
+    auto last_page_guard = bpm_->FetchPageWrite(last_page_id_);
+    LinkPage(&last_page_guard, page_ids.front());
+    last_page_id_ = page_ids.back();
+    AddToDirectory(page_ids);
+  }
+  for (size_t i = 0; i < free_spaces.size(); i++) {
+    free_space_map_.AddPage(page_ids[i], free_spaces[i]);
+  }
+  return rids;
+}
 
-  return RID(last_page_id, slot_id);
+auto TableHeap::AppendPage() -> page_id_t {
+  // The new page is initialized before it is linked, so a concurrent scan never follows a link to garbage.
+  auto next_page_id = NewPage();
+  auto last_page_guard = bpm_->FetchPageWrite(last_page_id_);
+  LinkPage(&last_page_guard, next_page_id);
+  last_page_id_ = next_page_id;
+  AddToDirectory({next_page_id});
+  return next_page_id;
 }
 
 void TableHeap::UpdateTupleMeta(const TupleMeta &meta, RID rid) {
   auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
+  // The out-of-line values of a tuple are released once its deletion has completed.
+  bool release_values = toast_.HasToastedValues() && TablePage::IsDead(meta);
+  if (pax_layout_ != nullptr) {
+    auto page = page_guard.AsMut<PaxPage>();
+    if (release_values && !TablePage::IsDead(page->GetTupleMeta(rid))) {
+      toast_.Release(*schema_, page->GetTuple(*pax_layout_, rid).second);
+    }
+    page->UpdateTupleMeta(meta, rid);
+    return;
+  }
+  if (layout_ == TableLayout::COMPRESSED) {
+    auto page = page_guard.AsMut<CompressedPage>();
+    if (release_values && !TablePage::IsDead(page->GetTupleMeta(rid))) {
+      toast_.Release(*schema_, page->GetTuple(*schema_, rid).second);
+    }
+    page->UpdateTupleMeta(meta, rid);
+    return;
+  }
   auto page = page_guard.AsMut<TablePage>();
+  if (release_values && !TablePage::IsDead(page->GetTupleMeta(rid))) {
+    toast_.Release(*schema_, page->GetTuple(rid).second);
+  }
+  auto num_dead_tuples = static_cast<int64_t>(page->GetNumDeadTuples());
   page->UpdateTupleMeta(meta, rid);
+  num_dead_tuples_ += page->GetNumDeadTuples() - num_dead_tuples;
+  free_space_map_.Update(rid.GetPageId(), page->GetFreeSpace() + page->GetReclaimableSpace());
 }
 
 auto TableHeap::GetTuple(RID rid) -> std::pair<TupleMeta, Tuple> {
-  auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
-  auto page = page_guard.As<TablePage>();
-  auto [meta, tuple] = page->GetTuple(rid);
+  std::pair<TupleMeta, Tuple> result;
+  {
+    auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
+    if (pax_layout_ != nullptr) {
+      result = page_guard.As<PaxPage>()->GetTuple(*pax_layout_, rid);
+    } else if (layout_ == TableLayout::COMPRESSED) {
+      result = page_guard.As<CompressedPage>()->GetTuple(*schema_, rid);
+    } else {
+      result = page_guard.As<TablePage>()->GetTuple(rid);
+    }
+  }
+  auto &[meta, tuple] = result;
   tuple.rid_ = rid;
-  return std::make_pair(meta, std::move(tuple));
+  // The out-of-line values of a dead tuple may be gone already.
+  if (toast_.HasToastedValues() && !TablePage::IsDead(meta) &&
+      ToastStore::IsToasted(*schema_, tuple, schema_->GetUnlinedColumns())) {
+    tuple = toast_.Detoast(*schema_, tuple);
+  }
+  return result;
+}
+
+void TableHeap::DetoastViews(const std::vector<uint32_t> *column_ids, std::vector<TupleView> *views,
+                             std::vector<Tuple> *tuples) const {
+  tuples->clear();
+  if (!toast_.HasToastedValues()) {
+    return;
+  }
+  std::vector<uint32_t> columns;
+  for (auto column_idx : schema_->GetUnlinedColumns()) {
+    if (column_ids == nullptr || std::find(column_ids->begin(), column_ids->end(), column_idx) != column_ids->end()) {
+      columns.push_back(column_idx);
+    }
+  }
+  for (auto &view : *views) {
+    if (TablePage::IsDead(view.meta_) || !ToastStore::IsToasted(*schema_, view, columns)) {
+      continue;
+    }
+    // Moving a Tuple keeps its data where it is, so the views stay valid as `tuples` grows.
+    const auto &tuple = tuples->emplace_back(toast_.Detoast(*schema_, view, column_ids));
+    view.data_ = tuple.GetData();
+    view.size_ = tuple.GetLength();
+  }
 }
 
 auto TableHeap::GetTupleMeta(RID rid) -> TupleMeta {
   auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
+  if (pax_layout_ != nullptr) {
+    return page_guard.As<PaxPage>()->GetTupleMeta(rid);
+  }
+  if (layout_ == TableLayout::COMPRESSED) {
+    return page_guard.As<CompressedPage>()->GetTupleMeta(rid);
+  }
   auto page = page_guard.As<TablePage>();
   return page->GetTupleMeta(rid);
 }
 
 auto TableHeap::MakeIterator() -> TableIterator {
+  // Count the scan before its stop RID is taken, so neither inserts nor the vacuum can move that RID under it.
+  open_scans_++;
+  bounded_scans_++;
   std::unique_lock<std::mutex> guard(latch_);
   auto last_page_id = last_page_id_;
   guard.unlock();
 
+  // PaxPage and CompressedPage keep the tuple count at the same place as TablePage.
   auto page_guard = bpm_->FetchPageRead(last_page_id);
   auto page = page_guard.As<TablePage>();
   return {this, {first_page_id_, 0}, {last_page_id, page->GetNumTuples()}};
 }
 
-auto TableHeap::MakeEagerIterator() -> TableIterator { return {this, {first_page_id_, 0}, {INVALID_PAGE_ID, 0}}; }
+auto TableHeap::MakeEagerIterator() -> TableIterator {
+  open_scans_++;
+  return {this, {first_page_id_, 0}, {INVALID_PAGE_ID, 0}};
+}
+
+auto TableHeap::MakeParallelScan(size_t pages_per_morsel) -> std::unique_ptr<ParallelTableScan> {
+  return std::unique_ptr<ParallelTableScan>(new ParallelTableScan(this, pages_per_morsel));
+}
+
+auto TableHeap::GetNumPages() -> size_t {
+  std::scoped_lock lock(latch_);
+  return page_directory_.size();
+}
+
+auto TableHeap::GetPageIdAt(size_t index) -> page_id_t {
+  std::scoped_lock lock(latch_);
+  return page_directory_[index];
+}
+
+auto TableHeap::GetPageIdAfter(page_id_t page_id) -> page_id_t {
+  std::scoped_lock lock(latch_);
+  auto index = page_indexes_.at(page_id) + 1;
+  return index < page_directory_.size() ? page_directory_[index] : INVALID_PAGE_ID;
+}
+
+void TableHeap::AddToDirectory(const std::vector<page_id_t> &page_ids) {
+  for (auto page_id : page_ids) {
+    page_indexes_[page_id] = page_directory_.size();
+    page_directory_.push_back(page_id);
+  }
+}
 
 void TableHeap::UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid) {
+  std::optional<Tuple> toasted;
+  if (schema_ != nullptr) {
+    toasted = toast_.Toast(*schema_, tuple);
+  }
+  const auto &stored_tuple = toasted.has_value() ? *toasted : tuple;
+
+  // The out-of-line values of the old tuple are released once it has been overwritten.
+  std::optional<Tuple> old_tuple;
   auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
-  auto page = page_guard.AsMut<TablePage>();
-  page->UpdateTupleInPlaceUnsafe(meta, tuple, rid);
+  if (zone_map_ != nullptr) {
+    zone_map_->Add(rid.GetPageId(), stored_tuple);
+  }
+  if (pax_layout_ != nullptr) {
+    auto page = page_guard.AsMut<PaxPage>();
+    if (toast_.HasToastedValues()) {
+      old_tuple = page->GetTuple(*pax_layout_, rid).second;
+    }
+    page->UpdateTupleInPlaceUnsafe(*pax_layout_, meta, stored_tuple, rid);
+  } else if (layout_ == TableLayout::COMPRESSED) {
+    auto page = page_guard.AsMut<CompressedPage>();
+    if (toast_.HasToastedValues()) {
+      old_tuple = page->GetTuple(*schema_, rid).second;
+    }
+    page->UpdateTupleInPlaceUnsafe(*schema_, meta, stored_tuple, rid);
+  } else {
+    auto page = page_guard.AsMut<TablePage>();
+    if (toast_.HasToastedValues()) {
+      old_tuple = page->GetTuple(rid).second;
+    }
+    auto num_dead_tuples = static_cast<int64_t>(page->GetNumDeadTuples());
+    page->UpdateTupleInPlaceUnsafe(meta, stored_tuple, rid);
+    num_dead_tuples_ += page->GetNumDeadTuples() - num_dead_tuples;
+    free_space_map_.Update(rid.GetPageId(), page->GetFreeSpace() + page->GetReclaimableSpace());
+  }
+  if (old_tuple.has_value()) {
+    toast_.Release(*schema_, *old_tuple);
+  }
+}
+
+auto TableHeap::NeedsVacuum() -> bool {
+  return num_dead_tuples_ > num_dead_tuples_after_vacuum_ || has_uncompressed_tails_ || toast_.HasReleased();
+}
+
+auto TableHeap::Vacuum(double min_dead_ratio) -> size_t {
+  size_t reclaimed = 0;
+  // An open scan may still read a value it saw before the value was released.
+  if (open_scans_ == 0) {
+    reclaimed += toast_.FreeReleased() * BUSTUB_PAGE_SIZE;
+  }
+  if (layout_ == TableLayout::PAX) {
+    return reclaimed;
+  }
+  if (layout_ == TableLayout::COMPRESSED) {
+    return reclaimed + CompressPages();
+  }
+  // The dead tuples left in pages below the dead ratio. Tuples that die in pages after the pass went by make the count
+  // of the table exceed it, so that it needs another pass.
+  size_t num_dead_tuples_left = 0;
+  auto page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    // Look at the page under a read latch first, so clean pages never block their readers.
+    page_id_t next_page_id;
+    bool needs_vacuum;
+    {
+      auto page_guard = bpm_->FetchPageRead(page_id);
+      auto page = page_guard.As<TablePage>();
+      next_page_id = page->GetNextPageId();
+      needs_vacuum = page->GetNumDeadTuples() > 0 && page->GetDeadTupleRatio() >= min_dead_ratio;
+      if (!needs_vacuum) {
+        num_dead_tuples_left += page->GetNumDeadTuples();
+      }
+    }
+    if (needs_vacuum) {
+      auto page_guard = bpm_->FetchPageWrite(page_id);
+      auto page = page_guard.AsMut<TablePage>();
+      reclaimed += page->GetReclaimableSpace();
+      num_dead_tuples_ -= page->GetNumDeadTuples();
+      // An open iterator may be positioned on a free slot, or have its stop RID behind one.
+      page->Compact(open_scans_ == 0);
+      free_space_map_.Update(page_id, page->GetFreeSpace() + page->GetReclaimableSpace());
+      // Narrow the zone of the page down to its live tuples.
+      if (zone_map_ != nullptr) {
+        std::vector<TupleView> views;
+        page->GetTupleViews(page_id, 0, page->GetNumTuples(), &views);
+        views.erase(std::remove_if(views.begin(), views.end(),
+                                   [](const TupleView &view) { return TablePage::IsDead(view.meta_); }),
+                    views.end());
+        zone_map_->Rebuild(page_id, views);
+      }
+    }
+    page_id = next_page_id;
+  }
+  num_dead_tuples_after_vacuum_ = num_dead_tuples_left;
+  return reclaimed;
+}
+
+auto TableHeap::CompressPages() -> size_t {
+  has_uncompressed_tails_ = false;
+  size_t freed = 0;
+  auto page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    page_id_t next_page_id;
+    bool has_tail;
+    {
+      auto page_guard = bpm_->FetchPageRead(page_id);
+      auto page = page_guard.As<CompressedPage>();
+      next_page_id = page->GetNextPageId();
+      has_tail = page->GetNumTuples() > page->GetNumCompressedTuples();
+    }
+    // Tuples keep their slots, so open iterators are not affected.
+    if (has_tail) {
+      auto page_guard = bpm_->FetchPageWrite(page_id);
+      freed += page_guard.AsMut<CompressedPage>()->Compress(*schema_);
+    }
+    page_id = next_page_id;
+  }
+  return freed;
 }
 
 }  // namespace bustub
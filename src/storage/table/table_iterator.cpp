@@ -10,7 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <mutex>  // NOLINT
 #include <optional>
 
 #include "common/config.h"
@@ -22,12 +25,24 @@ namespace bustub {
 
 TableIterator::TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid)
     : table_heap_(table_heap), rid_(rid), stop_at_rid_(stop_at_rid) {
-  // If the rid doesn't correspond to a tuple (i.e., the table has just been initialized), then
-  // we set rid_ to invalid.
-  auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
-  auto page = page_guard.As<TablePage>();
-  if (rid_.GetSlotNum() >= page->GetNumTuples()) {
-    rid_ = RID{INVALID_PAGE_ID, 0};
+  // If the rid doesn't correspond to a tuple (i.e., the table has just been initialized, or vacuum emptied the first
+  // pages), move on to the first page that has one.
+  SkipEmptyPages();
+}
+
+TableIterator::TableIterator(TableIterator &&that) noexcept
+    : table_heap_(that.table_heap_), rid_(that.rid_), stop_at_rid_(that.stop_at_rid_) {
+  that.table_heap_ = nullptr;
+}
+
+TableIterator::~TableIterator() {
+  if (table_heap_ == nullptr) {
+    return;
+  }
+  // Counted by TableHeap::MakeIterator / MakeEagerIterator.
+  table_heap_->open_scans_--;
+  if (stop_at_rid_.GetPageId() != INVALID_PAGE_ID) {
+    table_heap_->bounded_scans_--;
   }
 }
 
@@ -43,10 +58,11 @@ auto TableIterator::operator++() -> TableIterator & {
   auto next_tuple_id = rid_.GetSlotNum() + 1;
 
   if (stop_at_rid_.GetPageId() != INVALID_PAGE_ID) {
+    // Page ids are not ordered along the chain, since a bulk insert links pages it allocated before pages appended
+    // in the meantime, so only the stop page itself tells where the scan ends.
     BUSTUB_ASSERT(
-        /* case 1: cursor before the page of the stop tuple */ rid_.GetPageId() < stop_at_rid_.GetPageId() ||
-            /* case 2: cursor at the page before the tuple */
-            (rid_.GetPageId() == stop_at_rid_.GetPageId() && next_tuple_id <= stop_at_rid_.GetSlotNum()),
+        /* case 1: cursor before the page of the stop tuple */ rid_.GetPageId() != stop_at_rid_.GetPageId() ||
+            /* case 2: cursor at the page before the tuple */ next_tuple_id <= stop_at_rid_.GetSlotNum(),
         "iterate out of bound");
   }
 
@@ -56,15 +72,122 @@ auto TableIterator::operator++() -> TableIterator & {
     rid_ = RID{INVALID_PAGE_ID, 0};
   } else if (next_tuple_id < page->GetNumTuples()) {
     // that's fine
+  } else if (rid_.GetPageId() == stop_at_rid_.GetPageId()) {
+    rid_ = RID{INVALID_PAGE_ID, 0};
   } else {
     auto next_page_id = page->GetNextPageId();
     // if next page is invalid, RID is set to invalid page; otherwise, it's the first tuple in that page.
     rid_ = RID{next_page_id, 0};
+    page_guard.Drop();
+    SkipEmptyPages();
   }
 
-  page_guard.Drop();
-
   return *this;
 }
 
+auto TableIterator::NextBatch(TupleViewBatch *batch, const std::vector<uint32_t> *column_ids,
+                              const std::vector<ZoneBound> *bounds) -> bool {
+  batch->views_.clear();
+  const auto *zone_map = bounds != nullptr && !bounds->empty() ? table_heap_->zone_map_.get() : nullptr;
+  while (!IsEnd()) {
+    auto page_id = rid_.GetPageId();
+    page_id_t next_page_id;
+    if (zone_map != nullptr && !zone_map->MayMatch(page_id, *bounds)) {
+      next_page_id = page_id == stop_at_rid_.GetPageId() ? INVALID_PAGE_ID : table_heap_->GetPageIdAfter(page_id);
+      rid_ = RID{next_page_id, 0} == stop_at_rid_ ? RID{INVALID_PAGE_ID, 0} : RID{next_page_id, 0};
+      continue;
+    }
+    {
+      auto page_guard = table_heap_->bpm_->FetchPageRead(page_id);
+      memcpy(batch->page_.get(), page_guard.GetData(), BUSTUB_PAGE_SIZE);
+      next_page_id = page_guard.As<TablePage>()->GetNextPageId();
+    }
+    table_heap_->pages_scanned_.fetch_add(1, std::memory_order_relaxed);
+    // PaxPage and CompressedPage have their tuple count at the same place as TablePage, see NUM_TUPLES_OFFSET.
+    auto page = reinterpret_cast<const TablePage *>(batch->page_.get());
+    auto end_slot = page->GetNumTuples();
+    if (page_id == stop_at_rid_.GetPageId()) {
+      end_slot = std::min(end_slot, stop_at_rid_.GetSlotNum());
+      next_page_id = INVALID_PAGE_ID;
+    }
+    if (auto layout = table_heap_->GetPaxLayout(); layout != nullptr) {
+      reinterpret_cast<const PaxPage *>(batch->page_.get())
+          ->GetTupleViews(*layout, page_id, rid_.GetSlotNum(), end_slot, column_ids, &batch->tuple_data_,
+                          &batch->views_);
+    } else if (table_heap_->GetLayout() == TableLayout::COMPRESSED) {
+      reinterpret_cast<const CompressedPage *>(batch->page_.get())
+          ->GetTupleViews(*table_heap_->schema_, page_id, rid_.GetSlotNum(), end_slot, column_ids,
+                          &batch->tuple_data_, &batch->views_);
+    } else {
+      page->GetTupleViews(page_id, rid_.GetSlotNum(), end_slot, &batch->views_);
+    }
+    table_heap_->DetoastViews(column_ids, &batch->views_, &batch->detoasted_tuples_);
+    // A scan of a range of pages stops at the first page after it.
+    rid_ = RID{next_page_id, 0} == stop_at_rid_ ? RID{INVALID_PAGE_ID, 0} : RID{next_page_id, 0};
+    if (!batch->views_.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+ParallelTableScan::ParallelTableScan(TableHeap *table_heap, size_t pages_per_morsel)
+    : table_heap_(table_heap), pages_per_morsel_(pages_per_morsel) {
+  BUSTUB_ASSERT(pages_per_morsel > 0, "a morsel has at least one page");
+  // Counted as a bounded scan for its whole life, so no page it covers gets new tuples in between two morsels.
+  table_heap_->open_scans_++;
+  table_heap_->bounded_scans_++;
+  std::unique_lock<std::mutex> guard(table_heap_->latch_);
+  num_pages_ = table_heap_->page_directory_.size();
+  auto last_page_id = table_heap_->last_page_id_;
+  guard.unlock();
+
+  auto page_guard = table_heap_->bpm_->FetchPageRead(last_page_id);
+  stop_at_rid_ = RID{last_page_id, page_guard.As<TablePage>()->GetNumTuples()};
+}
+
+ParallelTableScan::~ParallelTableScan() {
+  table_heap_->open_scans_--;
+  table_heap_->bounded_scans_--;
+}
+
+auto ParallelTableScan::NextMorsel() -> std::optional<TableIterator> {
+  auto begin = next_page_.fetch_add(pages_per_morsel_);
+  if (begin >= num_pages_) {
+    return std::nullopt;
+  }
+  return MakeIterator(begin, std::min(begin + pages_per_morsel_, num_pages_));
+}
+
+auto ParallelTableScan::MakeIterator(size_t begin, size_t end) -> TableIterator {
+  BUSTUB_ASSERT(begin <= end && end <= num_pages_, "page range out of bounds");
+  // Counted by the iterator like one made by TableHeap::MakeIterator, and uncounted by its destructor.
+  table_heap_->open_scans_++;
+  table_heap_->bounded_scans_++;
+  if (begin == end) {
+    return {table_heap_, stop_at_rid_, stop_at_rid_};
+  }
+  auto stop_at_rid = end == num_pages_ ? stop_at_rid_ : RID{table_heap_->GetPageIdAt(end), 0};
+  return {table_heap_, RID{table_heap_->GetPageIdAt(begin), 0}, stop_at_rid};
+}
+
+void TableIterator::SkipEmptyPages() {
+  while (rid_.GetPageId() != INVALID_PAGE_ID) {
+    if (rid_ == stop_at_rid_) {
+      rid_ = RID{INVALID_PAGE_ID, 0};
+      return;
+    }
+    auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
+    auto page = page_guard.As<TablePage>();
+    if (rid_.GetSlotNum() < page->GetNumTuples()) {
+      return;
+    }
+    if (rid_.GetPageId() == stop_at_rid_.GetPageId()) {
+      rid_ = RID{INVALID_PAGE_ID, 0};
+      return;
+    }
+    rid_ = RID{page->GetNextPageId(), 0};
+  }
+}
+
 }  // namespace bustub
@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_file.cpp
+//
+// Identification: src/storage/table/tmp_tuple_file.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/tmp_tuple_file.h"
+
+#include <cstring>
+
+#include "common/exception.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+TmpTupleFile::TmpTupleFile(BufferPoolManager *bpm) : bpm_(bpm) { page_.Init(INVALID_PAGE_ID, BUSTUB_PAGE_SIZE); }
+
+TmpTupleFile::~TmpTupleFile() {
+  for (auto page_id : page_ids_) {
+    bpm_->DeletePage(page_id);
+  }
+}
+
+void TmpTupleFile::Append(const TupleRef &tuple) {
+  TmpTuple out(INVALID_PAGE_ID, 0);
+  if (!page_.Insert(tuple, &out)) {
+    if (page_.GetFreeSpacePointer() == BUSTUB_PAGE_SIZE) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY,
+                      fmt::format("a tuple of {} bytes is too large to be spilled", tuple.GetLength()));
+    }
+    page_id_t page_id = INVALID_PAGE_ID;
+    {
+      auto guard = bpm_->NewPageGuarded(&page_id);
+      BUSTUB_ENSURE(page_id != INVALID_PAGE_ID, "no page to spill tuples to");
+      memcpy(guard.GetDataMut(), page_.GetData(), BUSTUB_PAGE_SIZE);
+    }
+    page_ids_.push_back(page_id);
+    page_.Init(INVALID_PAGE_ID, BUSTUB_PAGE_SIZE);
+    Append(tuple);
+    return;
+  }
+  num_tuples_++;
+}
+
+auto TmpTupleFile::Reader::LoadPage() -> bool {
+  if (next_page_ > file_->page_ids_.size()) {
+    return false;
+  }
+  if (next_page_ < file_->page_ids_.size()) {
+    auto guard = file_->bpm_->FetchPageRead(file_->page_ids_[next_page_]);
+    memcpy(page_.GetData(), guard.GetData(), BUSTUB_PAGE_SIZE);
+  } else {
+    memcpy(page_.GetData(), file_->page_.GetData(), BUSTUB_PAGE_SIZE);
+  }
+  next_page_++;
+  // The page fills from its end. Walking up from the last tuple inserted leaves the first one on top of `offsets_`.
+  for (size_t offset = page_.GetFreeSpacePointer(); offset < BUSTUB_PAGE_SIZE;
+       offset += sizeof(uint32_t) + *reinterpret_cast<const uint32_t *>(page_.GetData() + offset)) {
+    offsets_.push_back(offset);
+  }
+  return true;
+}
+
+auto TmpTupleFile::Reader::Next(Tuple *tuple) -> bool {
+  while (offsets_.empty()) {
+    if (!LoadPage()) {
+      return false;
+    }
+  }
+  page_.Get(offsets_.back(), tuple);
+  offsets_.pop_back();
+  return true;
+}
+
+}  // namespace bustub
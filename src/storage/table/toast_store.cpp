@@ -0,0 +1,295 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// toast_store.cpp
+//
+// Identification: src/storage/table/toast_store.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/toast_store.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <utility>
+
+#include "common/macros.h"
+#include "storage/page/overflow_page.h"
+#include "type/limits.h"
+
+namespace bustub {
+
+/**
+ * Values are compressed with a small LZ77 codec. The compressed data is a sequence of items, each starting with a
+ * control byte c: if c < 0x80, c + 1 literal bytes follow; otherwise it is a match of (c & 0x7f) + MIN_MATCH bytes
+ * copied from a distance given by the next two bytes (little endian). A value is only stored compressed if that
+ * saves at least 1 / MIN_COMPRESSION_GAIN of it.
+ */
+static constexpr uint32_t MIN_MATCH = 3;
+static constexpr uint32_t MAX_MATCH = 0x7f + MIN_MATCH;
+static constexpr uint32_t MAX_LITERALS = 0x80;
+static constexpr uint32_t MAX_DISTANCE = 0xffff;
+static constexpr uint32_t HASH_BITS = 12;
+static constexpr uint32_t MIN_COMPRESSION_GAIN = 8;
+
+static auto Compress(const char *data, uint32_t size) -> std::vector<char> {
+  std::vector<char> out;
+  out.reserve(size);
+  std::vector<int64_t> last_position(1 << HASH_BITS, -1);
+  uint32_t literal_start = 0;
+  auto emit_literals = [&](uint32_t end) {
+    while (literal_start < end) {
+      auto n = std::min(end - literal_start, MAX_LITERALS);
+      out.push_back(static_cast<char>(n - 1));
+      out.insert(out.end(), data + literal_start, data + literal_start + n);
+      literal_start += n;
+    }
+  };
+
+  uint32_t pos = 0;
+  while (pos + MIN_MATCH <= size) {
+    uint32_t key = static_cast<uint8_t>(data[pos]) | static_cast<uint8_t>(data[pos + 1]) << 8 |
+                   static_cast<uint8_t>(data[pos + 2]) << 16;
+    auto hash = (key * 2654435761U) >> (32 - HASH_BITS);
+    auto candidate = last_position[hash];
+    last_position[hash] = pos;
+    if (candidate < 0 || pos - candidate > MAX_DISTANCE || memcmp(data + candidate, data + pos, MIN_MATCH) != 0) {
+      pos++;
+      continue;
+    }
+    uint32_t len = MIN_MATCH;
+    while (pos + len < size && len < MAX_MATCH && data[candidate + len] == data[pos + len]) {
+      len++;
+    }
+    emit_literals(pos);
+    auto distance = static_cast<uint32_t>(pos - candidate);
+    out.push_back(static_cast<char>(0x80 | (len - MIN_MATCH)));
+    out.push_back(static_cast<char>(distance & 0xff));
+    out.push_back(static_cast<char>(distance >> 8));
+    pos += len;
+    literal_start = pos;
+  }
+  emit_literals(size);
+  return out;
+}
+
+static void Decompress(const char *data, uint32_t size, char *out, uint32_t out_size) {
+  uint32_t pos = 0;
+  uint32_t out_pos = 0;
+  while (pos < size) {
+    auto control = static_cast<uint8_t>(data[pos++]);
+    if (control < 0x80) {
+      uint32_t n = control + 1;
+      BUSTUB_ENSURE(pos + n <= size && out_pos + n <= out_size, "corrupted compressed value");
+      memcpy(out + out_pos, data + pos, n);
+      pos += n;
+      out_pos += n;
+      continue;
+    }
+    uint32_t len = (control & 0x7f) + MIN_MATCH;
+    BUSTUB_ENSURE(pos + 2 <= size, "corrupted compressed value");
+    uint32_t distance = static_cast<uint8_t>(data[pos]) | static_cast<uint8_t>(data[pos + 1]) << 8;
+    pos += 2;
+    BUSTUB_ENSURE(distance > 0 && distance <= out_pos && out_pos + len <= out_size, "corrupted compressed value");
+    // The match may overlap the bytes it produces, so it is copied one byte at a time.
+    for (uint32_t i = 0; i < len; i++, out_pos++) {
+      out[out_pos] = out[out_pos - distance];
+    }
+  }
+  BUSTUB_ENSURE(out_pos == out_size, "corrupted compressed value");
+}
+
+/** @return the length field of the VARCHAR value of column `column_idx` in the tuple at `data` */
+static auto VarcharAt(const Schema &schema, const char *data, uint32_t column_idx) -> const char * {
+  auto offset = *reinterpret_cast<const uint32_t *>(data + schema.GetColumn(column_idx).GetOffset());
+  return data + offset;
+}
+
+/** @return the number of bytes of a VARCHAR value with length field `len`, the length field included */
+static auto StoredSize(uint32_t len) -> uint32_t {
+  return sizeof(uint32_t) + (len == BUSTUB_VALUE_NULL ? 0 : len & ~TOAST_FLAG);
+}
+
+static auto IsToastedLength(uint32_t len) -> bool { return len != BUSTUB_VALUE_NULL && (len & TOAST_FLAG) != 0; }
+
+auto ToastStore::Toast(const Schema &schema, const Tuple &tuple) -> std::optional<Tuple> {
+  if (tuple.GetLength() <= TOAST_TUPLE_THRESHOLD) {
+    return std::nullopt;
+  }
+  const char *data = tuple.GetData();
+
+  // Move the largest values first, so as few values as possible are moved.
+  std::vector<std::pair<uint32_t, uint32_t>> candidates;
+  for (auto column_idx : schema.GetUnlinedColumns()) {
+    auto len = *reinterpret_cast<const uint32_t *>(VarcharAt(schema, data, column_idx));
+    if (len != BUSTUB_VALUE_NULL && (len & TOAST_FLAG) == 0 && len >= TOAST_MIN_VALUE_SIZE) {
+      candidates.emplace_back(len, column_idx);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(), std::greater<>());
+  std::vector<bool> move(schema.GetColumnCount(), false);
+  auto size = tuple.GetLength();
+  bool moved_any = false;
+  for (auto [len, column_idx] : candidates) {
+    if (size <= TOAST_TUPLE_THRESHOLD) {
+      break;
+    }
+    move[column_idx] = true;
+    size -= len - sizeof(ToastPointer);
+    moved_any = true;
+  }
+  if (!moved_any) {
+    return std::nullopt;
+  }
+
+  std::vector<char> out(data, data + schema.GetLength());
+  for (auto column_idx : schema.GetUnlinedColumns()) {
+    const char *value = VarcharAt(schema, data, column_idx);
+    auto len = *reinterpret_cast<const uint32_t *>(value);
+    auto var_offset = static_cast<uint32_t>(out.size());
+    memcpy(out.data() + schema.GetColumn(column_idx).GetOffset(), &var_offset, sizeof(uint32_t));
+    if (!move[column_idx]) {
+      out.insert(out.end(), value, value + StoredSize(len));
+      continue;
+    }
+
+    ToastPointer pointer{INVALID_PAGE_ID, len, len, 0};
+    auto compressed = Compress(value + sizeof(uint32_t), len);
+    if (compressed.size() <= len - len / MIN_COMPRESSION_GAIN) {
+      pointer.stored_size_ = compressed.size();
+      pointer.is_compressed_ = 1;
+      pointer.first_page_id_ = WriteChain(compressed.data(), compressed.size());
+    } else {
+      pointer.first_page_id_ = WriteChain(value + sizeof(uint32_t), len);
+    }
+    uint32_t flagged_len = TOAST_FLAG | sizeof(ToastPointer);
+    out.resize(var_offset + sizeof(uint32_t) + sizeof(ToastPointer));
+    memcpy(out.data() + var_offset, &flagged_len, sizeof(uint32_t));
+    memcpy(out.data() + var_offset + sizeof(uint32_t), &pointer, sizeof(ToastPointer));
+  }
+  has_toasted_values_ = true;
+
+  Tuple toasted;
+  toasted.CopyFrom(TupleRef{tuple.GetRid(), out.data(), static_cast<uint32_t>(out.size())});
+  return toasted;
+}
+
+auto ToastStore::Detoast(const Schema &schema, const TupleRef &tuple, const std::vector<uint32_t> *column_ids) const
+    -> Tuple {
+  std::vector<bool> read(schema.GetColumnCount(), column_ids == nullptr);
+  if (column_ids != nullptr) {
+    for (auto column_idx : *column_ids) {
+      read[column_idx] = true;
+    }
+  }
+
+  const char *data = tuple.GetData();
+  std::vector<char> out(data, data + schema.GetLength());
+  for (auto column_idx : schema.GetUnlinedColumns()) {
+    const char *value = VarcharAt(schema, data, column_idx);
+    auto len = *reinterpret_cast<const uint32_t *>(value);
+    auto var_offset = static_cast<uint32_t>(out.size());
+    memcpy(out.data() + schema.GetColumn(column_idx).GetOffset(), &var_offset, sizeof(uint32_t));
+    if (!IsToastedLength(len) || !read[column_idx]) {
+      out.insert(out.end(), value, value + StoredSize(len));
+      continue;
+    }
+    ToastPointer pointer;
+    memcpy(&pointer, value + sizeof(uint32_t), sizeof(ToastPointer));
+    out.resize(var_offset + sizeof(uint32_t) + pointer.raw_size_);
+    memcpy(out.data() + var_offset, &pointer.raw_size_, sizeof(uint32_t));
+    ReadValue(pointer, out.data() + var_offset + sizeof(uint32_t));
+  }
+
+  Tuple detoasted;
+  detoasted.CopyFrom(TupleRef{tuple.GetRid(), out.data(), static_cast<uint32_t>(out.size())});
+  return detoasted;
+}
+
+auto ToastStore::IsToasted(const Schema &schema, const TupleRef &tuple, const std::vector<uint32_t> &columns)
+    -> bool {
+  return std::any_of(columns.begin(), columns.end(), [&](uint32_t column_idx) {
+    return IsToastedLength(*reinterpret_cast<const uint32_t *>(VarcharAt(schema, tuple.GetData(), column_idx)));
+  });
+}
+
+void ToastStore::Release(const Schema &schema, const TupleRef &tuple) {
+  std::scoped_lock lock(latch_);
+  for (auto column_idx : schema.GetUnlinedColumns()) {
+    const char *value = VarcharAt(schema, tuple.GetData(), column_idx);
+    if (IsToastedLength(*reinterpret_cast<const uint32_t *>(value))) {
+      ToastPointer pointer;
+      memcpy(&pointer, value + sizeof(uint32_t), sizeof(ToastPointer));
+      released_chains_.push_back(pointer.first_page_id_);
+    }
+  }
+}
+
+auto ToastStore::HasReleased() -> bool {
+  std::scoped_lock lock(latch_);
+  return !released_chains_.empty();
+}
+
+auto ToastStore::FreeReleased() -> size_t {
+  std::vector<page_id_t> chains;
+  {
+    std::scoped_lock lock(latch_);
+    chains.swap(released_chains_);
+  }
+  size_t num_pages = 0;
+  for (auto page_id : chains) {
+    while (page_id != INVALID_PAGE_ID) {
+      page_id_t next_page_id;
+      {
+        auto guard = bpm_->FetchPageRead(page_id);
+        next_page_id = guard.As<OverflowPage>()->GetNextPageId();
+      }
+      bpm_->DeletePage(page_id);
+      page_id = next_page_id;
+      num_pages++;
+    }
+  }
+  return num_pages;
+}
+
+auto ToastStore::WriteChain(const char *data, uint32_t size) -> page_id_t {
+  // Write the pages back to front, so each page knows its successor when it is written.
+  auto num_pages = std::max<uint32_t>((size + OverflowPage::CAPACITY - 1) / OverflowPage::CAPACITY, 1);
+  page_id_t next_page_id = INVALID_PAGE_ID;
+  for (auto i = num_pages; i > 0; i--) {
+    auto begin = (i - 1) * OverflowPage::CAPACITY;
+    auto end = std::min(size, begin + OverflowPage::CAPACITY);
+    page_id_t page_id = INVALID_PAGE_ID;
+    auto guard = bpm_->NewPageGuarded(&page_id);
+    BUSTUB_ENSURE(page_id != INVALID_PAGE_ID, "no page for an out-of-line value");
+    guard.AsMut<OverflowPage>()->Init(next_page_id, data + begin, end - begin);
+    next_page_id = page_id;
+  }
+  return next_page_id;
+}
+
+void ToastStore::ReadValue(const ToastPointer &pointer, char *out) const {
+  std::vector<char> compressed;
+  char *stored = out;
+  if (pointer.is_compressed_ != 0) {
+    compressed.resize(pointer.stored_size_);
+    stored = compressed.data();
+  }
+  uint32_t offset = 0;
+  for (auto page_id = pointer.first_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto guard = bpm_->FetchPageRead(page_id);
+    auto page = guard.As<OverflowPage>();
+    BUSTUB_ENSURE(offset + page->GetSize() <= pointer.stored_size_, "corrupted out-of-line value");
+    memcpy(stored + offset, page->GetData(), page->GetSize());
+    offset += page->GetSize();
+    page_id = page->GetNextPageId();
+  }
+  BUSTUB_ENSURE(offset == pointer.stored_size_, "corrupted out-of-line value");
+  if (pointer.is_compressed_ != 0) {
+    Decompress(compressed.data(), pointer.stored_size_, out, pointer.raw_size_);
+  }
+}
+
+}  // namespace bustub
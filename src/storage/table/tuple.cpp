@@ -16,6 +16,8 @@
 #include <string>
 #include <vector>
 
+#include "common/exception.h"
+#include "storage/table/toast_store.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -61,11 +63,12 @@ Tuple::Tuple(std::vector<Value> values, const Schema *schema) {
 }
 
 auto Tuple::GetValue(const Schema *schema, const uint32_t column_idx) const -> Value {
-  assert(schema);
-  const TypeId column_type = schema->GetColumn(column_idx).GetType();
-  const char *data_ptr = GetDataPtr(schema, column_idx);
-  // the third parameter "is_inlined" is unused
-  return Value::DeserializeFrom(data_ptr, column_type);
+  return TupleRef(*this).GetValue(schema, column_idx);
+}
+
+void Tuple::CopyFrom(const TupleRef &tuple) {
+  data_.assign(tuple.GetData(), tuple.GetData() + tuple.GetLength());
+  rid_ = tuple.GetRid();
 }
 
 auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs)
@@ -78,18 +81,38 @@ auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const s
   return {values, &key_schema};
 }
 
-auto Tuple::GetDataPtr(const Schema *schema, const uint32_t column_idx) const -> const char * {
+auto TupleRef::GetDataPtr(const Schema *schema, const uint32_t column_idx) const -> const char * {
   assert(schema);
   const auto &col = schema->GetColumn(column_idx);
   bool is_inlined = col.IsInlined();
   // For inline type, data is stored where it is.
   if (is_inlined) {
-    return (data_.data() + col.GetOffset());
+    return (data_ + col.GetOffset());
   }
   // We read the relative offset from the tuple data.
-  int32_t offset = *reinterpret_cast<const int32_t *>(data_.data() + col.GetOffset());
+  int32_t offset = *reinterpret_cast<const int32_t *>(data_ + col.GetOffset());
   // And return the beginning address of the real data for the VARCHAR type.
-  return (data_.data() + offset);
+  return (data_ + offset);
+}
+
+auto TupleRef::GetValue(const Schema *schema, const uint32_t column_idx) const -> Value {
+  assert(schema);
+  const TypeId column_type = schema->GetColumn(column_idx).GetType();
+  const char *data_ptr = GetDataPtr(schema, column_idx);
+  if (!schema->GetColumn(column_idx).IsInlined()) {
+    auto len = *reinterpret_cast<const uint32_t *>(data_ptr);
+    if (len != BUSTUB_VALUE_NULL && (len & TOAST_FLAG) != 0) {
+      throw Exception("the value is stored out of line and was not read, see ToastStore");
+    }
+  }
+  // the third parameter "is_inlined" is unused
+  return Value::DeserializeFrom(data_ptr, column_type);
+}
+
+auto TupleRef::ToTuple() const -> Tuple {
+  Tuple tuple;
+  tuple.CopyFrom(*this);
+  return tuple;
 }
 
 auto Tuple::ToString(const Schema *schema) const -> std::string {
@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vacuum_worker.cpp
+//
+// Identification: src/storage/table/vacuum_worker.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/vacuum_worker.h"
+
+namespace bustub {
+
+VacuumWorker::~VacuumWorker() {
+  {
+    std::scoped_lock lock(latch_);
+    stopped_ = true;
+  }
+  cv_.notify_one();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void VacuumWorker::AddTable(TableHeap *table) {
+  std::scoped_lock lock(latch_);
+  tables_.push_back(table);
+  if (thread_.joinable()) {
+    return;
+  }
+  thread_ = std::thread([this] {
+    std::unique_lock lock(latch_);
+    while (!cv_.wait_for(lock, interval_, [this] { return stopped_; })) {
+      lock.unlock();
+      VacuumTables();
+      lock.lock();
+    }
+  });
+}
+
+auto VacuumWorker::VacuumTables() -> size_t {
+  // Tables are only ever added, so the ones seen here stay valid while they are vacuumed without the latch.
+  std::vector<TableHeap *> tables;
+  {
+    std::scoped_lock lock(latch_);
+    tables = tables_;
+  }
+  size_t reclaimed = 0;
+  for (auto *table : tables) {
+    if (table->NeedsVacuum()) {
+      reclaimed += table->Vacuum(min_dead_ratio_);
+    }
+  }
+  return reclaimed;
+}
+
+}  // namespace bustub
@@ -0,0 +1,152 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.cpp
+//
+// Identification: src/storage/table/zone_map.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/zone_map.h"
+
+#include <utility>
+
+namespace bustub {
+
+/** @return true if the values of `type` are numbers, whose order the zones can use */
+static auto IsNumeric(TypeId type) -> bool {
+  switch (type) {
+    case TypeId::TINYINT:
+    case TypeId::SMALLINT:
+    case TypeId::INTEGER:
+    case TypeId::BIGINT:
+    case TypeId::DECIMAL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+ZoneMap::ZoneMap(const Schema &schema) : schema_(schema), column_zone_idx_(schema.GetColumnCount(), UNTRACKED) {
+  for (uint32_t column_idx = 0; column_idx < schema.GetColumnCount(); column_idx++) {
+    if (IsNumeric(schema.GetColumn(column_idx).GetType())) {
+      column_zone_idx_[column_idx] = columns_.size();
+      columns_.push_back(column_idx);
+    }
+  }
+}
+
+auto ZoneMap::TrackedValues(const TupleRef &tuple) const -> std::vector<Value> {
+  std::vector<Value> values;
+  values.reserve(columns_.size());
+  for (auto column_idx : columns_) {
+    values.push_back(tuple.GetValue(&schema_, column_idx));
+  }
+  return values;
+}
+
+void ZoneMap::Widen(const std::vector<Value> &values, std::vector<ColumnZone> *zones) {
+  zones->resize(values.size());
+  for (size_t i = 0; i < values.size(); i++) {
+    auto &zone = (*zones)[i];
+    zone.num_tuples_++;
+    if (values[i].IsNull()) {
+      zone.num_nulls_++;
+      continue;
+    }
+    if (!zone.min_.has_value() || values[i].CompareLessThan(*zone.min_) == CmpBool::CmpTrue) {
+      zone.min_ = values[i];
+    }
+    if (!zone.max_.has_value() || values[i].CompareGreaterThan(*zone.max_) == CmpBool::CmpTrue) {
+      zone.max_ = values[i];
+    }
+  }
+}
+
+void ZoneMap::Add(page_id_t page_id, const TupleRef &tuple) {
+  if (columns_.empty()) {
+    return;
+  }
+  auto values = TrackedValues(tuple);
+  std::scoped_lock lock(latch_);
+  Widen(values, &zones_[page_id]);
+}
+
+void ZoneMap::Rebuild(page_id_t page_id, const std::vector<TupleView> &tuples) {
+  if (columns_.empty()) {
+    return;
+  }
+  // Built aside and swapped in, so a concurrent scan never sees the page without a zone.
+  std::vector<ColumnZone> zones;
+  for (const auto &tuple : tuples) {
+    Widen(TrackedValues(tuple), &zones);
+  }
+  std::scoped_lock lock(latch_);
+  if (zones.empty()) {
+    zones_.erase(page_id);
+  } else {
+    zones_[page_id] = std::move(zones);
+  }
+}
+
+auto ZoneMap::MayMatch(page_id_t page_id, const std::vector<ZoneBound> &bounds) const -> bool {
+  if (columns_.empty()) {
+    return true;
+  }
+  std::scoped_lock lock(latch_);
+  auto it = zones_.find(page_id);
+  if (it == zones_.end()) {
+    // A page without tuples has none that match.
+    return false;
+  }
+  for (const auto &bound : bounds) {
+    if (!IsTracked(bound.column_idx_) || !IsNumeric(bound.value_.GetTypeId())) {
+      continue;
+    }
+    const auto &zone = it->second[column_zone_idx_[bound.column_idx_]];
+    if (bound.or_null_ && zone.num_nulls_ > 0) {
+      continue;
+    }
+    // A comparison with NULL is never true.
+    if (!zone.min_.has_value() || bound.value_.IsNull()) {
+      return false;
+    }
+    const auto &min = *zone.min_;
+    const auto &max = *zone.max_;
+    bool may_match = true;
+    switch (bound.op_) {
+      case ZoneBound::Op::EQ:
+        may_match = min.CompareLessThanEquals(bound.value_) == CmpBool::CmpTrue &&
+                    max.CompareGreaterThanEquals(bound.value_) == CmpBool::CmpTrue;
+        break;
+      case ZoneBound::Op::LT:
+        may_match = min.CompareLessThan(bound.value_) == CmpBool::CmpTrue;
+        break;
+      case ZoneBound::Op::LE:
+        may_match = min.CompareLessThanEquals(bound.value_) == CmpBool::CmpTrue;
+        break;
+      case ZoneBound::Op::GT:
+        may_match = max.CompareGreaterThan(bound.value_) == CmpBool::CmpTrue;
+        break;
+      case ZoneBound::Op::GE:
+        may_match = max.CompareGreaterThanEquals(bound.value_) == CmpBool::CmpTrue;
+        break;
+    }
+    if (!may_match) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto ZoneMap::GetZone(page_id_t page_id, uint32_t column_idx) const -> std::optional<ColumnZone> {
+  std::scoped_lock lock(latch_);
+  auto it = zones_.find(page_id);
+  if (it == zones_.end() || !IsTracked(column_idx)) {
+    return std::nullopt;
+  }
+  return it->second[column_zone_idx_[column_idx]];
+}
+
+}  // namespace bustub
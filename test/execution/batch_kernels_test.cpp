@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// batch_kernels_test.cpp
+//
+// Identification: test/execution/batch_kernels_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/expressions/arithmetic_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/tuple_batch.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** Check that `expr` gives the same values over the selected rows of `batch` a batch and a tuple at a time. */
+static void CheckBatchEqualsTuples(const AbstractExpression &expr, const TupleBatch &batch, const Schema &schema) {
+  ColumnVector result;
+  expr.EvaluateBatch(batch, &result);
+  ASSERT_EQ(result.Size(), batch.NumSelected()) << expr.ToString();
+  for (size_t i = 0; i < batch.NumSelected(); i++) {
+    auto tuple = batch.GetTuple(batch.GetSelection()[i], schema);
+    auto expected = expr.Evaluate(tuple, schema);
+    auto actual = result.GetValue(i);
+    ASSERT_EQ(actual.GetTypeId(), expected.GetTypeId()) << expr.ToString();
+    ASSERT_EQ(actual.IsNull(), expected.IsNull()) << expr.ToString() << " on " << tuple.ToString(&schema);
+    if (!expected.IsNull()) {
+      ASSERT_EQ(actual.ToString(), expected.ToString()) << expr.ToString() << " on " << tuple.ToString(&schema);
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BatchKernelsTest, RandomizedTest) {
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::INTEGER}, Column{"c", TypeId::BIGINT},
+                 Column{"d", TypeId::DECIMAL}, Column{"e", TypeId::BOOLEAN}, Column{"f", TypeId::BOOLEAN}});
+  std::mt19937 gen(15445);  // NOLINT
+  std::uniform_int_distribution<int> small(-20, 20);
+  std::uniform_int_distribution<int> percent(0, 99);
+
+  // Small values, so comparisons often tie and mixed types compare equal, with some near the limits of INTEGER so
+  // that + and - overflow.
+  auto integer = [&]() {
+    auto p = percent(gen);
+    if (p < 15) {
+      return ValueFactory::GetNullValueByType(TypeId::INTEGER);
+    }
+    if (p < 25) {
+      return ValueFactory::GetIntegerValue(std::numeric_limits<int32_t>::max() - small(gen) - 20);
+    }
+    if (p < 35) {
+      return ValueFactory::GetIntegerValue(std::numeric_limits<int32_t>::min() + small(gen) + 21);
+    }
+    return ValueFactory::GetIntegerValue(small(gen));
+  };
+  auto bigint = [&]() {
+    auto p = percent(gen);
+    if (p < 15) {
+      return ValueFactory::GetNullValueByType(TypeId::BIGINT);
+    }
+    if (p < 25) {
+      return ValueFactory::GetBigIntValue(int64_t{1} << 40);
+    }
+    return ValueFactory::GetBigIntValue(small(gen));
+  };
+  auto decimal = [&]() {
+    auto p = percent(gen);
+    if (p < 15) {
+      return ValueFactory::GetNullValueByType(TypeId::DECIMAL);
+    }
+    return ValueFactory::GetDecimalValue(small(gen) / (p % 2 == 0 ? 1.0 : 2.0));
+  };
+  auto boolean = [&]() {
+    auto p = percent(gen);
+    if (p < 20) {
+      return ValueFactory::GetNullValueByType(TypeId::BOOLEAN);
+    }
+    return ValueFactory::GetBooleanValue(p % 2 == 0);
+  };
+
+  auto a = std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER);
+  auto b = std::make_shared<ColumnValueExpression>(0, 1, TypeId::INTEGER);
+  auto c = std::make_shared<ColumnValueExpression>(0, 2, TypeId::BIGINT);
+  auto d = std::make_shared<ColumnValueExpression>(0, 3, TypeId::DECIMAL);
+  auto e = std::make_shared<ColumnValueExpression>(0, 4, TypeId::BOOLEAN);
+  auto f = std::make_shared<ColumnValueExpression>(0, 5, TypeId::BOOLEAN);
+  auto five = std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(5));
+  auto null = std::make_shared<ConstantValueExpression>(ValueFactory::GetNullValueByType(TypeId::INTEGER));
+  std::vector<std::pair<AbstractExpressionRef, AbstractExpressionRef>> operands{
+      {a, b}, {a, c}, {c, a}, {a, d}, {d, a}, {c, d}, {d, c}, {a, five}, {five, c}, {a, null}};
+
+  std::vector<AbstractExpressionRef> exprs;
+  std::vector<AbstractExpressionRef> predicates;
+  for (auto comp_type : {ComparisonType::Equal, ComparisonType::NotEqual, ComparisonType::LessThan,
+                         ComparisonType::LessThanOrEqual, ComparisonType::GreaterThan,
+                         ComparisonType::GreaterThanOrEqual}) {
+    for (const auto &[lhs, rhs] : operands) {
+      predicates.push_back(std::make_shared<ComparisonExpression>(lhs, rhs, comp_type));
+    }
+  }
+  exprs.insert(exprs.end(), predicates.begin(), predicates.end());
+  for (auto logic_type : {LogicType::And, LogicType::Or}) {
+    exprs.push_back(std::make_shared<LogicExpression>(e, f, logic_type));
+    exprs.push_back(std::make_shared<LogicExpression>(predicates[0], f, logic_type));
+    exprs.push_back(std::make_shared<LogicExpression>(predicates[2], predicates[15], logic_type));
+    exprs.push_back(std::make_shared<LogicExpression>(predicates[40], predicates[59], logic_type));
+  }
+  for (auto compute_type : {ArithmeticType::Plus, ArithmeticType::Minus}) {
+    auto ab = std::make_shared<ArithmeticExpression>(a, b, compute_type);
+    exprs.push_back(ab);
+    exprs.push_back(std::make_shared<ArithmeticExpression>(a, five, compute_type));
+    exprs.push_back(std::make_shared<ArithmeticExpression>(ab, a, compute_type));
+    exprs.push_back(std::make_shared<ArithmeticExpression>(b, null, compute_type));
+  }
+
+  for (int round = 0; round < 10; round++) {
+    TupleBatch batch;
+    batch.Reset(schema);
+    while (!batch.IsFull()) {
+      batch.AppendRow({integer(), integer(), bigint(), decimal(), boolean(), boolean()});
+    }
+    // Every other round, over a selection of the rows.
+    if (round % 2 == 1) {
+      std::vector<uint8_t> keep;
+      for (size_t i = 0; i < batch.NumSelected(); i++) {
+        keep.push_back(static_cast<uint8_t>(percent(gen) < 60));
+      }
+      batch.Select(keep);
+    }
+    for (const auto &expr : exprs) {
+      CheckBatchEqualsTuples(*expr, batch, schema);
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_pipeline_test.cpp
+//
+// Identification: test/execution/parallel_pipeline_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "common/bustub_instance.h"
+#include "common/exception.h"
+#include "fmt/format.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+static auto Execute(BustubInstance *instance, const std::string &sql) -> std::string {
+  std::stringstream ss;
+  auto writer = SimpleStreamWriter(ss, true, ",");
+  EXPECT_TRUE(instance->ExecuteSql(sql, writer));
+  return ss.str();
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelPipelineTest, SameResultsAsSerialTest) {
+  auto instance = std::make_unique<BustubInstance>();
+  instance->GenerateMockTable();
+  Execute(instance.get(), "create table p(v1 int, v2 int, v3 int, v4 int, v5 int, v6 varchar(128));");
+  Execute(instance.get(), "insert into p select * from __mock_agg_input_big;");
+  // Enough pages for the scans to be split into several morsels.
+  ASSERT_GT(instance->catalog_->GetTable("p")->table_->GetNumPages(), 4 * TableHeap::DEFAULT_PAGES_PER_MORSEL);
+
+  const std::vector<std::string> queries{
+      "select count(*), sum(v2), min(v3), max(v4) from p;",
+      "select v1, count(*), sum(v2), min(v3), max(v4) from p group by v1 order by v1;",
+      "select v1, count(*), sum(v2) from p where v3 < 30 group by v1 order by v1;",
+      "select l.v1, count(*), sum(r.v2), max(r.v3) from p l inner join p r on l.v2 = r.v2 group by l.v1 order by l.v1;",
+      "select l.v3, count(*), count(r.v2) from p l left join (select * from p where v4 = 3) r on l.v2 = r.v2 "
+      "group by l.v3 order by l.v3;",
+  };
+  Execute(instance.get(), "set parallelism = 1;");
+  std::vector<std::string> expected;
+  for (const auto &query : queries) {
+    expected.push_back(Execute(instance.get(), query));
+  }
+  ASSERT_EQ(expected[0], "10000,49995000,0,9,\n");
+
+  for (const auto *parallelism : {"2", "4"}) {
+    Execute(instance.get(), std::string("set parallelism = ") + parallelism + ";");
+    for (size_t i = 0; i < queries.size(); i++) {
+      EXPECT_EQ(Execute(instance.get(), queries[i]), expected[i]) << queries[i] << " at parallelism " << parallelism;
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelPipelineTest, SessionVariablesTest) {
+  auto instance = std::make_unique<BustubInstance>();
+  std::stringstream ss;
+  auto writer = SimpleStreamWriter(ss, true, ",");
+  for (const auto *variable : {"parallelism", "work_mem"}) {
+    for (const auto *value : {"-1", "0", "1x", "abc", "99999999999999999999999"}) {
+      EXPECT_THROW(instance->ExecuteSql(fmt::format("set {} = '{}';", variable, value), writer), Exception)
+          << variable << " " << value;
+    }
+  }
+  EXPECT_THROW(instance->ExecuteSql("set parallelism = 100000;", writer), Exception);
+  Execute(instance.get(), "set parallelism = 2;");
+  Execute(instance.get(), "set work_mem = 4096;");
+  EXPECT_EQ(instance->GetSessionVariable("parallelism"), "2");
+  EXPECT_EQ(instance->GetSessionVariable("work_mem"), "4096");
+}
+
+}  // namespace bustub
@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// seq_scan_executor_test.cpp
+//
+// Identification: test/execution/seq_scan_executor_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "catalog/catalog.h"
+#include "common/bustub_instance.h"
+#include "fmt/format.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+static auto Execute(BustubInstance *instance, const std::string &sql) -> std::string {
+  std::stringstream ss;
+  auto writer = SimpleStreamWriter(ss, true, ",");
+  EXPECT_TRUE(instance->ExecuteSql(sql, writer));
+  return ss.str();
+}
+
+// NOLINTNEXTLINE
+TEST(SeqScanExecutorTest, FilterSkipsPages) {
+  auto instance = std::make_unique<BustubInstance>();
+  Execute(instance.get(), "create table t(x int, y int);");
+  std::string values;
+  for (int i = 0; i < 10000; i++) {
+    values += fmt::format("{}({}, {})", i == 0 ? "" : ", ", i, i * 10);
+  }
+  Execute(instance.get(), "insert into t values " + values + ";");
+  auto *table = instance->catalog_->GetTable("t")->table_.get();
+  ASSERT_GT(table->GetNumPages(), 4);
+
+  auto pages_before = table->GetNumPagesScanned();
+  EXPECT_EQ(Execute(instance.get(), "select count(*) from t;"), "10000,\n");
+  auto num_pages = table->GetNumPagesScanned() - pages_before;
+
+  // The filter is merged into the scan, which checks the bounds of its predicate against the zone map.
+  auto plan = Execute(instance.get(), "explain (o) select y from t where x < 5;");
+  EXPECT_NE(plan.find("SeqScan { table=t, filter=(#0.0<5)"), std::string::npos) << plan;
+
+  pages_before = table->GetNumPagesScanned();
+  EXPECT_EQ(Execute(instance.get(), "select y from t where x < 5;"), "0,\n10,\n20,\n30,\n40,\n");
+  EXPECT_EQ(table->GetNumPagesScanned() - pages_before, 1);
+
+  // A disjunction gives no bounds, so every page is read.
+  pages_before = table->GetNumPagesScanned();
+  EXPECT_EQ(Execute(instance.get(), "select count(*) from t where x >= 9998 or x < 0;"), "2,\n");
+  EXPECT_EQ(table->GetNumPagesScanned() - pages_before, num_pages);
+
+  pages_before = table->GetNumPagesScanned();
+  EXPECT_EQ(Execute(instance.get(), "select count(*), min(y) from t where x >= 9998;"), "2,99980,\n");
+  EXPECT_EQ(table->GetNumPagesScanned() - pages_before, 1);
+}
+
+}  // namespace bustub
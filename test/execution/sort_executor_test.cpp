@@ -0,0 +1,153 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor_test.cpp
+//
+// Identification: test/execution/sort_executor_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "common/bustub_instance.h"
+#include "fmt/format.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+static auto Execute(BustubInstance *instance, const std::string &sql) -> std::string {
+  std::stringstream ss;
+  auto writer = SimpleStreamWriter(ss, true, ",");
+  EXPECT_TRUE(instance->ExecuteSql(sql, writer));
+  return ss.str();
+}
+
+// NOLINTNEXTLINE
+TEST(SortExecutorTest, ExternalSortTest) {
+  auto instance = std::make_unique<BustubInstance>();
+  Execute(instance.get(), "create table t(a int, id int);");
+  Execute(instance.get(), "create table n(id int, b varchar(16));");
+
+  // Few distinct values of a and b, so the sort needs every key, with NULLs in both. A NULL VARCHAR cannot be
+  // inserted, so the rows without a name in `n` get theirs from the left join.
+  struct Row {
+    std::optional<int> a_;
+    std::optional<std::string> b_;
+    int id_;
+  };
+  const int num_rows = 3000;
+  std::vector<Row> rows;
+  std::string t_values;
+  std::string n_values;
+  for (int i = 0; i < num_rows; i++) {
+    Row row{i % 13 == 0 ? std::nullopt : std::make_optional(i * 7919 % 50),
+            i % 17 == 0 ? std::nullopt : std::make_optional(fmt::format("k{:03}", i * 31 % 97)), i};
+    t_values += fmt::format("{}({}, {})", i == 0 ? "" : ", ", row.a_.has_value() ? std::to_string(*row.a_) : "null",
+                            row.id_);
+    if (row.b_.has_value()) {
+      n_values += fmt::format("{}({}, '{}')", n_values.empty() ? "" : ", ", row.id_, *row.b_);
+    }
+    rows.push_back(std::move(row));
+  }
+  Execute(instance.get(), "insert into t values " + t_values + ";");
+  Execute(instance.get(), "insert into n values " + n_values + ";");
+
+  // ORDER BY a DESC, b, id DESC: NULLs come first in descending order and last in ascending order.
+  std::sort(rows.begin(), rows.end(), [](const Row &x, const Row &y) {
+    auto a_key = [](const Row &row) { return std::make_tuple(!row.a_.has_value(), row.a_.value_or(0)); };
+    auto b_key = [](const Row &row) { return std::make_tuple(!row.b_.has_value(), row.b_.value_or("")); };
+    if (a_key(x) != a_key(y)) {
+      return a_key(x) > a_key(y);
+    }
+    if (b_key(x) != b_key(y)) {
+      return b_key(x) < b_key(y);
+    }
+    return x.id_ > y.id_;
+  });
+  std::string expected;
+  for (const auto &row : rows) {
+    expected += fmt::format("{},{},{},\n", row.a_.has_value() ? std::to_string(*row.a_) : "integer_null",
+                            row.b_.value_or("varlen_null"), row.id_);
+  }
+
+  const std::string query =
+      "select t.a, n.b, t.id from t left join n on t.id = n.id order by t.a desc, n.b, t.id desc;";
+  EXPECT_EQ(Execute(instance.get(), query), expected);
+
+  // The rows take well over 100 KB, so two pages of memory make the sort spill dozens of runs, and only two of them
+  // are merged at a time, in several passes.
+  Execute(instance.get(), "set work_mem = 8192;");
+  EXPECT_EQ(Execute(instance.get(), query), expected);
+  Execute(instance.get(), "set work_mem = 20000;");
+  EXPECT_EQ(Execute(instance.get(), query), expected);
+}
+
+// NOLINTNEXTLINE
+TEST(SortExecutorTest, ExpressionKeyTest) {
+  auto instance = std::make_unique<BustubInstance>();
+  Execute(instance.get(), "create table t(a int, id int);");
+
+  struct Row {
+    std::optional<int> a_;
+    int id_;
+  };
+  const int num_rows = 3000;
+  std::vector<Row> rows;
+  std::string values;
+  for (int i = 0; i < num_rows; i++) {
+    Row row{i % 13 == 0 ? std::nullopt : std::make_optional(i * 7919 % 50), i};
+    values += fmt::format("{}({}, {})", i == 0 ? "" : ", ", row.a_.has_value() ? std::to_string(*row.a_) : "null",
+                          row.id_);
+    rows.push_back(row);
+  }
+  Execute(instance.get(), "insert into t values " + values + ";");
+
+  // The keys are computed, so neither the sort nor the TopN can read them from the tuple. A NULL `a` gives a NULL key.
+  using Key = std::tuple<bool, int, int>;
+  auto expected_rows = [&](const std::function<Key(const Row &)> &key, size_t limit, bool scan_filter) {
+    std::vector<Row> sorted;
+    std::copy_if(rows.begin(), rows.end(), std::back_inserter(sorted),
+                 [&](const Row &row) { return !scan_filter || row.id_ > 100; });
+    std::sort(sorted.begin(), sorted.end(), [&](const Row &x, const Row &y) { return key(x) < key(y); });
+    std::string expected;
+    for (size_t i = 0; i < std::min(limit, sorted.size()); i++) {
+      const auto &row = sorted[i];
+      expected += fmt::format("{},{},\n", row.a_.has_value() ? std::to_string(*row.a_) : "integer_null", row.id_);
+    }
+    return expected;
+  };
+  // ORDER BY a + 1, id: NULLs last.
+  auto plus_one = [](const Row &row) { return Key{!row.a_.has_value(), row.a_.value_or(0) + 1, row.id_}; };
+  // ORDER BY a + 1 DESC, id: NULLs first.
+  auto plus_one_desc = [](const Row &row) { return Key{row.a_.has_value(), -row.a_.value_or(0) - 1, row.id_}; };
+  // ORDER BY id - a, id: NULLs last.
+  auto difference = [](const Row &row) { return Key{!row.a_.has_value(), row.id_ - row.a_.value_or(0), row.id_}; };
+
+  for (const auto *work_mem : {"16777216", "8192"}) {
+    Execute(instance.get(), fmt::format("set work_mem = {};", work_mem));
+    EXPECT_EQ(Execute(instance.get(), "select * from t order by a + 1, id;"), expected_rows(plus_one, num_rows, false))
+        << work_mem;
+    EXPECT_EQ(Execute(instance.get(), "select * from t order by a + 1 desc, id;"),
+              expected_rows(plus_one_desc, num_rows, false))
+        << work_mem;
+  }
+  EXPECT_EQ(Execute(instance.get(), "select * from t order by a + 1, id limit 70;"),
+            expected_rows(plus_one, 70, false));
+  EXPECT_EQ(Execute(instance.get(), "select * from t order by a + 1 desc, id limit 300;"),
+            expected_rows(plus_one_desc, 300, false));
+  EXPECT_EQ(Execute(instance.get(), "select * from t where id > 100 order by id - a, id limit 25;"),
+            expected_rows(difference, 25, true));
+  EXPECT_EQ(Execute(instance.get(), "select * from t where id > 100 order by a + 1 desc, id limit 300;"),
+            expected_rows(plus_one_desc, 300, true));
+}
+
+}  // namespace bustub
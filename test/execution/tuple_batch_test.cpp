@@ -0,0 +1,186 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch_test.cpp
+//
+// Identification: test/execution/tuple_batch_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/tuple_batch.h"
+#include "gtest/gtest.h"
+#include "type/type.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TupleBatchTest, NullBitmapTest) {
+  // Enough rows for the bitmap to span several words and to grow after the first NULL.
+  const size_t num_rows = 300;
+  for (auto type : {TypeId::INTEGER, TypeId::BIGINT, TypeId::DECIMAL}) {
+    ColumnVector column(type);
+    for (size_t i = 0; i < num_rows; i++) {
+      if (i % 7 == 3) {
+        column.Append(ValueFactory::GetNullValueByType(type));
+      } else {
+        column.Append(ValueFactory::GetIntegerValue(static_cast<int32_t>(i)));
+      }
+    }
+    ASSERT_EQ(column.Size(), num_rows);
+    ASSERT_TRUE(column.IsFixedSize());
+    ASSERT_TRUE(column.HasNulls());
+    for (size_t i = 0; i < num_rows; i++) {
+      ASSERT_EQ(column.IsNull(i), i % 7 == 3) << i;
+      auto value = column.GetValue(i);
+      ASSERT_EQ(value.GetTypeId(), type);
+      ASSERT_EQ(value.IsNull(), i % 7 == 3) << i;
+      if (!value.IsNull()) {
+        ASSERT_EQ(value.CastAs(TypeId::INTEGER).GetAs<int32_t>(), static_cast<int32_t>(i));
+      }
+    }
+
+    // A NULL set after the rows are written, on a column that had none so far.
+    column.Reset(type);
+    ASSERT_FALSE(column.HasNulls());
+    for (size_t i = 0; i < num_rows; i++) {
+      column.Append(ValueFactory::GetIntegerValue(1));
+    }
+    ASSERT_FALSE(column.IsNull(3));
+    column.SetNull(200);
+    column.Append(ValueFactory::GetIntegerValue(2));
+    for (size_t i = 0; i <= num_rows; i++) {
+      ASSERT_EQ(column.IsNull(i), i == 200) << i;
+    }
+  }
+
+  // Serialized NULLs are recognized by their sentinel.
+  ColumnVector column(TypeId::INTEGER);
+  auto null_value = ValueFactory::GetNullValueByType(TypeId::INTEGER);
+  auto one = ValueFactory::GetIntegerValue(1);
+  char data[sizeof(int32_t)];
+  null_value.SerializeTo(data);
+  column.AppendRaw(data);
+  one.SerializeTo(data);
+  column.AppendRaw(data);
+  EXPECT_TRUE(column.IsNull(0));
+  EXPECT_FALSE(column.IsNull(1));
+  EXPECT_EQ(column.GetValue(1).GetAs<int32_t>(), 1);
+
+  // VARCHAR values are boxed, NULLs included.
+  ColumnVector strings(TypeId::VARCHAR);
+  strings.Append(ValueFactory::GetVarcharValue("a"));
+  strings.Append(ValueFactory::GetNullValueByType(TypeId::VARCHAR));
+  strings.Append(ValueFactory::GetVarcharValue("c"));
+  strings.SetNull(2);
+  EXPECT_FALSE(strings.IsFixedSize());
+  EXPECT_FALSE(strings.IsNull(0));
+  EXPECT_TRUE(strings.IsNull(1));
+  EXPECT_TRUE(strings.IsNull(2));
+  EXPECT_EQ(strings.GetBoxedValue(0).ToString(), "a");
+
+  ColumnVector filled;
+  filled.Fill(null_value, 70);
+  EXPECT_EQ(filled.Size(), 70);
+  EXPECT_TRUE(filled.IsNull(0));
+  EXPECT_TRUE(filled.IsNull(69));
+}
+
+// NOLINTNEXTLINE
+TEST(TupleBatchTest, GatherTest) {
+  const size_t num_rows = 200;
+  std::vector<uint32_t> rows;
+  std::vector<uint32_t> all_rows;
+  for (uint32_t i = 0; i < num_rows; i++) {
+    if (i % 3 != 0) {
+      rows.push_back(i);
+    }
+    all_rows.push_back(i);
+  }
+
+  for (auto type : {TypeId::TINYINT, TypeId::SMALLINT, TypeId::INTEGER, TypeId::BIGINT, TypeId::DECIMAL,
+                    TypeId::VARCHAR}) {
+    ColumnVector source(type);
+    for (size_t i = 0; i < num_rows; i++) {
+      if (i % 5 == 1) {
+        source.Append(ValueFactory::GetNullValueByType(type));
+      } else if (type == TypeId::VARCHAR) {
+        source.Append(ValueFactory::GetVarcharValue(std::to_string(i % 100)));
+      } else {
+        source.Append(ValueFactory::GetIntegerValue(static_cast<int32_t>(i % 100)));
+      }
+    }
+
+    for (const auto *selection : {&rows, &all_rows}) {
+      ColumnVector column;
+      column.Gather(source, *selection);
+      ASSERT_EQ(column.GetType(), type);
+      ASSERT_EQ(column.Size(), selection->size());
+      for (size_t i = 0; i < selection->size(); i++) {
+        auto row = (*selection)[i];
+        ASSERT_EQ(column.IsNull(i), row % 5 == 1) << Type::TypeIdToString(type) << " " << row;
+        if (!column.IsNull(i)) {
+          ASSERT_EQ(column.GetValue(i).ToString(), source.GetValue(row).ToString());
+        }
+      }
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TupleBatchTest, SelectTest) {
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 16}});
+  TupleBatch batch;
+  batch.Reset(schema);
+  for (int32_t i = 0; i < 100; i++) {
+    auto a = i % 10 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(i);
+    batch.AppendRow({a, ValueFactory::GetVarcharValue("v" + std::to_string(i))});
+  }
+  ASSERT_EQ(batch.NumRows(), 100);
+  ASSERT_EQ(batch.NumSelected(), 100);
+
+  // a > 50: NULLs are not selected.
+  auto a = std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER);
+  auto fifty = std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(50));
+  batch.Select(ComparisonExpression(a, fifty, ComparisonType::GreaterThan));
+  std::vector<uint32_t> expected;
+  for (uint32_t i = 51; i < 100; i++) {
+    if (i % 10 != 0) {
+      expected.push_back(i);
+    }
+  }
+  ASSERT_EQ(batch.GetSelection(), expected);
+
+  // A second selection applies to the rows still selected, and keeps the values of all rows in place.
+  std::vector<uint8_t> keep;
+  std::vector<uint32_t> kept;
+  for (auto row : batch.GetSelection()) {
+    keep.push_back(row % 2);
+    if (row % 2 == 1) {
+      kept.push_back(row);
+    }
+  }
+  batch.Select(keep);
+  ASSERT_EQ(batch.GetSelection(), kept);
+  ASSERT_EQ(batch.NumRows(), 100);
+
+  auto values = batch.GetRowValues(kept[0]);
+  EXPECT_EQ(values[0].GetAs<int32_t>(), 51);
+  EXPECT_EQ(values[1].ToString(), "v51");
+  auto tuple = batch.GetTuple(kept[1], schema);
+  EXPECT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), 53);
+  EXPECT_EQ(tuple.GetValue(&schema, 1).ToString(), "v53");
+  EXPECT_TRUE(batch.GetTuple(10, schema).GetValue(&schema, 0).IsNull());
+}
+
+}  // namespace bustub
@@ -1,4 +1,6 @@
 #include <fmt/format.h>
+#include <filesystem>
+#include <fstream>
 #include <functional>
 #include <memory>
 #include <numeric>
@@ -121,4 +123,190 @@ TEST(TrieStoreTest, MixedConcurrentTest) {
   }
 }
 
+TEST(TrieStoreTest, ScanSnapshotTest) {
+  auto store = TrieStore();
+  for (uint32_t i = 0; i < 100; i++) {
+    store.Put<uint32_t>(fmt::format("key-{:#03}", i), i);
+  }
+  auto iter = store.ScanPrefix<uint32_t>("key-0");
+  auto range = store.Range<uint32_t>("key-050", "key-060");
+  for (uint32_t i = 0; i < 100; i++) {
+    store.Remove(fmt::format("key-{:#03}", i));
+  }
+  ASSERT_TRUE(store.ScanPrefix<uint32_t>("key-").IsEnd());
+
+  // The iterators still see the version they were created on.
+  for (uint32_t i = 0; i < 100; i++, ++iter) {
+    ASSERT_FALSE(iter.IsEnd());
+    ASSERT_EQ(iter.Value(), i);
+  }
+  ASSERT_TRUE(iter.IsEnd());
+  for (uint32_t i = 50; i < 60; i++, ++range) {
+    ASSERT_FALSE(range.IsEnd());
+    ASSERT_EQ(range.Key(), fmt::format("key-{:#03}", i));
+  }
+  ASSERT_TRUE(range.IsEnd());
+}
+
+TEST(TrieStoreTest, ApplyBatchTest) {
+  const std::string directory = "trie_store_apply_batch";
+  std::filesystem::remove_all(directory);
+  {
+    auto store = TrieStore(directory, 0);
+    store.Put<uint32_t>("a", 1);
+    WriteBatch batch;
+    for (uint32_t i = 0; i < 1000; i++) {
+      batch.Put<uint32_t>(fmt::format("key{:04}", i), i);
+    }
+    batch.Remove("a");
+    store.Apply(std::move(batch));
+    ASSERT_EQ(store.Get<uint32_t>("a"), std::nullopt);
+    ASSERT_EQ(**store.Get<uint32_t>("key0999"), 999);
+
+    WriteBatch unserializable;
+    unserializable.Put<uint32_t>("b", 2);
+    unserializable.Put<Integer>("c", std::make_unique<uint32_t>(3));
+    ASSERT_THROW(store.Apply(std::move(unserializable)), Exception);
+    ASSERT_EQ(store.Get<uint32_t>("b"), std::nullopt);
+  }
+  {
+    auto store = TrieStore(directory, 0);
+    ASSERT_EQ(store.Get<uint32_t>("a"), std::nullopt);
+    for (uint32_t i = 0; i < 1000; i++) {
+      ASSERT_EQ(**store.Get<uint32_t>(fmt::format("key{:04}", i)), i);
+    }
+  }
+  std::filesystem::remove_all(directory);
+}
+
+TEST(TrieStoreTest, DurableRestartTest) {
+  const std::string directory = "trie_store_durable_restart";
+  std::filesystem::remove_all(directory);
+  {
+    auto store = TrieStore(directory, 0);
+    store.Put<uint32_t>("a", 1);
+    store.Put<uint64_t>("b", 2);
+    store.Put<std::string>("c", "3");
+    store.Checkpoint();
+    store.Put<std::string>("a", "overwritten");
+    store.Remove("b");
+    store.Put<uint32_t>("d", 4);
+    ASSERT_THROW(store.Put<Integer>("e", std::make_unique<uint32_t>(5)), Exception);
+  }
+  {
+    // Snapshot plus log tail.
+    auto store = TrieStore(directory, 0);
+    ASSERT_EQ(**store.Get<std::string>("a"), "overwritten");
+    ASSERT_EQ(store.Get<uint64_t>("b"), std::nullopt);
+    ASSERT_EQ(**store.Get<std::string>("c"), "3");
+    ASSERT_EQ(**store.Get<uint32_t>("d"), 4);
+    store.Checkpoint();
+    store.Put<uint32_t>("f", 6);
+  }
+  {
+    auto store = TrieStore(directory, 0);
+    ASSERT_EQ(**store.Get<std::string>("a"), "overwritten");
+    ASSERT_EQ(**store.Get<uint32_t>("d"), 4);
+    ASSERT_EQ(**store.Get<uint32_t>("f"), 6);
+  }
+  std::filesystem::remove_all(directory);
+}
+
+TEST(TrieStoreTest, DurableTornTailTest) {
+  const std::string directory = "trie_store_durable_torn_tail";
+  std::filesystem::remove_all(directory);
+  {
+    auto store = TrieStore(directory, 0);
+    for (uint32_t i = 0; i < 100; i++) {
+      store.Put<uint32_t>(fmt::format("{:#05}", i), i);
+    }
+  }
+  // Simulate a crash in the middle of appending a record.
+  std::string last_segment;
+  for (const auto &entry : std::filesystem::directory_iterator(directory)) {
+    last_segment = std::max(last_segment, entry.path().string());
+  }
+  {
+    std::ofstream out(last_segment, std::ios::binary | std::ios::app);
+    out << "torn";
+  }
+  {
+    auto store = TrieStore(directory, 0);
+    for (uint32_t i = 0; i < 100; i++) {
+      ASSERT_EQ(**store.Get<uint32_t>(fmt::format("{:#05}", i)), i);
+    }
+    store.Put<uint32_t>("after", 1);
+  }
+  {
+    auto store = TrieStore(directory, 0);
+    ASSERT_EQ(**store.Get<uint32_t>("after"), 1);
+  }
+  std::filesystem::remove_all(directory);
+}
+
+TEST(TrieStoreTest, DurableStrayFilesTest) {
+  const std::string directory = "trie_store_durable_stray_files";
+  std::filesystem::remove_all(directory);
+  {
+    auto store = TrieStore(directory, 0);
+    store.Put<uint32_t>("a", 1);
+    // Files next to the log whose names only start like a segment: a copy of the segment as it is now, which
+    // would undo the next write if it were replayed, and a file that is not numbered at all.
+    for (const auto &entry : std::filesystem::directory_iterator(directory)) {
+      std::filesystem::copy_file(entry.path(), entry.path().string() + ".bak");
+    }
+    std::ofstream(directory + "/wal.tmp") << "junk";
+    store.Put<uint32_t>("a", 2);
+  }
+  {
+    auto store = TrieStore(directory, 0);
+    ASSERT_EQ(**store.Get<uint32_t>("a"), 2);
+  }
+  std::filesystem::remove_all(directory);
+}
+
+TEST(TrieStoreTest, DurableBackgroundCheckpointTest) {
+  const std::string directory = "trie_store_durable_checkpoint";
+  std::filesystem::remove_all(directory);
+  {
+    auto store = TrieStore(directory, 100, false);
+    std::vector<std::thread> threads;
+    for (int tid = 0; tid < 4; tid++) {
+      threads.emplace_back([&store, tid] {
+        for (uint32_t i = 0; i < 1000; i++) {
+          store.Put<std::string>(fmt::format("{:#05}", i * 4 + tid), fmt::format("value-{}", i * 4 + tid));
+        }
+      });
+    }
+    for (auto &t : threads) {
+      t.join();
+    }
+  }
+  ASSERT_TRUE(std::filesystem::exists(directory + "/snapshot"));
+  {
+    auto store = TrieStore(directory, 100, false);
+    for (uint32_t i = 0; i < 4000; i++) {
+      ASSERT_EQ(**store.Get<std::string>(fmt::format("{:#05}", i)), fmt::format("value-{}", i));
+    }
+  }
+  std::filesystem::remove_all(directory);
+}
+
+TEST(TrieStoreTest, DurableCheckpointFailureTest) {
+  const std::string directory = "trie_store_durable_checkpoint_failure";
+  std::filesystem::remove_all(directory);
+  {
+    auto store = TrieStore(directory, 10, false);
+    // Checkpoints cannot create files any more, but the open log segment still takes the writes.
+    std::filesystem::remove_all(directory);
+    for (uint32_t i = 0; i < 100; i++) {
+      store.Put<uint32_t>(fmt::format("{:#05}", i), i);
+    }
+    for (uint32_t i = 0; i < 100; i++) {
+      ASSERT_EQ(**store.Get<uint32_t>(fmt::format("{:#05}", i)), i);
+    }
+  }
+  std::filesystem::remove_all(directory);
+}
+
 }  // namespace bustub
@@ -9,6 +9,7 @@
 #include "common/exception.h"
 #include "gtest/gtest.h"
 #include "primer/trie.h"
+#include "primer/write_batch.h"
 
 namespace bustub {
 
@@ -250,4 +251,187 @@ TEST(TrieTest, PointerStability) {
   ASSERT_EQ(reinterpret_cast<uint64_t>(ptr_before), reinterpret_cast<uint64_t>(ptr_after));
 }
 
+TEST(TrieTest, WideFanoutTest) {
+  // Grow the root through every child layout and back, checking all children after each step.
+  auto trie = Trie();
+  std::vector<Trie> versions;
+  for (int c = 0; c < 256; c++) {
+    trie = trie.Put<uint32_t>(std::string(1, static_cast<char>(c)), c);
+    versions.push_back(trie);
+  }
+  for (int c = 0; c < 256; c++) {
+    ASSERT_EQ(*trie.Get<uint32_t>(std::string(1, static_cast<char>(c))), c);
+  }
+  for (int c = 0; c < 256; c += 2) {
+    trie = trie.Remove(std::string(1, static_cast<char>(c)));
+  }
+  for (int c = 1; c < 250; c += 2) {
+    trie = trie.Remove(std::string(1, static_cast<char>(c)));
+  }
+  for (int c = 0; c < 256; c++) {
+    auto *value = trie.Get<uint32_t>(std::string(1, static_cast<char>(c)));
+    if (c >= 250 && c % 2 == 1) {
+      ASSERT_EQ(*value, c);
+    } else {
+      ASSERT_EQ(value, nullptr);
+    }
+  }
+  // Down to a single child, which is kept inline, and then to none.
+  trie = trie.Remove(std::string(1, static_cast<char>(251)));
+  trie = trie.Remove(std::string(1, static_cast<char>(253)));
+  ASSERT_EQ(*trie.Get<uint32_t>(std::string(1, static_cast<char>(255))), 255);
+  ASSERT_EQ(trie.Get<uint32_t>(std::string(1, static_cast<char>(253))), nullptr);
+  trie = trie.Remove(std::string(1, static_cast<char>(255)));
+  ASSERT_EQ(trie.Get<uint32_t>(std::string(1, static_cast<char>(255))), nullptr);
+  // Older versions are untouched.
+  for (int v = 0; v < 256; v++) {
+    for (int c = 0; c < 256; c++) {
+      auto *value = versions[v].Get<uint32_t>(std::string(1, static_cast<char>(c)));
+      if (c <= v) {
+        ASSERT_EQ(*value, c);
+      } else {
+        ASSERT_EQ(value, nullptr);
+      }
+    }
+  }
+}
+
+TEST(TrieTest, RemovePrunesEmptyNodes) {
+  auto trie = Trie();
+  trie = trie.Put<uint32_t>("test", 2333);
+  trie = trie.Put<uint32_t>("team", 23);
+  trie = trie.Remove("test");
+  trie = trie.Remove("team");
+  ASSERT_EQ(trie.Get<uint32_t>("test"), nullptr);
+  ASSERT_EQ(trie.Get<uint32_t>("team"), nullptr);
+  trie = trie.Put<uint32_t>("te", 23);
+  ASSERT_EQ(*trie.Get<uint32_t>("te"), 23);
+}
+
+TEST(TrieTest, ScanPrefixTest) {
+  auto trie = Trie();
+  trie = trie.Put<uint32_t>("test", 1);
+  trie = trie.Put<uint32_t>("te", 2);
+  trie = trie.Put<std::string>("tea", "skipped");
+  trie = trie.Put<uint32_t>("team", 3);
+  trie = trie.Put<uint32_t>("toast", 4);
+  trie = trie.Put<uint32_t>("", 5);
+
+  std::vector<std::pair<std::string, uint32_t>> result;
+  for (auto iter = trie.ScanPrefix<uint32_t>("te"); !iter.IsEnd(); ++iter) {
+    result.emplace_back(iter.Key(), iter.Value());
+  }
+  std::vector<std::pair<std::string, uint32_t>> expected{{"te", 2}, {"team", 3}, {"test", 1}};
+  ASSERT_EQ(result, expected);
+
+  result.clear();
+  for (auto iter = trie.ScanPrefix<uint32_t>(""); !iter.IsEnd(); ++iter) {
+    result.emplace_back(iter.Key(), iter.Value());
+  }
+  expected = {{"", 5}, {"te", 2}, {"team", 3}, {"test", 1}, {"toast", 4}};
+  ASSERT_EQ(result, expected);
+
+  ASSERT_TRUE(trie.ScanPrefix<uint32_t>("x").IsEnd());
+  ASSERT_TRUE(trie.ScanPrefix<uint32_t>("tests").IsEnd());
+  ASSERT_TRUE(Trie().ScanPrefix<uint32_t>("").IsEnd());
+}
+
+TEST(TrieTest, RangeTest) {
+  auto trie = Trie();
+  for (uint32_t i = 0; i < 1000; i += 3) {
+    trie = trie.Put<uint32_t>(fmt::format("{:#05}", i), i);
+  }
+  auto check = [&trie](const std::string &lo, const std::string &hi) {
+    std::vector<uint32_t> result;
+    for (auto iter = trie.Range<uint32_t>(lo, hi); !iter.IsEnd(); ++iter) {
+      ASSERT_EQ(iter.Key(), fmt::format("{:#05}", iter.Value()));
+      result.push_back(iter.Value());
+    }
+    std::vector<uint32_t> expected;
+    for (uint32_t i = 0; i < 1000; i += 3) {
+      auto key = fmt::format("{:#05}", i);
+      if (lo <= key && key < hi) {
+        expected.push_back(i);
+      }
+    }
+    ASSERT_EQ(result, expected);
+  };
+  check("00100", "00200");
+  check("00101", "00199");
+  check("001", "002");
+  check("", "~");
+  check("00500", "00500");
+  check("00900", "00100");
+  check("0099", "01");
+}
+
+TEST(TrieTest, ApplyBatchTest) {
+  auto trie = Trie();
+  trie = trie.Put<uint32_t>("te", 1);
+  trie = trie.Put<uint32_t>("test", 2);
+  trie = trie.Put<std::string>("tea", "3");
+
+  WriteBatch batch;
+  batch.Put<uint32_t>("team", 4);
+  batch.Put<uint32_t>("t", 5);
+  batch.Remove("test");
+  batch.Put<std::string>("te", "6");
+  batch.Put<uint32_t>("", 7);
+  batch.Remove("missing");
+  batch.Put<uint32_t>("tea", 8);
+  batch.Remove("tea");
+  batch.Put<uint32_t>("tea", 9);
+  auto new_trie = trie.Apply(batch);
+
+  ASSERT_EQ(*new_trie.Get<uint32_t>("team"), 4);
+  ASSERT_EQ(*new_trie.Get<uint32_t>("t"), 5);
+  ASSERT_EQ(new_trie.Get<uint32_t>("test"), nullptr);
+  ASSERT_EQ(*new_trie.Get<std::string>("te"), "6");
+  ASSERT_EQ(*new_trie.Get<uint32_t>(""), 7);
+  ASSERT_EQ(*new_trie.Get<uint32_t>("tea"), 9);
+
+  // The old version is unchanged.
+  ASSERT_EQ(*trie.Get<uint32_t>("te"), 1);
+  ASSERT_EQ(*trie.Get<uint32_t>("test"), 2);
+  ASSERT_EQ(*trie.Get<std::string>("tea"), "3");
+  ASSERT_EQ(trie.Get<uint32_t>("team"), nullptr);
+
+  // Removing everything leaves an empty trie.
+  WriteBatch remove_all;
+  for (const auto *key : {"", "t", "te", "tea", "team"}) {
+    remove_all.Remove(key);
+  }
+  ASSERT_TRUE(new_trie.Apply(remove_all).ScanPrefix<uint32_t>("").IsEnd());
+  ASSERT_TRUE(new_trie.Apply(remove_all).ScanPrefix<std::string>("").IsEnd());
+}
+
+TEST(TrieTest, ApplyMatchesSequentialWrites) {
+  std::mt19937 gen(2333);
+  std::uniform_int_distribution<uint32_t> key_dist(0, 2000);
+  auto trie = Trie();
+  for (int round = 0; round < 10; round++) {
+    WriteBatch batch;
+    auto expected = trie;
+    for (int i = 0; i < 1000; i++) {
+      auto key = fmt::format("{}", key_dist(gen));
+      if (i % 3 == 0) {
+        batch.Remove(key);
+        expected = expected.Remove(key);
+      } else {
+        batch.Put<uint32_t>(key, i);
+        expected = expected.Put<uint32_t>(key, i);
+      }
+    }
+    trie = trie.Apply(batch);
+    auto actual_it = trie.ScanPrefix<uint32_t>("");
+    auto expected_it = expected.ScanPrefix<uint32_t>("");
+    for (; !expected_it.IsEnd(); ++expected_it, ++actual_it) {
+      ASSERT_FALSE(actual_it.IsEnd());
+      ASSERT_EQ(actual_it.Key(), expected_it.Key());
+      ASSERT_EQ(actual_it.Value(), expected_it.Value());
+    }
+    ASSERT_TRUE(actual_it.IsEnd());
+  }
+}
+
 }  // namespace bustub
@@ -0,0 +1,53 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// generic_key_test.cpp
+//
+// Identification: test/storage/generic_key_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "catalog/schema.h"
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(GenericComparatorTest, CompareColumns) {
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 8}});
+  GenericComparator<32> comparator(&schema);
+  auto make_key = [&](const Value &a, const Value &b) {
+    GenericKey<32> key;
+    key.SetFromKey(Tuple({a, b}, &schema));
+    return key;
+  };
+  auto null_integer = ValueFactory::GetNullValueByType(TypeId::INTEGER);
+  auto null_varchar = ValueFactory::GetNullValueByType(TypeId::VARCHAR);
+
+  // Ordered keys, compared with each of the others.
+  std::vector<GenericKey<32>> keys{
+      make_key(ValueFactory::GetIntegerValue(-7), ValueFactory::GetVarcharValue("b")),
+      make_key(ValueFactory::GetIntegerValue(0), ValueFactory::GetVarcharValue("")),
+      make_key(ValueFactory::GetIntegerValue(0), ValueFactory::GetVarcharValue("ab")),
+      make_key(ValueFactory::GetIntegerValue(0), ValueFactory::GetVarcharValue("abc")),
+      make_key(ValueFactory::GetIntegerValue(0), ValueFactory::GetVarcharValue("b")),
+      make_key(ValueFactory::GetIntegerValue(0), null_varchar),
+      make_key(ValueFactory::GetIntegerValue(12), ValueFactory::GetVarcharValue("a")),
+      make_key(null_integer, ValueFactory::GetVarcharValue("a")),
+  };
+  for (size_t i = 0; i < keys.size(); i++) {
+    for (size_t j = 0; j < keys.size(); j++) {
+      auto expected = i < j ? -1 : (i > j ? 1 : 0);
+      EXPECT_EQ(expected, comparator(keys[i], keys[j])) << i << " vs " << j;
+    }
+  }
+  EXPECT_EQ(0, comparator(make_key(ValueFactory::GetIntegerValue(3), ValueFactory::GetVarcharValue("x")),
+                          make_key(ValueFactory::GetIntegerValue(3), ValueFactory::GetVarcharValue("x"))));
+}
+
+}  // namespace bustub
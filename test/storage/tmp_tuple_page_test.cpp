@@ -10,20 +10,22 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <memory>
+#include <string>
 #include <vector>
 
+#include "buffer/buffer_pool_manager.h"
+#include "common/exception.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tmp_tuple_file.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(TmpTuplePageTest, DISABLED_BasicTest) {
-  // There are many ways to do this assignment, and this is only one of them.
-  // If you don't like the TmpTuplePage idea, please feel free to delete this test case entirely.
-  // You will get full credit as long as you are correctly using a linear probe hash table.
-
+TEST(TmpTuplePageTest, BasicTest) {
   TmpTuplePage page{};
   page_id_t page_id = 15445;
   page.Init(page_id, BUSTUB_PAGE_SIZE);
@@ -46,6 +48,63 @@ TEST(TmpTuplePageTest, DISABLED_BasicTest) {
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + sizeof(page_id_t) + sizeof(lsn_t)), BUSTUB_PAGE_SIZE - 8);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + BUSTUB_PAGE_SIZE - 8), 4);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + BUSTUB_PAGE_SIZE - 4), 123);
+  ASSERT_EQ(tmp_tuple.GetPageId(), page_id);
+  ASSERT_EQ(tmp_tuple.GetOffset(), BUSTUB_PAGE_SIZE - 8);
+
+  // Fill the page up, then read every tuple back from where it was stored.
+  std::vector<TmpTuple> stored{tmp_tuple};
+  for (int i = 1;; i++) {
+    Tuple next({ValueFactory::GetIntegerValue(123 + i)}, &schema);
+    if (!page.Insert(next, &tmp_tuple)) {
+      break;
+    }
+    stored.push_back(tmp_tuple);
+  }
+  ASSERT_EQ(stored.size(), (BUSTUB_PAGE_SIZE - TmpTuplePage::HEADER_SIZE) / 8);
+  for (size_t i = 0; i < stored.size(); i++) {
+    page.Get(stored[i].GetOffset(), &tuple);
+    ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), static_cast<int32_t>(123 + i));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TmpTuplePageTest, TmpTupleFileTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(4, disk_manager.get());
+  Schema schema({Column{"id", TypeId::INTEGER}, Column{"payload", TypeId::VARCHAR, 64}});
+  auto make_tuple = [&](int i) {
+    return Tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(i % 50, 'x'))}, &schema);
+  };
+
+  // Far more pages than frames are written, and none stays pinned.
+  const int num_tuples = 10000;
+  auto file = std::make_unique<TmpTupleFile>(bpm.get());
+  for (int i = 0; i < num_tuples; i++) {
+    file->Append(make_tuple(i));
+  }
+  ASSERT_EQ(file->NumTuples(), static_cast<size_t>(num_tuples));
+  ASSERT_GT(file->NumPages(), bpm->GetPoolSize());
+
+  // The tuples are read back in order, as often as needed.
+  for (int round = 0; round < 2; round++) {
+    TmpTupleFile::Reader reader(file.get());
+    Tuple tuple;
+    for (int i = 0; i < num_tuples; i++) {
+      ASSERT_TRUE(reader.Next(&tuple));
+      ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), i);
+      ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), std::string(i % 50, 'x'));
+    }
+    ASSERT_FALSE(reader.Next(&tuple));
+  }
+
+  // A tuple larger than a page cannot be spilled.
+  Schema large_schema({Column{"payload", TypeId::VARCHAR, BUSTUB_PAGE_SIZE}});
+  Tuple large({ValueFactory::GetVarcharValue(std::string(BUSTUB_PAGE_SIZE, 'x'))}, &large_schema);
+  ASSERT_THROW(file->Append(large), Exception);
+
+  file.reset();
+  page_id_t page_id;
+  ASSERT_NE(bpm->NewPage(&page_id), nullptr);
 }
 
 }  // namespace bustub
@@ -0,0 +1,879 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_heap_test.cpp
+//
+// Identification: test/table/table_heap_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <unordered_set>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/exception.h"
+#include "fmt/format.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/free_space_map.h"
+#include "storage/page/compressed_page.h"
+#include "storage/page/pax_page.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/toast_store.h"
+#include "storage/table/vacuum_worker.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+static auto MakeTuple(const Schema &schema, int32_t id) -> Tuple {
+  std::vector<Value> values{ValueFactory::GetIntegerValue(id),
+                            ValueFactory::GetVarcharValue(std::string(40 + id % 20, 'x'))};
+  return {values, &schema};
+}
+
+static auto CountPages(BufferPoolManager *bpm, const TableHeap &table) -> size_t {
+  size_t num_pages = 0;
+  for (auto page_id = table.GetFirstPageId(); page_id != INVALID_PAGE_ID; num_pages++) {
+    auto guard = bpm->FetchPageRead(page_id);
+    page_id = guard.As<TablePage>()->GetNextPageId();
+  }
+  return num_pages;
+}
+
+static auto CountLiveTuples(TableHeap *table) -> size_t {
+  size_t num_tuples = 0;
+  for (auto iter = table->MakeIterator(); !iter.IsEnd(); ++iter) {
+    if (!iter.GetTuple().first.is_deleted_) {
+      num_tuples++;
+    }
+  }
+  return num_tuples;
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, FreeSpaceMapTest) {
+  FreeSpaceMap map;
+  ASSERT_EQ(map.FindPage(10, 0), INVALID_PAGE_ID);
+  for (page_id_t page_id = 0; page_id < 100; page_id++) {
+    map.AddPage(page_id, 0);
+  }
+  ASSERT_EQ(map.FindPage(10, 0), INVALID_PAGE_ID);
+
+  map.Update(20, 100);
+  map.Update(70, 1000);
+  ASSERT_EQ(map.GetFreeSpace(20), 96);
+  ASSERT_EQ(map.FindPage(10, 0), 20);
+  ASSERT_EQ(map.FindPage(10, 30), 70);
+  // The search wraps around.
+  ASSERT_EQ(map.FindPage(10, 80), 20);
+  ASSERT_EQ(map.FindPage(500, 0), 70);
+  // Free space is rounded down, so a page is never reported to have more room than it has.
+  ASSERT_EQ(map.FindPage(100, 0), 70);
+  ASSERT_EQ(map.FindPage(2000, 0), INVALID_PAGE_ID);
+
+  map.Update(70, 0);
+  ASSERT_EQ(map.FindPage(500, 0), INVALID_PAGE_ID);
+  ASSERT_EQ(map.GetNumPages(), 100);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, ReuseDeletedSpaceTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  auto table = std::make_unique<TableHeap>(bpm.get());
+  Schema schema({Column{"id", TypeId::INTEGER}, Column{"payload", TypeId::VARCHAR, 64}});
+
+  const int num_tuples = 1000;
+  std::vector<RID> rids;
+  for (int i = 0; i < num_tuples; i++) {
+    rids.push_back(*table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, MakeTuple(schema, i)));
+  }
+  auto num_pages = CountPages(bpm.get(), *table);
+
+  // Delete and reinsert everything a few times. The space and slots of the deleted tuples are reused, so the table
+  // does not grow.
+  for (int round = 0; round < 5; round++) {
+    for (auto rid : rids) {
+      table->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rid);
+    }
+    rids.clear();
+    for (int i = 0; i < num_tuples; i++) {
+      rids.push_back(*table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, MakeTuple(schema, i)));
+    }
+    ASSERT_LE(CountPages(bpm.get(), *table), num_pages + 1);
+  }
+
+  ASSERT_EQ(CountLiveTuples(table.get()), num_tuples);
+  for (int i = 0; i < num_tuples; i++) {
+    auto [meta, tuple] = table->GetTuple(rids[i]);
+    ASSERT_FALSE(meta.is_deleted_);
+    ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), i);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, VacuumTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  auto table = std::make_unique<TableHeap>(bpm.get());
+  Schema schema({Column{"id", TypeId::INTEGER}, Column{"payload", TypeId::VARCHAR, 64}});
+
+  const int num_tuples = 1000;
+  std::vector<RID> rids;
+  for (int i = 0; i < num_tuples; i++) {
+    rids.push_back(*table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, MakeTuple(schema, i)));
+  }
+  ASSERT_EQ(table->Vacuum(), 0);
+
+  // Delete every other tuple, and one more whose delete is still in progress, which must not be reclaimed.
+  for (int i = 0; i < num_tuples; i += 2) {
+    table->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[i]);
+  }
+  table->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, 1, true}, rids[1]);
+  {
+    auto guard = bpm->FetchPageRead(rids[0].GetPageId());
+    ASSERT_NEAR(guard.As<TablePage>()->GetDeadTupleRatio(), 0.5, 0.05);
+  }
+
+  // Nothing reaches a higher ratio than 0.5.
+  ASSERT_EQ(table->Vacuum(0.9), 0);
+  ASSERT_GT(table->Vacuum(), 0);
+  ASSERT_EQ(table->Vacuum(), 0);
+  {
+    auto guard = bpm->FetchPageRead(rids[0].GetPageId());
+    ASSERT_EQ(guard.As<TablePage>()->GetDeadTupleRatio(), 0);
+    ASSERT_EQ(guard.As<TablePage>()->GetReclaimableSpace(), 0);
+  }
+
+  // Live tuples keep their RIDs and data.
+  for (int i = 1; i < num_tuples; i += 2) {
+    auto [meta, tuple] = table->GetTuple(rids[i]);
+    ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), i);
+    ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), std::string(40 + i % 20, 'x'));
+  }
+
+  // Once everything is dead, the slots at the end of each page are trimmed too.
+  table->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[1]);
+  for (int i = 1; i < num_tuples; i += 2) {
+    table->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[i]);
+  }
+  ASSERT_GT(table->Vacuum(), 0);
+  size_t num_slots = 0;
+  for (auto iter = table->MakeIterator(); !iter.IsEnd(); ++iter) {
+    num_slots++;
+  }
+  ASSERT_EQ(num_slots, 0);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, BackgroundVacuumTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  auto table = std::make_unique<TableHeap>(bpm.get());
+  auto clean_table = std::make_unique<TableHeap>(bpm.get());
+  Schema schema({Column{"id", TypeId::INTEGER}, Column{"payload", TypeId::VARCHAR, 64}});
+  auto worker = std::make_unique<VacuumWorker>(std::chrono::milliseconds(10));
+  worker->AddTable(table.get());
+  worker->AddTable(clean_table.get());
+
+  std::vector<RID> rids;
+  for (int i = 0; i < 1000; i++) {
+    rids.push_back(*table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, MakeTuple(schema, i)));
+    clean_table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, MakeTuple(schema, i));
+  }
+  ASSERT_FALSE(clean_table->NeedsVacuum());
+  for (auto rid : rids) {
+    table->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rid);
+  }
+  for (int i = 0; i < 500 && table->GetNumDeadTuples() > 0; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  worker.reset();
+  ASSERT_EQ(table->GetNumDeadTuples(), 0);
+  auto guard = bpm->FetchPageRead(rids[0].GetPageId());
+  ASSERT_EQ(guard.As<TablePage>()->GetReclaimableSpace(), 0);
+  guard.Drop();
+  ASSERT_FALSE(table->NeedsVacuum());
+  ASSERT_FALSE(clean_table->NeedsVacuum());
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, NeedsVacuumTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  auto table = std::make_unique<TableHeap>(bpm.get());
+  Schema schema({Column{"id", TypeId::INTEGER}, Column{"payload", TypeId::VARCHAR, 64}});
+  std::vector<RID> rids;
+  for (int i = 0; i < 100; i++) {
+    rids.push_back(*table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, MakeTuple(schema, i)));
+  }
+  ASSERT_FALSE(table->NeedsVacuum());
+
+  // A page below the dead ratio keeps its dead tuples, and the table needs no vacuum until more of them die.
+  table->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[0]);
+  ASSERT_EQ(table->GetNumDeadTuples(), 1);
+  ASSERT_TRUE(table->NeedsVacuum());
+  ASSERT_EQ(table->Vacuum(), 0);
+  ASSERT_EQ(table->GetNumDeadTuples(), 1);
+  ASSERT_FALSE(table->NeedsVacuum());
+
+  for (int i = 1; i < 50; i++) {
+    table->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[i]);
+  }
+  ASSERT_EQ(table->GetNumDeadTuples(), 50);
+  ASSERT_TRUE(table->NeedsVacuum());
+  ASSERT_GT(table->Vacuum(), 0);
+  ASSERT_LT(table->GetNumDeadTuples(), 50);
+  ASSERT_FALSE(table->NeedsVacuum());
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, BoundedScanAppendsTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  auto table = std::make_unique<TableHeap>(bpm.get());
+  Schema schema({Column{"id", TypeId::INTEGER}, Column{"payload", TypeId::VARCHAR, 64}});
+
+  for (int i = 0; i < 500; i++) {
+    table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, MakeTuple(schema, i));
+  }
+
+  // Delete and reinsert every tuple while scanning, like an update does. Even though the deleted space could be
+  // reused, the scan must never see the reinserted tuples.
+  size_t num_scanned = 0;
+  for (auto iter = table->MakeIterator(); !iter.IsEnd(); ++iter) {
+    auto [meta, tuple] = iter.GetTuple();
+    if (meta.is_deleted_) {
+      continue;
+    }
+    num_scanned++;
+    table->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, iter.GetRID());
+    table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple);
+  }
+  ASSERT_EQ(num_scanned, 500);
+  ASSERT_EQ(CountLiveTuples(table.get()), 500);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, ConcurrentInsertTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(256, disk_manager.get());
+  auto table = std::make_unique<TableHeap>(bpm.get());
+  Schema schema({Column{"id", TypeId::INTEGER}, Column{"payload", TypeId::VARCHAR, 64}});
+
+  const int num_threads = 8;
+  const int num_tuples = 1000;
+  std::vector<std::vector<RID>> rids(num_threads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < num_tuples; i++) {
+        auto tuple = MakeTuple(schema, t * num_tuples + i);
+        rids[t].push_back(*table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::unordered_set<RID> unique_rids;
+  for (int t = 0; t < num_threads; t++) {
+    for (int i = 0; i < num_tuples; i++) {
+      unique_rids.insert(rids[t][i]);
+      ASSERT_EQ(table->GetTuple(rids[t][i]).second.GetValue(&schema, 0).GetAs<int32_t>(), t * num_tuples + i);
+    }
+  }
+  ASSERT_EQ(unique_rids.size(), num_threads * num_tuples);
+  ASSERT_EQ(CountLiveTuples(table.get()), num_threads * num_tuples);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, BatchScanTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  auto table = std::make_unique<TableHeap>(bpm.get());
+  Schema schema({Column{"id", TypeId::INTEGER}, Column{"payload", TypeId::VARCHAR, 64}});
+
+  const int num_tuples = 1000;
+  std::vector<RID> rids;
+  for (int i = 0; i < num_tuples; i++) {
+    rids.push_back(*table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, MakeTuple(schema, i)));
+  }
+  for (int i = 0; i < num_tuples; i += 3) {
+    table->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[i]);
+  }
+
+  // A batch scan returns the same tuples as a tuple-at-a-time scan, one page per batch.
+  TupleViewBatch batch;
+  {
+    std::vector<RID> scanned;
+    Tuple tuple;
+    auto iter = table->MakeIterator();
+    while (iter.NextBatch(&batch)) {
+      ASSERT_GT(batch.Size(), 0);
+      for (size_t i = 0; i < batch.Size(); i++) {
+        auto id = static_cast<int32_t>(scanned.size());
+        ASSERT_EQ(batch[i].rid_, rids[id]);
+        ASSERT_EQ(batch[i].rid_.GetPageId(), batch[0].rid_.GetPageId());
+        ASSERT_EQ(batch[i].meta_.is_deleted_, id % 3 == 0);
+        tuple.CopyFrom(batch[i]);
+        ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), id);
+        ASSERT_EQ(tuple.GetRid(), batch[i].rid_);
+        scanned.push_back(batch[i].rid_);
+      }
+    }
+    ASSERT_EQ(batch.Size(), 0);
+    ASSERT_EQ(scanned.size(), num_tuples);
+  }
+
+  // Tuples inserted after the iterator was created are not returned.
+  {
+    auto iter = table->MakeIterator();
+    table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, MakeTuple(schema, num_tuples));
+    size_t num_scanned = 0;
+    while (iter.NextBatch(&batch)) {
+      num_scanned += batch.Size();
+    }
+    ASSERT_EQ(num_scanned, num_tuples);
+  }
+
+  // Pages emptied and trimmed by vacuum are skipped, even at the start of the table.
+  for (int i = 0; i < num_tuples / 2; i++) {
+    table->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[i]);
+  }
+  ASSERT_GT(table->Vacuum(), 0);
+  {
+    auto guard = bpm->FetchPageRead(table->GetFirstPageId());
+    ASSERT_EQ(guard.As<TablePage>()->GetNumTuples(), 0);
+  }
+  size_t num_live = 0;
+  auto iter = table->MakeIterator();
+  while (iter.NextBatch(&batch)) {
+    for (size_t i = 0; i < batch.Size(); i++) {
+      num_live += batch[i].meta_.is_deleted_ ? 0 : 1;
+    }
+  }
+  ASSERT_GT(num_live, 0);
+  ASSERT_EQ(num_live, CountLiveTuples(table.get()));
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, PaxTableTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  Schema schema({Column{"id", TypeId::INTEGER}, Column{"payload", TypeId::VARCHAR, 64},
+                 Column{"big", TypeId::BIGINT}, Column{"flag", TypeId::BOOLEAN}});
+  auto table = std::make_unique<TableHeap>(bpm.get(), schema, TableLayout::PAX);
+  ASSERT_NE(table->GetPaxLayout(), nullptr);
+
+  auto make_tuple = [&](int32_t id) -> Tuple {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(id),
+                              id % 7 == 0 ? ValueFactory::GetNullValueByType(TypeId::VARCHAR)
+                                          : ValueFactory::GetVarcharValue(std::string(id % 30, 'a' + id % 26)),
+                              id % 5 == 0 ? ValueFactory::GetNullValueByType(TypeId::BIGINT)
+                                          : ValueFactory::GetBigIntValue(static_cast<int64_t>(id) * 1000),
+                              ValueFactory::GetBooleanValue(id % 2 == 0)};
+    return {values, &schema};
+  };
+
+  const int num_tuples = 2000;
+  std::vector<RID> rids;
+  for (int i = 0; i < num_tuples; i++) {
+    rids.push_back(*table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, make_tuple(i)));
+  }
+  ASSERT_GT(CountPages(bpm.get(), *table), 1);
+  for (int i = 0; i < num_tuples; i += 10) {
+    table->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[i]);
+  }
+  // PAX pages are never compacted.
+  ASSERT_EQ(table->Vacuum(), 0);
+
+  // Tuples read back are the same as the ones inserted.
+  for (int i = 0; i < num_tuples; i++) {
+    auto [meta, tuple] = table->GetTuple(rids[i]);
+    ASSERT_EQ(meta.is_deleted_, i % 10 == 0);
+    auto expected = make_tuple(i);
+    ASSERT_EQ(tuple.GetLength(), expected.GetLength());
+    ASSERT_EQ(memcmp(tuple.GetData(), expected.GetData(), tuple.GetLength()), 0);
+  }
+  ASSERT_EQ(CountLiveTuples(table.get()), num_tuples - num_tuples / 10);
+
+  // A batch scan of some columns leaves the others NULL.
+  std::vector<uint32_t> column_ids{1, 2};
+  TupleViewBatch batch;
+  Tuple tuple;
+  int num_scanned = 0;
+  auto iter = table->MakeIterator();
+  while (iter.NextBatch(&batch, &column_ids)) {
+    for (size_t i = 0; i < batch.Size(); i++, num_scanned++) {
+      tuple.CopyFrom(batch[i]);
+      ASSERT_EQ(batch[i].rid_, rids[num_scanned]);
+      ASSERT_TRUE(tuple.IsNull(&schema, 0));
+      ASSERT_TRUE(tuple.IsNull(&schema, 3));
+      auto payload = tuple.GetValue(&schema, 1);
+      ASSERT_EQ(payload.IsNull(), num_scanned % 7 == 0);
+      if (!payload.IsNull()) {
+        ASSERT_EQ(payload.ToString(), std::string(num_scanned % 30, 'a' + num_scanned % 26));
+      }
+      ASSERT_EQ(tuple.IsNull(&schema, 2), num_scanned % 5 == 0);
+    }
+  }
+  ASSERT_EQ(num_scanned, num_tuples);
+
+  // Every page knows the range of its values and which of them are NULL.
+  for (auto page_id = table->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    auto guard = bpm->FetchPageRead(page_id);
+    auto page = guard.As<PaxPage>();
+    auto first_id = page->GetTuple(*table->GetPaxLayout(), RID{page_id, 0}).second.GetValue(&schema, 0);
+    auto [min, max] = *page->GetMinMax(*table->GetPaxLayout(), 0);
+    ASSERT_EQ(min.GetAs<int32_t>(), first_id.GetAs<int32_t>());
+    ASSERT_EQ(max.GetAs<int32_t>(), first_id.GetAs<int32_t>() + page->GetNumTuples() - 1);
+    ASSERT_FALSE(page->GetMinMax(*table->GetPaxLayout(), 1).has_value());
+    for (uint32_t slot = 0; slot < page->GetNumTuples(); slot++) {
+      ASSERT_EQ(page->IsNull(*table->GetPaxLayout(), 1, slot), (first_id.GetAs<int32_t>() + slot) % 7 == 0);
+    }
+    page_id = page->GetNextPageId();
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, ToastTest) {
+  Schema schema({Column{"id", TypeId::INTEGER}, Column{"doc", TypeId::VARCHAR, 100000},
+                 Column{"note", TypeId::VARCHAR, 32}});
+  // Large documents that compress well, large ones that do not, and small ones that stay in the tuple.
+  auto make_doc = [](int32_t id, char seed) {
+    if (id % 3 == 0) {
+      std::string doc;
+      while (doc.size() < 20000) {
+        doc += fmt::format("line {} of document {}{}\n", doc.size() % 100, id, seed);
+      }
+      return doc;
+    }
+    std::string doc(id % 3 == 1 ? 6000 : 50, ' ');
+    uint32_t state = id * 7919 + seed;
+    for (auto &c : doc) {
+      state = state * 1103515245 + 12345;
+      c = static_cast<char>('a' + (state >> 16) % 26);
+    }
+    return doc;
+  };
+  auto make_tuple = [&](int32_t id, char seed = 'x') -> Tuple {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(id), ValueFactory::GetVarcharValue(make_doc(id, seed)),
+                              ValueFactory::GetVarcharValue(fmt::format("note {}", id))};
+    return {values, &schema};
+  };
+
+  for (auto layout : {TableLayout::ROW, TableLayout::PAX}) {
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+    auto table = std::make_unique<TableHeap>(bpm.get(), schema, layout);
+
+    const int num_tuples = 30;
+    std::vector<RID> rids;
+    for (int i = 0; i < num_tuples; i++) {
+      rids.push_back(*table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, make_tuple(i)));
+    }
+    // Only pointers to the large values are in the table pages, so the pages fill up with rows rather than data.
+    auto num_pages = layout == TableLayout::ROW ? 1 : (num_tuples - 1) / table->GetPaxLayout()->GetCapacity() + 1;
+    ASSERT_EQ(CountPages(bpm.get(), *table), num_pages);
+
+    // Tuples read back have all of their values.
+    auto check_tuples = [&]() {
+      for (int i = 0; i < num_tuples; i++) {
+        auto [meta, tuple] = table->GetTuple(rids[i]);
+        auto expected = make_tuple(i);
+        ASSERT_EQ(tuple.GetLength(), expected.GetLength());
+        ASSERT_EQ(memcmp(tuple.GetData(), expected.GetData(), tuple.GetLength()), 0);
+        ASSERT_EQ(tuple.GetRid(), rids[i]);
+      }
+    };
+    check_tuples();
+
+    // A scan reads the large values of the columns it reads only.
+    TupleViewBatch batch;
+    std::vector<uint32_t> column_ids{0, 2};
+    for (auto *columns : {static_cast<std::vector<uint32_t> *>(nullptr), &column_ids}) {
+      int num_scanned = 0;
+      auto iter = table->MakeIterator();
+      while (iter.NextBatch(&batch, columns)) {
+        for (size_t i = 0; i < batch.Size(); i++, num_scanned++) {
+          TupleRef tuple = batch[i];
+          ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), num_scanned);
+          ASSERT_EQ(tuple.GetValue(&schema, 2).ToString(), fmt::format("note {}", num_scanned));
+          if (columns == nullptr || (layout == TableLayout::ROW && num_scanned % 3 == 2)) {
+            ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), make_doc(num_scanned, 'x'));
+          } else if (layout == TableLayout::ROW) {
+            ASSERT_THROW(tuple.GetValue(&schema, 1), Exception);
+          } else {
+            ASSERT_TRUE(tuple.IsNull(&schema, 1));
+          }
+        }
+      }
+      ASSERT_EQ(num_scanned, num_tuples);
+    }
+
+    // Overwriting a large value releases the old one, and deleting a tuple releases all of them. Their overflow
+    // pages are deleted by the next vacuum.
+    auto updated = make_tuple(0, 'y');
+    table->UpdateTupleInPlaceUnsafe(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, updated, rids[0]);
+    auto [meta, tuple] = table->GetTuple(rids[0]);
+    ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), make_doc(0, 'y'));
+    // The old document compressed into a single page.
+    ASSERT_EQ(table->Vacuum(), BUSTUB_PAGE_SIZE);
+    ASSERT_EQ(table->Vacuum(), 0);
+
+    table->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[1]);
+    ASSERT_GE(table->Vacuum(), 2 * BUSTUB_PAGE_SIZE);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, CompressedTableTest) {
+  Schema schema({Column{"id", TypeId::INTEGER}, Column{"category", TypeId::INTEGER},
+                 Column{"city", TypeId::VARCHAR, 32}, Column{"note", TypeId::VARCHAR, 64},
+                 Column{"score", TypeId::BIGINT}});
+  const std::vector<std::string> cities{"Pittsburgh", "Seattle", "Boston", "Austin", "Denver"};
+  auto make_tuple = [&](int32_t id, const std::string &note) -> Tuple {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(id), ValueFactory::GetIntegerValue(id / 50),
+                              ValueFactory::GetVarcharValue(cities[id * 7 % cities.size()]),
+                              ValueFactory::GetVarcharValue(note),
+                              id % 11 == 0 ? ValueFactory::GetNullValueByType(TypeId::BIGINT)
+                                           : ValueFactory::GetBigIntValue(1000000 + id % 100)};
+    return {values, &schema};
+  };
+  auto make_note = [](int32_t id) { return fmt::format("note {}", id * 7919 % 10007); };
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  auto row_table = std::make_unique<TableHeap>(bpm.get(), schema, TableLayout::ROW);
+  auto table = std::make_unique<TableHeap>(bpm.get(), schema, TableLayout::COMPRESSED);
+  ASSERT_EQ(table->GetLayout(), TableLayout::COMPRESSED);
+
+  const int num_tuples = 3000;
+  std::vector<RID> rids;
+  for (int i = 0; i < num_tuples; i++) {
+    auto tuple = make_tuple(i, make_note(i));
+    row_table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple);
+    rids.push_back(*table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple));
+  }
+  ASSERT_LT(CountPages(bpm.get(), *table) * 3, CountPages(bpm.get(), *row_table) * 2);
+
+  // Each column of a full page is stored in the encoding that suits its values.
+  {
+    auto guard = bpm->FetchPageRead(table->GetFirstPageId());
+    auto page = guard.As<CompressedPage>();
+    ASSERT_GT(page->GetNumCompressedTuples(), 0);
+    ASSERT_EQ(page->GetEncoding(0), ColumnEncoding::FRAME_OF_REFERENCE);
+    ASSERT_EQ(page->GetEncoding(1), ColumnEncoding::RUN_LENGTH);
+    ASSERT_EQ(page->GetEncoding(2), ColumnEncoding::DICTIONARY);
+    ASSERT_EQ(page->GetEncoding(3), ColumnEncoding::PLAIN);
+  }
+
+  // Deletes and in-place updates of compressed tuples keep their RIDs.
+  for (int i = 0; i < num_tuples; i += 10) {
+    table->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[i]);
+  }
+  const std::string long_note = "a note that is a lot longer than the one before";
+  table->UpdateTupleInPlaceUnsafe(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, make_tuple(1, long_note), rids[1]);
+
+  auto check_tuples = [&]() {
+    for (int i = 0; i < num_tuples; i++) {
+      auto [meta, tuple] = table->GetTuple(rids[i]);
+      ASSERT_EQ(meta.is_deleted_, i % 10 == 0);
+      auto expected = make_tuple(i, i == 1 ? long_note : make_note(i));
+      ASSERT_EQ(tuple.GetLength(), expected.GetLength());
+      ASSERT_EQ(memcmp(tuple.GetData(), expected.GetData(), tuple.GetLength()), 0);
+    }
+    ASSERT_EQ(CountLiveTuples(table.get()), num_tuples - num_tuples / 10);
+  };
+  check_tuples();
+
+  // The vacuum compresses the tuples left in the tails of the pages.
+  ASSERT_GT(table->Vacuum(), 0);
+  for (auto page_id = table->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    auto guard = bpm->FetchPageRead(page_id);
+    auto page = guard.As<CompressedPage>();
+    ASSERT_EQ(page->GetNumCompressedTuples(), page->GetNumTuples());
+    page_id = page->GetNextPageId();
+  }
+  ASSERT_EQ(table->Vacuum(), 0);
+  check_tuples();
+
+  // A batch scan of some columns only decodes those, and leaves the others NULL.
+  std::vector<uint32_t> column_ids{0, 2};
+  TupleViewBatch batch;
+  int num_scanned = 0;
+  auto iter = table->MakeIterator();
+  while (iter.NextBatch(&batch, &column_ids)) {
+    for (size_t i = 0; i < batch.Size(); i++, num_scanned++) {
+      TupleRef tuple = batch[i];
+      ASSERT_EQ(batch[i].rid_, rids[num_scanned]);
+      ASSERT_EQ(batch[i].meta_.is_deleted_, num_scanned % 10 == 0);
+      ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), num_scanned);
+      ASSERT_EQ(tuple.GetValue(&schema, 2).ToString(), cities[num_scanned * 7 % cities.size()]);
+      ASSERT_TRUE(tuple.IsNull(&schema, 1));
+      ASSERT_TRUE(tuple.IsNull(&schema, 3));
+      ASSERT_TRUE(tuple.IsNull(&schema, 4));
+    }
+  }
+  ASSERT_EQ(num_scanned, num_tuples);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, ParallelScanTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  Schema schema({Column{"id", TypeId::INTEGER}, Column{"payload", TypeId::VARCHAR, 64}});
+  auto table = std::make_unique<TableHeap>(bpm.get(), schema, TableLayout::ROW);
+
+  const int num_tuples = 5000;
+  for (int i = 0; i < num_tuples; i++) {
+    table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, MakeTuple(schema, i));
+  }
+  ASSERT_EQ(table->GetNumPages(), CountPages(bpm.get(), *table));
+
+  // Workers take morsels until none are left; together they see every tuple exactly once.
+  auto scan = table->MakeParallelScan(3);
+  ASSERT_EQ(scan->GetNumPages(), table->GetNumPages());
+  const int num_workers = 4;
+  std::vector<std::vector<int32_t>> seen(num_workers);
+  std::vector<std::thread> workers;
+  for (int worker = 0; worker < num_workers; worker++) {
+    workers.emplace_back([&, worker]() {
+      TupleViewBatch batch;
+      while (auto iter = scan->NextMorsel()) {
+        // Half of the workers scan with batches, the others a tuple at a time.
+        if (worker % 2 == 0) {
+          while (iter->NextBatch(&batch)) {
+            for (size_t i = 0; i < batch.Size(); i++) {
+              seen[worker].push_back(TupleRef(batch[i]).GetValue(&schema, 0).GetAs<int32_t>());
+            }
+          }
+        } else {
+          for (; !iter->IsEnd(); ++*iter) {
+            seen[worker].push_back(iter->GetTuple().second.GetValue(&schema, 0).GetAs<int32_t>());
+          }
+        }
+      }
+    });
+  }
+  // Tuples inserted while the scan is open land behind it.
+  for (int i = num_tuples; i < num_tuples + 500; i++) {
+    table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, MakeTuple(schema, i));
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  std::vector<int32_t> all;
+  for (const auto &ids : seen) {
+    all.insert(all.end(), ids.begin(), ids.end());
+  }
+  std::sort(all.begin(), all.end());
+  ASSERT_EQ(all.size(), num_tuples);
+  for (int i = 0; i < num_tuples; i++) {
+    ASSERT_EQ(all[i], i);
+  }
+  ASSERT_FALSE(scan->NextMorsel().has_value());
+
+  // Any split of the pages covers the same tuples in order.
+  auto middle = scan->GetNumPages() / 2;
+  int32_t next_id = 0;
+  std::vector<std::pair<size_t, size_t>> ranges{{0, 0}, {0, middle}, {middle, scan->GetNumPages()}};
+  for (auto [begin, end] : ranges) {
+    for (auto iter = scan->MakeIterator(begin, end); !iter.IsEnd(); ++iter) {
+      ASSERT_EQ(iter.GetTuple().second.GetValue(&schema, 0).GetAs<int32_t>(), next_id++);
+    }
+  }
+  ASSERT_EQ(next_id, num_tuples);
+  scan.reset();
+  ASSERT_EQ(CountLiveTuples(table.get()), num_tuples + 500);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, BulkInsertTest) {
+  Schema schema({Column{"id", TypeId::INTEGER}, Column{"payload", TypeId::VARCHAR, 64}});
+  for (auto layout : {TableLayout::ROW, TableLayout::PAX, TableLayout::COMPRESSED}) {
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+    auto table = std::make_unique<TableHeap>(bpm.get(), schema, layout);
+
+    // A small batch is inserted tuple by tuple into the existing page.
+    std::vector<Tuple> tuples{MakeTuple(schema, 0), MakeTuple(schema, 1)};
+    auto rids = table->BulkInsert(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuples);
+    ASSERT_EQ(rids.size(), 2);
+    ASSERT_EQ(rids[0].GetPageId(), table->GetFirstPageId());
+    ASSERT_EQ(table->GetNumPages(), 1);
+
+    // A large one fills new pages, linked after the existing ones.
+    tuples.clear();
+    const int num_tuples = 3000;
+    for (int i = 2; i < num_tuples; i++) {
+      tuples.push_back(MakeTuple(schema, i));
+    }
+    auto bulk_rids = table->BulkInsert(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuples);
+    ASSERT_EQ(bulk_rids.size(), tuples.size());
+    ASSERT_NE(bulk_rids[0].GetPageId(), table->GetFirstPageId());
+    rids.insert(rids.end(), bulk_rids.begin(), bulk_rids.end());
+    ASSERT_EQ(table->GetNumPages(), CountPages(bpm.get(), *table));
+
+    // A scan sees the tuples in the order they were inserted.
+    int32_t next_id = 0;
+    for (auto iter = table->MakeIterator(); !iter.IsEnd(); ++iter, next_id++) {
+      ASSERT_EQ(iter.GetRID(), rids[next_id]);
+      auto expected = MakeTuple(schema, next_id);
+      auto tuple = iter.GetTuple().second;
+      ASSERT_EQ(tuple.GetLength(), expected.GetLength());
+      ASSERT_EQ(memcmp(tuple.GetData(), expected.GetData(), tuple.GetLength()), 0);
+    }
+    ASSERT_EQ(next_id, num_tuples);
+
+    // The new pages take later inserts like any other page.
+    table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, MakeTuple(schema, num_tuples));
+    ASSERT_EQ(CountLiveTuples(table.get()), num_tuples + 1);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, ConcurrentBulkInsertTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(256, disk_manager.get());
+  auto table = std::make_unique<TableHeap>(bpm.get());
+  Schema schema({Column{"id", TypeId::INTEGER}, Column{"payload", TypeId::VARCHAR, 64}});
+
+  // A bulk insert allocates its pages before it links them, so single inserts appending pages in the meantime leave
+  // page ids out of order along the chain. Bounded scans started all along must still stop at their last page.
+  const int num_bulk_threads = 2;
+  const int num_batches = 10;
+  const int batch_size = 300;
+  const int num_insert_threads = 2;
+  const int num_inserts = 500;
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_bulk_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (int b = 0; b < num_batches; b++) {
+        std::vector<Tuple> tuples;
+        for (int i = 0; i < batch_size; i++) {
+          tuples.push_back(MakeTuple(schema, (t * num_batches + b) * batch_size + i));
+        }
+        table->BulkInsert(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuples);
+        // The last page is likely this batch's own, which may come after pages with larger ids.
+        ASSERT_GE(CountLiveTuples(table.get()), (b + 1) * batch_size);
+      }
+    });
+  }
+  for (int t = 0; t < num_insert_threads; t++) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < num_inserts; i++) {
+        table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, MakeTuple(schema, i));
+      }
+    });
+  }
+  std::thread scanner([&] {
+    size_t last_count = 0;
+    while (!done) {
+      auto count = CountLiveTuples(table.get());
+      ASSERT_GE(count, last_count);
+      last_count = count;
+    }
+  });
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  done = true;
+  scanner.join();
+
+  ASSERT_EQ(table->GetNumPages(), CountPages(bpm.get(), *table));
+  ASSERT_EQ(CountLiveTuples(table.get()),
+            num_bulk_threads * num_batches * batch_size + num_insert_threads * num_inserts);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, ZoneMapTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(64, disk_manager.get());
+  Schema schema({Column{"id", TypeId::INTEGER}, Column{"payload", TypeId::VARCHAR, 64}});
+  auto table = std::make_unique<TableHeap>(bpm.get(), schema, TableLayout::ROW);
+  const auto *zone_map = table->GetZoneMap();
+  ASSERT_TRUE(zone_map->IsTracked(0));
+  ASSERT_FALSE(zone_map->IsTracked(1));
+
+  const int num_tuples = 10000;
+  std::vector<RID> rids;
+  for (int i = 0; i < num_tuples; i++) {
+    rids.push_back(*table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, MakeTuple(schema, i)));
+  }
+  std::vector<Value> nulls{ValueFactory::GetNullValueByType(TypeId::INTEGER), ValueFactory::GetVarcharValue("")};
+  auto null_rid = *table->InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, Tuple{nulls, &schema});
+
+  // Ids are inserted in ascending order, so each page holds a narrow range of them.
+  auto first_zone = *zone_map->GetZone(rids[0].GetPageId(), 0);
+  ASSERT_EQ(first_zone.min_->GetAs<int32_t>(), 0);
+  auto first_page_tuples =
+      std::count_if(rids.begin(), rids.end(), [&](RID rid) { return rid.GetPageId() == rids[0].GetPageId(); });
+  ASSERT_EQ(first_zone.max_->GetAs<int32_t>(), first_page_tuples - 1);
+  ASSERT_EQ(first_zone.num_nulls_, 0);
+  auto last_zone = *zone_map->GetZone(null_rid.GetPageId(), 0);
+  ASSERT_EQ(last_zone.num_nulls_, 1);
+  ASSERT_EQ(last_zone.max_->GetAs<int32_t>(), num_tuples - 1);
+
+  // A scan for a range of ids only reads the pages that may hold them.
+  std::vector<ZoneBound> bounds{{0, ZoneBound::Op::GE, ValueFactory::GetIntegerValue(4000)},
+                                {0, ZoneBound::Op::LT, ValueFactory::GetIntegerValue(4100)}};
+  size_t num_batches = 0;
+  size_t num_matches = 0;
+  TupleViewBatch batch;
+  for (auto iter = table->MakeIterator(); iter.NextBatch(&batch, nullptr, &bounds);) {
+    num_batches++;
+    for (size_t i = 0; i < batch.Size(); i++) {
+      auto id = TupleRef{batch[i]}.GetValue(&schema, 0);
+      if (!id.IsNull() && id.GetAs<int32_t>() >= 4000 && id.GetAs<int32_t>() < 4100) {
+        num_matches++;
+      }
+    }
+  }
+  ASSERT_EQ(num_matches, 100);
+  ASSERT_LE(num_batches, 3);
+  ASSERT_LT(num_batches, table->GetNumPages());
+
+  // Nothing matches a bound outside of all zones, or a NULL bound.
+  std::vector<ZoneBound> none{{0, ZoneBound::Op::GT, ValueFactory::GetIntegerValue(num_tuples)}};
+  ASSERT_FALSE(table->MakeIterator().NextBatch(&batch, nullptr, &none));
+  none = {{0, ZoneBound::Op::EQ, ValueFactory::GetNullValueByType(TypeId::INTEGER)}};
+  ASSERT_FALSE(table->MakeIterator().NextBatch(&batch, nullptr, &none));
+
+  // A bound that NULLs satisfy as well still reads the page holding the NULL.
+  std::vector<ZoneBound> or_null{{0, ZoneBound::Op::GT, ValueFactory::GetIntegerValue(num_tuples), true}};
+  auto null_iter = table->MakeIterator();
+  ASSERT_TRUE(null_iter.NextBatch(&batch, nullptr, &or_null));
+  ASSERT_EQ(batch[0].rid_.GetPageId(), null_rid.GetPageId());
+  ASSERT_FALSE(null_iter.NextBatch(&batch, nullptr, &or_null));
+
+  // Deletes leave the zones as they are, until vacuum narrows them down to the live tuples.
+  auto page_id = rids[0].GetPageId();
+  for (size_t i = 0; i < rids.size() && rids[i].GetPageId() == page_id; i++) {
+    if (i >= 10) {
+      table->UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, rids[i]);
+    }
+  }
+  ASSERT_EQ(zone_map->GetZone(page_id, 0)->max_->GetAs<int32_t>(), first_zone.max_->GetAs<int32_t>());
+  ASSERT_GT(table->Vacuum(), 0);
+  auto vacuumed_zone = *zone_map->GetZone(page_id, 0);
+  ASSERT_EQ(vacuumed_zone.min_->GetAs<int32_t>(), 0);
+  ASSERT_EQ(vacuumed_zone.max_->GetAs<int32_t>(), 9);
+  ASSERT_EQ(vacuumed_zone.num_tuples_, 10);
+
+  // An update widens the zone again.
+  table->UpdateTupleInPlaceUnsafe(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, MakeTuple(schema, -20), rids[0]);
+  ASSERT_EQ(zone_map->GetZone(page_id, 0)->min_->GetAs<int32_t>(), -20);
+}
+
+}  // namespace bustub
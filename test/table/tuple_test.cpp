@@ -17,10 +17,14 @@
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
@@ -61,4 +65,35 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(TupleTest, TupleRefTest) {
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 16}, Column{"c", TypeId::BIGINT}});
+  std::vector<Value> values{ValueFactory::GetIntegerValue(42), ValueFactory::GetVarcharValue("hello"),
+                            ValueFactory::GetNullValueByType(TypeId::BIGINT)};
+  Tuple tuple{values, &schema};
+
+  // A reference reads the values straight out of the bytes it points to.
+  TupleRef ref{RID{3, 7}, tuple.GetData(), tuple.GetLength()};
+  ASSERT_EQ(TupleRef(tuple).GetData(), tuple.GetData());
+  ASSERT_EQ(ref.GetRid(), RID(3, 7));
+  ASSERT_EQ(ref.GetValue(&schema, 0).GetAs<int32_t>(), 42);
+  ASSERT_EQ(ref.GetValue(&schema, 1).ToString(), "hello");
+  ASSERT_FALSE(ref.IsNull(&schema, 1));
+  ASSERT_TRUE(ref.IsNull(&schema, 2));
+
+  // Expressions evaluate on a reference without a copy of the tuple.
+  const ComparisonExpression comparison{std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER),
+                                        std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(42)),
+                                        ComparisonType::Equal};
+  const AbstractExpression &pred = comparison;
+  ASSERT_TRUE(pred.Evaluate(ref, schema).GetAs<bool>());
+  ASSERT_TRUE(pred.Evaluate(&tuple, schema).GetAs<bool>());
+
+  // Materializing it makes an owning copy.
+  auto copy = ref.ToTuple();
+  ASSERT_NE(copy.GetData(), tuple.GetData());
+  ASSERT_EQ(copy.GetRid(), RID(3, 7));
+  ASSERT_EQ(copy.GetValue(&schema, 1).ToString(), "hello");
+}
+
 }  // namespace bustub
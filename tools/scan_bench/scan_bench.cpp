@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/buffer_pool_manager.h"
+#include "fmt/format.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+auto ClockNs() -> uint64_t {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-scan-bench");
+  program.add_argument("--rows").help("number of rows to insert into each table");
+  program.add_argument("--scans").help("number of times each table is scanned");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  uint64_t total_rows = 200000;
+  if (program.present("--rows")) {
+    total_rows = std::stoull(program.get("--rows"));
+  }
+  uint64_t total_scans = 5;
+  if (program.present("--scans")) {
+    total_scans = std::stoull(program.get("--scans"));
+  }
+
+  // An order line table: sequential keys, clustered dates, few distinct statuses, and free-form comments.
+  bustub::Schema schema({bustub::Column{"id", bustub::TypeId::BIGINT},
+                         bustub::Column{"order_id", bustub::TypeId::INTEGER},
+                         bustub::Column{"quantity", bustub::TypeId::INTEGER},
+                         bustub::Column{"ship_day", bustub::TypeId::INTEGER},
+                         bustub::Column{"status", bustub::TypeId::VARCHAR, 16},
+                         bustub::Column{"comment", bustub::TypeId::VARCHAR, 64}});
+  const std::vector<std::string> statuses{"PENDING", "SHIPPED", "DELIVERED", "RETURNED"};
+  std::vector<bustub::Tuple> tuples;
+  tuples.reserve(total_rows);
+  for (uint64_t i = 0; i < total_rows; i++) {
+    std::vector<bustub::Value> values{
+        bustub::ValueFactory::GetBigIntValue(static_cast<int64_t>(i)),
+        bustub::ValueFactory::GetIntegerValue(static_cast<int32_t>(i / 4)),
+        bustub::ValueFactory::GetIntegerValue(static_cast<int32_t>(i * 2654435761ULL % 50)),
+        bustub::ValueFactory::GetIntegerValue(static_cast<int32_t>(19000 + i / 100)),
+        bustub::ValueFactory::GetVarcharValue(statuses[i * 7 / 1000 % statuses.size()]),
+        bustub::ValueFactory::GetVarcharValue(fmt::format("comment {:x}", i * 2654435761ULL % 1000003))};
+    tuples.emplace_back(values, &schema);
+  }
+
+  fmt::print(stderr, "[info] total_rows={}, total_scans={}\n", total_rows, total_scans);
+
+  fmt::print("<<< BEGIN\n");
+  for (auto layout : {bustub::TableLayout::ROW, bustub::TableLayout::PAX, bustub::TableLayout::COMPRESSED}) {
+    auto disk_manager = std::make_unique<bustub::DiskManagerUnlimitedMemory>();
+    auto bpm = std::make_unique<bustub::BufferPoolManager>(65536, disk_manager.get());
+    auto table = std::make_unique<bustub::TableHeap>(bpm.get(), schema, layout);
+
+    auto insert_start = ClockNs();
+    for (const auto &tuple : tuples) {
+      table->InsertTuple(bustub::TupleMeta{bustub::INVALID_TXN_ID, bustub::INVALID_TXN_ID, false}, tuple);
+    }
+    // Compresses the tail of the last page of a COMPRESSED table.
+    table->Vacuum();
+    auto insert_ns = ClockNs() - insert_start;
+
+    // Load the same rows again through the bulk insert path.
+    auto bulk_table = std::make_unique<bustub::TableHeap>(bpm.get(), schema, layout);
+    auto bulk_insert_start = ClockNs();
+    for (size_t begin = 0; begin < tuples.size(); begin += 4096) {
+      std::vector<bustub::Tuple> batch(tuples.begin() + begin, tuples.begin() + std::min(begin + 4096, tuples.size()));
+      bulk_table->BulkInsert(bustub::TupleMeta{bustub::INVALID_TXN_ID, bustub::INVALID_TXN_ID, false}, batch);
+    }
+    bulk_table->Vacuum();
+    auto bulk_insert_ns = ClockNs() - bulk_insert_start;
+
+    size_t num_pages = 0;
+    for (auto page_id = table->GetFirstPageId(); page_id != bustub::INVALID_PAGE_ID; num_pages++) {
+      auto guard = bpm->FetchPageRead(page_id);
+      page_id = guard.As<bustub::TablePage>()->GetNextPageId();
+    }
+
+    // Scan all columns, then a single one, summing a column so that the values are really read.
+    const std::vector<uint32_t> one_column{2};
+    bustub::TupleViewBatch batch;
+    for (const auto *column_ids : {static_cast<const std::vector<uint32_t> *>(nullptr), &one_column}) {
+      int64_t checksum = 0;
+      auto scan_start = ClockNs();
+      for (uint64_t scan = 0; scan < total_scans; scan++) {
+        auto iter = table->MakeEagerIterator();
+        while (iter.NextBatch(&batch, column_ids)) {
+          for (size_t i = 0; i < batch.Size(); i++) {
+            bustub::TupleRef tuple = batch[i];
+            checksum += tuple.GetValue(&schema, 2).GetAs<int32_t>();
+          }
+        }
+      }
+      auto scan_ns = ClockNs() - scan_start;
+      fmt::print("{}_scan_{}_ns_per_row: {:.1f} (checksum {})\n", layout, column_ids == nullptr ? "all" : "one",
+                 static_cast<double>(scan_ns) / (total_rows * total_scans), checksum);
+    }
+    fmt::print("{}_insert_ns_per_row: {:.1f}\n", layout, static_cast<double>(insert_ns) / total_rows);
+    fmt::print("{}_bulk_insert_ns_per_row: {:.1f}\n", layout, static_cast<double>(bulk_insert_ns) / total_rows);
+    fmt::print("{}_pages: {}\n", layout, num_pages);
+    fmt::print("{}_rows_per_page: {:.1f}\n", layout, static_cast<double>(total_rows) / num_pages);
+  }
+  fmt::print(">>> END\n");
+  return 0;
+}
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/normalized_key.h"
+#include "fmt/format.h"
+#include "type/value_factory.h"
+
+auto ClockNs() -> uint64_t {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+struct Entry {
+  uint64_t prefix_;
+  const char *key_;
+  uint32_t key_size_;
+  uint32_t row_;
+};
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-sort-bench");
+  program.add_argument("--rows").help("number of rows to sort");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  uint64_t total_rows = 1000000;
+  if (program.present("--rows")) {
+    total_rows = std::stoull(program.get("--rows"));
+  }
+
+  // Random integers, few distinct names, and a nullable column.
+  bustub::Schema schema({bustub::Column{"id", bustub::TypeId::INTEGER},
+                         bustub::Column{"name", bustub::TypeId::VARCHAR, 16},
+                         bustub::Column{"score", bustub::TypeId::BIGINT}});
+  std::vector<bustub::Tuple> tuples;
+  tuples.reserve(total_rows);
+  for (uint64_t i = 0; i < total_rows; i++) {
+    auto hash = i * 2654435761ULL;
+    std::vector<bustub::Value> values{
+        bustub::ValueFactory::GetIntegerValue(static_cast<int32_t>(hash % 2000003) - 1000000),
+        bustub::ValueFactory::GetVarcharValue(fmt::format("name{}", hash % 1009)),
+        hash % 10 == 0 ? bustub::ValueFactory::GetNullValueByType(bustub::TypeId::BIGINT)
+                       : bustub::ValueFactory::GetBigIntValue(static_cast<int64_t>(hash % 100003))};
+    tuples.emplace_back(values, &schema);
+  }
+  auto column = [&](uint32_t column_idx) {
+    return std::make_shared<bustub::ColumnValueExpression>(0, column_idx, schema.GetColumn(column_idx).GetType());
+  };
+  using OrderBys = std::vector<std::pair<bustub::OrderByType, bustub::AbstractExpressionRef>>;
+  std::vector<std::pair<std::string, OrderBys>> sorts{
+      {"int", {{bustub::OrderByType::ASC, column(0)}}},
+      {"bigint_desc_int", {{bustub::OrderByType::DESC, column(2)}, {bustub::OrderByType::ASC, column(0)}}},
+      {"varchar_int", {{bustub::OrderByType::ASC, column(1)}, {bustub::OrderByType::ASC, column(0)}}},
+  };
+
+  fmt::print(stderr, "[info] total_rows={}\n", total_rows);
+
+  fmt::print("<<< BEGIN\n");
+  for (const auto &[name, order_bys] : sorts) {
+    // Compare Values, as a sort on the Type of each key would.
+    std::vector<uint32_t> rows(total_rows);
+    for (uint32_t i = 0; i < total_rows; i++) {
+      rows[i] = i;
+    }
+    auto value_start = ClockNs();
+    std::sort(rows.begin(), rows.end(), [&, &order_bys = order_bys](uint32_t a, uint32_t b) {
+      for (const auto &[order_by_type, expr] : order_bys) {
+        auto a_value = expr->Evaluate(&tuples[a], schema);
+        auto b_value = expr->Evaluate(&tuples[b], schema);
+        if (a_value.IsNull() || b_value.IsNull()) {
+          if (a_value.IsNull() != b_value.IsNull()) {
+            return (order_by_type == bustub::OrderByType::DESC) == a_value.IsNull();
+          }
+          continue;
+        }
+        if (a_value.CompareEquals(b_value) == bustub::CmpBool::CmpTrue) {
+          continue;
+        }
+        auto less = a_value.CompareLessThan(b_value) == bustub::CmpBool::CmpTrue;
+        return order_by_type == bustub::OrderByType::DESC ? !less : less;
+      }
+      return false;
+    });
+    auto value_ns = ClockNs() - value_start;
+
+    // Encode normalized keys, then radix sort them.
+    auto normalized_start = ClockNs();
+    bustub::KeyNormalizer normalizer(order_bys);
+    std::vector<char> keys;
+    std::vector<uint32_t> offsets;
+    offsets.reserve(total_rows + 1);
+    for (const auto &tuple : tuples) {
+      offsets.push_back(keys.size());
+      normalizer.Encode(tuple, schema, &keys);
+    }
+    offsets.push_back(keys.size());
+    std::vector<Entry> entries;
+    entries.reserve(total_rows);
+    uint32_t max_key_size = 0;
+    for (uint32_t i = 0; i < total_rows; i++) {
+      auto key_size = offsets[i + 1] - offsets[i];
+      const auto *key = keys.data() + offsets[i];
+      entries.push_back({bustub::KeyNormalizer::Prefix(key, key_size), key, key_size, i});
+      max_key_size = std::max(max_key_size, key_size);
+    }
+    auto encode_ns = ClockNs() - normalized_start;
+    bustub::SortByNormalizedKey(&entries, max_key_size > sizeof(uint64_t), [](const Entry &a, const Entry &b) {
+      if (a.prefix_ != b.prefix_) {
+        return a.prefix_ < b.prefix_;
+      }
+      return bustub::KeyNormalizer::Compare(a.key_, a.key_size_, b.key_, b.key_size_) < 0;
+    });
+    auto normalized_ns = ClockNs() - normalized_start;
+
+    // Both orders must agree on the keys, if not on the order of the rows with equal keys.
+    size_t mismatches = 0;
+    for (uint32_t i = 0; i < total_rows; i++) {
+      auto a = rows[i];
+      auto b = entries[i].row_;
+      for (const auto &[order_by_type, expr] : order_bys) {
+        auto a_value = expr->Evaluate(&tuples[a], schema);
+        auto b_value = expr->Evaluate(&tuples[b], schema);
+        auto equal = a_value.IsNull() || b_value.IsNull() ? a_value.IsNull() == b_value.IsNull()
+                                                          : a_value.CompareEquals(b_value) == bustub::CmpBool::CmpTrue;
+        if (!equal) {
+          mismatches++;
+          break;
+        }
+      }
+    }
+    fmt::print("{}_value_compare_ns_per_row: {:.1f}\n", name, static_cast<double>(value_ns) / total_rows);
+    fmt::print("{}_normalized_key_ns_per_row: {:.1f} (encode {:.1f})\n", name,
+               static_cast<double>(normalized_ns) / total_rows, static_cast<double>(encode_ns) / total_rows);
+    fmt::print("{}_mismatches: {}\n", name, mismatches);
+  }
+  fmt::print(">>> END\n");
+  return 0;
+}
@@ -116,6 +116,18 @@ auto ProcessExtraOptions(const std::string &sql, bustub::BustubInstance &instanc
           return false;
         }
         check_options->check_options_set_.emplace(bustub::CheckOption::ENABLE_NLJ_CHECK);
+      } else if (bustub::StringUtil::StartsWith(opt, "ensure:plan:")) {
+        auto text = opt.substr(std::string("ensure:plan:").size());
+        if (!bustub::StringUtil::Contains(result.str(), text)) {
+          fmt::print("{} not found in the plan\n", text);
+          return false;
+        }
+      } else if (bustub::StringUtil::StartsWith(opt, "ensure:no_plan:")) {
+        auto text = opt.substr(std::string("ensure:no_plan:").size());
+        if (bustub::StringUtil::Contains(result.str(), text)) {
+          fmt::print("{} should not be in the plan\n", text);
+          return false;
+        }
       } else {
         throw bustub::NotImplementedException(fmt::format("unsupported extra option: {}", opt));
       }
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "fmt/format.h"
+#include "primer/trie.h"
+#include "primer/trie_store.h"
+#include "primer/write_batch.h"
+
+// Every allocation made by this process is accounted here, so that the memory footprint of a trie can be measured
+// without knowing anything about its node layout. The size is stashed in a header in front of the user pointer.
+static std::atomic<int64_t> live_bytes{0};
+static constexpr size_t ALLOC_HEADER_SIZE = alignof(std::max_align_t);
+
+auto operator new(size_t size) -> void * {
+  auto *raw = static_cast<char *>(std::malloc(size + ALLOC_HEADER_SIZE));  // NOLINT
+  if (raw == nullptr) {
+    throw std::bad_alloc();
+  }
+  *reinterpret_cast<size_t *>(raw) = size;
+  live_bytes += static_cast<int64_t>(size);
+  return raw + ALLOC_HEADER_SIZE;
+}
+
+auto operator new(size_t size, const std::nothrow_t & /* tag */) noexcept -> void * {
+  try {
+    return operator new(size);
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+
+void operator delete(void *ptr) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  auto *raw = static_cast<char *>(ptr) - ALLOC_HEADER_SIZE;
+  live_bytes -= static_cast<int64_t>(*reinterpret_cast<size_t *>(raw));
+  std::free(raw);  // NOLINT
+}
+
+void operator delete(void *ptr, size_t /* size */) noexcept { operator delete(ptr); }
+
+void operator delete(void *ptr, const std::nothrow_t & /* tag */) noexcept { operator delete(ptr); }
+
+auto ClockNs() -> uint64_t {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-trie-bench");
+  program.add_argument("--keys").help("number of keys to insert");
+  program.add_argument("--lookups").help("number of point lookups to time");
+  program.add_argument("--threads").help("number of writer threads, and of reader threads, on the TrieStore");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  uint64_t total_keys = 200000;
+  if (program.present("--keys")) {
+    total_keys = std::stoull(program.get("--keys"));
+  }
+  uint64_t total_lookups = 2000000;
+  if (program.present("--lookups")) {
+    total_lookups = std::stoull(program.get("--lookups"));
+  }
+
+  std::vector<std::string> keys;
+  keys.reserve(total_keys);
+  for (uint64_t i = 0; i < total_keys; i++) {
+    keys.push_back(fmt::format("key-{:#010}", i * 2654435761ULL % (total_keys * 16)));
+  }
+  int64_t key_bytes = live_bytes;
+
+  uint64_t num_threads = 4;
+  if (program.present("--threads")) {
+    num_threads = std::max<uint64_t>(std::stoull(program.get("--threads")), 1);
+  }
+
+  fmt::print(stderr, "[info] total_keys={}, total_lookups={}, threads={}\n", total_keys, total_lookups, num_threads);
+
+  auto trie = bustub::Trie();
+  auto put_start = ClockNs();
+  for (uint64_t i = 0; i < total_keys; i++) {
+    trie = trie.Put<uint64_t>(keys[i], i);
+  }
+  auto put_ns = ClockNs() - put_start;
+  int64_t trie_bytes = live_bytes - key_bytes;
+
+  // Load the same keys again, in batches of 10000, through a single-pass Apply per batch.
+  auto batch_trie = bustub::Trie();
+  auto apply_start = ClockNs();
+  for (uint64_t begin = 0; begin < total_keys; begin += 10000) {
+    bustub::WriteBatch batch;
+    for (uint64_t i = begin; i < std::min(begin + 10000, total_keys); i++) {
+      batch.Put<uint64_t>(keys[i], i);
+    }
+    batch_trie = batch_trie.Apply(batch);
+  }
+  auto apply_ns = ClockNs() - apply_start;
+  batch_trie = bustub::Trie();
+
+  std::mt19937_64 gen(2333);
+  std::uniform_int_distribution<uint64_t> dis(0, total_keys - 1);
+  uint64_t checksum = 0;
+  auto get_start = ClockNs();
+  for (uint64_t i = 0; i < total_lookups; i++) {
+    const auto *value = trie.Get<uint64_t>(keys[dis(gen)]);
+    if (value == nullptr) {
+      throw std::runtime_error("key not found");
+    }
+    checksum += *value;
+  }
+  auto get_ns = ClockNs() - get_start;
+  trie = bustub::Trie();
+
+  // Writers overwrite every key of a TrieStore once, each its own share of the keys, while readers look up random
+  // keys, which must have either the old or the new value.
+  bustub::TrieStore store;
+  for (uint64_t i = 0; i < total_keys; i++) {
+    store.Put<uint64_t>(keys[i], i);
+  }
+  std::vector<std::thread> threads;
+  // Set by a reader that finds a wrong value. An exception would terminate the process from inside the thread.
+  std::atomic<bool> wrong_value{false};
+  auto store_start = ClockNs();
+  for (uint64_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid] {
+      for (uint64_t i = tid; i < total_keys; i += num_threads) {
+        store.Put<uint64_t>(keys[i], i + 1);
+      }
+    });
+  }
+  for (uint64_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid] {
+      std::mt19937_64 gen(tid);
+      std::uniform_int_distribution<uint64_t> key_dis(0, total_keys - 1);
+      for (uint64_t i = 0; i < total_lookups / num_threads; i++) {
+        auto key = key_dis(gen);
+        auto guard = store.Get<uint64_t>(keys[key]);
+        if (!guard.has_value() || (**guard != key && **guard != key + 1)) {
+          wrong_value = true;
+          return;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto store_ns = ClockNs() - store_start;
+  if (wrong_value) {
+    throw std::runtime_error("wrong value in the store");
+  }
+
+  fmt::print("<<< BEGIN\n");
+  fmt::print("put_ns_per_key: {:.1f}\n", static_cast<double>(put_ns) / total_keys);
+  fmt::print("apply_ns_per_key: {:.1f}\n", static_cast<double>(apply_ns) / total_keys);
+  fmt::print("get_ns_per_key: {:.1f}\n", static_cast<double>(get_ns) / total_lookups);
+  fmt::print("bytes_per_key: {:.1f}\n", static_cast<double>(trie_bytes) / total_keys);
+  fmt::print("store_writes_per_sec: {:.0f}\n", total_keys * 1e9 / store_ns);
+  fmt::print("store_reads_per_sec: {:.0f}\n", total_lookups / num_threads * num_threads * 1e9 / store_ns);
+  fmt::print("checksum: {}\n", checksum);
+  fmt::print(">>> END\n");
+  return 0;
+}